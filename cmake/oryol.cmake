@@ -20,6 +20,7 @@ option(ORYOL_UNITTESTS_RUN_AFTER_BUILD "Automatically run unit tests after build
 option(ORYOL_UNITTESTS_HEADLESS "If enabled don't run tests which require a display" OFF)
 option(ORYOL_EXCEPTIONS "Enable C++ exceptions" OFF)
 option(ORYOL_ALLOCATOR_DEBUG "Enable allocator debugging code (slow)" OFF)
+option(ORYOL_ALLOCATOR_STATS "Enable per-tag memory allocation statistics" OFF)
 option(ORYOL_SAMPLES "Compile sample programs" ON)
 option(ORYOL_FORCE_NO_THREADS "Enable to simulate no support for std::thread" OFF)
 option(ORYOL_COMPILE_VERBOSE "Enable very verbose compilation" OFF)
@@ -93,6 +94,11 @@ macro(oryol_setup)
     else()
         add_definitions(-DORYOL_ALLOCATOR_DEBUG=0)
     endif()
+    if (ORYOL_ALLOCATOR_STATS)
+        add_definitions(-DORYOL_ALLOCATOR_STATS=1)
+    else()
+        add_definitions(-DORYOL_ALLOCATOR_STATS=0)
+    endif()
     if (ORYOL_UNITTESTS)
         add_definitions(-DORYOL_UNITTESTS=1)
         if (ORYOL_UNITTESTS_HEADLESS)
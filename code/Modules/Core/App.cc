@@ -23,7 +23,8 @@ App::App() :
 curState(AppState::Construct),
 nextState(AppState::InvalidAppState),
 quitRequested(false),
-suspendRequested(false)
+suspendRequested(false),
+pipelined(false)
 {
     self = this;
     #if ORYOL_ANDROID
@@ -35,6 +36,9 @@ suspendRequested(false)
 
 //------------------------------------------------------------------------------
 App::~App() {
+    if (this->pipeline.IsValid()) {
+        this->pipeline.Discard();
+    }
     #if ORYOL_ANDROID
     this->androidBridge.discard();
     #elif ORYOL_IOS
@@ -104,6 +108,11 @@ void
 App::onFrame() {
     // state transition?
     if ((this->nextState != AppState::InvalidAppState) && (this->nextState != this->curState)) {
+        // leaving the Running state, wait for a running update
+        if (this->pipeline.IsValid()) {
+            this->pipeline.Discard();
+        }
+
         // check if the next state is blocked
         if (this->blockers.Contains(this->nextState)) {
             // yikes, we're blocked
@@ -144,7 +153,12 @@ App::onFrame() {
                 this->nextState = this->OnInit();
                 break;
             case AppState::Running:
-                this->nextState = this->OnRunning();
+                if (this->pipelined) {
+                    this->onRunningPipelined();
+                }
+                else {
+                    this->nextState = this->OnRunning();
+                }
                 break;
             case AppState::Cleanup:
                 this->nextState = this->OnCleanup();
@@ -163,6 +177,22 @@ App::onFrame() {
     }  
 }
 
+//------------------------------------------------------------------------------
+void
+App::onRunningPipelined() {
+    if (!this->pipeline.IsValid()) {
+        this->pipeline.Setup([this](int64 frameIndex, int32 bufferIndex) {
+            this->OnUpdate(bufferIndex);
+        });
+    }
+    // wait for the update of this frame, and start the next update,
+    // which runs in parallel with OnRunning()
+    this->pipeline.BeginFrame();
+    this->OnSync();
+    this->pipeline.StartUpdate();
+    this->nextState = this->OnRunning();
+}
+
 //------------------------------------------------------------------------------
 AppState::Code
 App::OnConstruct() {
@@ -224,6 +254,57 @@ App::OnDestroy() {
     return AppState::InvalidAppState;
 }
 
+//------------------------------------------------------------------------------
+void
+App::OnSync() {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+void
+App::OnUpdate(int32 bufferIndex) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+ Can be called at any time on the main thread, for instance in OnInit().
+ Disabling pipelined mode waits for a running update.
+*/
+void
+App::SetPipelined(bool b) {
+    this->pipelined = b;
+    if (!b && this->pipeline.IsValid()) {
+        this->pipeline.Discard();
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+App::IsPipelined() const {
+    return this->pipelined;
+}
+
+//------------------------------------------------------------------------------
+int32
+App::RenderBufferIndex() const {
+    return this->pipeline.IsValid() ? this->pipeline.RenderBufferIndex() : 0;
+}
+
+//------------------------------------------------------------------------------
+void
+App::SyncUpdate() {
+    if (this->pipeline.IsValid()) {
+        this->pipeline.Sync();
+    }
+}
+
+//------------------------------------------------------------------------------
+const FrameFence&
+App::UpdateFence() const {
+    return this->pipeline.UpdateFence();
+}
+
 //------------------------------------------------------------------------------
 void
 App::readyForInit() {
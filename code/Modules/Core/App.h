@@ -31,12 +31,24 @@
     };
     OryolMain(MyAppClass);    
     ```
+
+    In the optional pipelined mode (see SetPipelined()), the Running
+    state is split into OnUpdate(), which is called on an update thread
+    and computes the next frame, and OnRunning(), which renders the
+    current frame on the main thread in parallel. Data written by
+    OnUpdate() and read by OnRunning() must be double-buffered:
+    OnUpdate() gets the index of the buffer it must write, and OnRunning()
+    reads from RenderBufferIndex(). OnSync() is called on the main thread
+    between the two, while no update is running, this is the place
+    to hand input and other main-thread state over to the update side.
+    Pipelining adds one frame of latency, see FramePipeline for details.
 */
 #include "Core/Types.h"
 #include "Core/Args.h"
 #include "Core/AppState.h"
 #include "Core/String/WideString.h"
 #include "Core/Containers/Set.h"
+#include "Core/Threading/FramePipeline.h"
 #if ORYOL_WINDOWS
 #define VC_EXTRALEAN (1)
 #define WIN32_LEAN_AND_MEAN (1)
@@ -79,6 +91,21 @@ public:
     virtual AppState::Code OnCleanup();
     /// on destroy frame method
     virtual AppState::Code OnDestroy();
+    /// on sync frame method (pipelined mode only, main thread, no update running)
+    virtual void OnSync();
+    /// on update frame method (pipelined mode only, called on the update thread)
+    virtual void OnUpdate(int32 bufferIndex);
+
+    /// enable/disable pipelined mode (OnUpdate() of next frame runs in parallel with OnRunning())
+    void SetPipelined(bool b);
+    /// return true if pipelined mode is enabled
+    bool IsPipelined() const;
+    /// get the frame data buffer index OnRunning() should read from (pipelined mode)
+    int32 RenderBufferIndex() const;
+    /// wait until a running OnUpdate() has finished (pipelined mode)
+    void SyncUpdate();
+    /// get the fence which is signalled after each OnUpdate() (pipelined mode)
+    const FrameFence& UpdateFence() const;
 
     /// add a blocker which prevents entering this state
     void addBlocker(AppState::Code blockedState);
@@ -89,6 +116,8 @@ public:
     static void staticOnFrame();
     /// virtual onFrame method to be overwritten by subclass
     virtual void onFrame();
+    /// run the Running state in pipelined mode
+    void onRunningPipelined();
     /// low-level ready for init notifier
     void readyForInit();
     /// low-level request app to quit notifier
@@ -103,6 +132,8 @@ protected:
     Set<AppState::Code> blockers;
     bool quitRequested;
     bool suspendRequested;
+    bool pipelined;
+    FramePipeline pipeline;
     #if ORYOL_IOS
     _priv::iosBridge iosBridge;
     #endif
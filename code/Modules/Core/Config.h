@@ -35,6 +35,9 @@
 #define ORYOL_MAX_PLATFORM_ALIGN (16)
 #endif
 
+/// size of a CPU cache line in bytes (for padding shared data)
+#define ORYOL_CACHELINE_SIZE (64)
+
 /// memory debug fill pattern (byte)
 #define ORYOL_MEMORY_DEBUG_BYTE (0xBB)
 /// memory debug fill pattern (short)
@@ -47,6 +50,9 @@
 /// maximum grow size for dynamic container classes (num elements)
 #define ORYOL_CONTAINER_DEFAULT_MAX_GROW (1<<16)
 
+/// default chunk size of per-thread frame arenas (bytes)
+#define ORYOL_FRAMEARENA_DEFAULT_CHUNK_SIZE (1<<18)
+
 #ifndef __GNUC__
 #define __attribute__(x)
 #endif
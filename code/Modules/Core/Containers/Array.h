@@ -61,6 +61,10 @@ public:
     int32 GetMinGrow() const;
     /// get max grow value
     int32 GetMaxGrow() const;
+    /// allocate from a FrameArena instead of the heap (array must not have been allocated yet)
+    void SetArena(FrameArena* arena);
+    /// set buffer alignment, e.g. for SIMD data (array must not have been allocated yet)
+    void SetAlignment(int32 alignment);
     /// get number of elements in array
     int32 Size() const;
     /// return true if empty
@@ -215,6 +219,18 @@ Array<TYPE>::GetMaxGrow() const {
     return this->maxGrow;
 }
 
+//------------------------------------------------------------------------------
+template<class TYPE> void
+Array<TYPE>::SetArena(FrameArena* arena) {
+    this->buffer.setArena(arena);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+Array<TYPE>::SetAlignment(int32 alignment) {
+    this->buffer.setAlignment(alignment);
+}
+
 //------------------------------------------------------------------------------
 template<class TYPE> int32
 Array<TYPE>::Size() const {
@@ -0,0 +1,444 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::FrozenMap
+    @ingroup Core
+    @brief immutable key/value map optimized for lookup
+
+    A FrozenMap is built once from a Map (or an array of KeyValuePairs),
+    and is read-only after that. Keys and values are stored in separate
+    arrays in Eytzinger order (the implicit layout of a binary heap: the
+    children of the element at 1-based position k are at 2k and 2k+1).
+    A lookup walks down this implicit tree with a single, predictable
+    loop, and the top levels of the tree share a few cache lines, so
+    Find() is considerably faster than the binary search of a Map for
+    bigger key sets, and doesn't touch the values until the key is found.
+
+    Keys must be unique, and only need an operator< and operator==.
+
+    If KEY and VALUE are trivially copyable, a FrozenMap can be written
+    to a flat binary blob with WriteBlob(), and a FrozenMap can be set up
+    directly on top of such a blob with SetupFromBlob(), for instance in a
+    memory-mapped file. In this case, the FrozenMap doesn't own the
+    memory, and the blob must remain valid as long as the FrozenMap is
+    used. The blob is not endian-neutral. The blob layout uses a fixed
+    alignment of BlobAlign (16) bytes on all platforms, so the start of
+    the blob must be 16-byte aligned.
+
+    The element indices used by KeyAtIndex() and ValueAtIndex() are
+    in Eytzinger order, not in sorted order.
+
+    @see Map, HashMap
+*/
+#include <algorithm>
+#include <new>
+#include <type_traits>
+#include "Core/Config.h"
+#include "Core/Types.h"
+#include "Core/Assert.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/Map.h"
+#include "Core/Containers/KeyValuePair.h"
+
+namespace Oryol {
+
+template<class KEY, class VALUE> class FrozenMap {
+public:
+    /// default constructor
+    FrozenMap();
+    /// construct from a Map
+    FrozenMap(const Map<KEY, VALUE>& map);
+    /// copy constructor (copy owns its memory)
+    FrozenMap(const FrozenMap& rhs);
+    /// move constructor
+    FrozenMap(FrozenMap&& rhs);
+    /// destructor
+    ~FrozenMap();
+
+    /// copy-assignment operator (copy owns its memory)
+    void operator=(const FrozenMap& rhs);
+    /// move-assignment operator
+    void operator=(FrozenMap&& rhs);
+
+    /// build from a Map (keys in a Map are sorted and unique)
+    void Build(const Map<KEY, VALUE>& map);
+    /// build from an array of key/value pairs, keys must be unique
+    void Build(const KeyValuePair<KEY, VALUE>* kvps, int32 num);
+    /// discard content
+    void Clear();
+
+    /// get number of elements
+    int32 Size() const;
+    /// return true if empty
+    bool Empty() const;
+    /// return true if the FrozenMap doesn't own its memory (set up from a blob)
+    bool IsView() const;
+
+    /// test if an element exists
+    bool Contains(const KEY& key) const;
+    /// find element index, return InvalidIndex if not found
+    int32 FindIndex(const KEY& key) const;
+    /// find value by key, return nullptr if not found
+    const VALUE* Find(const KEY& key) const;
+    /// read-only access to value by key, key must exist
+    const VALUE& operator[](const KEY& key) const;
+    /// get key at index (Eytzinger order)
+    const KEY& KeyAtIndex(int32 index) const;
+    /// get value at index (Eytzinger order)
+    const VALUE& ValueAtIndex(int32 index) const;
+
+    /// alignment of blobs and of the arrays inside blobs (platform-independent)
+    static const int32 BlobAlign = 16;
+    /// get size of the blob written by WriteBlob() in bytes
+    int32 BlobSize() const;
+    /// write content as a flat blob, return number of written bytes
+    int32 WriteBlob(void* ptr, int32 maxBytes) const;
+    /// set up as non-owning view on a blob, return false if blob is not valid
+    bool SetupFromBlob(const void* ptr, int32 numBytes);
+
+private:
+    /// blob header
+    struct blobHeader {
+        uint32 magic;
+        uint32 num;
+        uint32 keySize;
+        uint32 valueSize;
+    };
+    static const uint32 BlobMagic = 'F' | ('R'<<8) | ('Z'<<16) | ('M'<<24);
+    /// get offset of key and value arrays in blob
+    static int32 keysOffset();
+    static int32 valuesOffset(int32 num);
+    /// allocate owned key and value arrays
+    void alloc(int32 num);
+    /// copy sorted elements into Eytzinger order, return next sorted index
+    int32 fill(const KeyValuePair<KEY, VALUE>* sorted, int32 i, int32 k);
+    /// copy from other FrozenMap
+    void copy(const FrozenMap& rhs);
+    /// move from other FrozenMap
+    void move(FrozenMap&& rhs);
+
+    const KEY* keys;
+    const VALUE* values;
+    int32 num;
+    bool owned;
+};
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE>
+FrozenMap<KEY, VALUE>::FrozenMap() :
+keys(nullptr),
+values(nullptr),
+num(0),
+owned(false) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE>
+FrozenMap<KEY, VALUE>::FrozenMap(const Map<KEY, VALUE>& map) :
+keys(nullptr),
+values(nullptr),
+num(0),
+owned(false) {
+    this->Build(map);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE>
+FrozenMap<KEY, VALUE>::FrozenMap(const FrozenMap& rhs) :
+keys(nullptr),
+values(nullptr),
+num(0),
+owned(false) {
+    this->copy(rhs);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE>
+FrozenMap<KEY, VALUE>::FrozenMap(FrozenMap&& rhs) :
+keys(nullptr),
+values(nullptr),
+num(0),
+owned(false) {
+    this->move(std::move(rhs));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE>
+FrozenMap<KEY, VALUE>::~FrozenMap() {
+    this->Clear();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE> void
+FrozenMap<KEY, VALUE>::operator=(const FrozenMap& rhs) {
+    if (&rhs != this) {
+        this->Clear();
+        this->copy(rhs);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE> void
+FrozenMap<KEY, VALUE>::operator=(FrozenMap&& rhs) {
+    if (&rhs != this) {
+        this->Clear();
+        this->move(std::move(rhs));
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE> void
+FrozenMap<KEY, VALUE>::alloc(int32 numElms) {
+    o_assert_dbg(nullptr == this->keys);
+    if (numElms > 0) {
+        this->keys = (KEY*) Memory::Alloc(numElms * sizeof(KEY), MemoryTag::Containers);
+        this->values = (VALUE*) Memory::Alloc(numElms * sizeof(VALUE), MemoryTag::Containers);
+    }
+    this->num = numElms;
+    this->owned = true;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE> void
+FrozenMap<KEY, VALUE>::Clear() {
+    if (this->owned) {
+        for (int32 i = 0; i < this->num; i++) {
+            this->keys[i].~KEY();
+            this->values[i].~VALUE();
+        }
+        if (this->keys) {
+            Memory::Free((void*)this->keys);
+            Memory::Free((void*)this->values);
+        }
+    }
+    this->keys = nullptr;
+    this->values = nullptr;
+    this->num = 0;
+    this->owned = false;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE> void
+FrozenMap<KEY, VALUE>::copy(const FrozenMap& rhs) {
+    this->alloc(rhs.num);
+    for (int32 i = 0; i < rhs.num; i++) {
+        new((void*)&this->keys[i]) KEY(rhs.keys[i]);
+        new((void*)&this->values[i]) VALUE(rhs.values[i]);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE> void
+FrozenMap<KEY, VALUE>::move(FrozenMap&& rhs) {
+    this->keys = rhs.keys;
+    this->values = rhs.values;
+    this->num = rhs.num;
+    this->owned = rhs.owned;
+    rhs.keys = nullptr;
+    rhs.values = nullptr;
+    rhs.num = 0;
+    rhs.owned = false;
+}
+
+//------------------------------------------------------------------------------
+/**
+ In-order traversal of the implicit tree, this assigns the sorted
+ elements to the 1-based tree positions k.
+*/
+template<class KEY, class VALUE> int32
+FrozenMap<KEY, VALUE>::fill(const KeyValuePair<KEY, VALUE>* sorted, int32 i, int32 k) {
+    if (k <= this->num) {
+        i = this->fill(sorted, i, 2 * k);
+        new((void*)&this->keys[k - 1]) KEY(sorted[i].key);
+        new((void*)&this->values[k - 1]) VALUE(sorted[i].value);
+        i++;
+        i = this->fill(sorted, i, 2 * k + 1);
+    }
+    return i;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE> void
+FrozenMap<KEY, VALUE>::Build(const Map<KEY, VALUE>& map) {
+    this->Clear();
+    this->alloc(map.Size());
+    this->fill(map.begin(), 0, 1);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE> void
+FrozenMap<KEY, VALUE>::Build(const KeyValuePair<KEY, VALUE>* kvps, int32 numKvps) {
+    o_assert((nullptr != kvps) || (0 == numKvps));
+    Array<KeyValuePair<KEY, VALUE>> sorted;
+    sorted.Reserve(numKvps);
+    for (int32 i = 0; i < numKvps; i++) {
+        sorted.Add(kvps[i]);
+    }
+    std::sort(sorted.begin(), sorted.end());
+    for (int32 i = 1; i < numKvps; i++) {
+        o_assert2(sorted[i-1].key < sorted[i].key, "FrozenMap::Build(): duplicate key!\n");
+    }
+    this->Clear();
+    this->alloc(numKvps);
+    this->fill(sorted.begin(), 0, 1);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE> int32
+FrozenMap<KEY, VALUE>::Size() const {
+    return this->num;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE> bool
+FrozenMap<KEY, VALUE>::Empty() const {
+    return 0 == this->num;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE> bool
+FrozenMap<KEY, VALUE>::IsView() const {
+    return !this->owned && (nullptr != this->keys);
+}
+
+//------------------------------------------------------------------------------
+/**
+ Walk down the tree, going right whenever the node key is less than
+ the search key. At the end, the path bits of k describe the search
+ path, and the lower bound is the node where the path last went
+ left: strip the trailing right-turns (1-bits) plus one more bit.
+*/
+template<class KEY, class VALUE> int32
+FrozenMap<KEY, VALUE>::FindIndex(const KEY& key) const {
+    const int32 n = this->num;
+    if (0 == n) {
+        return InvalidIndex;
+    }
+    const KEY* k0 = this->keys - 1;
+    uint32 k = 1;
+    while (k <= uint32(n)) {
+        k = 2 * k + uint32(k0[k] < key);
+    }
+    while (k & 1) {
+        k >>= 1;
+    }
+    k >>= 1;
+    if ((0 != k) && (k0[k] == key)) {
+        return int32(k - 1);
+    }
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE> bool
+FrozenMap<KEY, VALUE>::Contains(const KEY& key) const {
+    return InvalidIndex != this->FindIndex(key);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE> const VALUE*
+FrozenMap<KEY, VALUE>::Find(const KEY& key) const {
+    const int32 index = this->FindIndex(key);
+    return (InvalidIndex != index) ? &this->values[index] : nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE> const VALUE&
+FrozenMap<KEY, VALUE>::operator[](const KEY& key) const {
+    const int32 index = this->FindIndex(key);
+    o_assert(InvalidIndex != index);
+    return this->values[index];
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE> const KEY&
+FrozenMap<KEY, VALUE>::KeyAtIndex(int32 index) const {
+    o_assert_range_dbg(index, this->num);
+    return this->keys[index];
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE> const VALUE&
+FrozenMap<KEY, VALUE>::ValueAtIndex(int32 index) const {
+    o_assert_range_dbg(index, this->num);
+    return this->values[index];
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE> int32
+FrozenMap<KEY, VALUE>::keysOffset() {
+    static_assert(std::alignment_of<KEY>::value <= BlobAlign, "FrozenMap: KEY alignment too big for blob");
+    static_assert(sizeof(blobHeader) == BlobAlign, "FrozenMap: unexpected blob header size");
+    return sizeof(blobHeader);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE> int32
+FrozenMap<KEY, VALUE>::valuesOffset(int32 numElms) {
+    static_assert(std::alignment_of<VALUE>::value <= BlobAlign, "FrozenMap: VALUE alignment too big for blob");
+    return (keysOffset() + numElms * int32(sizeof(KEY)) + BlobAlign - 1) & ~(BlobAlign - 1);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE> int32
+FrozenMap<KEY, VALUE>::BlobSize() const {
+    return valuesOffset(this->num) + this->num * int32(sizeof(VALUE));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE> int32
+FrozenMap<KEY, VALUE>::WriteBlob(void* ptr, int32 maxBytes) const {
+    static_assert(std::is_trivially_copyable<KEY>::value && std::is_trivially_copyable<VALUE>::value,
+        "FrozenMap::WriteBlob(): KEY and VALUE must be trivially copyable");
+    o_assert(nullptr != ptr);
+    const int32 size = this->BlobSize();
+    o_assert(maxBytes >= size);
+    uint8* dst = (uint8*) ptr;
+    Memory::Clear(dst, size);
+    blobHeader* hdr = (blobHeader*) dst;
+    hdr->magic = BlobMagic;
+    hdr->num = uint32(this->num);
+    hdr->keySize = sizeof(KEY);
+    hdr->valueSize = sizeof(VALUE);
+    if (this->num > 0) {
+        Memory::Copy(this->keys, dst + keysOffset(), this->num * sizeof(KEY));
+        Memory::Copy(this->values, dst + valuesOffset(this->num), this->num * sizeof(VALUE));
+    }
+    return size;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE> bool
+FrozenMap<KEY, VALUE>::SetupFromBlob(const void* ptr, int32 numBytes) {
+    static_assert(std::is_trivially_copyable<KEY>::value && std::is_trivially_copyable<VALUE>::value,
+        "FrozenMap::SetupFromBlob(): KEY and VALUE must be trivially copyable");
+    o_assert(nullptr != ptr);
+    o_assert2(0 == (uintptr(ptr) & (BlobAlign - 1)), "FrozenMap::SetupFromBlob(): blob not aligned!\n");
+    this->Clear();
+    if (numBytes < int32(sizeof(blobHeader))) {
+        return false;
+    }
+    const uint8* src = (const uint8*) ptr;
+    const blobHeader* hdr = (const blobHeader*) src;
+    if ((BlobMagic != hdr->magic) ||
+        (sizeof(KEY) != hdr->keySize) ||
+        (sizeof(VALUE) != hdr->valueSize) ||
+        (hdr->num > uint32(numBytes))) {
+        return false;
+    }
+    const int32 numElms = int32(hdr->num);
+    if (numBytes < valuesOffset(numElms) + numElms * int32(sizeof(VALUE))) {
+        return false;
+    }
+    if (numElms > 0) {
+        this->keys = (const KEY*) (src + keysOffset());
+        this->values = (const VALUE*) (src + valuesOffset(numElms));
+    }
+    this->num = numElms;
+    this->owned = false;
+    return true;
+}
+
+} // namespace Oryol
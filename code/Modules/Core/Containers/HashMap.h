@@ -0,0 +1,466 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::HashMap
+    @ingroup Core
+    @brief key-value map using open-addressing hashing
+
+    A key-value-pair container with O(1) Add, Erase and lookup, for
+    big maps where the O(N) insertion of the sorted Map becomes a
+    bottleneck. Unlike Map, keys must be unique.
+
+    The key-value-pairs are kept in a dense array (so iteration with
+    begin()/end() is as fast as for an Array), and a separate
+    open-addressing index table maps hashes to array indices. The index
+    table uses Robin Hood hashing with backward-shift deletion, so there
+    are no tombstones and lookups of missing keys terminate early.
+    Erasing an element swaps in the last element of the dense array,
+    thus the element order is not stable.
+
+    The HASHER template parameter works like in HashSet, it is a
+    functor class with a 'uint32 operator()(const KEY&)', the hash
+    value is scrambled internally, so a simple identity hash for
+    integer keys is fine.
+
+    Contains(), Find(), FindIndex() and operator[] also accept keys of a
+    different type which can be compared with KEY (for instance a
+    StringView to look up String keys without creating a temporary
+    String), the HASHER must then also provide an operator() for this
+    key type which returns the same hash value as for an equal KEY.
+
+    The index table grows to keep the load factor below 7/8,
+    use Reserve() to presize the map, and Rehash() to shrink the
+    index table after many elements have been erased.
+
+    @see Map, HashSet, KeyValuePair
+*/
+#include <type_traits>
+#include "Core/Config.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/KeyValuePair.h"
+#include "Core/Containers/hashIndex.h"
+
+namespace Oryol {
+
+template<class KEY, class VALUE, class HASHER> class HashMap {
+    /// enable lookup methods for key types which don't convert to KEY
+    template<class K> using enableIfOtherKey = typename std::enable_if<!std::is_convertible<const K&, KEY>::value>::type;
+public:
+    /// default constructor
+    HashMap();
+    /// copy constructor
+    HashMap(const HashMap& rhs);
+    /// move constructor
+    HashMap(HashMap&& rhs);
+    /// destructor
+    ~HashMap();
+
+    /// copy-assignment operator
+    void operator=(const HashMap& rhs);
+    /// move-assignment operator
+    void operator=(HashMap&& rhs);
+
+    /// get number of elements in map
+    int32 Size() const;
+    /// return true if empty
+    bool Empty() const;
+    /// get number of slots in the index table
+    int32 Capacity() const;
+
+    /// read/write access to existing element
+    VALUE& operator[](const KEY& key);
+    /// read-only access to existing element
+    const VALUE& operator[](const KEY& key) const;
+    /// read/write access to existing element with a comparable key of a different type
+    template<class K, class=enableIfOtherKey<K>> VALUE& operator[](const K& key);
+    /// read-only access to existing element with a comparable key of a different type
+    template<class K, class=enableIfOtherKey<K>> const VALUE& operator[](const K& key) const;
+
+    /// increase capacity to hold at least numElements more elements without rehashing
+    void Reserve(int32 numElements);
+    /// rebuild the index table with at least minCapacity slots (0 to shrink to fit)
+    void Rehash(int32 minCapacity=0);
+    /// clear the map (keeps capacity)
+    void Clear();
+
+    /// test if an element exists
+    bool Contains(const KEY& key) const;
+    /// test if an element exists with a comparable key of a different type
+    template<class K, class=enableIfOtherKey<K>> bool Contains(const K& key) const;
+    /// add new element (key must not exist)
+    void Add(const KeyValuePair<KEY, VALUE>& kvp);
+    /// add new element with move semantics (key must not exist)
+    void Add(KeyValuePair<KEY, VALUE>&& kvp);
+    /// add new element (key must not exist)
+    void Add(const KEY& key, const VALUE& value);
+    /// add new element, return false if element with key already existed
+    bool AddUnique(const KeyValuePair<KEY, VALUE>& kvp);
+    /// add new element with move semantics, return false if element with key already existed
+    bool AddUnique(KeyValuePair<KEY, VALUE>&& kvp);
+    /// add new element, return false if element with key already existed
+    bool AddUnique(const KEY& key, const VALUE& value);
+    /// erase element, does nothing if key not contained
+    void Erase(const KEY& key);
+
+    /// find value by key, return nullptr if not contained
+    VALUE* Find(const KEY& key);
+    /// find value by key, return nullptr if not contained
+    const VALUE* Find(const KEY& key) const;
+    /// find value by a comparable key of a different type, return nullptr if not contained
+    template<class K, class=enableIfOtherKey<K>> VALUE* Find(const K& key);
+    /// find value by a comparable key of a different type, return nullptr if not contained
+    template<class K, class=enableIfOtherKey<K>> const VALUE* Find(const K& key) const;
+    /// find an element, returns index into dense element array, or InvalidIndex
+    int32 FindIndex(const KEY& key) const;
+    /// find an element with a comparable key of a different type, returns dense index, or InvalidIndex
+    template<class K, class=enableIfOtherKey<K>> int32 FindIndex(const K& key) const;
+    /// erase element at dense index
+    void EraseIndex(int32 index);
+    /// get key at dense index
+    const KEY& KeyAtIndex(int32 index) const;
+    /// get value at dense index (read-only)
+    const VALUE& ValueAtIndex(int32 index) const;
+    /// get value at dense index (read/write)
+    VALUE& ValueAtIndex(int32 index);
+
+    /// C++ conform begin, MAY RETURN nullptr!
+    KeyValuePair<KEY, VALUE>* begin();
+    /// C++ conform begin, MAY RETURN nullptr!
+    const KeyValuePair<KEY, VALUE>* begin() const;
+    /// C++ conform end, MAY RETURN nullptr!
+    KeyValuePair<KEY, VALUE>* end();
+    /// C++ conform end, MAY RETURN nullptr!
+    const KeyValuePair<KEY, VALUE>* end() const;
+
+private:
+    /// compute hash of a key
+    template<class K> static uint32 hashOf(const K& key);
+    /// find index table slot of a key, or InvalidIndex
+    template<class K> int32 findSlot(const K& key, uint32 hash) const;
+
+    Array<KeyValuePair<KEY, VALUE>> elms;
+    _priv::hashIndex table;
+};
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER>
+HashMap<KEY, VALUE, HASHER>::HashMap() {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER>
+HashMap<KEY, VALUE, HASHER>::HashMap(const HashMap& rhs) :
+elms(rhs.elms),
+table(rhs.table) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER>
+HashMap<KEY, VALUE, HASHER>::HashMap(HashMap&& rhs) :
+elms(std::move(rhs.elms)),
+table(std::move(rhs.table)) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER>
+HashMap<KEY, VALUE, HASHER>::~HashMap() {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::operator=(const HashMap& rhs) {
+    if (&rhs != this) {
+        this->elms = rhs.elms;
+        this->table = rhs.table;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::operator=(HashMap&& rhs) {
+    if (&rhs != this) {
+        this->elms = std::move(rhs.elms);
+        this->table = std::move(rhs.table);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> int32
+HashMap<KEY, VALUE, HASHER>::Size() const {
+    return this->elms.Size();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> bool
+HashMap<KEY, VALUE, HASHER>::Empty() const {
+    return this->elms.Empty();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> int32
+HashMap<KEY, VALUE, HASHER>::Capacity() const {
+    return this->table.capacity();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> template<class K> uint32
+HashMap<KEY, VALUE, HASHER>::hashOf(const K& key) {
+    return uint32(HASHER()(key));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> template<class K> int32
+HashMap<KEY, VALUE, HASHER>::findSlot(const K& key, uint32 hash) const {
+    const Array<KeyValuePair<KEY, VALUE>>& e = this->elms;
+    return this->table.find(hash, [&e, &key](int32 i) { return e[i].key == key; });
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Reserve(int32 numElements) {
+    o_assert_dbg(numElements >= 0);
+    this->table.reserve(this->Size() + numElements);
+    this->elms.Reserve(numElements);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Rehash(int32 minCapacity) {
+    this->table.rehash(minCapacity);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Clear() {
+    this->table.clear();
+    this->elms.Clear();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> VALUE&
+HashMap<KEY, VALUE, HASHER>::operator[](const KEY& key) {
+    const int32 slotIndex = this->findSlot(key, hashOf(key));
+    o_assert(InvalidIndex != slotIndex);
+    return this->elms[this->table.indexAt(slotIndex)].value;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> const VALUE&
+HashMap<KEY, VALUE, HASHER>::operator[](const KEY& key) const {
+    const int32 slotIndex = this->findSlot(key, hashOf(key));
+    o_assert(InvalidIndex != slotIndex);
+    return this->elms[this->table.indexAt(slotIndex)].value;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> template<class K, class> VALUE&
+HashMap<KEY, VALUE, HASHER>::operator[](const K& key) {
+    const int32 slotIndex = this->findSlot(key, hashOf(key));
+    o_assert(InvalidIndex != slotIndex);
+    return this->elms[this->table.indexAt(slotIndex)].value;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> template<class K, class> const VALUE&
+HashMap<KEY, VALUE, HASHER>::operator[](const K& key) const {
+    const int32 slotIndex = this->findSlot(key, hashOf(key));
+    o_assert(InvalidIndex != slotIndex);
+    return this->elms[this->table.indexAt(slotIndex)].value;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> bool
+HashMap<KEY, VALUE, HASHER>::Contains(const KEY& key) const {
+    return InvalidIndex != this->findSlot(key, hashOf(key));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> template<class K, class> bool
+HashMap<KEY, VALUE, HASHER>::Contains(const K& key) const {
+    return InvalidIndex != this->findSlot(key, hashOf(key));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Add(const KeyValuePair<KEY, VALUE>& kvp) {
+    const uint32 hash = hashOf(kvp.key);
+    o_assert_dbg(InvalidIndex == this->findSlot(kvp.key, hash));
+    this->elms.Add(kvp);
+    this->table.insert(hash, this->elms.Size() - 1);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Add(KeyValuePair<KEY, VALUE>&& kvp) {
+    const uint32 hash = hashOf(kvp.key);
+    o_assert_dbg(InvalidIndex == this->findSlot(kvp.key, hash));
+    this->elms.Add(std::move(kvp));
+    this->table.insert(hash, this->elms.Size() - 1);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Add(const KEY& key, const VALUE& value) {
+    this->Add(KeyValuePair<KEY, VALUE>(key, value));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> bool
+HashMap<KEY, VALUE, HASHER>::AddUnique(const KeyValuePair<KEY, VALUE>& kvp) {
+    const uint32 hash = hashOf(kvp.key);
+    if (InvalidIndex != this->findSlot(kvp.key, hash)) {
+        return false;
+    }
+    this->elms.Add(kvp);
+    this->table.insert(hash, this->elms.Size() - 1);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> bool
+HashMap<KEY, VALUE, HASHER>::AddUnique(KeyValuePair<KEY, VALUE>&& kvp) {
+    const uint32 hash = hashOf(kvp.key);
+    if (InvalidIndex != this->findSlot(kvp.key, hash)) {
+        return false;
+    }
+    this->elms.Add(std::move(kvp));
+    this->table.insert(hash, this->elms.Size() - 1);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> bool
+HashMap<KEY, VALUE, HASHER>::AddUnique(const KEY& key, const VALUE& value) {
+    return this->AddUnique(KeyValuePair<KEY, VALUE>(key, value));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Erase(const KEY& key) {
+    const int32 slotIndex = this->findSlot(key, hashOf(key));
+    if (InvalidIndex != slotIndex) {
+        this->EraseIndex(this->table.indexAt(slotIndex));
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::EraseIndex(int32 index) {
+    o_assert_range_dbg(index, this->elms.Size());
+    this->table.remove(this->table.findIndexSlot(hashOf(this->elms[index].key), index));
+    const int32 lastIndex = this->elms.Size() - 1;
+    if (index != lastIndex) {
+        // the last element is swapped into the erased element's place
+        const int32 lastSlot = this->table.findIndexSlot(hashOf(this->elms[lastIndex].key), lastIndex);
+        this->table.setIndexAt(lastSlot, index);
+    }
+    this->elms.EraseSwapBack(index);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> VALUE*
+HashMap<KEY, VALUE, HASHER>::Find(const KEY& key) {
+    const int32 slotIndex = this->findSlot(key, hashOf(key));
+    if (InvalidIndex != slotIndex) {
+        return &this->elms[this->table.indexAt(slotIndex)].value;
+    }
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> const VALUE*
+HashMap<KEY, VALUE, HASHER>::Find(const KEY& key) const {
+    const int32 slotIndex = this->findSlot(key, hashOf(key));
+    if (InvalidIndex != slotIndex) {
+        return &this->elms[this->table.indexAt(slotIndex)].value;
+    }
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> template<class K, class> VALUE*
+HashMap<KEY, VALUE, HASHER>::Find(const K& key) {
+    const int32 slotIndex = this->findSlot(key, hashOf(key));
+    if (InvalidIndex != slotIndex) {
+        return &this->elms[this->table.indexAt(slotIndex)].value;
+    }
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> template<class K, class> const VALUE*
+HashMap<KEY, VALUE, HASHER>::Find(const K& key) const {
+    const int32 slotIndex = this->findSlot(key, hashOf(key));
+    if (InvalidIndex != slotIndex) {
+        return &this->elms[this->table.indexAt(slotIndex)].value;
+    }
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> template<class K, class> int32
+HashMap<KEY, VALUE, HASHER>::FindIndex(const K& key) const {
+    const int32 slotIndex = this->findSlot(key, hashOf(key));
+    if (InvalidIndex != slotIndex) {
+        return this->table.indexAt(slotIndex);
+    }
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> int32
+HashMap<KEY, VALUE, HASHER>::FindIndex(const KEY& key) const {
+    const int32 slotIndex = this->findSlot(key, hashOf(key));
+    if (InvalidIndex != slotIndex) {
+        return this->table.indexAt(slotIndex);
+    }
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> const KEY&
+HashMap<KEY, VALUE, HASHER>::KeyAtIndex(int32 index) const {
+    return this->elms[index].key;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> const VALUE&
+HashMap<KEY, VALUE, HASHER>::ValueAtIndex(int32 index) const {
+    return this->elms[index].value;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> VALUE&
+HashMap<KEY, VALUE, HASHER>::ValueAtIndex(int32 index) {
+    return this->elms[index].value;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> KeyValuePair<KEY, VALUE>*
+HashMap<KEY, VALUE, HASHER>::begin() {
+    return this->elms.begin();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> const KeyValuePair<KEY, VALUE>*
+HashMap<KEY, VALUE, HASHER>::begin() const {
+    return this->elms.begin();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> KeyValuePair<KEY, VALUE>*
+HashMap<KEY, VALUE, HASHER>::end() {
+    return this->elms.end();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> const KeyValuePair<KEY, VALUE>*
+HashMap<KEY, VALUE, HASHER>::end() const {
+    return this->elms.end();
+}
+
+} // namespace Oryol
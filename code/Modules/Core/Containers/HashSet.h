@@ -8,14 +8,25 @@
     Implements a hash set with a fixed number of buckets, each
     bucket is a binary-sorted set.
     
-    @see Array, ArrayMap, Map, Set
+    If NUMBUCKETS is 0 (the default), a dynamically resizing hash set
+    is used instead: the values are kept in a dense array, and an
+    open-addressing index table (see HashMap) maps hashes to array
+    indices. The index table grows to keep the load factor below 7/8,
+    so lookups stay O(1) no matter how many values are added. Use
+    Reserve() to presize the set, and Rehash() to shrink the index table
+    after many values have been erased. Erasing a value swaps in the
+    last value of the dense array, thus the iteration order is not stable.
+    
+    @see Array, ArrayMap, Map, Set, HashMap
 */
 #include "Core/Config.h"
 #include "Core/Containers/Set.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/hashIndex.h"
 
 namespace Oryol {
 
-template<class VALUETYPE, class HASHER, int32 NUMBUCKETS> class HashSet {
+template<class VALUETYPE, class HASHER, int32 NUMBUCKETS=0> class HashSet {
 public:
     /// default constructor
     HashSet();
@@ -182,4 +193,255 @@ HashSet<VALUETYPE, HASHER, NUMBUCKETS>::findBucket(const VALUETYPE& val) {
     return this->buckets[uint32(HASHER()(val)) % NUMBUCKETS];
 }
 
-} // namespace Oryol
\ No newline at end of file
+//------------------------------------------------------------------------------
+/**
+    @brief dynamically resizing HashSet variant (NUMBUCKETS == 0)
+*/
+template<class VALUETYPE, class HASHER> class HashSet<VALUETYPE, HASHER, 0> {
+public:
+    /// default constructor
+    HashSet();
+    /// copy constructor
+    HashSet(const HashSet& rhs);
+    /// move constructor
+    HashSet(HashSet&& rhs);
+    /// copy-assignment operator
+    void operator=(const HashSet& rhs);
+    /// move-assignment operator
+    void operator=(HashSet&& rhs);
+    
+    /// set allocation strategy of the value array
+    void SetAllocStrategy(int32 minGrow, int32 maxGrow=ORYOL_CONTAINER_DEFAULT_MAX_GROW);
+    /// get min grow value
+    int32 GetMinGrow() const;
+    /// get max grow value
+    int32 GetMaxGrow() const;
+    /// get number of elements in set
+    int32 Size() const;
+    /// return true if empty
+    bool Empty() const;
+    /// get number of slots in the index table
+    int32 Capacity() const;
+
+    /// increase capacity to hold at least numValues more values without rehashing
+    void Reserve(int32 numValues);
+    /// rebuild the index table with at least minCapacity slots (0 to shrink to fit)
+    void Rehash(int32 minCapacity=0);
+    /// clear the set (keeps capacity)
+    void Clear();
+    
+    /// test if an element exists
+    bool Contains(const VALUETYPE& val) const;
+    /// find element
+    const VALUETYPE* Find(const VALUETYPE& val) const;
+    /// add element (must not exist)
+    void Add(const VALUETYPE& val);
+    /// add element with move semantics (must not exist)
+    void Add(VALUETYPE&& val);
+    /// add element, return false if element already existed
+    bool AddUnique(const VALUETYPE& val);
+    /// erase element, does nothing if not contained
+    void Erase(const VALUETYPE& val);
+
+    /// C++ conform begin, MAY RETURN nullptr!
+    const VALUETYPE* begin() const;
+    /// C++ conform end, MAY RETURN nullptr!
+    const VALUETYPE* end() const;
+    
+private:
+    /// compute hash of a value
+    static uint32 hashOf(const VALUETYPE& val);
+    /// find index table slot of a value, or InvalidIndex
+    int32 findSlot(const VALUETYPE& val, uint32 hash) const;
+
+    Array<VALUETYPE> values;
+    _priv::hashIndex table;
+};
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER>
+HashSet<VALUETYPE, HASHER, 0>::HashSet() {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER>
+HashSet<VALUETYPE, HASHER, 0>::HashSet(const HashSet& rhs) :
+values(rhs.values),
+table(rhs.table) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER>
+HashSet<VALUETYPE, HASHER, 0>::HashSet(HashSet&& rhs) :
+values(std::move(rhs.values)),
+table(std::move(rhs.table)) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> void
+HashSet<VALUETYPE, HASHER, 0>::operator=(const HashSet& rhs) {
+    if (&rhs != this) {
+        this->values = rhs.values;
+        this->table = rhs.table;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> void
+HashSet<VALUETYPE, HASHER, 0>::operator=(HashSet&& rhs) {
+    if (&rhs != this) {
+        this->values = std::move(rhs.values);
+        this->table = std::move(rhs.table);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> void
+HashSet<VALUETYPE, HASHER, 0>::SetAllocStrategy(int32 minGrow, int32 maxGrow) {
+    this->values.SetAllocStrategy(minGrow, maxGrow);
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> int32
+HashSet<VALUETYPE, HASHER, 0>::GetMinGrow() const {
+    return this->values.GetMinGrow();
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> int32
+HashSet<VALUETYPE, HASHER, 0>::GetMaxGrow() const {
+    return this->values.GetMaxGrow();
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> int32
+HashSet<VALUETYPE, HASHER, 0>::Size() const {
+    return this->values.Size();
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> bool
+HashSet<VALUETYPE, HASHER, 0>::Empty() const {
+    return this->values.Empty();
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> int32
+HashSet<VALUETYPE, HASHER, 0>::Capacity() const {
+    return this->table.capacity();
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> uint32
+HashSet<VALUETYPE, HASHER, 0>::hashOf(const VALUETYPE& val) {
+    return uint32(HASHER()(val));
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> int32
+HashSet<VALUETYPE, HASHER, 0>::findSlot(const VALUETYPE& val, uint32 hash) const {
+    const Array<VALUETYPE>& v = this->values;
+    return this->table.find(hash, [&v, &val](int32 i) { return v[i] == val; });
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> void
+HashSet<VALUETYPE, HASHER, 0>::Reserve(int32 numValues) {
+    o_assert_dbg(numValues >= 0);
+    this->table.reserve(this->Size() + numValues);
+    this->values.Reserve(numValues);
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> void
+HashSet<VALUETYPE, HASHER, 0>::Rehash(int32 minCapacity) {
+    this->table.rehash(minCapacity);
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> void
+HashSet<VALUETYPE, HASHER, 0>::Clear() {
+    this->table.clear();
+    this->values.Clear();
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> bool
+HashSet<VALUETYPE, HASHER, 0>::Contains(const VALUETYPE& val) const {
+    return InvalidIndex != this->findSlot(val, hashOf(val));
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> const VALUETYPE*
+HashSet<VALUETYPE, HASHER, 0>::Find(const VALUETYPE& val) const {
+    const int32 slotIndex = this->findSlot(val, hashOf(val));
+    if (InvalidIndex != slotIndex) {
+        return &this->values[this->table.indexAt(slotIndex)];
+    }
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> void
+HashSet<VALUETYPE, HASHER, 0>::Add(const VALUETYPE& val) {
+    const uint32 hash = hashOf(val);
+    o_assert_dbg(InvalidIndex == this->findSlot(val, hash));
+    this->values.Add(val);
+    this->table.insert(hash, this->values.Size() - 1);
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> void
+HashSet<VALUETYPE, HASHER, 0>::Add(VALUETYPE&& val) {
+    const uint32 hash = hashOf(val);
+    o_assert_dbg(InvalidIndex == this->findSlot(val, hash));
+    this->values.Add(std::move(val));
+    this->table.insert(hash, this->values.Size() - 1);
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> bool
+HashSet<VALUETYPE, HASHER, 0>::AddUnique(const VALUETYPE& val) {
+    const uint32 hash = hashOf(val);
+    if (InvalidIndex != this->findSlot(val, hash)) {
+        return false;
+    }
+    this->values.Add(val);
+    this->table.insert(hash, this->values.Size() - 1);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> void
+HashSet<VALUETYPE, HASHER, 0>::Erase(const VALUETYPE& val) {
+    const uint32 hash = hashOf(val);
+    const int32 slotIndex = this->findSlot(val, hash);
+    if (InvalidIndex != slotIndex) {
+        const int32 index = this->table.indexAt(slotIndex);
+        this->table.remove(slotIndex);
+        const int32 lastIndex = this->values.Size() - 1;
+        if (index != lastIndex) {
+            // the last value is swapped into the erased value's place
+            const int32 lastSlot = this->table.findIndexSlot(hashOf(this->values[lastIndex]), lastIndex);
+            this->table.setIndexAt(lastSlot, index);
+        }
+        this->values.EraseSwapBack(index);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> const VALUETYPE*
+HashSet<VALUETYPE, HASHER, 0>::begin() const {
+    return this->values.begin();
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> const VALUETYPE*
+HashSet<VALUETYPE, HASHER, 0>::end() const {
+    return this->values.end();
+}
+
+} // namespace Oryol
@@ -0,0 +1,564 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::InlineArray
+    @ingroup Core
+    @brief dynamic array with inline storage for the first N elements
+
+    An Array with the same API and growth behaviour, but the first
+    NUMINLINE elements are stored inside the InlineArray object itself,
+    so small arrays don't cause heap allocations. When the array grows
+    beyond NUMINLINE elements, the content spills into a heap buffer,
+    Trim() moves it back into the inline storage if it fits again.
+
+    The capacity of an InlineArray is never below NUMINLINE. Copy and
+    move semantics match Array (a copy truncates the heap capacity to
+    the number of elements, a move keeps size and capacity), but moving
+    an InlineArray whose elements are stored inline must move the
+    elements one by one (or with a memcpy for trivially relocatable
+    types), so it is O(N), not O(1).
+
+    Unlike Array, an InlineArray can't allocate from a FrameArena or
+    use a custom buffer alignment.
+
+    @see Array
+*/
+#include "Core/Config.h"
+#include "Core/Containers/elementBuffer.h"
+#include <initializer_list>
+
+namespace Oryol {
+
+template<class TYPE, int32 NUMINLINE> class InlineArray {
+    static_assert(NUMINLINE > 0, "InlineArray: NUMINLINE must be > 0!");
+public:
+    /// default constructor
+    InlineArray();
+    /// copy constructor (truncates heap capacity to actual size)
+    InlineArray(const InlineArray& rhs);
+    /// move constructor (same capacity and size)
+    InlineArray(InlineArray&& rhs);
+    /// initialize from initializer list
+    InlineArray(std::initializer_list<TYPE> l);
+    /// destructor
+    ~InlineArray();
+
+    /// copy-assignment operator (truncates heap capacity to actual size)
+    void operator=(const InlineArray& rhs);
+    /// move-assignment operator (same capacity and size)
+    void operator=(InlineArray&& rhs);
+
+    /// set allocation strategy
+    void SetAllocStrategy(int32 minGrow_, int32 maxGrow_=ORYOL_CONTAINER_DEFAULT_MAX_GROW);
+    /// get min grow value
+    int32 GetMinGrow() const;
+    /// get max grow value
+    int32 GetMaxGrow() const;
+    /// get number of elements in array
+    int32 Size() const;
+    /// return true if empty
+    bool Empty() const;
+    /// get capacity of array
+    int32 Capacity() const;
+    /// get number of free slots at back of array
+    int32 Spare() const;
+    /// return true if the elements are in the inline storage
+    bool IsInline() const;
+
+    /// read/write access single element
+    TYPE& operator[](int32 index);
+    /// read-only access single element
+    const TYPE& operator[](int32 index) const;
+    /// read/write access to first element
+    TYPE& Front();
+    /// read-only access to first element
+    const TYPE& Front() const;
+    /// read/write access to last element
+    TYPE& Back();
+    /// read-only access to last element
+    const TYPE& Back() const;
+
+    /// increase capacity to hold at least numElements more elements
+    void Reserve(int32 numElements);
+    /// trim capacity to size, moves elements back into inline storage if they fit
+    void Trim();
+    /// clear the array (deletes elements, keeps capacity)
+    void Clear();
+
+    /// copy-add element to back of array
+    void Add(const TYPE& elm);
+    /// move-add element to back of array
+    void Add(TYPE&& elm);
+    /// copy-insert element at index, keep array order
+    void Insert(int32 index, const TYPE& elm);
+    /// move-insert element at index, keep array order
+    void Insert(int32 index, TYPE&& elm);
+    /// emplace new element at back of array
+    template<class... ARGS> void Emplace(ARGS&&... args);
+
+    /// erase element at index, keep element ordering
+    void Erase(int32 index);
+    /// erase element at index, swap-in front or back element (destroys element ordering)
+    void EraseSwap(int32 index);
+    /// erase element at index, always swap-in from back (destroys element ordering)
+    void EraseSwapBack(int32 index);
+    /// erase element at index, always swap-in from front (destroys element ordering)
+    void EraseSwapFront(int32 index);
+
+    /// find element index with slow linear search
+    int32 FindIndexLinear(const TYPE& elm, int32 startIndex=0, int32 endIndex=InvalidIndex) const;
+
+    /// C++ conform begin
+    TYPE* begin();
+    /// C++ conform begin
+    const TYPE* begin() const;
+    /// C++ conform end
+    TYPE* end();
+    /// C++ conform end
+    const TYPE* end() const;
+
+private:
+    /// get pointer to inline storage
+    TYPE* inlineBuffer();
+    /// point the element buffer to the empty inline storage
+    void resetToInline();
+    /// destroy elements and free heap buffer
+    void destroy();
+    /// copy from other array
+    void copy(const InlineArray& rhs);
+    /// move from other array
+    void move(InlineArray&& rhs);
+    /// move-construct elements to uninitialized memory and destroy the source elements
+    static void relocate(TYPE* from, TYPE* to, int32 num);
+    /// reallocate with new capacity
+    void adjustCapacity(int32 newCapacity);
+    /// grow to make room
+    void grow();
+
+    _priv::elementBuffer<TYPE> buffer;
+    int32 minGrow;
+    int32 maxGrow;
+    alignas(TYPE) uint8 inlineStorage[NUMINLINE * sizeof(TYPE)];
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE>
+InlineArray<TYPE, NUMINLINE>::InlineArray() :
+minGrow(ORYOL_CONTAINER_DEFAULT_MIN_GROW),
+maxGrow(ORYOL_CONTAINER_DEFAULT_MAX_GROW) {
+    this->resetToInline();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE>
+InlineArray<TYPE, NUMINLINE>::InlineArray(const InlineArray& rhs) {
+    this->resetToInline();
+    this->copy(rhs);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE>
+InlineArray<TYPE, NUMINLINE>::InlineArray(InlineArray&& rhs) {
+    this->resetToInline();
+    this->move(std::move(rhs));
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE>
+InlineArray<TYPE, NUMINLINE>::InlineArray(std::initializer_list<TYPE> l) :
+minGrow(ORYOL_CONTAINER_DEFAULT_MIN_GROW),
+maxGrow(ORYOL_CONTAINER_DEFAULT_MAX_GROW) {
+    this->resetToInline();
+    this->Reserve(int32(l.size()));
+    for (const auto& elm : l) {
+        this->Add(elm);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE>
+InlineArray<TYPE, NUMINLINE>::~InlineArray() {
+    this->destroy();
+    // the elementBuffer destructor must not free the inline storage
+    this->buffer.bufStart = nullptr;
+    this->buffer.bufEnd = nullptr;
+    this->buffer.elmStart = nullptr;
+    this->buffer.elmEnd = nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> void
+InlineArray<TYPE, NUMINLINE>::operator=(const InlineArray& rhs) {
+    if (&rhs != this) {
+        this->destroy();
+        this->copy(rhs);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> void
+InlineArray<TYPE, NUMINLINE>::operator=(InlineArray&& rhs) {
+    if (&rhs != this) {
+        this->destroy();
+        this->move(std::move(rhs));
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> TYPE*
+InlineArray<TYPE, NUMINLINE>::inlineBuffer() {
+    return (TYPE*) this->inlineStorage;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> void
+InlineArray<TYPE, NUMINLINE>::resetToInline() {
+    TYPE* ptr = this->inlineBuffer();
+    this->buffer.bufStart = ptr;
+    this->buffer.bufEnd = ptr + NUMINLINE;
+    this->buffer.elmStart = ptr;
+    this->buffer.elmEnd = ptr;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> void
+InlineArray<TYPE, NUMINLINE>::destroy() {
+    this->buffer.clear();
+    if (!this->IsInline()) {
+        this->buffer.freeRaw(this->buffer.bufStart);
+    }
+    this->resetToInline();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> void
+InlineArray<TYPE, NUMINLINE>::copy(const InlineArray& rhs) {
+    o_assert_dbg(this->IsInline() && this->Empty());
+    this->minGrow = rhs.minGrow;
+    this->maxGrow = rhs.maxGrow;
+    const int32 num = rhs.Size();
+    if (num > NUMINLINE) {
+        this->adjustCapacity(num);
+    }
+    _priv::elementBuffer<TYPE>::copyConstruct(rhs.buffer.elmStart, this->buffer.elmStart, num);
+    this->buffer.elmEnd = this->buffer.elmStart + num;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> void
+InlineArray<TYPE, NUMINLINE>::move(InlineArray&& rhs) {
+    o_assert_dbg(this->IsInline() && this->Empty());
+    this->minGrow = rhs.minGrow;
+    this->maxGrow = rhs.maxGrow;
+    if (rhs.IsInline()) {
+        // elements must be moved over one by one
+        const int32 num = rhs.Size();
+        relocate(rhs.buffer.elmStart, this->buffer.elmStart, num);
+        this->buffer.elmEnd = this->buffer.elmStart + num;
+    }
+    else {
+        // take over heap buffer
+        this->buffer.bufStart = rhs.buffer.bufStart;
+        this->buffer.bufEnd = rhs.buffer.bufEnd;
+        this->buffer.elmStart = rhs.buffer.elmStart;
+        this->buffer.elmEnd = rhs.buffer.elmEnd;
+    }
+    // NOTE: don't reset minGrow/maxGrow, rhs is empty, but still a valid object!
+    rhs.resetToInline();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> void
+InlineArray<TYPE, NUMINLINE>::relocate(TYPE* from, TYPE* to, int32 num) {
+    if (IsTriviallyRelocatable<TYPE>::value) {
+        if (num > 0) {
+            Memory::Copy(from, to, num * sizeof(TYPE));
+        }
+        return;
+    }
+    for (int32 i = 0; i < num; i++) {
+        new(to++) TYPE(std::move(*from));
+        from++->~TYPE();
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> void
+InlineArray<TYPE, NUMINLINE>::SetAllocStrategy(int32 minGrow_, int32 maxGrow_) {
+    this->minGrow = minGrow_;
+    this->maxGrow = maxGrow_;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> int32
+InlineArray<TYPE, NUMINLINE>::GetMinGrow() const {
+    return this->minGrow;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> int32
+InlineArray<TYPE, NUMINLINE>::GetMaxGrow() const {
+    return this->maxGrow;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> int32
+InlineArray<TYPE, NUMINLINE>::Size() const {
+    return this->buffer.size();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> bool
+InlineArray<TYPE, NUMINLINE>::Empty() const {
+    return this->buffer.elmStart == this->buffer.elmEnd;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> int32
+InlineArray<TYPE, NUMINLINE>::Capacity() const {
+    return this->buffer.capacity();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> int32
+InlineArray<TYPE, NUMINLINE>::Spare() const {
+    return this->buffer.backSpare();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> bool
+InlineArray<TYPE, NUMINLINE>::IsInline() const {
+    return this->buffer.bufStart == (const TYPE*) this->inlineStorage;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> TYPE&
+InlineArray<TYPE, NUMINLINE>::operator[](int32 index) {
+    return this->buffer[index];
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> const TYPE&
+InlineArray<TYPE, NUMINLINE>::operator[](int32 index) const {
+    return this->buffer[index];
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> TYPE&
+InlineArray<TYPE, NUMINLINE>::Front() {
+    o_assert_dbg(!this->Empty());
+    return this->buffer.front();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> const TYPE&
+InlineArray<TYPE, NUMINLINE>::Front() const {
+    o_assert_dbg(!this->Empty());
+    return this->buffer.front();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> TYPE&
+InlineArray<TYPE, NUMINLINE>::Back() {
+    o_assert_dbg(!this->Empty());
+    return this->buffer.back();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> const TYPE&
+InlineArray<TYPE, NUMINLINE>::Back() const {
+    o_assert_dbg(!this->Empty());
+    return this->buffer.back();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> void
+InlineArray<TYPE, NUMINLINE>::Reserve(int32 numElements) {
+    int32 newCapacity = this->buffer.size() + numElements;
+    if (newCapacity > this->buffer.capacity()) {
+        this->adjustCapacity(newCapacity);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> void
+InlineArray<TYPE, NUMINLINE>::Trim() {
+    const int32 curSize = this->buffer.size();
+    if (!this->IsInline() && (curSize < this->buffer.capacity())) {
+        this->adjustCapacity(curSize);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> void
+InlineArray<TYPE, NUMINLINE>::Clear() {
+    this->buffer.clear();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> void
+InlineArray<TYPE, NUMINLINE>::Add(const TYPE& elm) {
+    if (this->buffer.backSpare() == 0) {
+        this->grow();
+    }
+    this->buffer.pushBack(elm);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> void
+InlineArray<TYPE, NUMINLINE>::Add(TYPE&& elm) {
+    if (this->buffer.backSpare() == 0) {
+        this->grow();
+    }
+    this->buffer.pushBack(std::move(elm));
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> void
+InlineArray<TYPE, NUMINLINE>::Insert(int32 index, const TYPE& elm) {
+    if (this->buffer.spare() == 0) {
+        this->grow();
+    }
+    this->buffer.insert(index, elm);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> void
+InlineArray<TYPE, NUMINLINE>::Insert(int32 index, TYPE&& elm) {
+    if (this->buffer.spare() == 0) {
+        this->grow();
+    }
+    this->buffer.insert(index, std::move(elm));
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> template<class... ARGS> void
+InlineArray<TYPE, NUMINLINE>::Emplace(ARGS&&... args) {
+    if (this->buffer.backSpare() == 0) {
+        this->grow();
+    }
+    this->buffer.emplaceBack(std::forward<ARGS>(args)...);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> void
+InlineArray<TYPE, NUMINLINE>::Erase(int32 index) {
+    this->buffer.erase(index);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> void
+InlineArray<TYPE, NUMINLINE>::EraseSwap(int32 index) {
+    this->buffer.eraseSwap(index);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> void
+InlineArray<TYPE, NUMINLINE>::EraseSwapBack(int32 index) {
+    this->buffer.eraseSwapBack(index);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> void
+InlineArray<TYPE, NUMINLINE>::EraseSwapFront(int32 index) {
+    this->buffer.eraseSwapFront(index);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> int32
+InlineArray<TYPE, NUMINLINE>::FindIndexLinear(const TYPE& elm, int32 startIndex, int32 endIndex) const {
+    const int32 size = this->buffer.size();
+    if (size > 0) {
+        o_assert_dbg(startIndex < size);
+        if (InvalidIndex == endIndex) {
+            endIndex = size;
+        }
+        else {
+            o_assert_dbg(endIndex <= size);
+        }
+        o_assert_dbg(startIndex <= endIndex);
+        for (int32 i = startIndex; i < endIndex; i++) {
+            if (elm == this->buffer.elmStart[i]) {
+                return i;
+            }
+        }
+    }
+    // fallthrough: not found
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> TYPE*
+InlineArray<TYPE, NUMINLINE>::begin() {
+    return this->buffer.elmStart;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> const TYPE*
+InlineArray<TYPE, NUMINLINE>::begin() const {
+    return this->buffer.elmStart;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> TYPE*
+InlineArray<TYPE, NUMINLINE>::end() {
+    return this->buffer.elmEnd;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> const TYPE*
+InlineArray<TYPE, NUMINLINE>::end() const {
+    return this->buffer.elmEnd;
+}
+
+//------------------------------------------------------------------------------
+/**
+ The elementBuffer can't grow or shrink the inline storage itself (it would
+ try to free it), so transitions between the inline storage and the heap
+ are handled here, heap-to-heap resizing is left to elementBuffer::alloc().
+*/
+template<class TYPE, int32 NUMINLINE> void
+InlineArray<TYPE, NUMINLINE>::adjustCapacity(int32 newCapacity) {
+    const int32 curSize = this->buffer.size();
+    o_assert_dbg(newCapacity >= curSize);
+    if (this->IsInline()) {
+        if (newCapacity > NUMINLINE) {
+            // spill from inline storage to the heap
+            TYPE* newBuffer = (TYPE*) this->buffer.allocRaw(newCapacity * sizeof(TYPE));
+            relocate(this->buffer.elmStart, newBuffer, curSize);
+            this->buffer.bufStart = newBuffer;
+            this->buffer.bufEnd = newBuffer + newCapacity;
+            this->buffer.elmStart = newBuffer;
+            this->buffer.elmEnd = newBuffer + curSize;
+        }
+    }
+    else if (newCapacity <= NUMINLINE) {
+        // move back from the heap into the inline storage
+        TYPE* oldBuffer = this->buffer.bufStart;
+        TYPE* inlineBuf = this->inlineBuffer();
+        relocate(this->buffer.elmStart, inlineBuf, curSize);
+        this->buffer.freeRaw(oldBuffer);
+        this->resetToInline();
+        this->buffer.elmEnd = inlineBuf + curSize;
+    }
+    else {
+        this->buffer.alloc(newCapacity, 0);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int32 NUMINLINE> void
+InlineArray<TYPE, NUMINLINE>::grow() {
+    const int32 curCapacity = this->buffer.capacity();
+    int32 growBy = curCapacity >> 1;
+    if (growBy < this->minGrow) {
+        growBy = this->minGrow;
+    }
+    else if (growBy > this->maxGrow) {
+        growBy = this->maxGrow;
+    }
+    o_assert_dbg(growBy > 0);
+    this->adjustCapacity(curCapacity + growBy);
+}
+
+} // namespace Oryol
@@ -11,6 +11,7 @@
     @see Map
 */
 #include "Core/Config.h"
+#include "Core/Traits.h"
 
 namespace Oryol {
 
@@ -226,4 +227,19 @@ template<class KEY, class VALUE> inline bool operator<=(const KEY& key, const Ke
     return key <= kvp.key;
 };
 
+//------------------------------------------------------------------------------
+/// a KeyValuePair is trivially relocatable if its key and value are
+template<class KEY, class VALUE> struct IsTriviallyRelocatable<KeyValuePair<KEY, VALUE>> :
+    std::integral_constant<bool, IsTriviallyRelocatable<KEY>::value && IsTriviallyRelocatable<VALUE>::value> { };
+
+//------------------------------------------------------------------------------
+/// KeyValuePairs are sorted by key, so they can be radix-sorted if the key can
+template<class KEY, class VALUE> struct RadixSortKey<KeyValuePair<KEY, VALUE>> {
+    static const bool IsValid = RadixSortKey<KEY>::IsValid;
+    typedef typename RadixSortKey<KEY>::Type Type;
+    static Type Get(const KeyValuePair<KEY, VALUE>& kvp) {
+        return RadixSortKey<KEY>::Get(kvp.key);
+    };
+};
+
 } // namespace Oryol
\ No newline at end of file
@@ -0,0 +1,291 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::MPMCQueue
+    @ingroup Core
+    @brief bounded lock-free multi-producer/multi-consumer ring buffer
+
+    A fixed-capacity FIFO ring buffer which can be accessed from any
+    number of producer and consumer threads without locks (Dmitry
+    Vyukov's bounded MPMC queue). Each cell has a sequence number which
+    tells whether the cell is ready to be written or read in the current
+    lap around the ring, producers and consumers claim cells by advancing
+    the enqueue or dequeue position with a compare-and-swap.
+
+    TryEnqueue() and TryDequeue() never block, they return false if the
+    queue is full or empty. The batch versions claim a contiguous range
+    of ready cells with a single compare-and-swap, and return the number
+    of elements that have been moved.
+
+    The enqueue and dequeue positions live on separate cache lines. The
+    capacity is rounded up to the next power of 2 (minimum 2). The queue
+    is not copyable, and must not be destroyed while other threads are
+    accessing it.
+
+    @see SPSCQueue, Queue
+*/
+#include "Core/Config.h"
+#include "Core/Types.h"
+#include "Core/Assert.h"
+#include "Core/Memory/Memory.h"
+#include <atomic>
+#include <new>
+#include <utility>
+
+namespace Oryol {
+
+template<class TYPE> class MPMCQueue {
+public:
+    /// constructor, capacity is rounded up to the next power of 2
+    MPMCQueue(int32 capacity=1024);
+    /// destructor (destroys remaining elements)
+    ~MPMCQueue();
+
+    /// get capacity of queue
+    int32 Capacity() const;
+    /// get approximate number of elements in queue
+    int32 Size() const;
+    /// return true if empty (approximation, see Size())
+    bool Empty() const;
+
+    /// copy-enqueue an element, return false if queue is full
+    bool TryEnqueue(const TYPE& elm);
+    /// move-enqueue an element, return false if queue is full
+    bool TryEnqueue(TYPE&& elm);
+    /// copy-enqueue up to num elements, return number of enqueued elements
+    int32 TryEnqueueBatch(const TYPE* elms, int32 num);
+    /// dequeue an element, return false if queue is empty
+    bool TryDequeue(TYPE& outElm);
+    /// dequeue up to maxNum elements, return number of dequeued elements
+    int32 TryDequeueBatch(TYPE* outElms, int32 maxNum);
+
+private:
+    /// not copyable
+    MPMCQueue(const MPMCQueue& rhs) = delete;
+    /// not copyable
+    void operator=(const MPMCQueue& rhs) = delete;
+
+    /// a ring buffer cell
+    struct cell {
+        std::atomic<uint32> sequence;
+        alignas(TYPE) uint8 storage[sizeof(TYPE)];
+        TYPE* elm() {
+            return (TYPE*) this->storage;
+        };
+    };
+    /// claim up to maxNum cells for writing, return number of claimed cells
+    uint32 claimEnqueue(uint32 maxNum, uint32& outPos);
+    /// claim up to maxNum cells for reading, return number of claimed cells
+    uint32 claimDequeue(uint32 maxNum, uint32& outPos);
+
+    cell* cells;
+    uint32 mask;
+    uint8 pad0[ORYOL_CACHELINE_SIZE];
+    std::atomic<uint32> enqueuePos;
+    uint8 pad1[ORYOL_CACHELINE_SIZE];
+    std::atomic<uint32> dequeuePos;
+    uint8 pad2[ORYOL_CACHELINE_SIZE];
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+MPMCQueue<TYPE>::MPMCQueue(int32 capacity) :
+cells(nullptr),
+mask(0),
+enqueuePos(0),
+dequeuePos(0) {
+    o_assert((capacity > 0) && (capacity <= (1<<30)));
+    uint32 cap = 2;
+    while (cap < uint32(capacity)) {
+        cap <<= 1;
+    }
+    this->mask = cap - 1;
+    this->cells = (cell*) Memory::AllocAligned(cap * sizeof(cell), ORYOL_CACHELINE_SIZE, MemoryTag::Containers);
+    for (uint32 i = 0; i < cap; i++) {
+        new(&this->cells[i].sequence) std::atomic<uint32>(i);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+MPMCQueue<TYPE>::~MPMCQueue() {
+    const uint32 end = this->enqueuePos.load(std::memory_order_relaxed);
+    for (uint32 pos = this->dequeuePos.load(std::memory_order_relaxed); pos != end; pos++) {
+        this->cells[pos & this->mask].elm()->~TYPE();
+    }
+    Memory::FreeAligned(this->cells);
+    this->cells = nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int32
+MPMCQueue<TYPE>::Capacity() const {
+    return int32(this->mask + 1);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int32
+MPMCQueue<TYPE>::Size() const {
+    const uint32 d = this->dequeuePos.load(std::memory_order_acquire);
+    const uint32 e = this->enqueuePos.load(std::memory_order_acquire);
+    const int32 num = int32(e - d);
+    return num > 0 ? num : 0;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+MPMCQueue<TYPE>::Empty() const {
+    return 0 == this->Size();
+}
+
+//------------------------------------------------------------------------------
+/**
+ A cell at position pos is ready for writing if its sequence number
+ is pos. Ready cells can't be touched by consumers, and other producers
+ can only claim them by advancing enqueuePos, so checking a range of
+ cells first and then claiming them all with one CAS is safe.
+*/
+template<class TYPE> uint32
+MPMCQueue<TYPE>::claimEnqueue(uint32 maxNum, uint32& outPos) {
+    uint32 pos = this->enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        uint32 num = 0;
+        int32 diff = 0;
+        while (num < maxNum) {
+            const uint32 seq = this->cells[(pos + num) & this->mask].sequence.load(std::memory_order_acquire);
+            diff = int32(seq - (pos + num));
+            if (0 != diff) {
+                break;
+            }
+            num++;
+        }
+        if (num > 0) {
+            if (this->enqueuePos.compare_exchange_weak(pos, pos + num, std::memory_order_relaxed)) {
+                outPos = pos;
+                return num;
+            }
+            // pos has been updated by compare_exchange, try again
+        }
+        else if (diff < 0) {
+            // cell still contains an element from the previous lap: queue is full
+            return 0;
+        }
+        else {
+            // another producer claimed the cell, reload position
+            pos = this->enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+ A cell at position pos is ready for reading if its sequence number
+ is pos + 1.
+*/
+template<class TYPE> uint32
+MPMCQueue<TYPE>::claimDequeue(uint32 maxNum, uint32& outPos) {
+    uint32 pos = this->dequeuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        uint32 num = 0;
+        int32 diff = 0;
+        while (num < maxNum) {
+            const uint32 seq = this->cells[(pos + num) & this->mask].sequence.load(std::memory_order_acquire);
+            diff = int32(seq - (pos + num + 1));
+            if (0 != diff) {
+                break;
+            }
+            num++;
+        }
+        if (num > 0) {
+            if (this->dequeuePos.compare_exchange_weak(pos, pos + num, std::memory_order_relaxed)) {
+                outPos = pos;
+                return num;
+            }
+        }
+        else if (diff < 0) {
+            // cell hasn't been written yet: queue is empty
+            return 0;
+        }
+        else {
+            // another consumer claimed the cell, reload position
+            pos = this->dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+MPMCQueue<TYPE>::TryEnqueue(const TYPE& elm) {
+    uint32 pos = 0;
+    if (0 == this->claimEnqueue(1, pos)) {
+        return false;
+    }
+    cell& c = this->cells[pos & this->mask];
+    new(c.elm()) TYPE(elm);
+    c.sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+MPMCQueue<TYPE>::TryEnqueue(TYPE&& elm) {
+    uint32 pos = 0;
+    if (0 == this->claimEnqueue(1, pos)) {
+        return false;
+    }
+    cell& c = this->cells[pos & this->mask];
+    new(c.elm()) TYPE(std::move(elm));
+    c.sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int32
+MPMCQueue<TYPE>::TryEnqueueBatch(const TYPE* elms, int32 num) {
+    o_assert_dbg(elms && (num >= 0));
+    if (0 == num) {
+        return 0;
+    }
+    uint32 pos = 0;
+    const uint32 n = this->claimEnqueue(uint32(num), pos);
+    for (uint32 i = 0; i < n; i++) {
+        cell& c = this->cells[(pos + i) & this->mask];
+        new(c.elm()) TYPE(elms[i]);
+        c.sequence.store(pos + i + 1, std::memory_order_release);
+    }
+    return int32(n);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+MPMCQueue<TYPE>::TryDequeue(TYPE& outElm) {
+    uint32 pos = 0;
+    if (0 == this->claimDequeue(1, pos)) {
+        return false;
+    }
+    cell& c = this->cells[pos & this->mask];
+    outElm = std::move(*c.elm());
+    c.elm()->~TYPE();
+    c.sequence.store(pos + this->mask + 1, std::memory_order_release);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int32
+MPMCQueue<TYPE>::TryDequeueBatch(TYPE* outElms, int32 maxNum) {
+    o_assert_dbg(outElms && (maxNum >= 0));
+    if (0 == maxNum) {
+        return 0;
+    }
+    uint32 pos = 0;
+    const uint32 n = this->claimDequeue(uint32(maxNum), pos);
+    for (uint32 i = 0; i < n; i++) {
+        cell& c = this->cells[(pos + i) & this->mask];
+        outElms[i] = std::move(*c.elm());
+        c.elm()->~TYPE();
+        c.sequence.store(pos + i + this->mask + 1, std::memory_order_release);
+    }
+    return int32(n);
+}
+
+} // namespace Oryol
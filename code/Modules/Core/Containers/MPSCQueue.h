@@ -0,0 +1,177 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::MPSCQueue
+    @ingroup Core
+    @brief unbounded lock-free multi-producer/single-consumer queue
+
+    A FIFO queue which can be written from any number of threads, and
+    read from exactly one consumer thread (Dmitry Vyukov's node-based
+    MPSC queue). Enqueue() is wait-free (one atomic exchange), and
+    never fails since the queue grows as needed, the list nodes come
+    from a thread-safe pool allocator so that steady-state traffic
+    doesn't hit the heap. EnqueueBatch() links a whole array of
+    elements privately, and publishes them with a single exchange,
+    so the elements of a batch are never interleaved with elements
+    from other producers. TryDequeue() never blocks and returns false
+    if the queue is empty.
+
+    NOTE: between a producer's exchange and the linking of its node
+    the queue can look empty to TryDequeue() although Empty() returns
+    false (this is only a few instructions long). Elements enqueued by
+    one producer are always dequeued in order.
+
+    Empty() may only be called by the consumer. The queue is not copyable,
+    and must not be destroyed while other threads are accessing it.
+
+    @see MPMCQueue, SPSCQueue, Queue
+*/
+#include "Core/Config.h"
+#include "Core/Types.h"
+#include "Core/Assert.h"
+#include "Core/Memory/poolAllocator.h"
+#include <atomic>
+#include <new>
+#include <utility>
+
+namespace Oryol {
+
+template<class TYPE> class MPSCQueue {
+public:
+    /// constructor
+    MPSCQueue();
+    /// destructor (destroys remaining elements)
+    ~MPSCQueue();
+
+    /// copy-enqueue an element (any thread)
+    void Enqueue(const TYPE& elm);
+    /// move-enqueue an element (any thread)
+    void Enqueue(TYPE&& elm);
+    /// copy-enqueue an array of elements with a single atomic operation (any thread)
+    void EnqueueBatch(const TYPE* elms, int32 num);
+    /// dequeue an element (consumer thread only), return false if queue is empty
+    bool TryDequeue(TYPE& outElm);
+    /// return true if the queue is empty (consumer thread only)
+    bool Empty() const;
+
+private:
+    /// not copyable
+    MPSCQueue(const MPSCQueue& rhs) = delete;
+    /// not copyable
+    void operator=(const MPSCQueue& rhs) = delete;
+
+    /// a list node, the value is only valid in nodes after the tail
+    struct node {
+        std::atomic<node*> next;
+        alignas(TYPE) uint8 storage[sizeof(TYPE)];
+        node() : next(nullptr) { };
+        TYPE* elm() {
+            return (TYPE*) this->storage;
+        };
+    };
+    /// link a chain of new nodes at the head
+    void push(node* first, node* last);
+
+    _priv::poolAllocator<node> allocator;
+    node* tail;                     // consumer side, this is the dummy node
+    uint8 pad0[ORYOL_CACHELINE_SIZE];
+    std::atomic<node*> head;        // producer side
+    uint8 pad1[ORYOL_CACHELINE_SIZE];
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+MPSCQueue<TYPE>::MPSCQueue() :
+tail(nullptr),
+head(nullptr) {
+    this->tail = this->allocator.Create();
+    this->head.store(this->tail, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+MPSCQueue<TYPE>::~MPSCQueue() {
+    node* n = this->tail->next.load(std::memory_order_acquire);
+    this->allocator.Destroy(this->tail);
+    while (n) {
+        node* next = n->next.load(std::memory_order_acquire);
+        n->elm()->~TYPE();
+        this->allocator.Destroy(n);
+        n = next;
+    }
+    this->tail = nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+MPSCQueue<TYPE>::push(node* first, node* last) {
+    // seq_cst so that consumers which park when Empty() can use a Dekker-style handshake
+    node* prev = this->head.exchange(last, std::memory_order_seq_cst);
+    prev->next.store(first, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+MPSCQueue<TYPE>::Enqueue(const TYPE& elm) {
+    node* n = this->allocator.Create();
+    new(n->elm()) TYPE(elm);
+    this->push(n, n);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+MPSCQueue<TYPE>::Enqueue(TYPE&& elm) {
+    node* n = this->allocator.Create();
+    new(n->elm()) TYPE(std::move(elm));
+    this->push(n, n);
+}
+
+//------------------------------------------------------------------------------
+/**
+ The chain is linked with relaxed stores, these become visible to
+ the consumer through the release store in push().
+*/
+template<class TYPE> void
+MPSCQueue<TYPE>::EnqueueBatch(const TYPE* elms, int32 num) {
+    o_assert_dbg(elms || (0 == num));
+    if (num <= 0) {
+        return;
+    }
+    node* first = this->allocator.Create();
+    new(first->elm()) TYPE(elms[0]);
+    node* last = first;
+    for (int32 i = 1; i < num; i++) {
+        node* n = this->allocator.Create();
+        new(n->elm()) TYPE(elms[i]);
+        last->next.store(n, std::memory_order_relaxed);
+        last = n;
+    }
+    this->push(first, last);
+}
+
+//------------------------------------------------------------------------------
+/**
+ The node after the tail holds the value, after moving the value out
+ it becomes the new dummy node and the old dummy is freed.
+*/
+template<class TYPE> bool
+MPSCQueue<TYPE>::TryDequeue(TYPE& outElm) {
+    node* t = this->tail;
+    node* next = t->next.load(std::memory_order_acquire);
+    if (nullptr == next) {
+        return false;
+    }
+    outElm = std::move(*next->elm());
+    next->elm()->~TYPE();
+    this->tail = next;
+    this->allocator.Destroy(t);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+MPSCQueue<TYPE>::Empty() const {
+    return this->head.load(std::memory_order_seq_cst) == this->tail;
+}
+
+} // namespace Oryol
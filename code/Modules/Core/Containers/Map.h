@@ -15,6 +15,10 @@
     operation. For big value and/or complex value types, consider using
     an ArrayMap!
  
+    Contains(), FindIndex() and operator[] also accept keys of a different
+    type which is comparable with KEY (for instance a StringView to look
+    up String keys without creating a temporary String).
+
     Allows to add multiple elements with the same key, these will be lumped 
     together in the internal buffer and will have adjacent indices
       
@@ -33,13 +37,17 @@
     @see KeyValuePair, Set
 */
 #include <algorithm>
+#include <type_traits>
 #include "Core/Config.h"
 #include "Core/Containers/elementBuffer.h"
 #include "Core/Containers/KeyValuePair.h"
+#include "Core/Containers/Sort.h"
 
 namespace Oryol {
 
 template<class KEY, class VALUE> class Map {
+    /// enable lookup methods for key types which don't convert to KEY
+    template<class K> using enableIfOtherKey = typename std::enable_if<!std::is_convertible<const K&, KEY>::value>::type;
 public:
     /// default constructor
     Map();
@@ -72,6 +80,10 @@ public:
     VALUE& operator[](const KEY& key);
     /// read-only access single element
     const VALUE& operator[](const KEY& key) const;
+    /// read/write access single element with a comparable key of a different type
+    template<class K, class=enableIfOtherKey<K>> VALUE& operator[](const K& key);
+    /// read-only access single element with a comparable key of a different type
+    template<class K, class=enableIfOtherKey<K>> const VALUE& operator[](const K& key) const;
     
     /// increase capacity to hold at least numElements more elements
     void Reserve(int32 numElements);
@@ -82,6 +94,8 @@ public:
 
     /// test if an element exists
     bool Contains(const KEY& key) const;
+    /// test if an element exists with a comparable key of a different type
+    template<class K, class=enableIfOtherKey<K>> bool Contains(const K& key) const;
     /// add new element
     void Add(const KeyValuePair<KEY, VALUE>& kvp);
     /// add new element
@@ -111,6 +125,8 @@ public:
     int32 FindDuplicate(int32 startIndex) const;
     /// find an element, returns index, or InvalidIndex
     int32 FindIndex(const KEY& key) const;
+    /// find an element with a comparable key of a different type, returns index, or InvalidIndex
+    template<class K, class=enableIfOtherKey<K>> int32 FindIndex(const K& key) const;
     /// erase element at index
     void EraseIndex(int32 index);
     /// get key at index
@@ -140,6 +156,8 @@ private:
     void adjustCapacity(int32 newCapacity);
     /// grow to make room
     void grow();
+    /// find first element with key not less than a comparable key
+    template<class K> KeyValuePair<KEY, VALUE>* lowerBound(const K& key) const;
     
     _priv::elementBuffer<KeyValuePair<KEY,VALUE>> buffer;
     int32 minGrow;
@@ -258,6 +276,54 @@ Map<KEY, VALUE>::operator[](const KEY& key) const {
     return kvp->value;
 }
     
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE> template<class K> KeyValuePair<KEY, VALUE>*
+Map<KEY, VALUE>::lowerBound(const K& key) const {
+    return std::lower_bound(this->buffer.elmStart, this->buffer.elmEnd, key,
+        [](const KeyValuePair<KEY, VALUE>& kvp, const K& k) { return kvp.key < k; });
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE> template<class K, class> bool
+Map<KEY, VALUE>::Contains(const K& key) const {
+    o_assert_dbg(!this->inBulkMode);
+    auto kvp = this->lowerBound(key);
+    return (kvp != this->buffer.elmEnd) && (kvp->key == key);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE> template<class K, class> VALUE&
+Map<KEY, VALUE>::operator[](const K& key) {
+    o_assert_dbg(!this->inBulkMode);
+    o_assert_dbg(this->buffer.elmStart);
+    auto kvp = this->lowerBound(key);
+    o_assert((kvp != this->buffer.elmEnd) && (kvp->key == key));    // not found if this triggers
+    return kvp->value;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE> template<class K, class> const VALUE&
+Map<KEY, VALUE>::operator[](const K& key) const {
+    o_assert_dbg(!this->inBulkMode);
+    o_assert_dbg(this->buffer.elmStart);
+    auto kvp = this->lowerBound(key);
+    o_assert_dbg((kvp != this->buffer.elmEnd) && (kvp->key == key));    // not found if this triggers
+    return kvp->value;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE> template<class K, class> int32
+Map<KEY, VALUE>::FindIndex(const K& key) const {
+    o_assert(!this->inBulkMode);
+    auto ptr = this->lowerBound(key);
+    if ((ptr != this->buffer.elmEnd) && (ptr->key == key)) {
+        return int32(ptr - this->buffer.elmStart);
+    }
+    else {
+        return InvalidIndex;
+    }
+}
+
 //------------------------------------------------------------------------------
 template<class KEY, class VALUE> void
 Map<KEY, VALUE>::Reserve(int32 numElements) {
@@ -412,7 +478,7 @@ Map<KEY, VALUE>::AddBulk(KeyValuePair<KEY, VALUE>&& kvp) {
 //------------------------------------------------------------------------------
 template<class KEY, class VALUE> void
 Map<KEY, VALUE>::AddBulk(const KEY& key, const VALUE& value) {
-    this->Insert(KeyValuePair<KEY, VALUE>(key, value));
+    this->AddBulk(KeyValuePair<KEY, VALUE>(key, value));
 }
 
 //------------------------------------------------------------------------------
@@ -420,7 +486,7 @@ template<class KEY, class VALUE> void
 Map<KEY, VALUE>::EndBulk() {
     o_assert(this->inBulkMode);
     this->inBulkMode = false;
-    std::sort(this->buffer.elmStart, this->buffer.elmEnd);
+    Sort::Auto(this->buffer.elmStart, this->buffer.elmEnd);
 }
 
 //------------------------------------------------------------------------------
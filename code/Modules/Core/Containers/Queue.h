@@ -33,6 +33,10 @@ public:
     int32 GetMinGrow() const;
     /// get max-grow value
     int32 GetMaxGrow() const;
+    /// allocate from a FrameArena instead of the heap (queue must not have been allocated yet)
+    void SetArena(FrameArena* arena);
+    /// set buffer alignment, e.g. for SIMD data (queue must not have been allocated yet)
+    void SetAlignment(int32 alignment);
     /// get number of elements in array
     int32 Size() const;
     /// return true if empty
@@ -222,6 +226,18 @@ Queue<TYPE>::GetMaxGrow() const {
     return this->maxGrow;
 }
 
+//------------------------------------------------------------------------------
+template<class TYPE> void
+Queue<TYPE>::SetArena(FrameArena* arena) {
+    this->buffer.setArena(arena);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+Queue<TYPE>::SetAlignment(int32 alignment) {
+    this->buffer.setAlignment(alignment);
+}
+
 //------------------------------------------------------------------------------
 template<class TYPE> int32
 Queue<TYPE>::Size() const {
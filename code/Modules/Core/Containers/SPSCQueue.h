@@ -0,0 +1,232 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::SPSCQueue
+    @ingroup Core
+    @brief bounded wait-free single-producer/single-consumer ring buffer
+
+    A fixed-capacity FIFO ring buffer for handing elements from exactly
+    one producer thread to exactly one consumer thread without locks.
+    TryEnqueue() and TryDequeue() never block, they return false if the
+    queue is full or empty. The batch versions move as many elements
+    as possible with a single index update, and return the number of
+    elements that have been moved.
+
+    The producer and consumer indices live on separate cache lines, and
+    each side keeps a cached copy of the other side's index, so that
+    the shared indices are only touched when the cached copy says the
+    queue is full (or empty).
+
+    The capacity is rounded up to the next power of 2. The queue is
+    not copyable, and must not be destroyed while other threads are
+    accessing it.
+
+    @see MPMCQueue, Queue
+*/
+#include "Core/Config.h"
+#include "Core/Types.h"
+#include "Core/Assert.h"
+#include "Core/Memory/Memory.h"
+#include <atomic>
+#include <new>
+#include <utility>
+
+namespace Oryol {
+
+template<class TYPE> class SPSCQueue {
+public:
+    /// constructor, capacity is rounded up to the next power of 2
+    SPSCQueue(int32 capacity=1024);
+    /// destructor (destroys remaining elements)
+    ~SPSCQueue();
+
+    /// get capacity of queue
+    int32 Capacity() const;
+    /// get number of elements in queue (only exact when called from producer or consumer side while the other side is idle)
+    int32 Size() const;
+    /// return true if empty (approximation, see Size())
+    bool Empty() const;
+
+    /// copy-enqueue an element, return false if queue is full (producer thread only)
+    bool TryEnqueue(const TYPE& elm);
+    /// move-enqueue an element, return false if queue is full (producer thread only)
+    bool TryEnqueue(TYPE&& elm);
+    /// copy-enqueue up to num elements, return number of enqueued elements (producer thread only)
+    int32 TryEnqueueBatch(const TYPE* elms, int32 num);
+    /// dequeue an element, return false if queue is empty (consumer thread only)
+    bool TryDequeue(TYPE& outElm);
+    /// dequeue up to maxNum elements, return number of dequeued elements (consumer thread only)
+    int32 TryDequeueBatch(TYPE* outElms, int32 maxNum);
+
+private:
+    /// not copyable
+    SPSCQueue(const SPSCQueue& rhs) = delete;
+    /// not copyable
+    void operator=(const SPSCQueue& rhs) = delete;
+    /// get number of free slots as seen by the producer, refreshes cached head if needed
+    uint32 freeSlots(uint32 tail, uint32 minNum);
+    /// get number of valid elements as seen by the consumer, refreshes cached tail if needed
+    uint32 validSlots(uint32 head, uint32 minNum);
+
+    TYPE* elms;
+    uint32 mask;
+    uint8 pad0[ORYOL_CACHELINE_SIZE];
+    // producer side
+    std::atomic<uint32> tail;       // next slot to write
+    uint32 cachedHead;              // producer's copy of head
+    uint8 pad1[ORYOL_CACHELINE_SIZE];
+    // consumer side
+    std::atomic<uint32> head;       // next slot to read
+    uint32 cachedTail;              // consumer's copy of tail
+    uint8 pad2[ORYOL_CACHELINE_SIZE];
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+SPSCQueue<TYPE>::SPSCQueue(int32 capacity) :
+elms(nullptr),
+mask(0),
+tail(0),
+cachedHead(0),
+head(0),
+cachedTail(0) {
+    o_assert((capacity > 0) && (capacity <= (1<<30)));
+    uint32 cap = 1;
+    while (cap < uint32(capacity)) {
+        cap <<= 1;
+    }
+    this->mask = cap - 1;
+    this->elms = (TYPE*) Memory::AllocAligned(cap * sizeof(TYPE), ORYOL_CACHELINE_SIZE, MemoryTag::Containers);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+SPSCQueue<TYPE>::~SPSCQueue() {
+    const uint32 t = this->tail.load(std::memory_order_relaxed);
+    for (uint32 h = this->head.load(std::memory_order_relaxed); h != t; h++) {
+        this->elms[h & this->mask].~TYPE();
+    }
+    Memory::FreeAligned(this->elms);
+    this->elms = nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int32
+SPSCQueue<TYPE>::Capacity() const {
+    return int32(this->mask + 1);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int32
+SPSCQueue<TYPE>::Size() const {
+    const uint32 h = this->head.load(std::memory_order_acquire);
+    const uint32 t = this->tail.load(std::memory_order_acquire);
+    return int32(t - h);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+SPSCQueue<TYPE>::Empty() const {
+    return 0 == this->Size();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> uint32
+SPSCQueue<TYPE>::freeSlots(uint32 t, uint32 minNum) {
+    const uint32 cap = this->mask + 1;
+    uint32 num = cap - (t - this->cachedHead);
+    if (num < minNum) {
+        this->cachedHead = this->head.load(std::memory_order_acquire);
+        num = cap - (t - this->cachedHead);
+    }
+    return num;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> uint32
+SPSCQueue<TYPE>::validSlots(uint32 h, uint32 minNum) {
+    uint32 num = this->cachedTail - h;
+    if (num < minNum) {
+        this->cachedTail = this->tail.load(std::memory_order_acquire);
+        num = this->cachedTail - h;
+    }
+    return num;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+SPSCQueue<TYPE>::TryEnqueue(const TYPE& elm) {
+    const uint32 t = this->tail.load(std::memory_order_relaxed);
+    if (0 == this->freeSlots(t, 1)) {
+        return false;
+    }
+    new(&this->elms[t & this->mask]) TYPE(elm);
+    this->tail.store(t + 1, std::memory_order_release);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+SPSCQueue<TYPE>::TryEnqueue(TYPE&& elm) {
+    const uint32 t = this->tail.load(std::memory_order_relaxed);
+    if (0 == this->freeSlots(t, 1)) {
+        return false;
+    }
+    new(&this->elms[t & this->mask]) TYPE(std::move(elm));
+    this->tail.store(t + 1, std::memory_order_release);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int32
+SPSCQueue<TYPE>::TryEnqueueBatch(const TYPE* elms_, int32 num) {
+    o_assert_dbg(elms_ && (num >= 0));
+    const uint32 t = this->tail.load(std::memory_order_relaxed);
+    uint32 n = this->freeSlots(t, uint32(num));
+    if (n > uint32(num)) {
+        n = uint32(num);
+    }
+    for (uint32 i = 0; i < n; i++) {
+        new(&this->elms[(t + i) & this->mask]) TYPE(elms_[i]);
+    }
+    if (n > 0) {
+        this->tail.store(t + n, std::memory_order_release);
+    }
+    return int32(n);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+SPSCQueue<TYPE>::TryDequeue(TYPE& outElm) {
+    const uint32 h = this->head.load(std::memory_order_relaxed);
+    if (0 == this->validSlots(h, 1)) {
+        return false;
+    }
+    TYPE* ptr = &this->elms[h & this->mask];
+    outElm = std::move(*ptr);
+    ptr->~TYPE();
+    this->head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int32
+SPSCQueue<TYPE>::TryDequeueBatch(TYPE* outElms, int32 maxNum) {
+    o_assert_dbg(outElms && (maxNum >= 0));
+    const uint32 h = this->head.load(std::memory_order_relaxed);
+    uint32 n = this->validSlots(h, uint32(maxNum));
+    if (n > uint32(maxNum)) {
+        n = uint32(maxNum);
+    }
+    for (uint32 i = 0; i < n; i++) {
+        TYPE* ptr = &this->elms[(h + i) & this->mask];
+        outElms[i] = std::move(*ptr);
+        ptr->~TYPE();
+    }
+    if (n > 0) {
+        this->head.store(h + n, std::memory_order_release);
+    }
+    return int32(n);
+}
+
+} // namespace Oryol
@@ -7,11 +7,17 @@
 
     The Set class provides a dynamic array of binary-sorted values similar
     to the std::set class. 
+
+    Adding many elements with Add() is slow, since each Add() must
+    move the elements behind the insert position. Use the bulk
+    methods instead, these append the elements, and sort them once
+    in EndBulk() (with a radix sort if the value type allows it).
      
     @see Array, ArrayMap, Map
 */
 #include <algorithm>
 #include "Core/Containers/Array.h"
+#include "Core/Containers/Sort.h"
 
 namespace Oryol {
 
@@ -53,6 +59,15 @@ public:
     void Erase(const VALUE& val);
     /// get value at index
     const VALUE& ValueAtIndex(int32 index);
+
+    /// begin bulk-adding elements
+    void BeginBulk();
+    /// add element in bulk-mode (destroys sorting order)
+    void AddBulk(const VALUE& val);
+    /// add element in bulk-mode (destroys sorting order)
+    void AddBulk(VALUE&& val);
+    /// end bulk-mode (sorting happens here)
+    void EndBulk();
     
     /// C++ conform begin
     VALUE* begin();
@@ -65,33 +80,40 @@ public:
     
 private:
     Array<VALUE> valueArray;
+    bool inBulkMode;
 };
 
 //------------------------------------------------------------------------------
 template<class VALUE>
-Set<VALUE>::Set() {
+Set<VALUE>::Set() :
+inBulkMode(false) {
     // empty
 }
 
 //------------------------------------------------------------------------------
 template<class VALUE>
 Set<VALUE>::Set(const Set& rhs) :
-valueArray(rhs.values) {
+valueArray(rhs.valueArray),
+inBulkMode(false) {
+    o_assert_dbg(!rhs.inBulkMode);
     // empty
 }
 
 //------------------------------------------------------------------------------
 template<class VALUE>
 Set<VALUE>::Set(Set&& rhs) :
-valueArray(std::move(rhs.values)) {
-    // empty
+valueArray(std::move(rhs.valueArray)),
+inBulkMode(rhs.inBulkMode) {
+    rhs.inBulkMode = false;
 }
     
 //------------------------------------------------------------------------------
 template<class VALUE> void
 Set<VALUE>::operator=(const Set& rhs) {
+    o_assert_dbg(!rhs.inBulkMode);
     if (&rhs != this) {
         this->valueArray = rhs.valueArray;
+        this->inBulkMode = false;
     }
 }
 
@@ -100,6 +122,8 @@ template<class VALUE> void
 Set<VALUE>::operator=(Set&& rhs) {
     if (&rhs != this) {
         this->valueArray = std::move(rhs.valueArray);
+        this->inBulkMode = rhs.inBulkMode;
+        rhs.inBulkMode = false;
     }
 }
     
@@ -143,17 +167,20 @@ Set<VALUE>::Capacity() const {
 template<class VALUE> void
 Set<VALUE>::Clear() {
     this->valueArray.Clear();
+    this->inBulkMode = false;
 }
 
 //------------------------------------------------------------------------------
 template<class VALUE> bool
 Set<VALUE>::Contains(const VALUE& val) const {
+    o_assert_dbg(!this->inBulkMode);
     return std::binary_search(this->valueArray.begin(), this->valueArray.end(), val);
 }
 
 //------------------------------------------------------------------------------
 template<class VALUE> const VALUE*
 Set<VALUE>::Find(const VALUE& val) const {
+    o_assert_dbg(!this->inBulkMode);
     const VALUE* ptr = std::lower_bound(this->valueArray.begin(), this->valueArray.end(), val);
     if (ptr != this->valueArray.end() && val == *ptr) {
         return ptr;
@@ -166,6 +193,7 @@ Set<VALUE>::Find(const VALUE& val) const {
 //------------------------------------------------------------------------------
 template<class VALUE> void
 Set<VALUE>::Add(const VALUE& val) {
+    o_assert_dbg(!this->inBulkMode);
     const VALUE* begin = this->valueArray.begin();
     const VALUE* end = this->valueArray.end();
     const VALUE* ptr = std::lower_bound(begin, end, val);
@@ -181,6 +209,7 @@ Set<VALUE>::Add(const VALUE& val) {
 //------------------------------------------------------------------------------
 template<class VALUE> void
 Set<VALUE>::Erase(const VALUE& val) {
+    o_assert_dbg(!this->inBulkMode);
     const VALUE* begin = this->valueArray.begin();
     const VALUE* end = this->valueArray.end();
     const VALUE* ptr = std::lower_bound(begin, end, val);
@@ -195,6 +224,40 @@ template<class VALUE> const VALUE&
 Set<VALUE>::ValueAtIndex(int32 index) {
     return this->valueArray[index];
 };
+
+//------------------------------------------------------------------------------
+template<class VALUE> void
+Set<VALUE>::BeginBulk() {
+    o_assert(!this->inBulkMode);
+    this->inBulkMode = true;
+}
+
+//------------------------------------------------------------------------------
+template<class VALUE> void
+Set<VALUE>::AddBulk(const VALUE& val) {
+    o_assert_dbg(this->inBulkMode);
+    this->valueArray.Add(val);
+}
+
+//------------------------------------------------------------------------------
+template<class VALUE> void
+Set<VALUE>::AddBulk(VALUE&& val) {
+    o_assert_dbg(this->inBulkMode);
+    this->valueArray.Add(std::move(val));
+}
+
+//------------------------------------------------------------------------------
+template<class VALUE> void
+Set<VALUE>::EndBulk() {
+    o_assert(this->inBulkMode);
+    this->inBulkMode = false;
+    Sort::Auto(this->valueArray.begin(), this->valueArray.end());
+    #if ORYOL_DEBUG
+    for (int32 i = 1; i < this->valueArray.Size(); i++) {
+        o_assert2_dbg(!(this->valueArray[i-1] == this->valueArray[i]), "Duplicate element added in bulk-mode!\n");
+    }
+    #endif
+}
     
 //------------------------------------------------------------------------------
 template<class VALUE> VALUE*
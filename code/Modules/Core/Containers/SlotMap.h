@@ -0,0 +1,431 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::SlotMap
+    @ingroup Core
+    @brief dense value container addressed by generation-checked handles
+
+    A SlotMap stores values in a dense array and hands out SlotHandles
+    to address them. Add, Erase and lookup by handle are O(1), and the
+    live values can be iterated contiguously with begin()/end(), which
+    makes it a good fit for resource and entity tables which are
+    updated every frame.
+
+    A handle consists of a 32-bit slot index and a 32-bit generation
+    counter. Each slot in the sparse slot table remembers its current
+    generation (odd while the slot is in use, even while it is free),
+    so a handle to an erased value is detected as stale, even if the
+    slot has been reused for a new value in the meantime.
+
+    Erasing a value swaps in the last value of the dense array, thus
+    the iteration order is not stable, and pointers to values
+    are invalidated by Add and Erase (handles are not).
+
+    @see SlotHandle, Array
+*/
+#include "Core/Config.h"
+#include "Core/Containers/Array.h"
+
+namespace Oryol {
+
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::SlotHandle
+    @ingroup Core
+    @brief generation-checked handle to a value in a SlotMap
+*/
+class SlotHandle {
+public:
+    /// invalid slot index constant
+    static const uint32 InvalidSlotIndex = 0xFFFFFFFF;
+    /// default constructor, constructs invalid handle
+    SlotHandle() : index(InvalidSlotIndex), generation(0) { };
+    /// construct from slot index and generation
+    SlotHandle(uint32 index_, uint32 generation_) : index(index_), generation(generation_) { };
+
+    /// equality operator
+    bool operator==(const SlotHandle& rhs) const {
+        return (this->index == rhs.index) && (this->generation == rhs.generation);
+    };
+    /// inequality operator
+    bool operator!=(const SlotHandle& rhs) const {
+        return !(*this == rhs);
+    };
+    /// less-than operator
+    bool operator<(const SlotHandle& rhs) const {
+        return (this->index < rhs.index) || ((this->index == rhs.index) && (this->generation < rhs.generation));
+    };
+    /// return true if this is not the invalid handle (it may still be stale)
+    bool IsValid() const {
+        return InvalidSlotIndex != this->index;
+    };
+    /// get the slot index
+    uint32 SlotIndex() const {
+        return this->index;
+    };
+    /// get the generation counter
+    uint32 Generation() const {
+        return this->generation;
+    };
+
+private:
+    uint32 index;
+    uint32 generation;
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE> class SlotMap {
+public:
+    /// default constructor
+    SlotMap();
+    /// copy constructor
+    SlotMap(const SlotMap& rhs);
+    /// move constructor
+    SlotMap(SlotMap&& rhs);
+
+    /// copy-assignment operator
+    void operator=(const SlotMap& rhs);
+    /// move-assignment operator
+    void operator=(SlotMap&& rhs);
+
+    /// get number of live values
+    int32 Size() const;
+    /// return true if empty
+    bool Empty() const;
+    /// get number of slots (live and free)
+    int32 NumSlots() const;
+    /// reserve room for numValues more values
+    void Reserve(int32 numValues);
+    /// erase all values, all existing handles become stale
+    void Clear();
+
+    /// copy-add a value, return its handle
+    SlotHandle Add(const TYPE& val);
+    /// move-add a value, return its handle
+    SlotHandle Add(TYPE&& val);
+    /// construct a new value in place, return its handle
+    template<class... ARGS> SlotHandle Emplace(ARGS&&... args);
+    /// erase value by handle, does nothing if the handle is stale
+    void Erase(const SlotHandle& handle);
+    /// erase value at dense index
+    void EraseIndex(int32 index);
+
+    /// test if a handle refers to a live value
+    bool Contains(const SlotHandle& handle) const;
+    /// find value by handle, return nullptr if the handle is stale
+    TYPE* Find(const SlotHandle& handle);
+    /// find value by handle, return nullptr if the handle is stale
+    const TYPE* Find(const SlotHandle& handle) const;
+    /// read/write access to live value
+    TYPE& operator[](const SlotHandle& handle);
+    /// read-only access to live value
+    const TYPE& operator[](const SlotHandle& handle) const;
+    /// get dense index of a value, or InvalidIndex if the handle is stale
+    int32 FindIndex(const SlotHandle& handle) const;
+    /// get handle of value at dense index
+    SlotHandle HandleAtIndex(int32 index) const;
+    /// get value at dense index (read/write)
+    TYPE& ValueAtIndex(int32 index);
+    /// get value at dense index (read-only)
+    const TYPE& ValueAtIndex(int32 index) const;
+
+    /// C++ conform begin, MAY RETURN nullptr!
+    TYPE* begin();
+    /// C++ conform begin, MAY RETURN nullptr!
+    const TYPE* begin() const;
+    /// C++ conform end, MAY RETURN nullptr!
+    TYPE* end();
+    /// C++ conform end, MAY RETURN nullptr!
+    const TYPE* end() const;
+
+private:
+    /// an entry in the sparse slot table
+    struct slot {
+        uint32 generation;  // odd: slot is in use, even: slot is free
+        int32 index;        // dense index if in use, next free slot if free
+    };
+    /// allocate a slot for a new value at the end of the dense array
+    SlotHandle allocSlot();
+    /// test if a slot is in use
+    static bool isLive(const slot& s);
+
+    Array<TYPE> values;
+    Array<uint32> valueSlots;   // slot index of each dense value
+    Array<slot> slots;
+    int32 freeHead;             // first free slot, or InvalidIndex
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+SlotMap<TYPE>::SlotMap() :
+freeHead(InvalidIndex) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+SlotMap<TYPE>::SlotMap(const SlotMap& rhs) :
+values(rhs.values),
+valueSlots(rhs.valueSlots),
+slots(rhs.slots),
+freeHead(rhs.freeHead) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+SlotMap<TYPE>::SlotMap(SlotMap&& rhs) :
+values(std::move(rhs.values)),
+valueSlots(std::move(rhs.valueSlots)),
+slots(std::move(rhs.slots)),
+freeHead(rhs.freeHead) {
+    rhs.freeHead = InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+SlotMap<TYPE>::operator=(const SlotMap& rhs) {
+    if (&rhs != this) {
+        this->values = rhs.values;
+        this->valueSlots = rhs.valueSlots;
+        this->slots = rhs.slots;
+        this->freeHead = rhs.freeHead;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+SlotMap<TYPE>::operator=(SlotMap&& rhs) {
+    if (&rhs != this) {
+        this->values = std::move(rhs.values);
+        this->valueSlots = std::move(rhs.valueSlots);
+        this->slots = std::move(rhs.slots);
+        this->freeHead = rhs.freeHead;
+        rhs.freeHead = InvalidIndex;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int32
+SlotMap<TYPE>::Size() const {
+    return this->values.Size();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+SlotMap<TYPE>::Empty() const {
+    return this->values.Empty();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int32
+SlotMap<TYPE>::NumSlots() const {
+    return this->slots.Size();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+SlotMap<TYPE>::Reserve(int32 numValues) {
+    this->values.Reserve(numValues);
+    this->valueSlots.Reserve(numValues);
+    const int32 numFreeSlots = this->slots.Size() - this->values.Size();
+    if (numValues > numFreeSlots) {
+        this->slots.Reserve(numValues - numFreeSlots);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+SlotMap<TYPE>::Clear() {
+    // bump the generation of all live slots and rebuild the free list
+    this->freeHead = InvalidIndex;
+    for (int32 i = this->slots.Size() - 1; i >= 0; i--) {
+        slot& s = this->slots[i];
+        if (isLive(s)) {
+            s.generation++;
+        }
+        s.index = this->freeHead;
+        this->freeHead = i;
+    }
+    this->values.Clear();
+    this->valueSlots.Clear();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+SlotMap<TYPE>::isLive(const slot& s) {
+    return 0 != (s.generation & 1);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> SlotHandle
+SlotMap<TYPE>::allocSlot() {
+    uint32 slotIndex;
+    if (InvalidIndex != this->freeHead) {
+        slotIndex = uint32(this->freeHead);
+        this->freeHead = this->slots[slotIndex].index;
+    }
+    else {
+        o_assert(this->slots.Size() < int32(SlotHandle::InvalidSlotIndex >> 1));
+        slotIndex = uint32(this->slots.Size());
+        slot newSlot = { 0, InvalidIndex };
+        this->slots.Add(newSlot);
+    }
+    slot& s = this->slots[slotIndex];
+    s.generation++;
+    s.index = this->values.Size();
+    this->valueSlots.Add(slotIndex);
+    return SlotHandle(slotIndex, s.generation);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> SlotHandle
+SlotMap<TYPE>::Add(const TYPE& val) {
+    const SlotHandle handle = this->allocSlot();
+    this->values.Add(val);
+    return handle;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> SlotHandle
+SlotMap<TYPE>::Add(TYPE&& val) {
+    const SlotHandle handle = this->allocSlot();
+    this->values.Add(std::move(val));
+    return handle;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> template<class... ARGS> SlotHandle
+SlotMap<TYPE>::Emplace(ARGS&&... args) {
+    const SlotHandle handle = this->allocSlot();
+    this->values.Emplace(std::forward<ARGS>(args)...);
+    return handle;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+SlotMap<TYPE>::Erase(const SlotHandle& handle) {
+    const int32 index = this->FindIndex(handle);
+    if (InvalidIndex != index) {
+        this->EraseIndex(index);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+SlotMap<TYPE>::EraseIndex(int32 index) {
+    o_assert_range_dbg(index, this->values.Size());
+    const uint32 slotIndex = this->valueSlots[index];
+    slot& s = this->slots[slotIndex];
+    o_assert_dbg(isLive(s) && (s.index == index));
+    s.generation++;
+    s.index = this->freeHead;
+    this->freeHead = int32(slotIndex);
+    const int32 lastIndex = this->values.Size() - 1;
+    if (index != lastIndex) {
+        // the last value is swapped into the erased value's place
+        this->slots[this->valueSlots[lastIndex]].index = index;
+    }
+    this->values.EraseSwapBack(index);
+    this->valueSlots.EraseSwapBack(index);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int32
+SlotMap<TYPE>::FindIndex(const SlotHandle& handle) const {
+    const uint32 slotIndex = handle.SlotIndex();
+    if (slotIndex < uint32(this->slots.Size())) {
+        const slot& s = this->slots[slotIndex];
+        if (s.generation == handle.Generation() && isLive(s)) {
+            return s.index;
+        }
+    }
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+SlotMap<TYPE>::Contains(const SlotHandle& handle) const {
+    return InvalidIndex != this->FindIndex(handle);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> TYPE*
+SlotMap<TYPE>::Find(const SlotHandle& handle) {
+    const int32 index = this->FindIndex(handle);
+    if (InvalidIndex != index) {
+        return &this->values[index];
+    }
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> const TYPE*
+SlotMap<TYPE>::Find(const SlotHandle& handle) const {
+    const int32 index = this->FindIndex(handle);
+    if (InvalidIndex != index) {
+        return &this->values[index];
+    }
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> TYPE&
+SlotMap<TYPE>::operator[](const SlotHandle& handle) {
+    const int32 index = this->FindIndex(handle);
+    o_assert(InvalidIndex != index);
+    return this->values[index];
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> const TYPE&
+SlotMap<TYPE>::operator[](const SlotHandle& handle) const {
+    const int32 index = this->FindIndex(handle);
+    o_assert(InvalidIndex != index);
+    return this->values[index];
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> SlotHandle
+SlotMap<TYPE>::HandleAtIndex(int32 index) const {
+    const uint32 slotIndex = this->valueSlots[index];
+    return SlotHandle(slotIndex, this->slots[slotIndex].generation);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> TYPE&
+SlotMap<TYPE>::ValueAtIndex(int32 index) {
+    return this->values[index];
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> const TYPE&
+SlotMap<TYPE>::ValueAtIndex(int32 index) const {
+    return this->values[index];
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> TYPE*
+SlotMap<TYPE>::begin() {
+    return this->values.begin();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> const TYPE*
+SlotMap<TYPE>::begin() const {
+    return this->values.begin();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> TYPE*
+SlotMap<TYPE>::end() {
+    return this->values.end();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> const TYPE*
+SlotMap<TYPE>::end() const {
+    return this->values.end();
+}
+
+} // namespace Oryol
@@ -0,0 +1,277 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::Sort
+    @ingroup Core
+    @brief sorting functions for big element ranges
+
+    Sort::Radix() is an LSD radix sort for element types which have
+    a RadixSortKey (integers, KeyValuePairs with integer keys, and
+    integer-like types which specialize RadixSortKey, see Core/Traits.h).
+    It sorts 8 bits per pass, and skips passes where all keys have the
+    same byte, so sorting keys which only use the lower bits is cheap.
+    The radix sort is stable.
+
+    Sort::ParallelMerge() splits the range into chunks, sorts the
+    chunks with std::sort, and merges them pairwise, this works for all
+    types with an operator<. The chunks are sorted and merged as jobs
+    on the JobSystem if it has been setup (no threads are created),
+    otherwise on the calling thread.
+
+    Sort::Auto() picks the best algorithm for the element type and
+    range size, this is used by the bulk-modes of Map, Set and ArrayMap.
+
+    @see Map, Set, ArrayMap
+*/
+#include <algorithm>
+#include <new>
+#include <utility>
+#include <type_traits>
+#include "Core/Config.h"
+#include "Core/Types.h"
+#include "Core/Traits.h"
+#include "Core/Assert.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Threading/JobSystem.h"
+
+namespace Oryol {
+
+class Sort {
+public:
+    /// minimum number of elements where Auto() uses the radix sort
+    static const int32 MinRadixSortSize = 256;
+    /// minimum number of elements where Auto() uses the parallel merge sort
+    static const int32 MinParallelSortSize = 1<<15;
+    /// max number of chunks used by ParallelMerge()
+    static const int32 MaxSortChunks = 16;
+
+    /// sort a range with the best algorithm for the element type and range size
+    template<class TYPE> static void Auto(TYPE* begin, TYPE* end);
+    /// LSD radix sort (element type must have a RadixSortKey)
+    template<class TYPE> static void Radix(TYPE* begin, TYPE* end);
+    /// parallel merge sort on the JobSystem, numChunks=0 picks the number of JobSystem threads
+    template<class TYPE> static void ParallelMerge(TYPE* begin, TYPE* end, int32 numChunks=0);
+
+private:
+    /// radix sort implementation
+    template<class TYPE> static void radixSort(TYPE* begin, TYPE* end);
+    /// radix-sort elements directly (for small trivially copyable types)
+    template<class TYPE> static void radixSortDirect(TYPE* begin, int32 num);
+    /// radix-sort a key/index array, and permute the elements (for all other types)
+    template<class TYPE> static void radixSortIndirect(TYPE* begin, int32 num);
+    /// compute byte histograms of all keys
+    template<class TYPE, class GETKEY> static void histogram(const TYPE* elms, int32 num, const GETKEY& getKey, uint32 (*counts)[256]);
+    /// turn a histogram into scatter offsets, return false if the pass can be skipped
+    static bool prefixSum(uint32* counts, int32 num);
+    /// call func(first, last) on ranges of [0, numChunks), on the JobSystem if it has been setup
+    template<class FUNC> static void forEachChunk(int32 numChunks, const FUNC& func);
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+Sort::Auto(TYPE* begin, TYPE* end) {
+    const int32 num = int32(end - begin);
+    if (RadixSortKey<TYPE>::IsValid && (num >= MinRadixSortSize)) {
+        radixSort(begin, end);
+    }
+    else if (num >= MinParallelSortSize) {
+        ParallelMerge(begin, end);
+    }
+    else {
+        std::sort(begin, end);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+Sort::Radix(TYPE* begin, TYPE* end) {
+    static_assert(RadixSortKey<TYPE>::IsValid, "Sort::Radix: type has no RadixSortKey!");
+    radixSort(begin, end);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+Sort::radixSort(TYPE* begin, TYPE* end) {
+    o_assert_dbg(begin <= end);
+    const int32 num = int32(end - begin);
+    if (num < 2) {
+        return;
+    }
+    if (std::is_trivially_copyable<TYPE>::value && (sizeof(TYPE) <= 16)) {
+        radixSortDirect(begin, num);
+    }
+    else {
+        radixSortIndirect(begin, num);
+    }
+}
+
+//------------------------------------------------------------------------------
+inline bool
+Sort::prefixSum(uint32* counts, int32 num) {
+    uint32 sum = 0;
+    for (int32 i = 0; i < 256; i++) {
+        if (counts[i] == uint32(num)) {
+            // all keys have the same byte, pass can be skipped
+            return false;
+        }
+        const uint32 c = counts[i];
+        counts[i] = sum;
+        sum += c;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class GETKEY> void
+Sort::histogram(const TYPE* elms, int32 num, const GETKEY& getKey, uint32 (*counts)[256]) {
+    typedef decltype(getKey(elms[0])) KEYTYPE;
+    const int32 numBytes = sizeof(KEYTYPE);
+    Memory::Clear(counts, numBytes * 256 * sizeof(uint32));
+    for (int32 i = 0; i < num; i++) {
+        KEYTYPE key = getKey(elms[i]);
+        for (int32 b = 0; b < numBytes; b++) {
+            counts[b][key & 0xFF]++;
+            key >>= 8;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+Sort::radixSortDirect(TYPE* begin, int32 num) {
+    typedef typename RadixSortKey<TYPE>::Type KEYTYPE;
+    const int32 numBytes = sizeof(KEYTYPE);
+    auto getKey = [](const TYPE& elm) -> KEYTYPE { return RadixSortKey<TYPE>::Get(elm); };
+    uint32 counts[numBytes][256];
+    histogram(begin, num, getKey, counts);
+
+    TYPE* tmp = (TYPE*) Memory::Alloc(num * sizeof(TYPE), MemoryTag::Containers);
+    TYPE* src = begin;
+    TYPE* dst = tmp;
+    for (int32 b = 0; b < numBytes; b++) {
+        if (!prefixSum(counts[b], num)) {
+            continue;
+        }
+        const int32 shift = b * 8;
+        for (int32 i = 0; i < num; i++) {
+            const uint32 bucket = uint32(getKey(src[i]) >> shift) & 0xFF;
+            Memory::Copy(&src[i], &dst[counts[b][bucket]++], sizeof(TYPE));
+        }
+        std::swap(src, dst);
+    }
+    if (src != begin) {
+        Memory::Copy(src, begin, num * sizeof(TYPE));
+    }
+    Memory::Free(tmp);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+Sort::radixSortIndirect(TYPE* begin, int32 num) {
+    typedef typename RadixSortKey<TYPE>::Type KEYTYPE;
+    struct entry {
+        KEYTYPE key;
+        uint32 index;
+    };
+    const int32 numBytes = sizeof(KEYTYPE);
+    auto getKey = [](const entry& e) -> KEYTYPE { return e.key; };
+
+    // build and radix-sort the key/index array
+    entry* entries = (entry*) Memory::Alloc(2 * num * sizeof(entry), MemoryTag::Containers);
+    for (int32 i = 0; i < num; i++) {
+        entries[i].key = RadixSortKey<TYPE>::Get(begin[i]);
+        entries[i].index = uint32(i);
+    }
+    uint32 counts[numBytes][256];
+    histogram(entries, num, getKey, counts);
+    entry* src = entries;
+    entry* dst = entries + num;
+    for (int32 b = 0; b < numBytes; b++) {
+        if (!prefixSum(counts[b], num)) {
+            continue;
+        }
+        const int32 shift = b * 8;
+        for (int32 i = 0; i < num; i++) {
+            const uint32 bucket = uint32(src[i].key >> shift) & 0xFF;
+            dst[counts[b][bucket]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+
+    // move the elements into sorted order
+    TYPE* tmp = (TYPE*) Memory::Alloc(num * sizeof(TYPE), MemoryTag::Containers);
+    if (IsTriviallyRelocatable<TYPE>::value) {
+        for (int32 i = 0; i < num; i++) {
+            Memory::Copy(&begin[src[i].index], &tmp[i], sizeof(TYPE));
+        }
+        Memory::Copy(tmp, begin, num * sizeof(TYPE));
+    }
+    else {
+        for (int32 i = 0; i < num; i++) {
+            new(&tmp[i]) TYPE(std::move(begin[src[i].index]));
+        }
+        for (int32 i = 0; i < num; i++) {
+            begin[i] = std::move(tmp[i]);
+            tmp[i].~TYPE();
+        }
+    }
+    Memory::Free(tmp);
+    Memory::Free(entries);
+}
+
+//------------------------------------------------------------------------------
+template<class FUNC> void
+Sort::forEachChunk(int32 numChunks, const FUNC& func) {
+    if (JobSystem::IsValid()) {
+        JobSystem::ParallelFor(0, numChunks, 1, func);
+    }
+    else {
+        func(0, numChunks);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+Sort::ParallelMerge(TYPE* begin, TYPE* end, int32 numChunks) {
+    o_assert_dbg(begin <= end);
+    const int32 num = int32(end - begin);
+    if (0 == numChunks) {
+        numChunks = JobSystem::IsValid() ? JobSystem::NumThreads() : 1;
+    }
+    // don't bother with tiny chunks
+    const int32 maxChunks = num / (MinParallelSortSize / 4);
+    if (numChunks > maxChunks) {
+        numChunks = maxChunks;
+    }
+    if (numChunks > MaxSortChunks) {
+        numChunks = MaxSortChunks;
+    }
+    if (numChunks <= 1) {
+        std::sort(begin, end);
+        return;
+    }
+
+    // sort the chunks in parallel
+    TYPE* bounds[MaxSortChunks + 1];
+    for (int32 i = 0; i <= numChunks; i++) {
+        bounds[i] = begin + int32((int64(num) * i) / numChunks);
+    }
+    forEachChunk(numChunks, [&bounds](int32 first, int32 last) {
+        for (int32 i = first; i < last; i++) {
+            std::sort(bounds[i], bounds[i + 1]);
+        }
+    });
+
+    // merge adjacent chunks pairwise, doubling the chunk width per round
+    for (int32 width = 1; width < numChunks; width *= 2) {
+        const int32 numMerges = (numChunks - width + 2 * width - 1) / (2 * width);
+        forEachChunk(numMerges, [&bounds, width, numChunks](int32 first, int32 last) {
+            for (int32 m = first; m < last; m++) {
+                const int32 i = m * 2 * width;
+                std::inplace_merge(bounds[i], bounds[i + width], bounds[std::min(i + 2 * width, numChunks)]);
+            }
+        });
+    }
+}
+
+} // namespace Oryol
@@ -18,12 +18,32 @@
     
     '----' - empty memory slot (guaranteed to be destructed)
     'XXXX' - valid element (guaranteed to be constructed)
+    
+    By default, memory is allocated through Memory::Alloc(), optionally
+    a FrameArena can be set as allocation source. The arena belongs
+    to the elementBuffer object, not its content: a copy-constructed 
+    elementBuffer will allocate from the heap, copy-assignment keeps
+    the current allocation source, and a move will take over the
+    allocation source of the moved-from object.
+    
+    An optional buffer alignment bigger than ORYOL_MAX_PLATFORM_ALIGN
+    can be set (e.g. for SIMD loads or cache-line aligned data). The
+    alignment is a property of the content, so copies keep the 
+    alignment of the source buffer.
+    
+    Elements of trivially relocatable types (see Core/Traits.h) are
+    moved around with Memory::Move() when growing the buffer and
+    when making room for insertions or closing gaps after erase,
+    other types are moved one by one with their move-assignment and
+    move-constructor.
 */
 #include <new>
 #include <utility>
 #include "Core/Types.h"
 #include "Core/Assert.h"
+#include "Core/Traits.h"
 #include "Core/Memory/Memory.h"
+#include "Core/Memory/FrameArena.h"
 
 //------------------------------------------------------------------------------
 namespace Oryol {
@@ -55,6 +75,10 @@ public:
     int32 size() const;
     /// get overall capacity
     int32 capacity() const;
+    /// set optional frame arena as allocation source (buffer must be empty)
+    void setArena(FrameArena* arena);
+    /// set optional buffer alignment, 0 for default (buffer must be empty)
+    void setAlignment(int32 alignment);
     
     /// access element by index
     TYPE& operator[](int32 index);
@@ -78,6 +102,10 @@ public:
     /// clear content
     void clear();
     
+    /// allocate raw memory from arena or heap
+    void* allocRaw(int32 numBytes) const;
+    /// free raw memory to arena or heap
+    void freeRaw(void* ptr) const;
     /// test if to pointer is within [from, from+num]
     static bool overlaps(const TYPE* from, const TYPE* to, int32 num);
     /// copy-construct element range
@@ -132,6 +160,8 @@ public:
     TYPE* bufEnd;       // end of allocated buffer
     TYPE* elmStart;     // start of valid elements
     TYPE* elmEnd;       // end of valid elements (one-past-last)
+    FrameArena* arena;  // optional allocation source, nullptr for heap
+    int32 alignment;    // optional buffer alignment, 0 for default alignment
 };
 
 //------------------------------------------------------------------------------
@@ -140,7 +170,9 @@ elementBuffer<TYPE>::elementBuffer() :
     bufStart(nullptr),
     bufEnd(nullptr),
     elmStart(nullptr),
-    elmEnd(nullptr)
+    elmEnd(nullptr),
+    arena(nullptr),
+    alignment(0)
 {
     // empty
 }
@@ -151,7 +183,9 @@ elementBuffer<TYPE>::elementBuffer(const elementBuffer& rhs) :
     bufStart(nullptr),
     bufEnd(nullptr),
     elmStart(nullptr),
-    elmEnd(nullptr)
+    elmEnd(nullptr),
+    arena(nullptr),
+    alignment(rhs.alignment)
 {
     this->alloc(rhs.size(), 0);
     copyConstruct(rhs.elmStart, this->elmStart, rhs.size());
@@ -164,7 +198,9 @@ elementBuffer<TYPE>::elementBuffer(elementBuffer&& rhs) :
     bufStart(rhs.bufStart),
     bufEnd(rhs.bufEnd),
     elmStart(rhs.elmStart),
-    elmEnd(rhs.elmEnd)
+    elmEnd(rhs.elmEnd),
+    arena(rhs.arena),
+    alignment(rhs.alignment)
 {
     rhs.bufStart = nullptr;
     rhs.bufEnd = nullptr;
@@ -183,6 +219,7 @@ template<class TYPE> void
 elementBuffer<TYPE>::operator=(const elementBuffer<TYPE>& rhs) {
     if (&rhs != this) {
         this->destroy();
+        this->alignment = rhs.alignment;
         const int32 newSize = rhs.size();
         if (newSize > 0)
         {
@@ -201,6 +238,8 @@ elementBuffer<TYPE>::operator=(elementBuffer<TYPE>&& rhs) {
         this->bufEnd   = rhs.bufEnd;
         this->elmStart = rhs.elmStart;
         this->elmEnd   = rhs.elmEnd;
+        this->arena    = rhs.arena;
+        this->alignment = rhs.alignment;
         rhs.bufStart = 0;
         rhs.bufEnd   = 0;
         rhs.elmStart = 0;
@@ -238,6 +277,52 @@ elementBuffer<TYPE>::capacity() const {
     return int32(intptr(this->bufEnd - this->bufStart));
 }
 
+//------------------------------------------------------------------------------
+template<class TYPE> void
+elementBuffer<TYPE>::setArena(FrameArena* arena_) {
+    o_assert_dbg(nullptr == this->bufStart);
+    this->arena = arena_;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+elementBuffer<TYPE>::setAlignment(int32 alignment_) {
+    o_assert_dbg(nullptr == this->bufStart);
+    o_assert_dbg((alignment_ >= 0) && (0 == (alignment_ & (alignment_ - 1))));
+    this->alignment = alignment_ > ORYOL_MAX_PLATFORM_ALIGN ? alignment_ : 0;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void*
+elementBuffer<TYPE>::allocRaw(int32 numBytes) const {
+    if (nullptr != this->arena) {
+        if (0 != this->alignment) {
+            return this->arena->AllocAligned(numBytes, this->alignment);
+        }
+        return this->arena->Alloc(numBytes);
+    }
+    else if (0 != this->alignment) {
+        return Memory::AllocAligned(numBytes, this->alignment, MemoryTag::Containers);
+    }
+    else {
+        return Memory::Alloc(numBytes, MemoryTag::Containers);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+elementBuffer<TYPE>::freeRaw(void* ptr) const {
+    if (nullptr != this->arena) {
+        this->arena->Free(ptr);
+    }
+    else if (0 != this->alignment) {
+        Memory::FreeAligned(ptr);
+    }
+    else {
+        Memory::Free(ptr);
+    }
+}
+
 //------------------------------------------------------------------------------
 template<class TYPE> TYPE&
 elementBuffer<TYPE>::operator[](int32 index) {
@@ -292,11 +377,28 @@ elementBuffer<TYPE>::alloc(int32 newCapacity, int32 newFrontSpare) {
 
     // allocate new buffer
     const int32 newBufSize = newCapacity * sizeof(TYPE);
-    TYPE* newBuffer = (TYPE*) Memory::Alloc(newBufSize);
+    if (IsTriviallyRelocatable<TYPE>::value && (nullptr != this->bufStart) &&
+        (nullptr == this->arena) && (0 == this->alignment) &&
+        (newFrontSpare == this->frontSpare())) {
+
+        // fast path: elements stay at the same offset, so let realloc() move them
+        TYPE* newBuffer = (TYPE*) Memory::ReAlloc(this->bufStart, newBufSize);
+        this->bufStart = newBuffer;
+        this->bufEnd   = newBuffer + newCapacity;
+        this->elmStart = newBuffer + newFrontSpare;
+        this->elmEnd   = this->elmStart + curSize;
+        return;
+    }
+    TYPE* newBuffer = (TYPE*) this->allocRaw(newBufSize);
     TYPE* newElmStart = newBuffer + newFrontSpare;
     
     // need to move any elements?
-    if (curSize > 0) {
+    if (IsTriviallyRelocatable<TYPE>::value) {
+        if (curSize > 0) {
+            Memory::Copy(this->elmStart, newElmStart, curSize * sizeof(TYPE));
+        }
+    }
+    else if (curSize > 0) {
         // move-construct elements over to new buffer
         TYPE* src = this->elmStart;
         TYPE* dst = newElmStart;
@@ -309,7 +411,7 @@ elementBuffer<TYPE>::alloc(int32 newCapacity, int32 newFrontSpare) {
     
     // need to free old buffer?
     if (nullptr != this->bufStart) {
-        Memory::Free(this->bufStart);
+        this->freeRaw(this->bufStart);
     }
     
     // replace pointers
@@ -331,7 +433,7 @@ elementBuffer<TYPE>::destroy() {
     
     // free buffer
     if (nullptr != this->bufStart) {
-        Memory::Free(this->bufStart);
+        this->freeRaw(this->bufStart);
     }
     
     // clear all pointers
@@ -368,6 +470,12 @@ elementBuffer<TYPE>::overlaps(const TYPE* from, const TYPE* to, int32 num) {
 template<class TYPE> void
 elementBuffer<TYPE>::copyConstruct(const TYPE* from, TYPE* to, int32 num) {
     o_assert_dbg(!overlaps(from, to, num));
+    if (std::is_trivially_copyable<TYPE>::value) {
+        if (num > 0) {
+            Memory::Copy(from, to, num * sizeof(TYPE));
+        }
+        return;
+    }
     for (int i = 0; i < num; i++) {
         new(to++) TYPE(*from++);
     }
@@ -441,10 +549,16 @@ template<class TYPE> TYPE*
 elementBuffer<TYPE>::moveInsertFront(int32 index) {
     // free a slot for insertion by moving the elements
     // at and before it towards the front
-    // the freed slot will NOT be deconstructed!
+    // the freed slot will NOT be deconstructed, except for
+    // trivially relocatable types, where it is raw memory!
     o_assert_dbg(this->elmStart > this->bufStart);
     o_assert_dbg((index >= 0) && (index <= this->size()));
     
+    if (IsTriviallyRelocatable<TYPE>::value) {
+        Memory::Move(this->elmStart, this->elmStart - 1, index * sizeof(TYPE));
+        this->elmStart--;
+        return this->elmStart + index;
+    }
     new(this->elmStart - 1) TYPE(std::move(*this->elmStart));
     for (TYPE* ptr = this->elmStart; ptr < this->elmStart + index - 1; ptr++) {
         *ptr = std::move(*(ptr + 1));
@@ -458,10 +572,17 @@ template<class TYPE> TYPE*
 elementBuffer<TYPE>::moveInsertBack(int32 index) {
     // free a slot for insertion by moving the elements
     // after it towards the back
-    // the freed slot will NOT be deconstructed!
+    // the freed slot will NOT be deconstructed, except for
+    // trivially relocatable types, where it is raw memory!
     o_assert_dbg(this->elmEnd < this->bufEnd);
     o_assert_dbg((index >= 0) && (index < this->size()));
     
+    if (IsTriviallyRelocatable<TYPE>::value) {
+        TYPE* ptr = this->elmStart + index;
+        Memory::Move(ptr, ptr + 1, int32(this->elmEnd - ptr) * sizeof(TYPE));
+        this->elmEnd++;
+        return ptr;
+    }
     new(this->elmEnd) TYPE(std::move(*(this->elmEnd-1)));
     for (TYPE* ptr = this->elmEnd - 1; ptr > (this->elmStart+index); ptr--) {
         *ptr = std::move(*(ptr - 1));
@@ -475,6 +596,12 @@ template<class TYPE> void
 elementBuffer<TYPE>::moveEraseFront(int32 index) {
     // erase a slot by moving elements from the front
     o_assert_dbg((index >= 0) && (index < this->size()));
+    if (IsTriviallyRelocatable<TYPE>::value) {
+        (this->elmStart + index)->~TYPE();
+        Memory::Move(this->elmStart, this->elmStart + 1, index * sizeof(TYPE));
+        this->elmStart++;
+        return;
+    }
     for (TYPE* ptr = this->elmStart + index; ptr > this->elmStart; ptr--) {
         *ptr = std::move(*(ptr - 1));
     }
@@ -488,6 +615,13 @@ template<class TYPE> void
 elementBuffer<TYPE>::moveEraseBack(int32 index) {
     // erase a slot by moving elements from the back
     o_assert_dbg((index >= 0) && (index < this->size()));
+    if (IsTriviallyRelocatable<TYPE>::value) {
+        TYPE* ptr = this->elmStart + index;
+        ptr->~TYPE();
+        Memory::Move(ptr + 1, ptr, int32(this->elmEnd - (ptr + 1)) * sizeof(TYPE));
+        this->elmEnd--;
+        return;
+    }
     for (TYPE* ptr = this->elmStart + index; ptr < (this->elmEnd - 1); ptr++) {
         *ptr = std::move(*(ptr + 1));
     }
@@ -500,9 +634,10 @@ elementBuffer<TYPE>::moveEraseBack(int32 index) {
 template<class TYPE> TYPE*
 elementBuffer<TYPE>::prepareInsert(int32 index, bool& outSlotConstructed) {
 
-    // this method will return a pointer to an empty, destructed slot!
+    // this method will return a pointer to an empty slot, which is
+    // only constructed for non-relocatable types if outSlotConstructed is true
 
-    outSlotConstructed = true;
+    outSlotConstructed = !IsTriviallyRelocatable<TYPE>::value;
     const int32 size = this->size();
     if (index == size) {
         // special case insert at end of array
@@ -0,0 +1,372 @@
+#pragma once
+//------------------------------------------------------------------------------
+/*
+    @class Oryol::_priv::hashIndex
+    @ingroup _priv
+
+    Open-addressing index table which maps hash values to element
+    indices of a dense element array, used by HashMap and the
+    dynamically resizing HashSet. The table uses Robin Hood hashing
+    (the entry farther away from its home slot wins a slot), and
+    backward-shift deletion, so there are no tombstones, and lookups
+    of missing keys can stop early.
+
+    The table capacity is always 0 or a power of 2, and the table
+    grows to keep the load factor below 7/8. Each slot keeps the
+    unscrambled hash value, so the table can be rebuilt without
+    re-computing the element hashes.
+*/
+#include "Core/Types.h"
+#include "Core/Assert.h"
+#include "Core/Memory/Memory.h"
+
+namespace Oryol {
+namespace _priv {
+
+class hashIndex {
+public:
+    /// default constructor
+    hashIndex();
+    /// copy constructor
+    hashIndex(const hashIndex& rhs);
+    /// move constructor
+    hashIndex(hashIndex&& rhs);
+    /// destructor
+    ~hashIndex();
+
+    /// copy-assignment operator
+    void operator=(const hashIndex& rhs);
+    /// move-assignment operator
+    void operator=(hashIndex&& rhs);
+
+    /// get number of slots
+    int32 capacity() const;
+    /// get number of used slots
+    int32 size() const;
+    /// make sure that numElements fit into the table without growing
+    void reserve(int32 numElements);
+    /// rebuild the table with the smallest capacity >= minCapacity which fits the current size
+    void rehash(int32 minCapacity);
+    /// remove all entries, keep capacity
+    void clear();
+    /// destroy the table
+    void destroy();
+
+    /// find slot of a matching element, isMatch(int32 index) compares the element
+    template<class MATCH> int32 find(uint32 hash, const MATCH& isMatch) const;
+    /// find the slot which points to an element index
+    int32 findIndexSlot(uint32 hash, int32 index) const;
+    /// insert a new entry (grows the table if needed)
+    void insert(uint32 hash, int32 index);
+    /// remove the entry in a slot
+    void remove(int32 slotIndex);
+    /// get element index in a slot
+    int32 indexAt(int32 slotIndex) const;
+    /// set element index in a slot (when an element was moved in the element array)
+    void setIndexAt(int32 slotIndex, int32 index);
+
+private:
+    /// a table slot
+    struct slot {
+        uint32 hash;        // unscrambled hash value
+        int32 index;        // element index, InvalidIndex if empty
+    };
+    static const int32 MinCapacity = 16;
+
+    /// get home slot of a hash
+    int32 homeSlot(uint32 hash) const;
+    /// get probe distance of the entry in a slot
+    int32 probeDistance(int32 slotIndex) const;
+    /// insert an entry without growing
+    void insertNoGrow(uint32 hash, int32 index);
+    /// test if the table must grow to fit numElements
+    bool mustGrow(int32 numElements, int32 cap) const;
+    /// rebuild the table with a new capacity
+    void rebuild(int32 newCapacity);
+
+    slot* table;
+    int32 cap;          // always 0 or a power of 2
+    int32 shift;        // 32 - log2(cap)
+    int32 num;
+};
+
+//------------------------------------------------------------------------------
+inline
+hashIndex::hashIndex() :
+table(nullptr),
+cap(0),
+shift(32),
+num(0) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+inline
+hashIndex::hashIndex(const hashIndex& rhs) :
+table(nullptr),
+cap(0),
+shift(32),
+num(0) {
+    *this = rhs;
+}
+
+//------------------------------------------------------------------------------
+inline
+hashIndex::hashIndex(hashIndex&& rhs) :
+table(rhs.table),
+cap(rhs.cap),
+shift(rhs.shift),
+num(rhs.num) {
+    rhs.table = nullptr;
+    rhs.cap = 0;
+    rhs.shift = 32;
+    rhs.num = 0;
+}
+
+//------------------------------------------------------------------------------
+inline
+hashIndex::~hashIndex() {
+    this->destroy();
+}
+
+//------------------------------------------------------------------------------
+inline void
+hashIndex::operator=(const hashIndex& rhs) {
+    if (&rhs != this) {
+        this->destroy();
+        if (rhs.cap > 0) {
+            const int32 tableSize = rhs.cap * sizeof(slot);
+            this->table = (slot*) Memory::Alloc(tableSize, MemoryTag::Containers);
+            Memory::Copy(rhs.table, this->table, tableSize);
+        }
+        this->cap = rhs.cap;
+        this->shift = rhs.shift;
+        this->num = rhs.num;
+    }
+}
+
+//------------------------------------------------------------------------------
+inline void
+hashIndex::operator=(hashIndex&& rhs) {
+    if (&rhs != this) {
+        this->destroy();
+        this->table = rhs.table;
+        this->cap = rhs.cap;
+        this->shift = rhs.shift;
+        this->num = rhs.num;
+        rhs.table = nullptr;
+        rhs.cap = 0;
+        rhs.shift = 32;
+        rhs.num = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+inline void
+hashIndex::destroy() {
+    if (nullptr != this->table) {
+        Memory::Free(this->table);
+        this->table = nullptr;
+    }
+    this->cap = 0;
+    this->shift = 32;
+    this->num = 0;
+}
+
+//------------------------------------------------------------------------------
+inline int32
+hashIndex::capacity() const {
+    return this->cap;
+}
+
+//------------------------------------------------------------------------------
+inline int32
+hashIndex::size() const {
+    return this->num;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Uses Fibonacci hashing to scramble the hash value, so that the
+ upper bits of the user-provided hash end up in the slot index.
+*/
+inline int32
+hashIndex::homeSlot(uint32 hash) const {
+    return int32((hash * 0x9E3779B9) >> this->shift);
+}
+
+//------------------------------------------------------------------------------
+inline int32
+hashIndex::probeDistance(int32 slotIndex) const {
+    return (slotIndex - this->homeSlot(this->table[slotIndex].hash)) & (this->cap - 1);
+}
+
+//------------------------------------------------------------------------------
+inline bool
+hashIndex::mustGrow(int32 numElements, int32 c) const {
+    // keep load factor below 7/8
+    return (numElements * 8) > (c * 7);
+}
+
+//------------------------------------------------------------------------------
+inline void
+hashIndex::rebuild(int32 newCapacity) {
+    o_assert_dbg((newCapacity >= MinCapacity) && (0 == (newCapacity & (newCapacity - 1))));
+    o_assert_dbg(newCapacity > this->num);
+    slot* oldTable = this->table;
+    const int32 oldCapacity = this->cap;
+    this->table = (slot*) Memory::Alloc(newCapacity * sizeof(slot), MemoryTag::Containers);
+    for (int32 i = 0; i < newCapacity; i++) {
+        this->table[i].hash = 0;
+        this->table[i].index = InvalidIndex;
+    }
+    this->cap = newCapacity;
+    this->shift = 32;
+    for (int32 c = newCapacity; c > 1; c >>= 1) {
+        this->shift--;
+    }
+    for (int32 i = 0; i < oldCapacity; i++) {
+        if (InvalidIndex != oldTable[i].index) {
+            this->insertNoGrow(oldTable[i].hash, oldTable[i].index);
+        }
+    }
+    if (nullptr != oldTable) {
+        Memory::Free(oldTable);
+    }
+}
+
+//------------------------------------------------------------------------------
+inline void
+hashIndex::reserve(int32 numElements) {
+    int32 newCapacity = this->cap > 0 ? this->cap : MinCapacity;
+    while (this->mustGrow(numElements, newCapacity)) {
+        newCapacity *= 2;
+    }
+    if (newCapacity != this->cap) {
+        this->rebuild(newCapacity);
+    }
+}
+
+//------------------------------------------------------------------------------
+inline void
+hashIndex::rehash(int32 minCapacity) {
+    int32 newCapacity = MinCapacity;
+    while ((newCapacity < minCapacity) || this->mustGrow(this->num, newCapacity)) {
+        newCapacity *= 2;
+    }
+    this->rebuild(newCapacity);
+}
+
+//------------------------------------------------------------------------------
+inline void
+hashIndex::clear() {
+    for (int32 i = 0; i < this->cap; i++) {
+        this->table[i].index = InvalidIndex;
+    }
+    this->num = 0;
+}
+
+//------------------------------------------------------------------------------
+template<class MATCH> int32
+hashIndex::find(uint32 hash, const MATCH& isMatch) const {
+    if (0 == this->cap) {
+        return InvalidIndex;
+    }
+    const int32 mask = this->cap - 1;
+    int32 slotIndex = this->homeSlot(hash);
+    for (int32 dist = 0; ; dist++) {
+        const slot& s = this->table[slotIndex];
+        if (InvalidIndex == s.index) {
+            return InvalidIndex;
+        }
+        if (this->probeDistance(slotIndex) < dist) {
+            // a matching entry would have displaced this entry
+            return InvalidIndex;
+        }
+        if ((s.hash == hash) && isMatch(s.index)) {
+            return slotIndex;
+        }
+        slotIndex = (slotIndex + 1) & mask;
+    }
+}
+
+//------------------------------------------------------------------------------
+inline int32
+hashIndex::findIndexSlot(uint32 hash, int32 index) const {
+    o_assert_dbg(this->cap > 0);
+    const int32 mask = this->cap - 1;
+    int32 slotIndex = this->homeSlot(hash);
+    while (this->table[slotIndex].index != index) {
+        slotIndex = (slotIndex + 1) & mask;
+    }
+    return slotIndex;
+}
+
+//------------------------------------------------------------------------------
+inline void
+hashIndex::insertNoGrow(uint32 hash, int32 index) {
+    const int32 mask = this->cap - 1;
+    slot entry = { hash, index };
+    int32 slotIndex = this->homeSlot(hash);
+    for (int32 dist = 0; ; dist++) {
+        slot& s = this->table[slotIndex];
+        if (InvalidIndex == s.index) {
+            s = entry;
+            return;
+        }
+        // Robin Hood: the entry farther away from its home slot wins
+        const int32 curDist = this->probeDistance(slotIndex);
+        if (curDist < dist) {
+            slot tmp = s;
+            s = entry;
+            entry = tmp;
+            dist = curDist;
+        }
+        slotIndex = (slotIndex + 1) & mask;
+    }
+}
+
+//------------------------------------------------------------------------------
+inline void
+hashIndex::insert(uint32 hash, int32 index) {
+    if (this->mustGrow(this->num + 1, this->cap)) {
+        this->rebuild(this->cap > 0 ? this->cap * 2 : MinCapacity);
+    }
+    this->insertNoGrow(hash, index);
+    this->num++;
+}
+
+//------------------------------------------------------------------------------
+inline void
+hashIndex::remove(int32 slotIndex) {
+    o_assert_range_dbg(slotIndex, this->cap);
+    o_assert_dbg(InvalidIndex != this->table[slotIndex].index);
+    // backward-shift deletion: move following entries one slot
+    // back until an empty slot or an entry in its home slot is found
+    const int32 mask = this->cap - 1;
+    int32 next = (slotIndex + 1) & mask;
+    while ((InvalidIndex != this->table[next].index) && (this->probeDistance(next) > 0)) {
+        this->table[slotIndex] = this->table[next];
+        slotIndex = next;
+        next = (next + 1) & mask;
+    }
+    this->table[slotIndex].index = InvalidIndex;
+    this->num--;
+}
+
+//------------------------------------------------------------------------------
+inline int32
+hashIndex::indexAt(int32 slotIndex) const {
+    o_assert_range_dbg(slotIndex, this->cap);
+    return this->table[slotIndex].index;
+}
+
+//------------------------------------------------------------------------------
+inline void
+hashIndex::setIndexAt(int32 slotIndex, int32 index) {
+    o_assert_range_dbg(slotIndex, this->cap);
+    this->table[slotIndex].index = index;
+}
+
+} // namespace _priv
+} // namespace Oryol
@@ -5,12 +5,15 @@
 #include "Core.h"
 #include "Core/RunLoop.h"
 #include "Core/Ptr.h"
+#include "Core/Memory/FrameArena.h"
+#include "Core/Memory/Memory.h"
 
 namespace Oryol {
     
 Core::_state* Core::state = nullptr;
 ORYOL_THREADLOCAL_PTR(RunLoop) Core::threadPreRunLoop = nullptr;
 ORYOL_THREADLOCAL_PTR(RunLoop) Core::threadPostRunLoop = nullptr;
+ORYOL_THREADLOCAL_PTR(FrameArena) Core::threadFrameArena = nullptr;
 
 //------------------------------------------------------------------------------
 void
@@ -18,29 +21,20 @@ Core::Setup() {
     o_assert(!IsValid());
     state = new _state();
     state->mainThreadId = std::this_thread::get_id();
-    
-    // setup the before-frame runloop
-    auto ptr = RunLoop::Create();
-    ptr->addRef();
-    threadPreRunLoop = ptr.get();
+    setupThreadLocals();
 
-    // setup the after-frame runloop
-    ptr = RunLoop::Create();
-    ptr->addRef();
-    threadPostRunLoop = ptr.get();
+    // the main thread's before-frame runloop also starts a new frame
+    // for the per-frame allocation statistics
+    threadPreRunLoop->Add("Core::MemoryStats", [] {
+        Memory::NewFrameStats();
+    });
 }
 
 //------------------------------------------------------------------------------
 void
 Core::Discard() {
     o_assert(IsValid());
-    o_assert(threadPreRunLoop);
-    o_assert(threadPostRunLoop);
-    
-    threadPreRunLoop->release();
-    threadPreRunLoop = nullptr;
-    threadPostRunLoop->release();
-    threadPostRunLoop = nullptr;
+    discardThreadLocals();
     delete state;
     state = nullptr;
 
@@ -68,6 +62,13 @@ Core::PostRunLoop() {
     return threadPostRunLoop;
 }
 
+//------------------------------------------------------------------------------
+FrameArena*
+Core::ThreadFrameArena() {
+    o_assert(threadFrameArena);
+    return threadFrameArena;
+}
+
 //------------------------------------------------------------------------------
 bool
 Core::isMainThread() {
@@ -83,33 +84,56 @@ Core::isMainThread() {
 void
 Core::EnterThread() {
     #if ORYOL_HAS_THREADS
+    setupThreadLocals();
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+Core::LeaveThread() {
+    #if ORYOL_HAS_THREADS
+    discardThreadLocals();
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+Core::setupThreadLocals() {
     o_assert(!threadPreRunLoop);
     o_assert(!threadPostRunLoop);
-    
-    // create thread-local run loops
+    o_assert(!threadFrameArena);
+
+    // setup the before-frame runloop
     auto ptr = RunLoop::Create();
     ptr->addRef();
     threadPreRunLoop = ptr.get();
+
+    // setup the after-frame runloop
     ptr = RunLoop::Create();
     ptr->addRef();
     threadPostRunLoop = ptr.get();
-    #endif
+
+    // setup the frame arena, this is reset at the start of each frame
+    // (this is the first callback in the before-frame runloop)
+    threadFrameArena = new FrameArena();
+    threadPreRunLoop->Add("Core::FrameArena", [] {
+        threadFrameArena->Reset();
+    });
 }
 
 //------------------------------------------------------------------------------
 void
-Core::LeaveThread() {
-    #if ORYOL_HAS_THREADS
+Core::discardThreadLocals() {
     o_assert(threadPreRunLoop);
     o_assert(threadPostRunLoop);
+    o_assert(threadFrameArena);
+
     threadPreRunLoop->release();
     threadPreRunLoop = nullptr;
     threadPostRunLoop->release();
     threadPostRunLoop = nullptr;
-
-    // do NOT destroy the thread-local string atom table to
-    // ensure that string atom data pointers still point to valid data
-    #endif
+    delete threadFrameArena;
+    threadFrameArena = nullptr;
 }
 
 } // namespace Oryol
\ No newline at end of file
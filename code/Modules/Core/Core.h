@@ -15,6 +15,7 @@
 namespace Oryol {
 
 class RunLoop;
+class FrameArena;
 
 class Core {
 public:
@@ -29,6 +30,8 @@ public:
     static class RunLoop* PreRunLoop();
     /// get pointer to the per-thread 'after-frame' runloop
     static class RunLoop* PostRunLoop();
+    /// get pointer to the per-thread frame arena (reset at start of frame)
+    static class FrameArena* ThreadFrameArena();
 
     /// called when a thread is entered
     static void EnterThread();
@@ -38,9 +41,14 @@ public:
 private:
     /// return true if main thread
     static bool isMainThread();
+    /// setup thread-local objects
+    static void setupThreadLocals();
+    /// discard thread-local objects
+    static void discardThreadLocals();
     
     static ORYOL_THREADLOCAL_PTR(RunLoop) threadPreRunLoop;
     static ORYOL_THREADLOCAL_PTR(RunLoop) threadPostRunLoop;
+    static ORYOL_THREADLOCAL_PTR(FrameArena) threadFrameArena;
     struct _state {
         std::thread::id mainThreadId;
     };
@@ -28,7 +28,9 @@ using namespace _priv;
 using namespace std;
 
 Log::Level curLogLevel = Log::Level::Dbg;
-RWLock lock;
+// NOTE: loggers may log from within their callbacks, which re-enters
+// the read lock, so this must not block readers behind waiting writers
+RWLock lock(RWLock::PreferReader);
 Array<Ptr<Logger>> loggers;
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,175 @@
+//------------------------------------------------------------------------------
+//  FrameArena.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "FrameArena.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Assert.h"
+
+namespace Oryol {
+
+//------------------------------------------------------------------------------
+FrameArena::FrameArena(int32 chunkSize_) :
+chunkSize(chunkSize_),
+chunks(nullptr),
+curPtr(nullptr),
+curEnd(nullptr),
+lastAlloc(nullptr),
+allocatedBytes(0),
+numAllocs(0),
+capacity(0),
+numChunks(0) {
+    static_assert((sizeof(chunk) & (ORYOL_MAX_PLATFORM_ALIGN - 1)) == 0, "FrameArena::chunk must be multiple of ORYOL_MAX_PLATFORM_ALIGN!");
+    o_assert(this->chunkSize > 0);
+}
+
+//------------------------------------------------------------------------------
+FrameArena::~FrameArena() {
+    this->freeChunks();
+}
+
+//------------------------------------------------------------------------------
+void
+FrameArena::newChunk(int32 minBytes) {
+    const int32 size = minBytes > this->chunkSize ? minBytes : this->chunkSize;
+    chunk* c = (chunk*) Memory::Alloc(sizeof(chunk) + size, MemoryTag::Core);
+    c->next = this->chunks;
+    c->size = size;
+    this->chunks = c;
+    this->curPtr = (uint8*) (c + 1);
+    this->curEnd = this->curPtr + size;
+    this->lastAlloc = nullptr;
+    this->capacity += size;
+    this->numChunks++;
+}
+
+//------------------------------------------------------------------------------
+void
+FrameArena::freeChunks() {
+    chunk* c = this->chunks;
+    while (c) {
+        chunk* next = c->next;
+        Memory::Free(c);
+        c = next;
+    }
+    this->chunks = nullptr;
+    this->curPtr = nullptr;
+    this->curEnd = nullptr;
+    this->lastAlloc = nullptr;
+    this->capacity = 0;
+    this->numChunks = 0;
+}
+
+//------------------------------------------------------------------------------
+void*
+FrameArena::Alloc(int32 numBytes) {
+    o_assert_dbg(numBytes >= 0);
+    const int32 size = Memory::RoundUp(numBytes, ORYOL_MAX_PLATFORM_ALIGN);
+    if ((nullptr == this->curPtr) || ((this->curPtr + size) > this->curEnd)) {
+        this->newChunk(size);
+    }
+    uint8* ptr = this->curPtr;
+    this->curPtr += size;
+    this->lastAlloc = ptr;
+    this->allocatedBytes += size;
+    this->numAllocs++;
+    #if ORYOL_ALLOCATOR_DEBUG || ORYOL_UNITTESTS
+    Memory::Fill(ptr, size, ORYOL_MEMORY_DEBUG_BYTE);
+    #endif
+    return ptr;
+}
+
+//------------------------------------------------------------------------------
+void*
+FrameArena::AllocAligned(int32 numBytes, int32 alignment) {
+    o_assert_dbg((alignment > 0) && (0 == (alignment & (alignment - 1))));
+    if (alignment <= ORYOL_MAX_PLATFORM_ALIGN) {
+        return this->Alloc(numBytes);
+    }
+    const int32 size = Memory::RoundUp(numBytes, ORYOL_MAX_PLATFORM_ALIGN);
+    uint8* ptr = (uint8*) Memory::AlignUp(this->curPtr, alignment);
+    if ((nullptr == this->curPtr) || ((ptr + size) > this->curEnd)) {
+        this->newChunk(size + alignment);
+        ptr = (uint8*) Memory::AlignUp(this->curPtr, alignment);
+    }
+    this->allocatedBytes += int32((ptr + size) - this->curPtr);
+    this->curPtr = ptr + size;
+    this->lastAlloc = ptr;
+    this->numAllocs++;
+    #if ORYOL_ALLOCATOR_DEBUG || ORYOL_UNITTESTS
+    Memory::Fill(ptr, size, ORYOL_MEMORY_DEBUG_BYTE);
+    #endif
+    return ptr;
+}
+
+//------------------------------------------------------------------------------
+/**
+ If ptr is the most recent allocation and the current chunk has enough
+ room, the allocation is resized in place, otherwise new memory is
+ allocated and the old content is copied.
+*/
+void*
+FrameArena::ReAlloc(void* ptr, int32 oldNumBytes, int32 newNumBytes) {
+    if (nullptr == ptr) {
+        return this->Alloc(newNumBytes);
+    }
+    o_assert_dbg(this->Owns(ptr));
+    if (ptr == this->lastAlloc) {
+        const int32 oldSize = int32(this->curPtr - this->lastAlloc);
+        const int32 newSize = Memory::RoundUp(newNumBytes, ORYOL_MAX_PLATFORM_ALIGN);
+        if ((this->lastAlloc + newSize) <= this->curEnd) {
+            this->curPtr = this->lastAlloc + newSize;
+            this->allocatedBytes += newSize - oldSize;
+            return ptr;
+        }
+    }
+    void* newPtr = this->Alloc(newNumBytes);
+    Memory::Copy(ptr, newPtr, oldNumBytes < newNumBytes ? oldNumBytes : newNumBytes);
+    return newPtr;
+}
+
+//------------------------------------------------------------------------------
+void
+FrameArena::Free(void* ptr) {
+    if ((nullptr != ptr) && (ptr == this->lastAlloc)) {
+        this->allocatedBytes -= int32(this->curPtr - this->lastAlloc);
+        this->curPtr = this->lastAlloc;
+        this->lastAlloc = nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+ If more then one chunk had to be allocated during the last frame, all
+ chunks are replaced with a single chunk which is big enough to hold
+ the previous frame's allocations.
+*/
+void
+FrameArena::Reset() {
+    if (this->numChunks > 1) {
+        const int32 newSize = this->capacity;
+        this->freeChunks();
+        this->newChunk(newSize);
+    }
+    else if (nullptr != this->chunks) {
+        this->curPtr = (uint8*) (this->chunks + 1);
+        this->lastAlloc = nullptr;
+    }
+    this->allocatedBytes = 0;
+    this->numAllocs = 0;
+}
+
+//------------------------------------------------------------------------------
+bool
+FrameArena::Owns(const void* ptr) const {
+    const uint8* p = (const uint8*) ptr;
+    for (const chunk* c = this->chunks; c; c = c->next) {
+        const uint8* start = (const uint8*) (c + 1);
+        if ((p >= start) && (p < (start + c->size))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace Oryol
@@ -0,0 +1,113 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::FrameArena
+    @ingroup Core
+    @brief linear bump-pointer allocator for transient per-frame data
+
+    A FrameArena hands out memory by bumping a pointer through a big
+    chunk of memory, and releases everything at once in Reset(). Free()
+    is a no-op (unless the freed block was the last allocation, in which
+    case the arena is rewound), which makes it very cheap to throw away
+    scratch data (temporary strings, mesh builder streams, message payloads,
+    ...).
+
+    If a chunk is exhausted, a new chunk is allocated and chained to the
+    previous chunks. On Reset(), all chunks are coalesced into a single
+    chunk big enough to hold the high-water-mark of the previous frame,
+    so that in a steady state there's exactly one malloc per thread for
+    all transient frame allocations.
+
+    Each thread which called Core::Setup() or Core::EnterThread() owns a
+    FrameArena which is accessible through Core::ThreadFrameArena(), the
+    thread's PreRunLoop resets the arena at the start of a frame. Threads
+    which don't run their PreRunLoop must call Reset() themselves.
+
+    Containers (Array, Queue) and MemoryStream can be configured to
+    allocate from a FrameArena via SetArena(). Such objects MUST NOT
+    outlive the current frame!
+
+    @see Memory, Core
+*/
+#include "Core/Types.h"
+#include "Core/Config.h"
+
+namespace Oryol {
+
+class FrameArena {
+public:
+    /// constructor
+    FrameArena(int32 chunkSize=ORYOL_FRAMEARENA_DEFAULT_CHUNK_SIZE);
+    /// destructor
+    ~FrameArena();
+
+    /// allocate memory, aligned to ORYOL_MAX_PLATFORM_ALIGN
+    void* Alloc(int32 numBytes);
+    /// allocate memory with a specific (power-of-2) alignment
+    void* AllocAligned(int32 numBytes, int32 alignment);
+    /// re-allocate memory, grows in place if ptr is the last allocation
+    void* ReAlloc(void* ptr, int32 oldNumBytes, int32 newNumBytes);
+    /// free memory, only rewinds the arena if ptr is the last allocation
+    void Free(void* ptr);
+    /// release all allocations at once
+    void Reset();
+
+    /// test if a pointer is owned by this arena (slow)
+    bool Owns(const void* ptr) const;
+    /// get number of bytes allocated since the last Reset()
+    int32 AllocatedBytes() const;
+    /// get number of allocations since the last Reset()
+    int32 NumAllocs() const;
+    /// get overall size of all chunks
+    int32 Capacity() const;
+    /// get current number of chunks
+    int32 NumChunks() const;
+
+private:
+    /// chunk header, the chunk's memory follows the header
+    struct chunk {
+        chunk* next;
+        int32 size;
+        uint8 padding[ORYOL_MAX_PLATFORM_ALIGN - (sizeof(chunk*) + sizeof(int32)) % ORYOL_MAX_PLATFORM_ALIGN];
+    };
+    /// allocate a new chunk and make it the current chunk
+    void newChunk(int32 minBytes);
+    /// free all chunks
+    void freeChunks();
+
+    int32 chunkSize;
+    chunk* chunks;          // the current chunk, linked to previous chunks
+    uint8* curPtr;          // next free byte in current chunk
+    uint8* curEnd;          // one-past-end of current chunk
+    uint8* lastAlloc;       // start of last allocation (for rewinding)
+    int32 allocatedBytes;
+    int32 numAllocs;
+    int32 capacity;
+    int32 numChunks;
+};
+
+//------------------------------------------------------------------------------
+inline int32
+FrameArena::AllocatedBytes() const {
+    return this->allocatedBytes;
+}
+
+//------------------------------------------------------------------------------
+inline int32
+FrameArena::NumAllocs() const {
+    return this->numAllocs;
+}
+
+//------------------------------------------------------------------------------
+inline int32
+FrameArena::Capacity() const {
+    return this->capacity;
+}
+
+//------------------------------------------------------------------------------
+inline int32
+FrameArena::NumChunks() const {
+    return this->numChunks;
+}
+
+} // namespace Oryol
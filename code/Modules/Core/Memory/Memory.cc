@@ -4,14 +4,171 @@
 #include <memory>
 #include <cstdlib>
 #include <cstring>
+#if ORYOL_ALLOCATOR_STATS
+#include <atomic>
+#endif
 #include "Memory.h"
+#include "Core/Assert.h"
 
 namespace Oryol {
-    
+
+namespace {
+
+//------------------------------------------------------------------------------
+void* mallocFunc(void* /*userData*/, int32 numBytes) {
+    return std::malloc(numBytes);
+}
+
+//------------------------------------------------------------------------------
+void* reallocFunc(void* /*userData*/, void* ptr, int32 numBytes) {
+    return std::realloc(ptr, numBytes);
+}
+
+//------------------------------------------------------------------------------
+void freeFunc(void* /*userData*/, void* ptr) {
+    std::free(ptr);
+}
+
+Memory::Allocator allocator = { mallocFunc, reallocFunc, freeFunc, nullptr };
+
+#if ORYOL_ALLOCATOR_STATS
+// each allocation is prefixed with a header which keeps size and tag
+struct allocHeader {
+    int32 numBytes;
+    MemoryTag::Code tag;
+};
+const int32 headerSize = ORYOL_MAX_PLATFORM_ALIGN > 8 ? ORYOL_MAX_PLATFORM_ALIGN : 8;
+static_assert(sizeof(allocHeader) <= headerSize, "Memory: allocHeader too big!");
+
+// per-tag counters, padded to a cache line to prevent false sharing
+struct tagCounters {
+    std::atomic<int64> liveBytes{0};
+    std::atomic<int64> peakBytes{0};
+    std::atomic<int64> liveAllocs{0};
+    std::atomic<int64> totalAllocs{0};
+    std::atomic<int64> curFrameAllocs{0};
+    std::atomic<int64> frameAllocs{0};
+    uint8 padding[ORYOL_CACHELINE_SIZE - 6 * sizeof(int64)];
+};
+// the last entry accumulates all tags
+tagCounters counters[MemoryTag::NumMemoryTags + 1];
+
+//------------------------------------------------------------------------------
+void addBytes(tagCounters& c, int64 numBytes) {
+    const int64 live = c.liveBytes.fetch_add(numBytes, std::memory_order_relaxed) + numBytes;
+    int64 peak = c.peakBytes.load(std::memory_order_relaxed);
+    while ((live > peak) && !c.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+        // retry
+    }
+}
+
+//------------------------------------------------------------------------------
+void trackAlloc(tagCounters& c, int64 numBytes) {
+    addBytes(c, numBytes);
+    c.liveAllocs.fetch_add(1, std::memory_order_relaxed);
+    c.totalAllocs.fetch_add(1, std::memory_order_relaxed);
+    c.curFrameAllocs.fetch_add(1, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+void trackAlloc(MemoryTag::Code tag, int64 numBytes) {
+    trackAlloc(counters[tag], numBytes);
+    trackAlloc(counters[MemoryTag::NumMemoryTags], numBytes);
+}
+
+//------------------------------------------------------------------------------
+void trackFree(tagCounters& c, int64 numBytes) {
+    c.liveBytes.fetch_sub(numBytes, std::memory_order_relaxed);
+    c.liveAllocs.fetch_sub(1, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+void trackFree(MemoryTag::Code tag, int64 numBytes) {
+    trackFree(counters[tag], numBytes);
+    trackFree(counters[MemoryTag::NumMemoryTags], numBytes);
+}
+
+//------------------------------------------------------------------------------
+Memory::Stats getStats(const tagCounters& c) {
+    Memory::Stats stats;
+    stats.LiveBytes = c.liveBytes.load(std::memory_order_relaxed);
+    stats.PeakBytes = c.peakBytes.load(std::memory_order_relaxed);
+    stats.LiveAllocs = c.liveAllocs.load(std::memory_order_relaxed);
+    stats.TotalAllocs = c.totalAllocs.load(std::memory_order_relaxed);
+    stats.FrameAllocs = c.frameAllocs.load(std::memory_order_relaxed);
+    return stats;
+}
+#endif
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+void
+Memory::SetAllocator(const Allocator& alloc) {
+    o_assert((nullptr != alloc.Alloc) && (nullptr != alloc.ReAlloc) && (nullptr != alloc.Free));
+    #if ORYOL_ALLOCATOR_STATS
+    o_assert2(0 == counters[MemoryTag::NumMemoryTags].totalAllocs, "Memory::SetAllocator() must be called before first allocation!\n");
+    #endif
+    allocator = alloc;
+}
+
+//------------------------------------------------------------------------------
+const Memory::Allocator&
+Memory::GetAllocator() {
+    return allocator;
+}
+
+//------------------------------------------------------------------------------
+Memory::Stats
+Memory::GetStats(MemoryTag::Code tag) {
+    o_assert_range(tag, MemoryTag::NumMemoryTags);
+    #if ORYOL_ALLOCATOR_STATS
+    return getStats(counters[tag]);
+    #else
+    return Stats();
+    #endif
+}
+
+//------------------------------------------------------------------------------
+Memory::Stats
+Memory::GetTotalStats() {
+    #if ORYOL_ALLOCATOR_STATS
+    return getStats(counters[MemoryTag::NumMemoryTags]);
+    #else
+    return Stats();
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+Memory::NewFrameStats() {
+    #if ORYOL_ALLOCATOR_STATS
+    for (tagCounters& c : counters) {
+        c.frameAllocs.store(c.curFrameAllocs.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    #endif
+}
+
 //------------------------------------------------------------------------------
 void*
 Memory::Alloc(int32 numBytes) {
-    void* ptr = std::malloc(numBytes);
+    return Memory::Alloc(numBytes, MemoryTag::Default);
+}
+
+//------------------------------------------------------------------------------
+void*
+Memory::Alloc(int32 numBytes, MemoryTag::Code tag) {
+    o_assert_range_dbg(tag, MemoryTag::NumMemoryTags);
+    #if ORYOL_ALLOCATOR_STATS
+    uint8* basePtr = (uint8*) allocator.Alloc(allocator.UserData, numBytes + headerSize);
+    allocHeader* header = (allocHeader*) basePtr;
+    header->numBytes = numBytes;
+    header->tag = tag;
+    trackAlloc(tag, numBytes);
+    void* ptr = basePtr + headerSize;
+    #else
+    void* ptr = allocator.Alloc(allocator.UserData, numBytes);
+    #endif
 #if ORYOL_ALLOCATOR_DEBUG || ORYOL_UNITTESTS
     Memory::Fill(ptr, numBytes, ORYOL_MEMORY_DEBUG_BYTE);
 #endif
@@ -28,13 +185,64 @@ Memory::Fill(void* ptr, int32 numBytes, uint8 value) {
 void*
 Memory::ReAlloc(void* ptr, int32 s) {
     /// @todo: HMM need to fix fill with debug pattern...
-    return std::realloc(ptr, s);
+    #if ORYOL_ALLOCATOR_STATS
+    if (nullptr == ptr) {
+        return Memory::Alloc(s);
+    }
+    uint8* basePtr = ((uint8*)ptr) - headerSize;
+    const allocHeader oldHeader = *(allocHeader*)basePtr;
+    basePtr = (uint8*) allocator.ReAlloc(allocator.UserData, basePtr, s + headerSize);
+    ((allocHeader*)basePtr)->numBytes = s;
+    trackFree(oldHeader.tag, oldHeader.numBytes);
+    trackAlloc(oldHeader.tag, s);
+    return basePtr + headerSize;
+    #else
+    return allocator.ReAlloc(allocator.UserData, ptr, s);
+    #endif
 }
 
 //------------------------------------------------------------------------------
 void
 Memory::Free(void* p) {
-    std::free(p);
+    #if ORYOL_ALLOCATOR_STATS
+    if (nullptr != p) {
+        uint8* basePtr = ((uint8*)p) - headerSize;
+        const allocHeader* header = (const allocHeader*) basePtr;
+        trackFree(header->tag, header->numBytes);
+        allocator.Free(allocator.UserData, basePtr);
+    }
+    #else
+    allocator.Free(allocator.UserData, p);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+/**
+ Over-allocates from Memory::Alloc() and stores the original pointer
+ right in front of the aligned pointer, so the memory MUST be freed
+ with Memory::FreeAligned().
+*/
+void*
+Memory::AllocAligned(int32 numBytes, int32 alignment, MemoryTag::Code tag) {
+    o_assert_dbg((alignment > 0) && (0 == (alignment & (alignment - 1))));
+    uint8* basePtr = (uint8*) Memory::Alloc(numBytes + alignment + int32(sizeof(void*)), tag);
+    uint8* ptr = (uint8*) Memory::AlignUp(basePtr + sizeof(void*), alignment);
+    ((void**)ptr)[-1] = basePtr;
+    return ptr;
+}
+
+//------------------------------------------------------------------------------
+void*
+Memory::AllocAligned(int32 numBytes, int32 alignment) {
+    return Memory::AllocAligned(numBytes, alignment, MemoryTag::Default);
+}
+
+//------------------------------------------------------------------------------
+void
+Memory::FreeAligned(void* ptr) {
+    if (nullptr != ptr) {
+        Memory::Free(((void**)ptr)[-1]);
+    }
 }
 
 //------------------------------------------------------------------------------
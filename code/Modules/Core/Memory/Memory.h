@@ -9,22 +9,79 @@
     differs by platforms (e.g. platforms with SSE support return 16-byte
     aligned memory.
     
-    @todo for now this simply calls malloc()/free(), may be more
-    advanced in the future.
+    By default, allocations are forwarded to malloc()/realloc()/free(),
+    an application can install its own allocator backend with
+    SetAllocator(). This must happen before the first Oryol allocation
+    (for instance from a static initializer), since memory must always
+    be freed by the backend which allocated it.
+    
+    If ORYOL_ALLOCATOR_STATS is enabled (cmake option, off by default),
+    each allocation is accounted to a MemoryTag, and
+    per-tag statistics can be queried with GetStats(). The counters
+    are lock-free atomics.
+    
+    Memory::Alloc() returns memory aligned to ORYOL_MAX_PLATFORM_ALIGN,
+    use AllocAligned()/FreeAligned() for bigger alignments (e.g. 32 bytes
+    for AVX, or ORYOL_CACHELINE_SIZE to prevent false sharing).
 */
 #include "Core/Types.h"
 #include "Core/Config.h"
+#include "Core/Memory/MemoryTag.h"
 
 namespace Oryol {
     
 class Memory {
 public:
+    /// a pluggable allocator backend
+    struct Allocator {
+        /// allocate function
+        void* (*Alloc)(void* userData, int32 numBytes);
+        /// re-allocate function
+        void* (*ReAlloc)(void* userData, void* ptr, int32 numBytes);
+        /// free function
+        void (*Free)(void* userData, void* ptr);
+        /// user data pointer handed to allocator functions
+        void* UserData;
+    };
+    /// per-tag allocation statistics
+    struct Stats {
+        /// currently allocated bytes
+        int64 LiveBytes = 0;
+        /// highest number of allocated bytes
+        int64 PeakBytes = 0;
+        /// current number of allocations
+        int64 LiveAllocs = 0;
+        /// overall number of allocations
+        int64 TotalAllocs = 0;
+        /// number of allocations in the previous frame
+        int64 FrameAllocs = 0;
+    };
+
+    /// install an allocator backend (before first allocation!)
+    static void SetAllocator(const Allocator& allocator);
+    /// get the current allocator backend
+    static const Allocator& GetAllocator();
+    /// get allocation statistics for a memory tag (all zero if ORYOL_ALLOCATOR_STATS disabled)
+    static Stats GetStats(MemoryTag::Code tag);
+    /// get accumulated allocation statistics over all tags
+    static Stats GetTotalStats();
+    /// start a new frame for the FrameAllocs counter (called by Core on the main thread)
+    static void NewFrameStats();
+
     /// allocate a raw chunk of memory
     static void* Alloc(int32 numBytes);
-    /// re-allocate a raw chunk of memory
+    /// allocate a raw chunk of memory with a tag
+    static void* Alloc(int32 numBytes, MemoryTag::Code tag);
+    /// re-allocate a raw chunk of memory (keeps the original tag)
     static void* ReAlloc(void* ptr, int32 numBytes);
     /// free a raw chunk of memory
     static void Free(void* ptr);
+    /// allocate memory with a specific (power-of-2) alignment, not clamped to ORYOL_MAX_PLATFORM_ALIGN
+    static void* AllocAligned(int32 numBytes, int32 alignment);
+    /// allocate aligned memory with a tag
+    static void* AllocAligned(int32 numBytes, int32 alignment, MemoryTag::Code tag);
+    /// free memory allocated with AllocAligned()
+    static void FreeAligned(void* ptr);
     /// fill range of memory with a byte value
     static void Fill(void* ptr, int32 numBytes, uint8 value);
     /// copy a raw chunk of non-overlapping memory
@@ -35,6 +92,10 @@ public:
     static void Clear(void* ptr, int32 numBytes);
     /// align a pointer to size up to ORYOL_MAX_PLATFORM_ALIGN
     static void* Align(void* ptr, int32 byteSize);
+    /// align a pointer up to a (power-of-2) alignment, not clamped
+    static void* AlignUp(void* ptr, int32 alignment);
+    /// test if a pointer is aligned to a (power-of-2) alignment
+    static bool IsAligned(const void* ptr, int32 alignment);
     /// round-up a value to the next multiple of byteSize
     static int32 RoundUp(int32 val, int32 byteSize);
 };
@@ -48,6 +109,20 @@ Memory::Align(void* ptr, int32 byteSize) {
     return (void*) ptri;
 };
 
+//------------------------------------------------------------------------------
+inline void*
+Memory::AlignUp(void* ptr, int32 alignment) {
+    intptr ptri = (intptr)ptr;
+    ptri = (ptri + (alignment - 1)) & ~intptr(alignment - 1);
+    return (void*) ptri;
+}
+
+//------------------------------------------------------------------------------
+inline bool
+Memory::IsAligned(const void* ptr, int32 alignment) {
+    return 0 == (intptr(ptr) & (alignment - 1));
+}
+
 //------------------------------------------------------------------------------
 inline int32
 Memory::RoundUp(int32 val, int32 byteSize) {
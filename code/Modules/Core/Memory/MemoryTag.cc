@@ -0,0 +1,47 @@
+//------------------------------------------------------------------------------
+//  MemoryTag.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "MemoryTag.h"
+#include "Core/Macros.h"
+#include <cstring>
+
+namespace Oryol {
+
+//------------------------------------------------------------------------------
+const char*
+MemoryTag::ToString(Code c) {
+    switch (c) {
+        __ORYOL_TOSTRING(Default);
+        __ORYOL_TOSTRING(Core);
+        __ORYOL_TOSTRING(Containers);
+        __ORYOL_TOSTRING(String);
+        __ORYOL_TOSTRING(Gfx);
+        __ORYOL_TOSTRING(IO);
+        __ORYOL_TOSTRING(HTTP);
+        __ORYOL_TOSTRING(Messaging);
+        __ORYOL_TOSTRING(Resource);
+        __ORYOL_TOSTRING(Synth);
+        __ORYOL_TOSTRING(App);
+        default: return "InvalidMemoryTag";
+    }
+}
+
+//------------------------------------------------------------------------------
+MemoryTag::Code
+MemoryTag::FromString(const char* str) {
+    __ORYOL_FROMSTRING(Default);
+    __ORYOL_FROMSTRING(Core);
+    __ORYOL_FROMSTRING(Containers);
+    __ORYOL_FROMSTRING(String);
+    __ORYOL_FROMSTRING(Gfx);
+    __ORYOL_FROMSTRING(IO);
+    __ORYOL_FROMSTRING(HTTP);
+    __ORYOL_FROMSTRING(Messaging);
+    __ORYOL_FROMSTRING(Resource);
+    __ORYOL_FROMSTRING(Synth);
+    __ORYOL_FROMSTRING(App);
+    return MemoryTag::InvalidMemoryTag;
+}
+
+} // namespace Oryol
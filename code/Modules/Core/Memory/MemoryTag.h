@@ -0,0 +1,41 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::MemoryTag
+    @ingroup Core
+    @brief allocation tags for per-module memory statistics
+
+    An optional tag can be passed to Memory::Alloc() to account the
+    allocation to a specific module, see Memory::GetStats().
+*/
+#include "Core/Types.h"
+
+namespace Oryol {
+
+class MemoryTag {
+public:
+    /// memory tag enum
+    enum Code : uint8 {
+        Default,
+        Core,
+        Containers,
+        String,
+        Gfx,
+        IO,
+        HTTP,
+        Messaging,
+        Resource,
+        Synth,
+        App,
+
+        NumMemoryTags,
+        InvalidMemoryTag,
+    };
+
+    /// convert to string
+    static const char* ToString(Code c);
+    /// convert from string
+    static Code FromString(const char* str);
+};
+
+} // namespace Oryol
@@ -0,0 +1,33 @@
+//------------------------------------------------------------------------------
+//  poolAllocator.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "poolAllocator.h"
+#if ORYOL_HAS_THREADS
+#include "Core/Threading/ThreadLocalPtr.h"
+#endif
+
+namespace Oryol {
+namespace _priv {
+
+#if ORYOL_HAS_THREADS
+namespace {
+std::atomic<int32> threadCounter{0};
+// stores the thread index + 1, so that nullptr means 'not assigned yet'
+ORYOL_THREADLOCAL_PTR(void) threadIndex = nullptr;
+}
+
+//------------------------------------------------------------------------------
+int32
+poolAllocatorThreadIndex() {
+    intptr index = (intptr) threadIndex;
+    if (0 == index) {
+        index = ++threadCounter;
+        threadIndex = (void*) index;
+    }
+    return int32(index - 1);
+}
+#endif
+
+} // namespace _priv
+} // namespace Oryol
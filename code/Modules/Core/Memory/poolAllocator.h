@@ -3,67 +3,109 @@
 /*
     @class Oryol::_priv::poolAllocator
     @ingroup _priv
- 
-    Thread-safe pool allocator with placement-new/delete. Uses 32-bit
-    tags with a unique-count masked-in for its forward-linked list 
-    instead of pointers because of the ABA problem (which I was actually 
+
+    Thread-safe pool allocator with placement-new/delete. Uses 64-bit
+    tags with a 32-bit unique-count masked-in for its forward-linked list
+    instead of pointers because of the ABA problem (which I was actually
     running into with many threads and high object reuse). The pool
-    is split into up to 256 "puddles", where each puddle can hold
-    up to 256 elements. When no elements are in the free list, 
-    a new puddle is allocated. Thus one pool can hold up to
-    65536 elements.
+    is split into up to 128 "puddles", the first puddle holds 256
+    elements, and each following puddle doubles in size (up to 16 MByte
+    per puddle). When no elements are in the free list, a new puddle
+    is allocated.
+
+    The shared free-list is a lock-free stack of node batches. Each thread
+    uses a small "magazine" of free nodes, Create() and Destroy() only
+    touch the shared free-list when the magazine runs empty (pop a whole
+    batch) or full (push a whole batch), so that under contention there's
+    one CAS per batch instead of one CAS per object. Magazines are owned
+    by the pool and selected by a per-thread index, if two threads map
+    to the same (busy) magazine, the shared free-list is used directly.
 */
 #include <atomic>
 #include <utility>
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
 #include "Core/Types.h"
+#include "Core/Config.h"
+#include "Core/Assert.h"
 #include "Core/Memory/Memory.h"
 
 namespace Oryol {
 namespace _priv {
-    
+
+#if ORYOL_HAS_THREADS
+/// get a small per-thread index to select a pool allocator magazine
+int32 poolAllocatorThreadIndex();
+#endif
+
 template<class TYPE> class poolAllocator {
 public:
     /// constructor
     poolAllocator();
     /// destructor
     ~poolAllocator();
-    
+
     /// allocate and construct an object of type T
     template<typename... ARGS> TYPE* Create(ARGS&&... args);
     /// delete and free an object
     void Destroy(TYPE* obj);
-    
+
+    /// get overall number of elements in all puddles
+    int32 Capacity() const;
+
 private:
     enum class nodeState : uint8 {
-        init, free, used,
+        free, used,
     };
-    
-    typedef uint32 nodeTag;    // [16bit counter] | [8bit puddle index ] | [8bit elm_index])
-    static const uint32 invalidTag = 0xFFFFFFFF;
+
+    typedef uint64 nodeTag;     // [32bit counter] | [8bit puddle index] | [24bit elm index]
+    typedef uint32 nodeIndex;   // [8bit puddle index] | [24bit elm index]
+    static const nodeTag invalidTag = 0xFFFFFFFFFFFFFFFF;
+    static const nodeIndex invalidIndex = 0xFFFFFFFF;
 
     struct node {
-        nodeTag next;          // tag of next node
-        nodeTag myTag;        // my own tag
-        nodeState state;       // current state
-        uint8 padding[16 - (2*sizeof(nodeTag) + sizeof(nodeState))];      // pad to 16 bytes
+        nodeTag next;           // tag of next batch in the shared free-list
+        nodeIndex myIndex;      // my own index
+        nodeState state;        // current state
+        uint8 padding[16 - (sizeof(nodeTag) + sizeof(nodeIndex) + sizeof(nodeState))];      // pad to 16 bytes
     };
 
-    /// pop a new node from the free-list, return 0 if empty
+    static const int32 MagazineSize = 32;
+    static const int32 BatchSize = MagazineSize / 2;
+    static const int32 NumMagazines = 16;
+    struct magazine {
+        std::atomic_flag lock;
+        int32 num;
+        nodeIndex nodes[MagazineSize];
+        uint8 padding[ORYOL_CACHELINE_SIZE];
+    };
+
+    /// pop a batch of nodes from the shared free-list, return nullptr if empty
+    node* popBatch();
+    /// push a batch of nodes (linked through nextInBatch) onto the shared free-list
+    void pushBatch(node* first);
+    /// pop a batch of nodes, grow the pool if the shared free-list is empty
+    node* popBatchOrGrow();
+    /// pop a single node, refill from the shared free-list or allocate a new puddle
     node* pop();
-    /// push a node onto the free-list
-    void push(node*);
+    /// push a single node
+    void push(node* n);
     /// allocate a new puddle and add entries to free-list
     void allocPuddle();
-    /// get node address from a tag
-    node* addressFromTag(nodeTag tag) const;
-    /// get tag from a node address
-    nodeTag tagFromAddress(node* n) const;
+    /// get the number of elements in a puddle
+    uint32 numPuddleElements(uint32 puddleIndex) const;
+    /// get node address from a tag or index
+    node* addressFromIndex(nodeIndex index) const;
+    /// access the in-batch link of a free node (located in the unused object memory)
+    static nodeIndex& nextInBatch(node* n);
     /// test if a pointer is owned by this allocator (SLOW)
     bool isOwned(TYPE* obj) const;
-    
-    static const uint32 MaxNumPuddles = 256;
+
+    static const uint32 MaxNumPuddles = 128;
     static const uint32 NumPuddleElements = 256;
-    
+    static const uint32 MaxPuddleByteSize = 1<<24;
+
     int32 elmSize;                      // offset to next element in bytes
 
     #if ORYOL_HAS_ATOMIC
@@ -75,7 +117,11 @@ private:
         nodeTag head;
         uint32 numPuddles;
     #endif
+    std::atomic_flag growLock;          // only one thread at a time may grow the pool
     uint8* puddles[MaxNumPuddles];
+    #if ORYOL_HAS_THREADS
+    magazine magazines[NumMagazines];
+    #endif
 };
 
 //------------------------------------------------------------------------------
@@ -91,6 +137,13 @@ poolAllocator<TYPE>::poolAllocator()
     o_assert(this->elmSize >= (int32)(2*sizeof(node)));
     this->uniqueCount = 0;
     this->head = invalidTag;
+    this->growLock.clear();
+    #if ORYOL_HAS_THREADS
+    for (magazine& mag : this->magazines) {
+        mag.lock.clear();
+        mag.num = 0;
+    }
+    #endif
 }
 
 //------------------------------------------------------------------------------
@@ -104,26 +157,44 @@ poolAllocator<TYPE>::~poolAllocator() {
     }
 }
 
+//------------------------------------------------------------------------------
+template<class TYPE> uint32
+poolAllocator<TYPE>::numPuddleElements(uint32 puddleIndex) const {
+    uint32 maxElements = MaxPuddleByteSize / this->elmSize;
+    if (maxElements == 0) {
+        maxElements = 1;
+    }
+    const uint32 shift = puddleIndex < 16 ? puddleIndex : 16;
+    const uint32 num = NumPuddleElements << shift;
+    return num < maxElements ? num : maxElements;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int32
+poolAllocator<TYPE>::Capacity() const {
+    const uint32 num = this->numPuddles;
+    int32 capacity = 0;
+    for (uint32 i = 0; i < num; i++) {
+        capacity += this->numPuddleElements(i);
+    }
+    return capacity;
+}
+
 //------------------------------------------------------------------------------
 template<class TYPE>
 typename poolAllocator<TYPE>::node*
-poolAllocator<TYPE>::addressFromTag(nodeTag tag) const {
-    uint32 elmIndex = tag & 0xFF;
-    uint32 puddleIndex = (tag & 0xFF00) >> 8;
+poolAllocator<TYPE>::addressFromIndex(nodeIndex index) const {
+    uint32 elmIndex = index & 0x00FFFFFF;
+    uint32 puddleIndex = index >> 24;
     uint8* ptr = this->puddles[puddleIndex] + elmIndex * elmSize;
     return (node*) ptr;
 }
 
 //------------------------------------------------------------------------------
 template<class TYPE>
-typename poolAllocator<TYPE>::nodeTag
-poolAllocator<TYPE>::tagFromAddress(node* n) const {
-    o_assert(nullptr != n);
-    nodeTag tag = n->myTag;
-    #if ORYOL_ALLOCATOR_DEBUG
-    o_assert(n == addressFromTag(tag));
-    #endif
-    return tag;
+typename poolAllocator<TYPE>::nodeIndex&
+poolAllocator<TYPE>::nextInBatch(node* n) {
+    return *(nodeIndex*)(n + 1);
 }
 
 //------------------------------------------------------------------------------
@@ -134,85 +205,86 @@ poolAllocator<TYPE>::allocPuddle() {
     // method can be called from different threads
     #if ORYOL_HAS_ATOMIC
         uint32 newPuddleIndex = this->numPuddles.fetch_add(1, std::memory_order_relaxed);
-    #else 
+    #else
         uint32 newPuddleIndex = this->numPuddles++;
     #endif
     o_assert(newPuddleIndex < MaxNumPuddles);
-    
+
     // allocate new puddle
-    const uint32 puddleByteSize = NumPuddleElements * this->elmSize;
-    this->puddles[newPuddleIndex] = (uint8*) Memory::Alloc(puddleByteSize);
-    Memory::Clear(this->puddles[newPuddleIndex], puddleByteSize);
-    
-    // populate the free stack
-    for (int32 elmIndex = (NumPuddleElements - 1); elmIndex >= 0; elmIndex--) {
-        uint8* ptr = this->puddles[newPuddleIndex] + elmIndex * this->elmSize;
-        node* nodePtr = (node*) ptr;
+    const uint32 numElements = this->numPuddleElements(newPuddleIndex);
+    const uint32 puddleByteSize = numElements * this->elmSize;
+    uint8* puddle = (uint8*) Memory::Alloc(puddleByteSize, MemoryTag::Core);
+    Memory::Clear(puddle, puddleByteSize);
+    this->puddles[newPuddleIndex] = puddle;
+
+    // initialize the nodes, and link them into batches
+    node* batch = nullptr;
+    int32 batchNum = 0;
+    for (int32 elmIndex = (numElements - 1); elmIndex >= 0; elmIndex--) {
+        node* nodePtr = (node*) (puddle + elmIndex * this->elmSize);
         nodePtr->next  = invalidTag;
-        nodePtr->myTag = (newPuddleIndex << 8) | elmIndex;
-        nodePtr->state = nodeState::init;
-        this->push(nodePtr);
+        nodePtr->myIndex = (newPuddleIndex << 24) | elmIndex;
+        nodePtr->state = nodeState::free;
+        nextInBatch(nodePtr) = batch ? batch->myIndex : invalidIndex;
+        batch = nodePtr;
+        if (++batchNum == BatchSize) {
+            this->pushBatch(batch);
+            batch = nullptr;
+            batchNum = 0;
+        }
+    }
+    if (batch) {
+        this->pushBatch(batch);
     }
 }
 
 //------------------------------------------------------------------------------
 template<class TYPE> void
-poolAllocator<TYPE>::push(node* newHead) {
-    
+poolAllocator<TYPE>::pushBatch(node* first) {
+
     // see http://www.boost.org/doc/libs/1_53_0/boost/lockfree/stack.hpp
-    o_assert((nodeState::init == newHead->state) || (nodeState::used == newHead->state));
-    
-    o_assert(invalidTag == newHead->next);
-    #if ORYOL_ALLOCATOR_DEBUG
-    Memory::Fill((void*) (newHead + 1), sizeof(TYPE), 0xAA);
-    #endif
-    
-    newHead->state = nodeState::free;
-    newHead->myTag = (newHead->myTag & 0x0000FFFF) | (++this->uniqueCount & 0xFFFF) << 16;
+    o_assert_dbg(nodeState::free == first->state);
+    o_assert_dbg(invalidTag == first->next);
+
+    const nodeTag newHeadTag = (nodeTag(++this->uniqueCount) << 32) | first->myIndex;
     #if ORYOL_HAS_ATOMIC
         nodeTag oldHeadTag = this->head.load(std::memory_order_relaxed);
         for (;;) {
-            newHead->next = oldHeadTag;
-            if (this->head.compare_exchange_weak(oldHeadTag, newHead->myTag)) {
+            first->next = oldHeadTag;
+            if (this->head.compare_exchange_weak(oldHeadTag, newHeadTag)) {
                 break;
             }
         }
     #else
-        nodeTag oldHeadTag = this->head;
-        newHead->next = oldHeadTag;
-        this->head = newHead->myTag;
+        first->next = this->head;
+        this->head = newHeadTag;
     #endif
 }
 
 //------------------------------------------------------------------------------
 template<class TYPE>
 typename poolAllocator<TYPE>::node*
-poolAllocator<TYPE>::pop()
+poolAllocator<TYPE>::popBatch()
 {
     // see http://www.boost.org/doc/libs/1_53_0/boost/lockfree/stack.hpp
     for (;;) {
         #if ORYOL_HAS_ATOMIC
             nodeTag oldHeadTag = this->head.load(std::memory_order_consume);
-        #else 
+        #else
             nodeTag oldHeadTag = this->head;
         #endif
         if (invalidTag == oldHeadTag) {
             return nullptr;
         }
-        nodeTag newHeadTag = this->addressFromTag(oldHeadTag)->next;
+        node* nodePtr = this->addressFromIndex(nodeIndex(oldHeadTag));
+        nodeTag newHeadTag = nodePtr->next;
         #if ORYOL_HAS_ATOMIC
         if (this->head.compare_exchange_weak(oldHeadTag, newHeadTag)) {
         #else
         this->head = newHeadTag;
         #endif
-            o_assert(invalidTag != oldHeadTag);
-            node* nodePtr = this->addressFromTag(oldHeadTag);
             o_assert(nodeState::free == nodePtr->state);
-            #if ORYOL_ALLOCATOR_DEBUG
-            Memory::Fill((void*) (nodePtr+ 1), sizeof(TYPE), 0xBB);
-            #endif
             nodePtr->next = invalidTag;
-            nodePtr->state = nodeState::used;
             return nodePtr;
         #if ORYOL_HAS_ATOMIC
         }
@@ -220,20 +292,121 @@ poolAllocator<TYPE>::pop()
     }
 }
 
+//------------------------------------------------------------------------------
+/**
+ If the shared free-list is empty, only one thread allocates a new puddle,
+ other threads wait for the new puddle instead of growing the pool
+ at the same time.
+*/
+template<class TYPE>
+typename poolAllocator<TYPE>::node*
+poolAllocator<TYPE>::popBatchOrGrow() {
+    for (;;) {
+        node* n = this->popBatch();
+        if (n) {
+            return n;
+        }
+        if (!this->growLock.test_and_set(std::memory_order_acquire)) {
+            // check again, another thread might just have grown the pool
+            n = this->popBatch();
+            if (nullptr == n) {
+                this->allocPuddle();
+                n = this->popBatch();
+            }
+            this->growLock.clear(std::memory_order_release);
+            if (n) {
+                return n;
+            }
+        }
+        #if ORYOL_HAS_THREADS
+        else {
+            std::this_thread::yield();
+        }
+        #endif
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+typename poolAllocator<TYPE>::node*
+poolAllocator<TYPE>::pop() {
+
+    node* n = nullptr;
+    #if ORYOL_HAS_THREADS
+    magazine& mag = this->magazines[poolAllocatorThreadIndex() & (NumMagazines - 1)];
+    if (!mag.lock.test_and_set(std::memory_order_acquire)) {
+        if (0 == mag.num) {
+            // refill the magazine with a batch from the shared free-list
+            node* batch = this->popBatchOrGrow();
+            for (node* cur = batch; cur; ) {
+                const nodeIndex next = nextInBatch(cur);
+                mag.nodes[mag.num++] = cur->myIndex;
+                cur = (invalidIndex == next) ? nullptr : this->addressFromIndex(next);
+            }
+        }
+        if (mag.num > 0) {
+            n = this->addressFromIndex(mag.nodes[--mag.num]);
+        }
+        mag.lock.clear(std::memory_order_release);
+        if (n) {
+            return n;
+        }
+    }
+    #endif
+
+    // no magazine available, go to the shared free-list directly
+    n = this->popBatchOrGrow();
+    // give back the remainder of the batch
+    const nodeIndex next = nextInBatch(n);
+    if (invalidIndex != next) {
+        this->pushBatch(this->addressFromIndex(next));
+    }
+    return n;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+poolAllocator<TYPE>::push(node* n) {
+
+    #if ORYOL_HAS_THREADS
+    magazine& mag = this->magazines[poolAllocatorThreadIndex() & (NumMagazines - 1)];
+    if (!mag.lock.test_and_set(std::memory_order_acquire)) {
+        if (MagazineSize == mag.num) {
+            // magazine is full, flush a batch to the shared free-list
+            mag.num -= BatchSize;
+            node* batch = nullptr;
+            for (int32 i = mag.num + BatchSize - 1; i >= mag.num; i--) {
+                node* cur = this->addressFromIndex(mag.nodes[i]);
+                nextInBatch(cur) = batch ? batch->myIndex : invalidIndex;
+                batch = cur;
+            }
+            this->pushBatch(batch);
+        }
+        mag.nodes[mag.num++] = n->myIndex;
+        mag.lock.clear(std::memory_order_release);
+        return;
+    }
+    #endif
+
+    // no magazine available, push as single-node batch
+    nextInBatch(n) = invalidIndex;
+    this->pushBatch(n);
+}
+
 //------------------------------------------------------------------------------
 template<class TYPE>
 template<typename... ARGS> TYPE*
 poolAllocator<TYPE>::Create(ARGS&&... args) {
-    
+
     // pop a new node from the free-stack
     node* n = this->pop();
-    if (nullptr == n) {
-        // need to allocate a new puddle
-        this->allocPuddle();
-        n = this->pop();
-    }
     o_assert(nullptr != n);
-    
+    o_assert(nodeState::free == n->state);
+    #if ORYOL_ALLOCATOR_DEBUG
+    Memory::Fill((void*) (n + 1), sizeof(TYPE), 0xBB);
+    #endif
+    n->state = nodeState::used;
+
     // construct with placement new
     void* objPtr = (void*) (n + 1);
     TYPE* obj = new(objPtr) TYPE(std::forward<ARGS>(args)...);
@@ -247,7 +420,7 @@ poolAllocator<TYPE>::isOwned(TYPE* obj) const {
     const uint32 num = this->numPuddles;
     for (uint32 i = 0; i < num; i++) {
         const uint8* start = this->puddles[i];
-        const uint8* end = this->puddles[i] + NumPuddleElements * this->elmSize;
+        const uint8* end = this->puddles[i] + this->numPuddleElements(i) * this->elmSize;
         const uint8* ptr = (uint8*) obj;
         if ((ptr >= start) && (ptr < end)) {
             return true;
@@ -259,18 +432,24 @@ poolAllocator<TYPE>::isOwned(TYPE* obj) const {
 //------------------------------------------------------------------------------
 template<class TYPE> void
 poolAllocator<TYPE>::Destroy(TYPE* obj) {
-    
+
     #if ORYOL_ALLOCATOR_DEBUG
     // make sure this object has been allocated by us
     o_assert(this->isOwned(obj));
     #endif
-    
+
     // call destructor on obj
     obj->~TYPE();
-    
+
     // push the pool element back on the free-stack
     node* n = ((node*)obj) - 1;
-    push(n);
+    o_assert(nodeState::used == n->state);
+    o_assert(invalidTag == n->next);
+    #if ORYOL_ALLOCATOR_DEBUG
+    Memory::Fill((void*) (n + 1), sizeof(TYPE), 0xAA);
+    #endif
+    n->state = nodeState::free;
+    this->push(n);
 }
 
 } // namespace _priv
@@ -13,6 +13,7 @@
 #include <type_traits>
 #include "Core/Types.h"
 #include "Core/Assert.h"
+#include "Core/Traits.h"
 
 namespace Oryol {
 
@@ -193,4 +194,7 @@ private:
     };
 };
 
+/// a Ptr only holds a pointer, so it can be relocated with memcpy
+template<class T> struct IsTriviallyRelocatable<Ptr<T>> : std::true_type { };
+
 } // namespace oryol
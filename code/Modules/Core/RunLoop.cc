@@ -3,6 +3,9 @@
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include "RunLoop.h"
+#include "Core/Threading/JobSystem.h"
+#include <algorithm>
+#include <chrono>
 
 namespace Oryol {
 
@@ -10,7 +13,8 @@ OryolClassImpl(RunLoop);
 
 //------------------------------------------------------------------------------
 RunLoop::RunLoop() :
-curId(InvalidId)
+curId(InvalidId),
+scheduleDirty(false)
 {
     // empty
 }
@@ -22,13 +26,60 @@ RunLoop::~RunLoop() {
 
 //------------------------------------------------------------------------------
 void
+RunLoop::runTimed(const Func* func, Timing* timing) {
+    auto start = std::chrono::high_resolution_clock::now();
+    (*func)();
+    std::chrono::duration<float64, std::milli> dur = std::chrono::high_resolution_clock::now() - start;
+    timing->MilliSecs = dur.count();
+}
+
+//------------------------------------------------------------------------------
+/**
+ Within a phase, the Parallel callbacks are pushed to the JobSystem
+ first, then the Serial callbacks are called on this thread, and
+ finally this thread helps with the Parallel callbacks until all of
+ them are finished (this is the barrier between phases).
+*/
+void
 RunLoop::Run() {
     this->remCallbacks();
     this->addCallbacks();
-    for (const auto& entry : this->callbacks) {
-        if (entry.Value().valid) {
-            entry.Value().func();
+    if (this->scheduleDirty) {
+        this->updateSchedule();
+    }
+    const bool useJobs = JobSystem::IsValid() && (JobSystem::NumThreads() > 1);
+    const int32 num = this->schedule.Size();
+    for (int32 phaseStart = 0; phaseStart < num; ) {
+        const int32 phase = this->timings[phaseStart].Phase;
+        int32 phaseEnd = phaseStart + 1;
+        while ((phaseEnd < num) && (this->timings[phaseEnd].Phase == phase)) {
+            phaseEnd++;
+        }
+        JobHandle group;
+        if (useJobs) {
+            for (int32 i = phaseStart; i < phaseEnd; i++) {
+                if (Parallel == this->timings[i].Mode) {
+                    if (!group.IsValid()) {
+                        group = JobSystem::CreateGroup();
+                    }
+                    const Func* func = this->schedule[i];
+                    Timing* timing = &this->timings[i];
+                    JobSystem::Run([func, timing]() {
+                        runTimed(func, timing);
+                    }, group);
+                }
+            }
         }
+        for (int32 i = phaseStart; i < phaseEnd; i++) {
+            if (!useJobs || (Serial == this->timings[i].Mode)) {
+                runTimed(this->schedule[i], &this->timings[i]);
+            }
+        }
+        if (group.IsValid()) {
+            JobSystem::CloseGroup(group);
+            JobSystem::Wait(group);
+        }
+        phaseStart = phaseEnd;
     }
     this->remCallbacks();
     this->addCallbacks();
@@ -47,8 +98,20 @@ RunLoop::HasCallback(Id id) const {
 */
 RunLoop::Id
 RunLoop::Add(Func func) {
+    return this->Add(StringAtom(), DefaultPhase, Serial, func);
+}
+
+//------------------------------------------------------------------------------
+RunLoop::Id
+RunLoop::Add(const StringAtom& name, Func func) {
+    return this->Add(name, DefaultPhase, Serial, func);
+}
+
+//------------------------------------------------------------------------------
+RunLoop::Id
+RunLoop::Add(const StringAtom& name, int32 phase, Mode mode, Func func) {
     Id newId = ++this->curId;
-    this->toAdd.Add(newId, item{func, false});
+    this->toAdd.Add(newId, item{func, name, phase, mode, false});
     return newId;
 }
 
@@ -64,6 +127,16 @@ RunLoop::Remove(Id id) {
     this->toRemove.Add(id);
 }
 
+//------------------------------------------------------------------------------
+/**
+ NOTE: the timings of a callback are available until the next Run()
+ after the callback has been removed.
+*/
+const Array<RunLoop::Timing>&
+RunLoop::Timings() const {
+    return this->timings;
+}
+
 //------------------------------------------------------------------------------
 void
 RunLoop::addCallbacks() {
@@ -71,6 +144,7 @@ RunLoop::addCallbacks() {
         item& item = entry.Value();
         item.valid = true;
         this->callbacks.Add(entry.Key(), item);
+        this->scheduleDirty = true;
     }
     this->toAdd.Clear();
 }
@@ -81,6 +155,7 @@ RunLoop::remCallbacks() {
     for (Id id : this->toRemove) {
         if (this->callbacks.Contains(id)) {
             this->callbacks.Erase(id);
+            this->scheduleDirty = true;
         }
         else if (this->toAdd.Contains(id)) {
             this->toAdd.Erase(id);
@@ -89,4 +164,32 @@ RunLoop::remCallbacks() {
     this->toRemove.Clear();
 }
 
-} // namespace Oryol
\ No newline at end of file
+//------------------------------------------------------------------------------
+/**
+ The callbacks map is sorted by Id (which is the order of adding),
+ a stable sort by phase keeps this order within a phase. The schedule
+ points into the callbacks map, so it must be updated whenever the
+ map changes (this only happens at the start and end of Run()).
+*/
+void
+RunLoop::updateSchedule() {
+    this->timings.Clear();
+    for (const auto& entry : this->callbacks) {
+        Timing timing;
+        timing.Id = entry.Key();
+        timing.Name = entry.Value().name;
+        timing.Phase = entry.Value().phase;
+        timing.Mode = entry.Value().mode;
+        this->timings.Add(timing);
+    }
+    std::stable_sort(this->timings.begin(), this->timings.end(), [](const Timing& a, const Timing& b) {
+        return a.Phase < b.Phase;
+    });
+    this->schedule.Clear();
+    for (const Timing& timing : this->timings) {
+        this->schedule.Add(&this->callbacks[timing.Id].func);
+    }
+    this->scheduleDirty = false;
+}
+
+} // namespace Oryol
@@ -5,28 +5,43 @@
     @ingroup Core
     @brief universal run-loop object for on-frame callbacks
     
-    A runloop object manages a priority-sorted array of callback 
-    functions which are called per-frame. By default, each thread
-    has a RunLoop object which can be configured through the Core facade
-    singleton. Runloops can be nested by adding the Run() function
-    of one runloop to another runloop. NOTE that priority values are
-    inverted, lower values are called first).
-    
-    Examples for constructing callbacks:
-    
-    1. from C function myFunc():
+    A runloop object manages an array of callback functions which are
+    called per-frame. By default, each thread has a RunLoop object which
+    can be configured through the Core facade singleton. Runloops can be
+    nested by adding the Run() function of one runloop to another runloop.
 
-        Callback("name", pri, std::function<void()>(&myFunc);
-    2. from an object's method (careful, object must not go out-of-scope
-       as long as the callback is added to the RunLoop!
+    Callbacks are grouped into phases, all callbacks of a phase are
+    finished before the callbacks of the next phase are started (lower
+    phase values run first). Callbacks which are added as Parallel
+    run on the JobSystem worker threads concurrently with the other
+    callbacks of their phase (if the JobSystem has been setup with more
+    than one thread, otherwise they run on the calling thread like
+    Serial callbacks). Within a phase, all Parallel callbacks are
+    handed to the JobSystem first (in the order they were added), then
+    the Serial callbacks run on the calling thread in the order they
+    were added, so a Parallel callback may start before a Serial
+    callback which was added earlier. Without a multi-threaded
+    JobSystem, all callbacks of a phase run in the order they were
+    added. A Parallel callback must not touch state which
+    any other callback of its phase touches, must not depend on
+    thread-local data (like the FrameArena or the thread's RunLoops),
+    and must not add or remove runloop callbacks.
 
-        MyClass myObj;<br>
-        Callback("name", pri, std::function<void()>(&MyClass::MyMethod, &myObj));
+    The duration of each callback in the last Run() is recorded
+    together with the callback's name, see Timings().
+    
+    Examples for adding callbacks:
+    
+        runLoop->Add([] { ... });
+        runLoop->Add("IO", [] { ... });
+        runLoop->Add("Particles", RunLoop::DefaultPhase, RunLoop::Parallel, [] { ... });
 */
 #include <functional>
 #include "Core/RefCounted.h"
 #include "Core/String/StringAtom.h"
+#include "Core/Containers/Array.h"
 #include "Core/Containers/Map.h"
+#include "Core/Containers/Set.h"
 
 namespace Oryol {
 
@@ -39,6 +54,23 @@ public:
     static const Id InvalidId = 0;
     /// runloop function typedef
     typedef std::function<void()> Func;
+    /// the default callback phase
+    static const int32 DefaultPhase = 0;
+    /// how a callback is run in its phase
+    enum Mode {
+        /// run on the thread which calls Run()
+        Serial,
+        /// may run on a worker thread concurrently with the other callbacks of its phase
+        Parallel,
+    };
+    /// per-callback timing of the last Run()
+    struct Timing {
+        RunLoop::Id Id = InvalidId;
+        StringAtom Name;
+        int32 Phase = DefaultPhase;
+        RunLoop::Mode Mode = Serial;
+        float64 MilliSecs = 0.0;
+    };
 
     /// constructor
     RunLoop();
@@ -48,28 +80,44 @@ public:
     /// run one frame
     void Run();
     
-    /// add a callback to the run loop, higher priorities run earlier, slow!
+    /// add an unnamed Serial callback to the default phase, slow!
     Id Add(Func func);
+    /// add a named Serial callback to the default phase, slow!
+    Id Add(const StringAtom& name, Func func);
+    /// add a named callback to a phase, slow!
+    Id Add(const StringAtom& name, int32 phase, Mode mode, Func func);
     /// remove a callback, slow!
     void Remove(Id);
     /// test if a callback has been attached, slow!
     bool HasCallback(Id) const;
+    /// get callback timings of the last Run(), in execution order
+    const Array<Timing>& Timings() const;
     
 private:
     /// add new callbacks that have been added (called at beginning of Run())
     void addCallbacks();
     /// remove callbacks that have been removed (called at end of Run())
     void remCallbacks();
+    /// sort callbacks by phase into the schedule
+    void updateSchedule();
+    /// call a callback function and record its duration
+    static void runTimed(const Func* func, Timing* timing);
     
     struct item {
         Func func;
+        StringAtom name;
+        int32 phase;
+        Mode mode;
         bool valid;
     };
     
     Id curId;
+    bool scheduleDirty;
     Map<Id, item> callbacks;
     Map<Id, item> toAdd;
     Set<Id> toRemove;
+    Array<const Func*> schedule;
+    Array<Timing> timings;
 };
     
 } // namespace Oryol
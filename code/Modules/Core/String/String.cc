@@ -8,8 +8,6 @@
 
 namespace Oryol {
 
-const char* String::emptyString = "";
-
 //------------------------------------------------------------------------------
 String::String(const StringAtom& str) {
     const char* cstr = str.AsCStr();
@@ -22,16 +20,13 @@ String::String(const char* str) {
         this->create(str, int32(std::strlen(str)));
     }
     else {
-        this->data = nullptr;
-        this->strPtr = nullptr;
+        this->setEmpty();
     }
 }
 
 //------------------------------------------------------------------------------
-String::String() :
-data(nullptr),
-strPtr(nullptr) {
-    // empty
+String::String() {
+    this->setEmpty();
 }
 
 //------------------------------------------------------------------------------
@@ -89,26 +84,45 @@ String::AsStringAtom() const {
     return StringAtom(this->AsCStr());;
 }
 
+//------------------------------------------------------------------------------
+void
+String::setEmpty() {
+    this->inlineChars[0] = 0;
+    this->inlineChars[TagIndex] = 0;
+}
+
+//------------------------------------------------------------------------------
+bool
+String::isShared() const {
+    return SharedTag == uint8(this->inlineChars[TagIndex]);
+}
+
+//------------------------------------------------------------------------------
+bool
+String::isSameShared(const String& rhs) const {
+    return this->isShared() && rhs.isShared() && (this->shared.data == rhs.shared.data);
+}
+
 //------------------------------------------------------------------------------
 void
 String::destroy() {
-    o_assert(0 != this->data);
-    o_assert(0 == this->data->refCount);
-    this->data->~StringData();
-    Memory::Free(this->data);
-    this->data = nullptr;
-    this->strPtr = nullptr;
+    o_assert(this->isShared());
+    o_assert(0 == this->shared.data->refCount);
+    this->shared.data->~StringData();
+    Memory::Free(this->shared.data);
+    this->setEmpty();
 }
 
 //------------------------------------------------------------------------------
 void
 String::alloc(int32 len) {
-    o_assert(len > 0);
-    this->data = (StringData*) Memory::Alloc(sizeof(StringData) + len + 1);
-    new(this->data) StringData();
+    o_assert(len > MaxInlineLength);
+    this->shared.data = (StringData*) Memory::Alloc(sizeof(StringData) + len + 1, MemoryTag::String);
+    new(this->shared.data) StringData();
+    this->inlineChars[TagIndex] = char(SharedTag);
     this->addRef();
-    this->data->length = len;
-    this->strPtr = (const char*) &(this->data[1]);
+    this->shared.data->length = len;
+    this->shared.strPtr = (const char*) &(this->shared.data[1]);
 }
 
 //------------------------------------------------------------------------------
@@ -116,42 +130,59 @@ void
 String::create(const char* ptr, int32 len) {
     o_assert(0 != ptr);
     if ((ptr[0] != 0) && (len > 0)) {
-        this->alloc(len);
-        Memory::Copy(ptr, (void*)this->strPtr, len);
-        ((char*)this->strPtr)[len] = 0;
+        char* dst;
+        if (len <= MaxInlineLength) {
+            // short string, store inline
+            dst = this->inlineChars;
+            this->inlineChars[TagIndex] = char(len);
+        }
+        else {
+            this->alloc(len);
+            dst = (char*) this->shared.strPtr;
+        }
+        Memory::Copy(ptr, dst, len);
+        dst[len] = 0;
     }
     else {
         // empty string, don't bother to allocate storage for this
-        this->data = nullptr;
-        this->strPtr = nullptr;
+        this->setEmpty();
     }
 }
 
 //------------------------------------------------------------------------------
 void
 String::addRef() {
-    o_assert(nullptr != this->data);
+    o_assert(this->isShared());
     #if ORYOL_HAS_ATOMIC
-    this->data->refCount.fetch_add(1, std::memory_order_relaxed);
+    this->shared.data->refCount.fetch_add(1, std::memory_order_relaxed);
     #else
-    this->data->refCount++;
+    this->shared.data->refCount++;
     #endif
 }
 
 //------------------------------------------------------------------------------
 void
 String::release() {
-    if (nullptr != this->data) {
+    if (this->isShared()) {
         #if ORYOL_HAS_ATOMIC
-        if (1 == this->data->refCount.fetch_sub(1, std::memory_order_relaxed)) {
+        if (1 == this->shared.data->refCount.fetch_sub(1, std::memory_order_relaxed)) {
         #else
-        if (1 == this->data->refCount--) {
+        if (1 == this->shared.data->refCount--) {
         #endif
             // no more owners, destroy the shared string data
             this->destroy();
         }
-        this->data = nullptr;
-        this->strPtr = nullptr;
+    }
+    this->setEmpty();
+}
+
+//------------------------------------------------------------------------------
+void
+String::copy(const String& rhs) {
+    // this copies either the inline string, or the shared data pointer
+    Memory::Copy(rhs.inlineChars, this->inlineChars, InlineBufferSize);
+    if (this->isShared()) {
+        this->addRef();
     }
 }
 
@@ -162,30 +193,20 @@ String::release() {
  */
 void
 String::Assign(const String& rhs, int32 startIndex, int32 endIndex) {
-    this->release();
-    if (EndOfString == endIndex) {
-        endIndex = rhs.Length();
-    }
-    o_assert((startIndex >= 0) && (startIndex < endIndex));
-    o_assert(endIndex <= rhs.Length());
-    this->create(rhs.AsCStr() + startIndex, endIndex - startIndex);
+    // NOTE: rhs may be this string, so create the substring first
+    String subStr(rhs, startIndex, endIndex);
+    *this = std::move(subStr);
 }
     
 //------------------------------------------------------------------------------
 String::String(const String& rhs) {
-    this->data = rhs.data;
-    this->strPtr = rhs.strPtr;
-    if (nullptr != this->data) {
-        this->addRef();
-    }
+    this->copy(rhs);
 }
 
 //------------------------------------------------------------------------------
 String::String(String&& rhs) {
-    this->data = rhs.data;
-    this->strPtr = rhs.strPtr;
-    rhs.data = 0;
-    rhs.strPtr = 0;
+    Memory::Copy(rhs.inlineChars, this->inlineChars, InlineBufferSize);
+    rhs.setEmpty();
 }
 
 //------------------------------------------------------------------------------
@@ -207,11 +228,7 @@ void
 String::operator=(const String& rhs) {
     if (this != &rhs) {
         this->release();
-        this->data = rhs.data;
-        this->strPtr = rhs.strPtr;
-        if (nullptr != this->data) {
-            this->addRef();
-        }
+        this->copy(rhs);
     }
 }
 
@@ -220,22 +237,17 @@ void
 String::operator=(String&& rhs) {
     if (this != &rhs) {
         this->release();
-        this->data = rhs.data;
-        this->strPtr = rhs.strPtr;
-        rhs.data = 0;
-        rhs.strPtr = 0;
+        Memory::Copy(rhs.inlineChars, this->inlineChars, InlineBufferSize);
+        rhs.setEmpty();
     }
 }
 
 //------------------------------------------------------------------------------
 bool
 String::operator==(const String& rhs) const {
-    if (this->data == rhs.data) {
+    if (this->isSameShared(rhs)) {
         return true;
     }
-    else if ((nullptr == this->data) || (nullptr == rhs.data)) {
-        return false;
-    }
     else {
         return std::strcmp(this->AsCStr(), rhs.AsCStr()) == 0;
     }
@@ -250,7 +262,7 @@ String::operator!=(const String& rhs) const {
 //------------------------------------------------------------------------------
 bool
 String::operator<(const String& rhs) const {
-    if (this->data == rhs.data) {
+    if (this->isSameShared(rhs)) {
         return false;
     }
     else {
@@ -261,7 +273,7 @@ String::operator<(const String& rhs) const {
 //------------------------------------------------------------------------------
 bool
 String::operator>(const String& rhs) const {
-    if (this->data == rhs.data) {
+    if (this->isSameShared(rhs)) {
         return false;
     }
     else {
@@ -272,7 +284,7 @@ String::operator>(const String& rhs) const {
 //------------------------------------------------------------------------------
 bool
 String::operator<=(const String& rhs) const {
-    if (this->data == rhs.data) {
+    if (this->isSameShared(rhs)) {
         return true;
     }
     else {
@@ -283,7 +295,7 @@ String::operator<=(const String& rhs) const {
 //------------------------------------------------------------------------------
 bool
 String::operator>=(const String& rhs) const {
-    if (this->data == rhs.data) {
+    if (this->isSameShared(rhs)) {
         return true;
     }
     else {
@@ -294,22 +306,22 @@ String::operator>=(const String& rhs) const {
 //------------------------------------------------------------------------------
 int32
 String::Length() const {
-    if (nullptr == this->data) {
-        return 0;
+    if (this->isShared()) {
+        return this->shared.data->length;
     }
     else {
-        return this->data->length;
+        return int32(uint8(this->inlineChars[TagIndex]));
     }
 }
 
 //------------------------------------------------------------------------------
 const char*
 String::AsCStr() const {
-    if (nullptr == this->strPtr) {
-        return emptyString;
+    if (this->isShared()) {
+        return this->shared.strPtr;
     }
     else {
-        return this->strPtr;
+        return this->inlineChars;
     }
 }
 
@@ -334,19 +346,21 @@ String::Clear() {
 //------------------------------------------------------------------------------
 int32
 String::RefCount() const {
-    if (nullptr == this->data) {
-        return 0;
+    if (this->isShared()) {
+        return this->shared.data->refCount;
     }
     else {
-        return this->data->refCount;
+        // inline strings are never shared
+        return (0 != this->inlineChars[TagIndex]) ? 1 : 0;
     }
 }
 
 //------------------------------------------------------------------------------
 char
 String::Back() const {
-    if (this->strPtr) {
-        return this->strPtr[this->data->length - 1];
+    const int32 len = this->Length();
+    if (len > 0) {
+        return this->AsCStr()[len - 1];
     }
     else {
         return 0;
@@ -356,12 +370,7 @@ String::Back() const {
 //------------------------------------------------------------------------------
 char
 String::Front() const {
-    if (this->strPtr) {
-        return this->strPtr[0];
-    }
-    else {
-        return 0;
-    }
+    return this->AsCStr()[0];
 }
 
 //------------------------------------------------------------------------------
@@ -5,12 +5,15 @@
     @ingroup Core
     @brief immutable, reference counted, shared strings
     
-    An immutable, shared UTF-8 String class. Memory is only allocated
-    when creating or assigning from non-String objects (const char*,
-    StringAtoms). When assigning from another string,
-    only a pointer to the original string data is copied, and a 
-    refcount is maintained. The last String pointing to the string
-    data frees the string data.
+    An immutable, shared UTF-8 String class. Short strings (up to
+    MaxInlineLength bytes) are stored directly inside the String object,
+    creating, copying and destroying them never allocates memory and
+    never touches an atomic refcount. Longer strings live in a shared,
+    refcounted data block: memory is only allocated when creating or
+    assigning from non-String objects (const char*, StringAtoms). When
+    assigning from another string, only a pointer to the original
+    string data is copied, and a refcount is maintained. The last String
+    pointing to the string data frees the string data.
     
     To manipulate string data, use the StringUtil class.
     
@@ -27,6 +30,7 @@
 #include <atomic>
 #include "Core/Types.h"
 #include "Core/Assert.h"
+#include "Core/Traits.h"
 
 namespace Oryol {
 
@@ -96,8 +100,11 @@ public:
     bool Empty() const;
     /// clear content
     void Clear();
-    /// get the refcount of this string
+    /// get the refcount of this string (always 1 for non-empty inline strings)
     int32 RefCount() const;
+
+    /// max length of strings which are stored inline
+    static const int32 MaxInlineLength = 22;
     
 private:
     /// shared string data header, this is followed by the actual string
@@ -110,7 +117,7 @@ private:
         int32 length;
     };
     
-    /// create new string data block, numBytes does not include the terminating 0
+    /// create new string data (inline or shared), len does not include the terminating 0
     void create(const char* ptr, int32 len);
     /// private alloc function for len
     void alloc(int32 len);
@@ -120,10 +127,28 @@ private:
     void addRef();
     /// decrement refcount, call destroy if 0
     void release();
-    
-    StringData* data;
-    const char* strPtr;     // direct pointer to string data, necessary to see something in the debugger
-    static const char* emptyString;
+    /// copy content from other string, addRef shared data
+    void copy(const String& rhs);
+    /// set to empty inline string
+    void setEmpty();
+    /// return true if the string data is in a shared data block
+    bool isShared() const;
+    /// return true if both strings point to the same shared data block
+    bool isSameShared(const String& rhs) const;
+
+    static const int32 InlineBufferSize = MaxInlineLength + 2;
+    static const int32 TagIndex = InlineBufferSize - 1;
+    static const uint8 SharedTag = 0xFF;
+
+    // the last byte of inlineChars holds the length of an inline string,
+    // or SharedTag if the string data lives in a shared data block
+    union {
+        struct {
+            StringData* data;
+            const char* strPtr;     // direct pointer to string data, necessary to see something in the debugger
+        } shared;
+        char inlineChars[InlineBufferSize];
+    };
 };
 
 //------------------------------------------------------------------------------
@@ -152,5 +177,9 @@ bool operator>(const StringAtom& s0, const String& s1);
 bool operator<=(const StringAtom& s0, const String& s1);
 bool operator>=(const StringAtom& s0, const String& s1);
 
+/// a String holds inline characters or a pointer to shared data (never a pointer
+/// into itself), so it can be relocated with memcpy
+template<> struct IsTriviallyRelocatable<String> : std::true_type { };
+
 } // namespace Oryol
 
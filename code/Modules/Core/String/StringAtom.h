@@ -6,12 +6,22 @@
     @brief immutable, unique strings for fast comparison
     
     A unique string, relatively slow on creation, but fast for comparison.
-    String atoms are stored in thread-local stringAtomTables and comparison
-    is fastest in the creator thread.
+    String atoms are stored in a process-wide, thread-safe table, so
+    they are unique across all threads: copying and comparing string
+    atoms is a simple pointer operation, no matter which thread
+    created them.
+
+    To create a StringAtom from a string literal in hot code, use
+    ORYOL_ATOM("literal"): the string hash is computed at compile time,
+    and the string is only looked up in the atom table on first use,
+    after that the atom is returned from a static handle.
     
     @see String
 */
+#include <atomic>
+#include <type_traits>
 #include "Core/Types.h"
+#include "Core/Assert.h"
 #include "Core/String/stringAtomTable.h"
 
 namespace Oryol {
@@ -28,7 +38,7 @@ public:
     StringAtom(const char* str);
     /// construct from raw string (slow)
     StringAtom(const uchar* str);
-    /// copy-constructor (fast if rhs was created in same thread)
+    /// copy-constructor (fast)
     StringAtom(const StringAtom& rhs);
     /// move-constructor
     StringAtom(StringAtom&& rhs);
@@ -79,9 +89,12 @@ public:
     /// get String (slow because string object must be constructed)
     String AsString() const;
 
+    /// get atom for a string literal with precomputed hash through a static handle (see ORYOL_ATOM)
+    static StringAtom FromLiteral(std::atomic<const stringAtomBuffer::Header*>& handle, const char* str, int32 hash);
+
 private:
-    /// copy content
-    void copy(const StringAtom& rhs);
+    /// construct from atom table entry
+    explicit StringAtom(const stringAtomBuffer::Header* data);
     /// setup from C string
     void setupFromCString(const char* str);
     
@@ -116,14 +129,22 @@ StringAtom::StringAtom(const uchar* rhs) {
 
 //------------------------------------------------------------------------------
 inline
-StringAtom::StringAtom(const StringAtom& rhs) {
-    this->copy(rhs);
+StringAtom::StringAtom(const stringAtomBuffer::Header* data_) :
+data(data_) {
+    // empty
 }
 
 //------------------------------------------------------------------------------
 inline
-StringAtom::StringAtom(StringAtom&& rhs) {
-    this->copy(rhs);
+StringAtom::StringAtom(const StringAtom& rhs) :
+data(rhs.data) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+inline
+StringAtom::StringAtom(StringAtom&& rhs) :
+data(rhs.data) {
     rhs.data = nullptr;
 }
 
@@ -136,18 +157,14 @@ StringAtom::~StringAtom() {
 //------------------------------------------------------------------------------
 inline void
 StringAtom::operator=(const StringAtom& rhs) {
-    if (&rhs != this) {
-        this->Clear();
-        this->copy(rhs);
-    }
+    this->data = rhs.data;
 }
 
 //------------------------------------------------------------------------------
 inline void
 StringAtom::operator=(StringAtom&& rhs) {
     if (&rhs != this) {
-        this->Clear();
-        this->copy(rhs);
+        this->data = rhs.data;
         rhs.data = nullptr;
     }
 }
@@ -166,6 +183,12 @@ StringAtom::operator=(const uchar* rhs) {
     this->setupFromCString((const char*)rhs);
 }
 
+//------------------------------------------------------------------------------
+inline bool
+StringAtom::operator==(const StringAtom& rhs) const {
+    return this->data == rhs.data;
+}
+
 //------------------------------------------------------------------------------
 inline bool
 StringAtom::operator!=(const StringAtom& rhs) const {
@@ -175,10 +198,7 @@ StringAtom::operator!=(const StringAtom& rhs) const {
 //------------------------------------------------------------------------------
 inline bool
 StringAtom::operator<(const StringAtom& rhs) const {
-    if (rhs.data && this->data) {
-        // it is forbidden to compare string from different threads!
-        o_assert(this->data->table == rhs.data->table);
-    }
+    // NOTE: this is not a lexical order, but consistent across threads
     return this->data < rhs.data;
 }
 
@@ -228,4 +248,34 @@ StringAtom::AsCStr() const {
     }
 }
 
+//------------------------------------------------------------------------------
+inline StringAtom
+StringAtom::FromLiteral(std::atomic<const stringAtomBuffer::Header*>& handle, const char* str, int32 hash) {
+    const stringAtomBuffer::Header* data = handle.load(std::memory_order_acquire);
+    if ((nullptr == data) && (0 != str[0])) {
+        // first use, several threads may get here at the same time,
+        // but they will all find the same table entry
+        o_assert_dbg(stringAtomTable::HashForString(str) == hash);
+        data = stringAtomTable::Instance()->FindOrAdd(hash, str);
+        handle.store(data, std::memory_order_release);
+    }
+    return StringAtom(data);
+}
+
 } // namespace Oryol
+
+//------------------------------------------------------------------------------
+/**
+    @def ORYOL_ATOM
+    @ingroup Core
+    @brief get a StringAtom from a string literal
+
+    Hashes the literal at compile time, and keeps a static handle to
+    the atom table entry. Only the first use of an ORYOL_ATOM() at a
+    specific place in the code looks up the atom table (thread-safe),
+    later uses only load the handle.
+*/
+#define ORYOL_ATOM(str) ([]() -> Oryol::StringAtom { \
+    static std::atomic<const Oryol::stringAtomBuffer::Header*> handle(nullptr); \
+    return Oryol::StringAtom::FromLiteral(handle, str, std::integral_constant<Oryol::int32, Oryol::stringAtomTable::HashForLiteral(str)>::value); \
+}())
@@ -6,12 +6,7 @@
 #include <cstdio>
 #include "StringBuilder.h"
 #include "Core/Memory/Memory.h"
-
-#if ORYOL_WINDOWS
-#define o_strtok strtok_s
-#else
-#define o_strtok strtok_r
-#endif
+#include "Core/String/stringSearch.h"
 
 namespace Oryol {
     
@@ -47,6 +42,12 @@ StringBuilder() {
     this->Set(str, startIndex, endIndex);
 }
 
+//------------------------------------------------------------------------------
+StringBuilder::StringBuilder(const StringView& str) :
+StringBuilder() {
+    this->Set(str);
+}
+
 //------------------------------------------------------------------------------
 StringBuilder::StringBuilder(std::initializer_list<String> list) :
 StringBuilder() {
@@ -81,7 +82,7 @@ StringBuilder::ensureRoom(int32 numBytes) {
         // need to make room
         int32 growBy = (numBytes < minGrowSize) ? minGrowSize : numBytes;
         const int32 newCapacity = this->capacity + growBy;
-        char* newBuffer = (char*) Memory::Alloc(newCapacity);
+        char* newBuffer = (char*) Memory::Alloc(newCapacity, MemoryTag::String);
         if (this->buffer) {
             // copy over old content and free old buffer
             std::strcpy(newBuffer, this->buffer);
@@ -240,6 +241,25 @@ StringBuilder::Set(const String& str, int32 startIndex, int32 endIndex) {
     this->Append(str, startIndex, endIndex);
 }
 
+//------------------------------------------------------------------------------
+void
+StringBuilder::Append(const StringView& str) {
+    const int32 length = str.Length();
+    if (length > 0) {
+        this->ensureRoom(length);
+        std::memcpy(this->buffer + this->size, str.Ptr(), length);
+        this->size += length;
+        this->buffer[this->size] = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+StringBuilder::Set(const StringView& str) {
+    this->Clear();
+    this->Append(str);
+}
+
 //------------------------------------------------------------------------------
 void
 StringBuilder::Append(std::initializer_list<String> list) {
@@ -306,13 +326,14 @@ StringBuilder::PopBack() {
 
 //------------------------------------------------------------------------------
 void
-StringBuilder::substituteCommon(char* occur, int32 matchLen, int32 substLen, const char* subst) {
+StringBuilder::substituteCommon(int32 index, int32 matchLen, int32 substLen, const char* subst) {
     const int32 diff = substLen - matchLen;
     if (diff > 0) {
         this->ensureRoom(diff);
     }
     
-    // move tail in or out
+    // move tail in or out (NOTE: ensureRoom may have moved the buffer)
+    char* occur = this->buffer + index;
     const char* moveFrom = occur + matchLen;
     char* moveTo = occur + substLen;
     const int32 moveNumBytes = this->size - int32(moveFrom - this->buffer);
@@ -343,8 +364,7 @@ StringBuilder::SubstituteRange(int32 startIndex, int32 endIndex, const char* sub
     o_assert(endIndex <= this->size);
     const int32 matchLen = endIndex - startIndex;
     const int32 substLen = int32(std::strlen(subst));
-    char* occur = this->buffer + startIndex;
-    this->substituteCommon(occur, matchLen, substLen, subst);
+    this->substituteCommon(startIndex, matchLen, substLen, subst);
 }
 
 //------------------------------------------------------------------------------
@@ -355,11 +375,14 @@ StringBuilder::SubstituteAll(const char* match, const char* subst) {
 
     int32 numSubst = 0;
     if (nullptr != this->buffer) {
-        char* ptr = this->buffer;
         const int32 matchLen = int32(std::strlen(match));
         const int32 substLen = int32(std::strlen(subst));
-        while (nullptr != (ptr = std::strstr(ptr, match))) {
-            this->substituteCommon(ptr, matchLen, substLen, subst);
+        int32 pos = 0;
+        int32 index;
+        while (InvalidIndex != (index = stringSearch::FindSubString(this->buffer + pos, this->size - pos, match, matchLen))) {
+            // continue searching behind the substituted string
+            this->substituteCommon(pos + index, matchLen, substLen, subst);
+            pos += index + substLen;
             numSubst++;
         }
     }
@@ -379,11 +402,11 @@ StringBuilder::SubstituteFirst(const char* match, const char* subst) {
     o_assert(match[0] != 0);
     
     if (nullptr != this->buffer) {
-        char* occur = std::strstr(this->buffer, match);
-        if (nullptr != occur) {
-            const int32 matchLen = int32(std::strlen(match));
+        const int32 matchLen = int32(std::strlen(match));
+        const int32 index = stringSearch::FindSubString(this->buffer, this->size, match, matchLen);
+        if (InvalidIndex != index) {
             const int32 substLen = int32(std::strlen(subst));
-            this->substituteCommon(occur, matchLen, substLen, subst);
+            this->substituteCommon(index, matchLen, substLen, subst);
             return true;
         }
         else {
@@ -406,14 +429,14 @@ StringBuilder::SubstituteFirst(const String& match, const String& subst) {
 //------------------------------------------------------------------------------
 int32
 StringBuilder::findFirstOf(const char* str, int32 strLen, int32 startIndex, int32 endIndex, const char* delims) {
-    const char* ptr = str + startIndex;
-    const int index = (const int)std::strcspn(ptr, delims) + startIndex;
-    if (((endIndex != EndOfString) && (index >= endIndex)) || (index >= strLen)) {
-        return InvalidIndex;
+    if ((EndOfString == endIndex) || (endIndex > strLen)) {
+        endIndex = strLen;
     }
-    else {
-        return index;
+    if (startIndex >= endIndex) {
+        return InvalidIndex;
     }
+    const int32 index = stringSearch::FindFirstOf(str + startIndex, endIndex - startIndex, delims);
+    return (InvalidIndex != index) ? (index + startIndex) : InvalidIndex;
 }
 
 //------------------------------------------------------------------------------
@@ -454,14 +477,14 @@ StringBuilder::FindFirstOf(int32 startIndex, int32 endIndex, const char* delims)
 //------------------------------------------------------------------------------
 int32
 StringBuilder::findFirstNotOf(const char* str, int32 strLen, int32 startIndex, int32 endIndex, const char* delims) {
-    const char* ptr = str + startIndex;
-    int index = int32(std::strspn(ptr, delims)) + startIndex;
-    if (((EndOfString != endIndex) && (index >= endIndex)) || (index >= strLen)) {
-        return InvalidIndex;
+    if ((EndOfString == endIndex) || (endIndex > strLen)) {
+        endIndex = strLen;
     }
-    else {
-        return index;
+    if (startIndex >= endIndex) {
+        return InvalidIndex;
     }
+    const int32 index = stringSearch::FindFirstNotOf(str + startIndex, endIndex - startIndex, delims);
+    return (InvalidIndex != index) ? (index + startIndex) : InvalidIndex;
 }
 
 //------------------------------------------------------------------------------
@@ -474,9 +497,9 @@ int32
 StringBuilder::FindFirstNotOf(const char* str, int32 startIndex, int32 endIndex, const char* delims) {
     o_assert(0 != delims);
     o_assert(str);
-    o_assert((EndOfString != endIndex) || (endIndex >= startIndex));
+    o_assert((EndOfString == endIndex) || (endIndex >= startIndex));
     const int32 strLen = int32(std::strlen(str));
-    return findFirstOf(str, strLen, startIndex, endIndex, delims);
+    return findFirstNotOf(str, strLen, startIndex, endIndex, delims);
 }
 
 //------------------------------------------------------------------------------
@@ -501,21 +524,18 @@ StringBuilder::FindFirstNotOf(int32 startIndex, int32 endIndex, const char* deli
 
 //------------------------------------------------------------------------------
 int32
-StringBuilder::findSubString(const char* str, int32 startIndex, int32 endIndex, const char* subStr) {
-    const char* ptr = str + startIndex;
-    const char* occur = std::strstr(ptr, subStr);
-    if (nullptr == occur) {
+StringBuilder::findSubString(const char* str, int32 strLen, int32 startIndex, int32 endIndex, const char* subStr) {
+    // a match must start before endIndex, but may extend beyond it
+    const int32 subStrLen = int32(std::strlen(subStr));
+    int32 searchEnd = strLen;
+    if ((EndOfString != endIndex) && ((endIndex + subStrLen - 1) < strLen)) {
+        searchEnd = endIndex + subStrLen - 1;
+    }
+    if (startIndex > searchEnd) {
         return InvalidIndex;
     }
-    else {
-        int32 index = int32(occur - ptr) + startIndex;
-        if ((EndOfString != endIndex) && (index >= endIndex)) {
-            return InvalidIndex;
-        }
-        else {
-            return index;
-        }
-    }
+    const int32 index = stringSearch::FindSubString(str + startIndex, searchEnd - startIndex, subStr, subStrLen);
+    return (InvalidIndex != index) ? (index + startIndex) : InvalidIndex;
 }
 
 //------------------------------------------------------------------------------
@@ -527,8 +547,10 @@ StringBuilder::findSubString(const char* str, int32 startIndex, int32 endIndex,
 int32
 StringBuilder::FindSubString(const char* str, int32 startIndex, int32 endIndex, const char* subStr) {
     o_assert(0 != subStr);
+    o_assert(str);
     o_assert((EndOfString == endIndex) || (endIndex >= startIndex));
-    return findSubString(str, startIndex, endIndex, subStr);
+    const int32 strLen = int32(std::strlen(str));
+    return findSubString(str, strLen, startIndex, endIndex, subStr);
 }
     
 //------------------------------------------------------------------------------
@@ -543,7 +565,7 @@ StringBuilder::FindSubString(int32 startIndex, int32 endIndex, const char* subSt
     o_assert((EndOfString == endIndex) || (endIndex >= startIndex));
     if (nullptr != this->buffer) {
         o_assert(startIndex < this->size);
-        return findSubString(this->buffer, startIndex, endIndex, subStr);
+        return findSubString(this->buffer, this->size, startIndex, endIndex, subStr);
     }
     else {
         // no content
@@ -575,12 +597,21 @@ StringBuilder::Tokenize(const char* delims, Array<String>& outTokens) {
     
     outTokens.Clear();
     if (nullptr != this->buffer) {
-        char* ptr = this->buffer;
-        const char* token;
-        char* contextPtr = 0;
-        while (0 != (token = o_strtok(ptr, delims, &contextPtr))) {
-            outTokens.Add(token);
-            ptr = 0;
+        const char* ptr = this->buffer;
+        const char* end = ptr + this->size;
+        while (ptr < end) {
+            // skip delimiters, then find end of token
+            const int32 start = stringSearch::FindFirstNotOf(ptr, int32(end - ptr), delims);
+            if (InvalidIndex == start) {
+                break;
+            }
+            ptr += start;
+            int32 len = stringSearch::FindFirstOf(ptr, int32(end - ptr), delims);
+            if (InvalidIndex == len) {
+                len = int32(end - ptr);
+            }
+            outTokens.Add(String(ptr, 0, len));
+            ptr += len;
         }
     }
     this->Clear();
@@ -593,40 +624,36 @@ StringBuilder::Tokenize(const char* delims, Array<String>& outTokens) {
  */
 int32
 StringBuilder::Tokenize(const char* delims, char fence, Array<String>& outTokens) {
+    o_assert(nullptr != delims);
+
     outTokens.Clear();
     if (nullptr != this->buffer) {
-        char* ptr = this->buffer;
-        char* end = ptr + this->size;
-        while (ptr < end)
-        {
-            char* c;
-            
+        const char fenceStr[2] = { fence, 0 };
+        const char* ptr = this->buffer;
+        const char* end = ptr + this->size;
+        while (ptr < end) {
             // skip white space
-            while (*ptr && std::strchr(delims, *ptr))
-            {
+            const int32 start = stringSearch::FindFirstNotOf(ptr, int32(end - ptr), delims);
+            if (InvalidIndex == start) {
+                break;
+            }
+            ptr += start;
+            
+            // check for fenced area (an unterminated fence char is skipped)
+            int32 len = InvalidIndex;
+            if (fence == *ptr) {
                 ptr++;
+                len = stringSearch::FindFirstOf(ptr, int32(end - ptr), fenceStr);
             }
-            if (*ptr)
-            {
-                // check for fenced area
-                if ((fence == *ptr) && (0 != (c = std::strchr(++ptr, fence))))
-                {
-                    *c++ = 0;
-                    outTokens.Add(ptr);
-                    ptr = c;
-                }
-                else if (0 != (c = std::strpbrk(ptr, delims)))
-                {
-                    *c++ = 0;
-                    outTokens.Add(ptr);
-                    ptr = c;
-                }
-                else
-                {
-                    outTokens.Add(ptr);
-                    break;
+            if (InvalidIndex == len) {
+                len = stringSearch::FindFirstOf(ptr, int32(end - ptr), delims);
+                if (InvalidIndex == len) {
+                    len = int32(end - ptr);
                 }
             }
+            // NOTE: an empty fenced area results in an empty token
+            outTokens.Add((len > 0) ? String(ptr, 0, len) : String());
+            ptr += len + 1;
         }
     }
     this->Clear();
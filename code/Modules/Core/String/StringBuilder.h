@@ -11,6 +11,8 @@
 */
 #include "Core/Types.h"
 #include "Core/String/String.h"
+#include "Core/String/StringView.h"
+#include "Core/String/StringConverter.h"
 #include "Core/Containers/Array.h"
 
 namespace Oryol {
@@ -27,6 +29,8 @@ public:
     StringBuilder(const String& str);
     /// initialize from range of string, endIndex can be EndOfString
     StringBuilder(const String& str, int32 startIndex, int32 endIndex);
+    /// initialize from string view
+    StringBuilder(const StringView& str);
     /// initialize from an initializer list of strings
     StringBuilder(std::initializer_list<String> list);
     /// initialize from a list of strings with delimiters
@@ -66,6 +70,8 @@ public:
     void Set(const String& str);
     /// (re)set to range from string, endIndex can be EndOfString
     void Set(const String& str, int32 startIndex, int32 endIndex);
+    /// set content from string view
+    void Set(const StringView& str);
     /// (re)set to a list of strings
     void Set(std::initializer_list<String> list);
     /// (re)set to a list of strings with delimiter
@@ -81,10 +87,14 @@ public:
     void Append(const String& str);
     /// append range from string, if endIndex can be EndOfString
     void Append(const String& str, int32 startIndex, int32 endIndex);
+    /// append string view
+    void Append(const StringView& str);
     /// append a list of strings
     void Append(std::initializer_list<String> list);
     /// append a list of strings with delimiter
     void Append(char delim, std::initializer_list<String> list);
+    /// append an integer or float number (doesn't allocate if there's room)
+    template<class TYPE> void AppendNumber(TYPE val);
     
     /// substitute all occurances of a string, return number of substitutions
     int32 SubstituteAll(const char* match, const char* subst);
@@ -137,13 +147,13 @@ private:
     /// make sure that at least numBytes are available at end of string buffer 
     void ensureRoom(int32 numBytes);
     /// helper function for Substitute methods
-    void substituteCommon(char* occur, int32 matchLen, int32 substLen, const char* subst);
+    void substituteCommon(int32 index, int32 matchLen, int32 substLen, const char* subst);
     /// helper function for FindFirstOf functions
     static int32 findFirstOf(const char* str, int32 strLen, int32 startIndex, int32 endIndex, const char* delims);
     /// helper function for FindFirstNotOf functions
     static int32 findFirstNotOf(const char* str, int32 strLen, int32 startIndex, int32 endIndex, const char* delims);
     /// helper function for FindSubString functions
-    static int32 findSubString(const char* str, int32 startIndex, int32 endIndex, const char* subStr);
+    static int32 findSubString(const char* str, int32 strLen, int32 startIndex, int32 endIndex, const char* subStr);
     /// internal formatting method
     bool format(int32 maxLength, bool append, const char* fmt, va_list args);
     
@@ -153,4 +163,11 @@ private:
     int32 size;
 };
     
+//------------------------------------------------------------------------------
+template<class TYPE> void
+StringBuilder::AppendNumber(TYPE val) {
+    this->ensureRoom(StringConverter::MaxNumberChars);
+    this->size += StringConverter::ToChars(val, this->buffer + this->size, StringConverter::MaxNumberChars);
+}
+
 } // namespace Oryol
@@ -4,10 +4,12 @@
 #include "Pre.h"
 #include "Core/Assert.h"
 #include "StringConverter.h"
-#include "Ext/ConvertUTF/ConvertUTF.h"
+#include "Core/String/numberConverter.h"
+#include "Core/String/utfConverter.h"
 #include <cstdlib>
 #include <cstring>
 #include <cwchar>
+#include <limits>
 
 namespace Oryol {
 
@@ -34,7 +36,7 @@ StringConverter::UTF8ToWide(const unsigned char* src, int32 srcNumBytes, wchar_t
     o_assert(dstEndPtr > dst);
     if (sizeof(wchar_t) == 4) {
         UTF32* dstPtr = (UTF32*)dst;
-        convRes = ConvertUTF8toUTF32(&srcPtr, src + srcNumBytes, &dstPtr, (UTF32*) dstEndPtr, strictConversion);
+        convRes = utfConverter::UTF8ToUTF32(&srcPtr, src + srcNumBytes, &dstPtr, (UTF32*) dstEndPtr);
         o_assert(dstPtr < (UTF32*) (dst + (dstMaxBytes / sizeof(wchar_t))));
         *dstPtr = 0;
         if (conversionOK == convRes) {
@@ -44,7 +46,7 @@ StringConverter::UTF8ToWide(const unsigned char* src, int32 srcNumBytes, wchar_t
     else {
         o_assert(2 == sizeof(wchar_t));
         UTF16* dstPtr = (UTF16*) dst;
-        convRes = ConvertUTF8toUTF16(&srcPtr, src + srcNumBytes, &dstPtr, (UTF16*) dstEndPtr, strictConversion);
+        convRes = utfConverter::UTF8ToUTF16(&srcPtr, src + srcNumBytes, &dstPtr, (UTF16*) dstEndPtr);
         o_assert(dstPtr < (UTF16*) (dst + (dstMaxBytes / sizeof(wchar_t))));
         *dstPtr = 0;
         if (conversionOK == convRes) {
@@ -73,7 +75,7 @@ StringConverter::WideToUTF8(const wchar_t* src, int32 srcNumChars, unsigned char
         o_assert(4 == sizeof(wchar_t));
         const UTF32* srcPtr = (const UTF32*) src;
         const UTF32* srcEndPtr = (UTF32*) src + srcNumChars;
-        convRes = ConvertUTF32toUTF8(&srcPtr, srcEndPtr, &dstPtr, dstEnd, strictConversion);
+        convRes = utfConverter::UTF32ToUTF8(&srcPtr, srcEndPtr, &dstPtr, dstEnd);
         o_assert(dstPtr < (dst + dstMaxBytes));
         *dstPtr = 0;
         if (conversionOK == convRes) {
@@ -84,7 +86,7 @@ StringConverter::WideToUTF8(const wchar_t* src, int32 srcNumChars, unsigned char
         o_assert(2 == sizeof(wchar_t));
         const UTF16* srcPtr = (UTF16*) src;
         const UTF16* srcEndPtr = (UTF16*) src + srcNumChars;
-        convRes = ConvertUTF16toUTF8(&srcPtr, srcEndPtr, &dstPtr, dstEnd, strictConversion);
+        convRes = utfConverter::UTF16ToUTF8(&srcPtr, srcEndPtr, &dstPtr, dstEnd);
         o_assert(dstPtr < (dst + dstMaxBytes));
         *dstPtr = 0;
         if (conversionOK == convRes) {
@@ -112,7 +114,7 @@ StringConverter::WideToUTF8(const wchar_t* wide, int32 numWideChars) {
         }
         else {
             int32 dstBufSize = (numWideChars * MaxUTF8Size) + 1;
-            unsigned char* dstBuf = (unsigned char*) Memory::Alloc(dstBufSize);
+            unsigned char* dstBuf = (unsigned char*) Memory::Alloc(dstBufSize, MemoryTag::String);
             if (0 < StringConverter::WideToUTF8(wide, numWideChars, dstBuf, dstBufSize)) {
                 converted = (char*) dstBuf;
             }
@@ -156,7 +158,7 @@ StringConverter::UTF8ToWide(const unsigned char* src, int32 srcNumBytes) {
         else {
             // use buffer 
             int32 bufferSize = (srcNumBytes + 1) * sizeof(wchar_t);
-            wchar_t* dstBuf = (wchar_t*) Memory::Alloc(bufferSize);
+            wchar_t* dstBuf = (wchar_t*) Memory::Alloc(bufferSize, MemoryTag::String);
             bool success = (0 < StringConverter::UTF8ToWide(src, srcNumBytes, dstBuf, bufferSize));
             if (success) {
                 result = dstBuf;
@@ -181,46 +183,313 @@ StringConverter::UTF8ToWide(const String& src) {
     return UTF8ToWide((uchar*)src.AsCStr(), src.Length());
 }
 
+//------------------------------------------------------------------------------
+/**
+ Format a number into a temporary buffer if the destination buffer
+ might be too small.
+*/
+template<class TYPE, class FUNC> static int32
+formatNumber(TYPE val, char* buf, int32 bufSize, FUNC func) {
+    o_assert((nullptr != buf) && (bufSize > 0));
+    if (bufSize >= StringConverter::MaxNumberChars) {
+        return func(val, buf);
+    }
+    char tmp[StringConverter::MaxNumberChars];
+    const int32 len = func(val, tmp);
+    if (len < bufSize) {
+        std::memcpy(buf, tmp, len + 1);
+        return len;
+    }
+    else {
+        buf[0] = 0;
+        return 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<> int32
+StringConverter::ToChars(int8 val, char* buf, int32 bufSize) {
+    return formatNumber<int64>(val, buf, bufSize, numberConverter::FormatInt);
+}
+
+//------------------------------------------------------------------------------
+template<> int32
+StringConverter::ToChars(uint8 val, char* buf, int32 bufSize) {
+    return formatNumber<uint64>(val, buf, bufSize, numberConverter::FormatUInt);
+}
+
+//------------------------------------------------------------------------------
+template<> int32
+StringConverter::ToChars(int16 val, char* buf, int32 bufSize) {
+    return formatNumber<int64>(val, buf, bufSize, numberConverter::FormatInt);
+}
+
+//------------------------------------------------------------------------------
+template<> int32
+StringConverter::ToChars(uint16 val, char* buf, int32 bufSize) {
+    return formatNumber<uint64>(val, buf, bufSize, numberConverter::FormatUInt);
+}
+
+//------------------------------------------------------------------------------
+template<> int32
+StringConverter::ToChars(int32 val, char* buf, int32 bufSize) {
+    return formatNumber<int64>(val, buf, bufSize, numberConverter::FormatInt);
+}
+
+//------------------------------------------------------------------------------
+template<> int32
+StringConverter::ToChars(uint32 val, char* buf, int32 bufSize) {
+    return formatNumber<uint64>(val, buf, bufSize, numberConverter::FormatUInt);
+}
+
+//------------------------------------------------------------------------------
+template<> int32
+StringConverter::ToChars(int64 val, char* buf, int32 bufSize) {
+    return formatNumber<int64>(val, buf, bufSize, numberConverter::FormatInt);
+}
+
+//------------------------------------------------------------------------------
+template<> int32
+StringConverter::ToChars(uint64 val, char* buf, int32 bufSize) {
+    return formatNumber<uint64>(val, buf, bufSize, numberConverter::FormatUInt);
+}
+
+//------------------------------------------------------------------------------
+template<> int32
+StringConverter::ToChars(float32 val, char* buf, int32 bufSize) {
+    return formatNumber<float32>(val, buf, bufSize, numberConverter::FormatFloat32);
+}
+
+//------------------------------------------------------------------------------
+template<> int32
+StringConverter::ToChars(float64 val, char* buf, int32 bufSize) {
+    return formatNumber<float64>(val, buf, bufSize, numberConverter::FormatFloat64);
+}
+
+//------------------------------------------------------------------------------
+/**
+ Parse an integer through the 64-bit parsers, and check the range
+ of the result type.
+*/
+template<class TYPE, class WIDETYPE, class FUNC> static int32
+parseInteger(const char* str, int32 len, TYPE& outVal, FUNC func) {
+    o_assert(nullptr != str);
+    WIDETYPE val;
+    const int32 numChars = func(str, len, val);
+    if ((0 == numChars) || (val < WIDETYPE(std::numeric_limits<TYPE>::min())) || (val > WIDETYPE(std::numeric_limits<TYPE>::max()))) {
+        return 0;
+    }
+    outVal = TYPE(val);
+    return numChars;
+}
+
+//------------------------------------------------------------------------------
+template<> int32
+StringConverter::FromChars(const char* str, int32 len, int8& outVal) {
+    return parseInteger<int8, int64>(str, len, outVal, numberConverter::ParseInt);
+}
+
+//------------------------------------------------------------------------------
+template<> int32
+StringConverter::FromChars(const char* str, int32 len, uint8& outVal) {
+    return parseInteger<uint8, uint64>(str, len, outVal, numberConverter::ParseUInt);
+}
+
+//------------------------------------------------------------------------------
+template<> int32
+StringConverter::FromChars(const char* str, int32 len, int16& outVal) {
+    return parseInteger<int16, int64>(str, len, outVal, numberConverter::ParseInt);
+}
+
+//------------------------------------------------------------------------------
+template<> int32
+StringConverter::FromChars(const char* str, int32 len, uint16& outVal) {
+    return parseInteger<uint16, uint64>(str, len, outVal, numberConverter::ParseUInt);
+}
+
+//------------------------------------------------------------------------------
+template<> int32
+StringConverter::FromChars(const char* str, int32 len, int32& outVal) {
+    return parseInteger<int32, int64>(str, len, outVal, numberConverter::ParseInt);
+}
+
+//------------------------------------------------------------------------------
+template<> int32
+StringConverter::FromChars(const char* str, int32 len, uint32& outVal) {
+    return parseInteger<uint32, uint64>(str, len, outVal, numberConverter::ParseUInt);
+}
+
+//------------------------------------------------------------------------------
+template<> int32
+StringConverter::FromChars(const char* str, int32 len, int64& outVal) {
+    return parseInteger<int64, int64>(str, len, outVal, numberConverter::ParseInt);
+}
+
+//------------------------------------------------------------------------------
+template<> int32
+StringConverter::FromChars(const char* str, int32 len, uint64& outVal) {
+    return parseInteger<uint64, uint64>(str, len, outVal, numberConverter::ParseUInt);
+}
+
+//------------------------------------------------------------------------------
+template<> int32
+StringConverter::FromChars(const char* str, int32 len, float32& outVal) {
+    o_assert(nullptr != str);
+    return numberConverter::ParseFloat32(str, len, outVal);
+}
+
+//------------------------------------------------------------------------------
+template<> int32
+StringConverter::FromChars(const char* str, int32 len, float64& outVal) {
+    o_assert(nullptr != str);
+    return numberConverter::ParseFloat64(str, len, outVal);
+}
+
+//------------------------------------------------------------------------------
+/**
+ Convert a number to a String object through ToChars().
+*/
+template<class TYPE> static String
+numberToString(TYPE val) {
+    char buf[StringConverter::MaxNumberChars];
+    StringConverter::ToChars(val, buf, sizeof(buf));
+    return String(buf);
+}
+
+//------------------------------------------------------------------------------
+template<> String
+StringConverter::ToString(const int8& val) {
+    return numberToString(val);
+}
+
+//------------------------------------------------------------------------------
+template<> String
+StringConverter::ToString(const uint8& val) {
+    return numberToString(val);
+}
+
+//------------------------------------------------------------------------------
+template<> String
+StringConverter::ToString(const int16& val) {
+    return numberToString(val);
+}
+
+//------------------------------------------------------------------------------
+template<> String
+StringConverter::ToString(const uint16& val) {
+    return numberToString(val);
+}
+
+//------------------------------------------------------------------------------
+template<> String
+StringConverter::ToString(const int32& val) {
+    return numberToString(val);
+}
+
+//------------------------------------------------------------------------------
+template<> String
+StringConverter::ToString(const uint32& val) {
+    return numberToString(val);
+}
+
+//------------------------------------------------------------------------------
+template<> String
+StringConverter::ToString(const int64& val) {
+    return numberToString(val);
+}
+
+//------------------------------------------------------------------------------
+template<> String
+StringConverter::ToString(const uint64& val) {
+    return numberToString(val);
+}
+
+//------------------------------------------------------------------------------
+template<> String
+StringConverter::ToString(const float32& val) {
+    return numberToString(val);
+}
+
+//------------------------------------------------------------------------------
+template<> String
+StringConverter::ToString(const float64& val) {
+    return numberToString(val);
+}
+
+//------------------------------------------------------------------------------
+/**
+ Parse a number from a String object through FromChars(), leading
+ white space is skipped, returns 0 if parsing fails.
+*/
+template<class TYPE> static TYPE
+numberFromString(const String& str) {
+    const char* ptr = str.AsCStr();
+    while ((' ' == *ptr) || ('\t' == *ptr)) {
+        ptr++;
+    }
+    TYPE val = 0;
+    StringConverter::FromChars(ptr, int32(str.Length() - (ptr - str.AsCStr())), val);
+    return val;
+}
+
 //------------------------------------------------------------------------------
 template<> int8
 StringConverter::FromString(const String& str) {
-    return (int8) std::atoi(str.AsCStr());
+    return numberFromString<int8>(str);
 }
 
 //------------------------------------------------------------------------------
 template<> uint8
 StringConverter::FromString(const String& str) {
-    return (uint8) std::atoi(str.AsCStr());
+    return numberFromString<uint8>(str);
 }
 
 //------------------------------------------------------------------------------
 template<> int16
 StringConverter::FromString(const String& str) {
-    return (int16) std::atoi(str.AsCStr());
+    return numberFromString<int16>(str);
 }
 
 //------------------------------------------------------------------------------
 template<> uint16
 StringConverter::FromString(const String& str) {
-    return (uint16) std::atoi(str.AsCStr());
+    return numberFromString<uint16>(str);
 }
 
 //------------------------------------------------------------------------------
 template<> int32
 StringConverter::FromString(const String& str) {
-    return (int32) std::atoi(str.AsCStr());
+    return numberFromString<int32>(str);
 }
 
 //------------------------------------------------------------------------------
 template<> uint32
 StringConverter::FromString(const String& str) {
-    return (int32) std::atoi(str.AsCStr());
+    return numberFromString<uint32>(str);
+}
+
+//------------------------------------------------------------------------------
+template<> int64
+StringConverter::FromString(const String& str) {
+    return numberFromString<int64>(str);
+}
+
+//------------------------------------------------------------------------------
+template<> uint64
+StringConverter::FromString(const String& str) {
+    return numberFromString<uint64>(str);
 }
 
 //------------------------------------------------------------------------------
 template<> float32
 StringConverter::FromString(const String& str) {
-    return (float32) std::atof(str.AsCStr());
+    return numberFromString<float32>(str);
+}
+
+//------------------------------------------------------------------------------
+template<> float64
+StringConverter::FromString(const String& str) {
+    return numberFromString<float64>(str);
 }
 
 } // namespace Oryol
@@ -8,6 +8,12 @@
     and from and to simple types (int, float, ...). Please note that
     wchar_t is 2 bytes (UTF-16) on Windows, but 4 bytes (UTF-32) 
     on other UNIX-like platforms!
+
+    The number conversions don't allocate and don't depend on the
+    locale. Floats are written with the shortest representation which
+    parses back to the same value, and parsed with correct rounding.
+    ToChars() and FromChars() work directly on char buffers, use
+    StringBuilder::AppendNumber() to append numbers to a StringBuilder.
 */
 #include "Core/Types.h"
 #include "Core/Containers/Array.h"
@@ -22,6 +28,12 @@ public:
     template<class TYPE> static String ToString(const TYPE& val);
     /// convert a string to simple type
     template<class TYPE> static TYPE FromString(const String& str);
+    /// max number of chars written by ToChars() (including the 0-terminator)
+    static const int32 MaxNumberChars = 32;
+    /// write a number into a buffer, return length (excluding 0-terminator), 0 if buffer too small
+    template<class TYPE> static int32 ToChars(TYPE val, char* buf, int32 bufSize);
+    /// parse a number from a char range, return number of consumed chars, 0 on failure or overflow (outVal untouched)
+    template<class TYPE> static int32 FromChars(const char* str, int32 len, TYPE& outVal);
     
     /// convert raw UTF8 string range to raw wide string
     static int32 UTF8ToWide(const unsigned char* src, int32 srcNumBytes, wchar_t* dst, int32 dstMaxBytes);
@@ -0,0 +1,66 @@
+//------------------------------------------------------------------------------
+//  StringView.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "StringView.h"
+#include "Core/String/stringSearch.h"
+
+namespace Oryol {
+
+//------------------------------------------------------------------------------
+int32
+StringView::FindFirstOf(int32 startIndex, int32 endIndex, const char* delims) const {
+    o_assert_dbg(nullptr != delims);
+    if ((EndOfString == endIndex) || (endIndex > this->len)) {
+        endIndex = this->len;
+    }
+    if (startIndex >= endIndex) {
+        return EndOfString;
+    }
+    const int32 index = stringSearch::FindFirstOf(this->ptr + startIndex, endIndex - startIndex, delims);
+    return (InvalidIndex != index) ? (index + startIndex) : EndOfString;
+}
+
+//------------------------------------------------------------------------------
+int32
+StringView::FindSubString(int32 startIndex, int32 endIndex, const StringView& subString) const {
+    if ((EndOfString == endIndex) || (endIndex > this->len)) {
+        endIndex = this->len;
+    }
+    if ((startIndex >= endIndex) || subString.Empty()) {
+        return EndOfString;
+    }
+    const int32 index = stringSearch::FindSubString(this->ptr + startIndex, endIndex - startIndex, subString.ptr, subString.len);
+    return (InvalidIndex != index) ? (index + startIndex) : EndOfString;
+}
+
+//------------------------------------------------------------------------------
+int32
+StringView::Compare(const StringView& rhs) const {
+    // same order as strcmp() for strings without embedded 0-bytes
+    const int32 minLen = this->len < rhs.len ? this->len : rhs.len;
+    const int res = std::memcmp(this->ptr, rhs.ptr, minLen);
+    if (0 != res) {
+        return res;
+    }
+    return this->len - rhs.len;
+}
+
+//------------------------------------------------------------------------------
+String
+StringView::AsString() const {
+    if (this->len > 0) {
+        return String(this->ptr, 0, this->len);
+    }
+    else {
+        return String();
+    }
+}
+
+//------------------------------------------------------------------------------
+StringAtom
+StringView::AsStringAtom() const {
+    return StringAtom(this->AsString());
+}
+
+} // namespace Oryol
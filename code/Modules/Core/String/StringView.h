@@ -0,0 +1,245 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::StringView
+    @ingroup Core
+    @brief non-owning view into a range of string data
+
+    A StringView is just a pointer and a length, it doesn't own the
+    string data, never allocates memory, and is cheap to create, copy
+    and compare. The viewed data doesn't need to be 0-terminated, so
+    don't call C string functions on Ptr(). The viewer must make sure
+    that the viewed data outlives the view (StringAtom data lives until
+    the end of the program, so views into StringAtoms are always valid).
+
+    A StringView can be implicitly created from a C string or a String,
+    and explicitly from a StringAtom. It can be used to look up
+    String keys in a Map or HashMap without creating a temporary String.
+
+    @see String, StringAtom, StringBuilder
+*/
+#include <cstring>
+#include "Core/Types.h"
+#include "Core/Assert.h"
+#include "Core/String/String.h"
+#include "Core/String/StringAtom.h"
+
+namespace Oryol {
+
+class StringView {
+public:
+    /// default constructor, empty view
+    StringView();
+    /// construct from C string
+    StringView(const char* cstr);
+    /// construct from pointer and length in bytes
+    StringView(const char* ptr, int32 len);
+    /// construct from String
+    StringView(const String& str);
+    /// construct from StringAtom
+    explicit StringView(const StringAtom& atom);
+
+    /// get pointer to string data (NOT 0-terminated!)
+    const char* Ptr() const;
+    /// get length in number of bytes
+    int32 Length() const;
+    /// return true if the view is empty
+    bool Empty() const;
+    /// return true if the view is not empty
+    bool IsValid() const;
+    /// get character at index
+    char operator[](int32 index) const;
+    /// get the first character
+    char Front() const;
+    /// get the last character
+    char Back() const;
+
+    /// get a view of a range, endIndex can be EndOfString
+    StringView SubView(int32 startIndex, int32 endIndex) const;
+    /// find byte-index of first occurrence of delim chars, endIndex can be EndOfString, return EndOfString if not found
+    int32 FindFirstOf(int32 startIndex, int32 endIndex, const char* delims) const;
+    /// find substring index, endIndex can be EndOfString, return EndOfString if not found
+    int32 FindSubString(int32 startIndex, int32 endIndex, const StringView& subString) const;
+    /// test if the view starts with a prefix
+    bool StartsWith(const StringView& prefix) const;
+    /// test if the view ends with a suffix
+    bool EndsWith(const StringView& suffix) const;
+    /// lexical comparison, returns <0, 0 or >0 (same order as String)
+    int32 Compare(const StringView& rhs) const;
+
+    /// create a String from the view (may allocate)
+    String AsString() const;
+    /// create a StringAtom from the view (slow)
+    StringAtom AsStringAtom() const;
+
+private:
+    const char* ptr;
+    int32 len;
+};
+
+//------------------------------------------------------------------------------
+inline
+StringView::StringView() :
+ptr(""),
+len(0) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+inline
+StringView::StringView(const char* cstr) :
+ptr(cstr ? cstr : ""),
+len(cstr ? int32(std::strlen(cstr)) : 0) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+inline
+StringView::StringView(const char* ptr_, int32 len_) :
+ptr(ptr_),
+len(len_) {
+    o_assert_dbg((nullptr != ptr_) && (len_ >= 0));
+}
+
+//------------------------------------------------------------------------------
+inline
+StringView::StringView(const String& str) :
+ptr(str.AsCStr()),
+len(str.Length()) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+inline
+StringView::StringView(const StringAtom& atom) :
+ptr(atom.AsCStr()),
+len(atom.Length()) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+inline const char*
+StringView::Ptr() const {
+    return this->ptr;
+}
+
+//------------------------------------------------------------------------------
+inline int32
+StringView::Length() const {
+    return this->len;
+}
+
+//------------------------------------------------------------------------------
+inline bool
+StringView::Empty() const {
+    return 0 == this->len;
+}
+
+//------------------------------------------------------------------------------
+inline bool
+StringView::IsValid() const {
+    return 0 != this->len;
+}
+
+//------------------------------------------------------------------------------
+inline char
+StringView::operator[](int32 index) const {
+    o_assert_range_dbg(index, this->len);
+    return this->ptr[index];
+}
+
+//------------------------------------------------------------------------------
+inline char
+StringView::Front() const {
+    o_assert_dbg(this->len > 0);
+    return this->ptr[0];
+}
+
+//------------------------------------------------------------------------------
+inline char
+StringView::Back() const {
+    o_assert_dbg(this->len > 0);
+    return this->ptr[this->len - 1];
+}
+
+//------------------------------------------------------------------------------
+inline StringView
+StringView::SubView(int32 startIndex, int32 endIndex) const {
+    if (EndOfString == endIndex) {
+        endIndex = this->len;
+    }
+    o_assert_dbg((startIndex >= 0) && (startIndex <= endIndex) && (endIndex <= this->len));
+    return StringView(this->ptr + startIndex, endIndex - startIndex);
+}
+
+//------------------------------------------------------------------------------
+inline bool
+StringView::StartsWith(const StringView& prefix) const {
+    return (prefix.len <= this->len) && (0 == std::memcmp(this->ptr, prefix.ptr, prefix.len));
+}
+
+//------------------------------------------------------------------------------
+inline bool
+StringView::EndsWith(const StringView& suffix) const {
+    return (suffix.len <= this->len) && (0 == std::memcmp(this->ptr + this->len - suffix.len, suffix.ptr, suffix.len));
+}
+
+//------------------------------------------------------------------------------
+inline bool operator==(const StringView& s0, const StringView& s1) {
+    return (s0.Length() == s1.Length()) && (0 == std::memcmp(s0.Ptr(), s1.Ptr(), s0.Length()));
+}
+inline bool operator!=(const StringView& s0, const StringView& s1) {
+    return !(s0 == s1);
+}
+inline bool operator<(const StringView& s0, const StringView& s1) {
+    return s0.Compare(s1) < 0;
+}
+inline bool operator>(const StringView& s0, const StringView& s1) {
+    return s0.Compare(s1) > 0;
+}
+inline bool operator<=(const StringView& s0, const StringView& s1) {
+    return s0.Compare(s1) <= 0;
+}
+inline bool operator>=(const StringView& s0, const StringView& s1) {
+    return s0.Compare(s1) >= 0;
+}
+// NOTE: the following overloads are needed to resolve ambiguities, since
+// C strings and Strings are also implicitly convertible to StringAtom
+inline bool operator==(const StringView& s0, const char* s1) {
+    return s0 == StringView(s1);
+}
+inline bool operator!=(const StringView& s0, const char* s1) {
+    return s0 != StringView(s1);
+}
+inline bool operator==(const char* s0, const StringView& s1) {
+    return StringView(s0) == s1;
+}
+inline bool operator!=(const char* s0, const StringView& s1) {
+    return StringView(s0) != s1;
+}
+inline bool operator==(const StringView& s0, const String& s1) {
+    return s0 == StringView(s1);
+}
+inline bool operator!=(const StringView& s0, const String& s1) {
+    return s0 != StringView(s1);
+}
+inline bool operator==(const String& s0, const StringView& s1) {
+    return StringView(s0) == s1;
+}
+inline bool operator!=(const String& s0, const StringView& s1) {
+    return StringView(s0) != s1;
+}
+inline bool operator==(const StringView& s0, const StringAtom& s1) {
+    return s0 == StringView(s1);
+}
+inline bool operator!=(const StringView& s0, const StringAtom& s1) {
+    return s0 != StringView(s1);
+}
+inline bool operator==(const StringAtom& s0, const StringView& s1) {
+    return StringView(s0) == s1;
+}
+inline bool operator!=(const StringAtom& s0, const StringView& s1) {
+    return StringView(s0) != s1;
+}
+
+} // namespace Oryol
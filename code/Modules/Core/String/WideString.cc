@@ -26,7 +26,7 @@ void
 WideString::create(const wchar_t* ptr, int32 numChars) {
     o_assert(0 != ptr);
     if ((ptr[0] != 0) && (numChars > 0)) {
-        this->data = (StringData*) Memory::Alloc(sizeof(StringData) + ((numChars + 1) * sizeof(wchar_t)));
+        this->data = (StringData*) Memory::Alloc(sizeof(StringData) + ((numChars + 1) * sizeof(wchar_t)), MemoryTag::String);
         new(this->data) StringData();
         this->addRef();
         this->data->length = numChars;
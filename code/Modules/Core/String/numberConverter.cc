@@ -0,0 +1,1013 @@
+//------------------------------------------------------------------------------
+//  numberConverter.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include <cstring>
+#include <cmath>
+#include "numberConverter.h"
+#include "Core/Assert.h"
+
+namespace Oryol {
+
+static const char digitPairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static const uint32 pow10u32[10] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+static const float64 pow10f64[23] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static const float32 pow10f32[11] = {
+    1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
+
+//------------------------------------------------------------------------------
+/**
+ A minimal fixed-size unsigned big integer, only used for the exact
+ (slow) paths of float formatting and parsing. 4096 bits are enough
+ for all intermediate values of 64-bit float conversion.
+*/
+struct bigNum {
+    static const int32 MaxBlocks = 128;
+    int32 num;
+    uint32 blocks[MaxBlocks];
+
+    /// set to a 64-bit value
+    void set(uint64 val) {
+        this->num = 0;
+        while (val) {
+            this->blocks[this->num++] = uint32(val);
+            val >>= 32;
+        }
+    }
+    /// copy the used blocks from other big number
+    void assign(const bigNum& rhs) {
+        this->num = rhs.num;
+        for (int32 i = 0; i < rhs.num; i++) {
+            this->blocks[i] = rhs.blocks[i];
+        }
+    }
+    /// multiply with a 32-bit value
+    void mulSmall(uint32 f) {
+        uint64 carry = 0;
+        for (int32 i = 0; i < this->num; i++) {
+            const uint64 p = uint64(this->blocks[i]) * f + carry;
+            this->blocks[i] = uint32(p);
+            carry = p >> 32;
+        }
+        if (carry) {
+            o_assert_dbg(this->num < MaxBlocks);
+            this->blocks[this->num++] = uint32(carry);
+        }
+    }
+    /// add a 32-bit value
+    void addSmall(uint32 val) {
+        uint64 carry = val;
+        for (int32 i = 0; carry && (i < this->num); i++) {
+            const uint64 sum = uint64(this->blocks[i]) + carry;
+            this->blocks[i] = uint32(sum);
+            carry = sum >> 32;
+        }
+        if (carry) {
+            o_assert_dbg(this->num < MaxBlocks);
+            this->blocks[this->num++] = uint32(carry);
+        }
+    }
+    /// multiply with a power of 10
+    void mulPow10(int32 exp) {
+        while (exp >= 9) {
+            this->mulSmall(pow10u32[9]);
+            exp -= 9;
+        }
+        if (exp > 0) {
+            this->mulSmall(pow10u32[exp]);
+        }
+    }
+    /// multiply with a power of 2
+    void shiftLeft(int32 bits) {
+        if (0 == this->num) {
+            return;
+        }
+        const int32 blockShift = bits / 32;
+        const int32 bitShift = bits % 32;
+        int32 newNum = this->num + blockShift;
+        o_assert_dbg((newNum + 1) <= MaxBlocks);
+        if (bitShift) {
+            const uint32 top = this->blocks[this->num - 1] >> (32 - bitShift);
+            for (int32 i = this->num - 1; i > 0; i--) {
+                this->blocks[i + blockShift] = (this->blocks[i] << bitShift) | (this->blocks[i - 1] >> (32 - bitShift));
+            }
+            this->blocks[blockShift] = this->blocks[0] << bitShift;
+            if (top) {
+                this->blocks[newNum++] = top;
+            }
+        }
+        else {
+            for (int32 i = this->num - 1; i >= 0; i--) {
+                this->blocks[i + blockShift] = this->blocks[i];
+            }
+        }
+        for (int32 i = 0; i < blockShift; i++) {
+            this->blocks[i] = 0;
+        }
+        this->num = newNum;
+    }
+    /// add other big number
+    void add(const bigNum& rhs) {
+        const int32 n = (this->num > rhs.num) ? this->num : rhs.num;
+        uint64 carry = 0;
+        for (int32 i = 0; i < n; i++) {
+            const uint64 sum = carry +
+                ((i < this->num) ? this->blocks[i] : 0) +
+                ((i < rhs.num) ? rhs.blocks[i] : 0);
+            this->blocks[i] = uint32(sum);
+            carry = sum >> 32;
+        }
+        this->num = n;
+        if (carry) {
+            o_assert_dbg(this->num < MaxBlocks);
+            this->blocks[this->num++] = uint32(carry);
+        }
+    }
+    /// subtract other big number, which must not be greater
+    void sub(const bigNum& rhs) {
+        uint64 borrow = 0;
+        for (int32 i = 0; i < this->num; i++) {
+            const uint64 diff = uint64(this->blocks[i]) - ((i < rhs.num) ? rhs.blocks[i] : 0) - borrow;
+            this->blocks[i] = uint32(diff);
+            borrow = diff >> 63;
+        }
+        o_assert_dbg(0 == borrow);
+        while ((this->num > 0) && (0 == this->blocks[this->num - 1])) {
+            this->num--;
+        }
+    }
+    /// divide by other big number (quotient must be < 10), keep remainder, return quotient
+    int32 divDigit(const bigNum& rhs) {
+        int32 d = 0;
+        while (compare(*this, rhs) >= 0) {
+            this->sub(rhs);
+            d++;
+        }
+        return d;
+    }
+    /// compare 2 big numbers, return <0, 0 or >0
+    static int32 compare(const bigNum& a, const bigNum& b) {
+        if (a.num != b.num) {
+            return (a.num < b.num) ? -1 : 1;
+        }
+        for (int32 i = a.num - 1; i >= 0; i--) {
+            if (a.blocks[i] != b.blocks[i]) {
+                return (a.blocks[i] < b.blocks[i]) ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+};
+
+//------------------------------------------------------------------------------
+/**
+ Same interface as bigNum, but on a native unsigned integer, used when
+ all intermediate values are known to fit.
+*/
+template<class TYPE> struct smallNum {
+    TYPE val;
+
+    void set(uint64 v) {
+        this->val = v;
+    }
+    void assign(const smallNum& rhs) {
+        this->val = rhs.val;
+    }
+    void mulSmall(uint32 f) {
+        this->val *= f;
+    }
+    void mulPow10(int32 exp) {
+        for (; exp > 0; exp--) {
+            this->val *= 10;
+        }
+    }
+    void shiftLeft(int32 bits) {
+        this->val <<= bits;
+    }
+    void add(const smallNum& rhs) {
+        this->val += rhs.val;
+    }
+    void sub(const smallNum& rhs) {
+        this->val -= rhs.val;
+    }
+    int32 divDigit(const smallNum& rhs) {
+        const TYPE d = this->val / rhs.val;
+        this->val -= d * rhs.val;
+        return int32(d);
+    }
+    static int32 compare(const smallNum& a, const smallNum& b) {
+        return (a.val < b.val) ? -1 : ((a.val > b.val) ? 1 : 0);
+    }
+};
+
+//------------------------------------------------------------------------------
+/**
+ Describes the binary layout of a float type. Finite values are
+ represented as m * 2^e, with m < 2^(mantBits+1), and e between
+ minExp and maxExp, normalized values have the hidden bit set.
+*/
+struct floatDesc {
+    int32 mantBits;
+    int32 minExp;
+    int32 maxExp;
+    int32 minDecExp;    // values below 10^minDecExp round to zero
+    int32 maxDecExp;    // values at or above 10^maxDecExp round to infinity
+};
+static const floatDesc float32Desc = { 23, -149, 104, -46, 39 };
+static const floatDesc float64Desc = { 52, -1074, 971, -324, 309 };
+
+//------------------------------------------------------------------------------
+static int32
+bitLength(uint64 val) {
+    int32 len = 0;
+    while (val) {
+        val >>= 1;
+        len++;
+    }
+    return len;
+}
+
+//------------------------------------------------------------------------------
+static int32
+formatDigits(uint64 val, char* buf) {
+    char tmp[20];
+    char* p = tmp + sizeof(tmp);
+    while (val >= 100) {
+        const uint32 index = uint32(val % 100) * 2;
+        val /= 100;
+        p -= 2;
+        p[0] = digitPairs[index];
+        p[1] = digitPairs[index + 1];
+    }
+    if (val >= 10) {
+        const uint32 index = uint32(val) * 2;
+        p -= 2;
+        p[0] = digitPairs[index];
+        p[1] = digitPairs[index + 1];
+    }
+    else {
+        *--p = char('0' + val);
+    }
+    const int32 len = int32((tmp + sizeof(tmp)) - p);
+    std::memcpy(buf, p, len);
+    return len;
+}
+
+//------------------------------------------------------------------------------
+int32
+numberConverter::FormatUInt(uint64 val, char* buf) {
+    o_assert_dbg(buf);
+    const int32 len = formatDigits(val, buf);
+    buf[len] = 0;
+    return len;
+}
+
+//------------------------------------------------------------------------------
+int32
+numberConverter::FormatInt(int64 val, char* buf) {
+    o_assert_dbg(buf);
+    if (val < 0) {
+        buf[0] = '-';
+        const int32 len = formatDigits(uint64(0) - uint64(val), buf + 1) + 1;
+        buf[len] = 0;
+        return len;
+    }
+    else {
+        return FormatUInt(uint64(val), buf);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+ Estimate the decimal exponent k of m * 2^e (so that the value is in
+ [10^(k-1), 10^k)), this is either exact or one too small.
+*/
+static int32
+estimateDecimalExp(uint64 m, int32 e) {
+    return int32(std::ceil((e + bitLength(m) - 1) * 0.30102999566398114 - 1e-10));
+}
+
+//------------------------------------------------------------------------------
+/**
+ Get an upper bound for the number of bits needed by the digit generation.
+*/
+static int32
+requiredBits(uint64 m, int32 e, int32 k) {
+    int32 rBits = bitLength(m) + ((e > 0) ? e : 0) + 2;
+    int32 sBits = ((e < 0) ? -e : 0) + 3;
+    // log2(10) < 3.33
+    const int32 pow10Bits = (((k < 0) ? -k : k) * 333 + 99) / 100;
+    if (k >= 0) {
+        sBits += pow10Bits;
+    }
+    else {
+        rBits += pow10Bits;
+    }
+    // headroom for the fixup and the multiplications by 10
+    return ((rBits > sBits) ? rBits : sBits) + 5;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Generate the shortest digit sequence which uniquely identifies the
+ value m * 2^e. The value is 0.d1d2...dn * 10^outK. NUM is either
+ a native integer wrapper or bigNum, depending on the required bits.
+*/
+template<class NUM> static int32
+shortestDigits(uint64 m, int32 e, bool lowerCloser, int32 k, char* digits, int32& outK) {
+    o_assert_dbg(m > 0);
+
+    // r/s is the value, mp/s and mm/s are the distances to the
+    // halfway points to the neighbouring values
+    NUM r, s, mp, mm, tmp;
+    r.set(m);
+    if (e >= 0) {
+        if (!lowerCloser) {
+            r.shiftLeft(e + 1);
+            s.set(2);
+            mp.set(1);
+            mp.shiftLeft(e);
+            mm.assign(mp);
+        }
+        else {
+            r.shiftLeft(e + 2);
+            s.set(4);
+            mp.set(1);
+            mp.shiftLeft(e + 1);
+            mm.set(1);
+            mm.shiftLeft(e);
+        }
+    }
+    else {
+        if (!lowerCloser) {
+            r.shiftLeft(1);
+            s.set(1);
+            s.shiftLeft(1 - e);
+            mp.set(1);
+            mm.set(1);
+        }
+        else {
+            r.shiftLeft(2);
+            s.set(1);
+            s.shiftLeft(2 - e);
+            mp.set(2);
+            mm.set(1);
+        }
+    }
+
+    // scale by the estimated decimal exponent
+    if (k >= 0) {
+        s.mulPow10(k);
+    }
+    else {
+        r.mulPow10(-k);
+        mp.mulPow10(-k);
+        mm.mulPow10(-k);
+    }
+    // if the value is round-to-even, the halfway points belong to it
+    const bool even = 0 == (m & 1);
+    tmp.assign(r);
+    tmp.add(mp);
+    const int32 fixup = NUM::compare(tmp, s);
+    if (even ? (fixup >= 0) : (fixup > 0)) {
+        s.mulSmall(10);
+        k++;
+    }
+
+    // generate digits until the remaining value is within the rounding interval
+    int32 n = 0;
+    for (;;) {
+        r.mulSmall(10);
+        mp.mulSmall(10);
+        mm.mulSmall(10);
+        int32 d = r.divDigit(s);
+        const int32 cl = NUM::compare(r, mm);
+        const bool low = even ? (cl <= 0) : (cl < 0);
+        tmp.assign(r);
+        tmp.add(mp);
+        const int32 ch = NUM::compare(tmp, s);
+        const bool high = even ? (ch >= 0) : (ch > 0);
+        if (!low && !high) {
+            digits[n++] = char('0' + d);
+            continue;
+        }
+        if (low && high) {
+            // both neighbours roundtrip, pick the closer one
+            tmp.assign(r);
+            tmp.shiftLeft(1);
+            if (NUM::compare(tmp, s) >= 0) {
+                d++;
+            }
+        }
+        else if (high) {
+            d++;
+        }
+        o_assert_dbg(d <= 9);
+        digits[n++] = char('0' + d);
+        break;
+    }
+    outK = k;
+    return n;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Write digits 0.d1d2...dn * 10^k in ECMAScript Number-to-String notation.
+*/
+static int32
+writeDecimal(bool neg, const char* digits, int32 n, int32 k, char* buf) {
+    char* p = buf;
+    if (neg) {
+        *p++ = '-';
+    }
+    if ((n <= k) && (k <= 21)) {
+        // integer
+        std::memcpy(p, digits, n);
+        p += n;
+        for (int32 i = n; i < k; i++) {
+            *p++ = '0';
+        }
+    }
+    else if ((0 < k) && (k <= 21)) {
+        // decimal point within digits
+        std::memcpy(p, digits, k);
+        p += k;
+        *p++ = '.';
+        std::memcpy(p, digits + k, n - k);
+        p += n - k;
+    }
+    else if ((-6 < k) && (k <= 0)) {
+        // leading zeros
+        *p++ = '0';
+        *p++ = '.';
+        for (int32 i = k; i < 0; i++) {
+            *p++ = '0';
+        }
+        std::memcpy(p, digits, n);
+        p += n;
+    }
+    else {
+        // scientific notation
+        *p++ = digits[0];
+        if (n > 1) {
+            *p++ = '.';
+            std::memcpy(p, digits + 1, n - 1);
+            p += n - 1;
+        }
+        *p++ = 'e';
+        const int32 exp = k - 1;
+        *p++ = (exp < 0) ? '-' : '+';
+        p += formatDigits(uint64((exp < 0) ? -exp : exp), p);
+    }
+    *p = 0;
+    return int32(p - buf);
+}
+
+//------------------------------------------------------------------------------
+static int32
+writeSpecial(bool neg, const char* str, char* buf) {
+    char* p = buf;
+    if (neg) {
+        *p++ = '-';
+    }
+    const int32 len = int32(std::strlen(str));
+    std::memcpy(p, str, len + 1);
+    return int32(p - buf) + len;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Common float formatting for a decomposed float value.
+*/
+static int32
+formatFloat(bool neg, uint32 expField, uint64 frac, uint32 maxExpField, const floatDesc& desc, char* buf) {
+    if (expField == maxExpField) {
+        return writeSpecial(neg && (0 == frac), (0 == frac) ? "inf" : "nan", buf);
+    }
+    if ((0 == expField) && (0 == frac)) {
+        return writeSpecial(neg, "0", buf);
+    }
+    uint64 m;
+    int32 e;
+    bool lowerCloser;
+    if (0 == expField) {
+        // denormalized
+        m = frac;
+        e = desc.minExp;
+        lowerCloser = false;
+    }
+    else {
+        m = frac | (uint64(1) << desc.mantBits);
+        e = int32(expField) - 1 + desc.minExp;
+        lowerCloser = (0 == frac) && (expField > 1);
+    }
+
+    // fast path for integers which are exactly representable
+    if ((e <= 0) && (e > -desc.mantBits - 1)) {
+        const uint64 intMask = (uint64(1) << -e) - 1;
+        if (0 == (m & intMask)) {
+            char* p = buf;
+            if (neg) {
+                *p++ = '-';
+            }
+            const int32 len = formatDigits(m >> -e, p);
+            p[len] = 0;
+            return int32(p - buf) + len;
+        }
+    }
+    char digits[24];
+    int32 k = estimateDecimalExp(m, e);
+    const int32 bits = requiredBits(m, e, k);
+    int32 n;
+    if (bits <= 64) {
+        n = shortestDigits<smallNum<uint64>>(m, e, lowerCloser, k, digits, k);
+    }
+    #if defined(__SIZEOF_INT128__)
+    else if (bits <= 128) {
+        n = shortestDigits<smallNum<unsigned __int128>>(m, e, lowerCloser, k, digits, k);
+    }
+    #endif
+    else {
+        n = shortestDigits<bigNum>(m, e, lowerCloser, k, digits, k);
+    }
+    return writeDecimal(neg, digits, n, k, buf);
+}
+
+//------------------------------------------------------------------------------
+int32
+numberConverter::FormatFloat32(float32 val, char* buf) {
+    o_assert_dbg(buf);
+    uint32 bits;
+    std::memcpy(&bits, &val, sizeof(bits));
+    return formatFloat(0 != (bits >> 31), (bits >> 23) & 0xFF, bits & 0x7FFFFF, 0xFF, float32Desc, buf);
+}
+
+//------------------------------------------------------------------------------
+int32
+numberConverter::FormatFloat64(float64 val, char* buf) {
+    o_assert_dbg(buf);
+    uint64 bits;
+    std::memcpy(&bits, &val, sizeof(bits));
+    const uint64 fracMask = (uint64(1) << 52) - 1;
+    return formatFloat(0 != (bits >> 63), uint32(bits >> 52) & 0x7FF, bits & fracMask, 0x7FF, float64Desc, buf);
+}
+
+//------------------------------------------------------------------------------
+static inline bool
+isDigit(char c) {
+    return (c >= '0') && (c <= '9');
+}
+
+//------------------------------------------------------------------------------
+/**
+ Parse unsigned digits into a 64-bit value, fails on overflow.
+*/
+static int32
+parseDigits(const char* str, int32 len, uint64& outVal) {
+    const uint64 maxVal = ~uint64(0);
+    uint64 val = 0;
+    int32 i = 0;
+    for (; (i < len) && isDigit(str[i]); i++) {
+        const uint64 d = uint64(str[i] - '0');
+        if (val > ((maxVal - d) / 10)) {
+            return 0;
+        }
+        val = val * 10 + d;
+    }
+    outVal = val;
+    return i;
+}
+
+//------------------------------------------------------------------------------
+int32
+numberConverter::ParseUInt(const char* str, int32 len, uint64& outVal) {
+    o_assert_dbg(str && (len >= 0));
+    int32 i = 0;
+    if ((i < len) && ('+' == str[i])) {
+        i++;
+    }
+    uint64 val;
+    const int32 numDigits = parseDigits(str + i, len - i, val);
+    if (0 == numDigits) {
+        return 0;
+    }
+    outVal = val;
+    return i + numDigits;
+}
+
+//------------------------------------------------------------------------------
+int32
+numberConverter::ParseInt(const char* str, int32 len, int64& outVal) {
+    o_assert_dbg(str && (len >= 0));
+    int32 i = 0;
+    bool neg = false;
+    if ((i < len) && (('+' == str[i]) || ('-' == str[i]))) {
+        neg = '-' == str[i];
+        i++;
+    }
+    uint64 mag;
+    const int32 numDigits = parseDigits(str + i, len - i, mag);
+    if (0 == numDigits) {
+        return 0;
+    }
+    const uint64 maxMag = neg ? (uint64(1) << 63) : ((uint64(1) << 63) - 1);
+    if (mag > maxMag) {
+        return 0;
+    }
+    outVal = neg ? int64(uint64(0) - mag) : int64(mag);
+    return i + numDigits;
+}
+
+//------------------------------------------------------------------------------
+/**
+ The result of scanning a float string, the value is digits * 10^exp10.
+*/
+struct floatScan {
+    static const int32 MaxDigits = 800;
+    bool neg = false;
+    bool isInf = false;
+    bool isNaN = false;
+    bool truncated = false;     // non-zero digits after MaxDigits were dropped
+    int32 numDigits = 0;
+    int32 exp10 = 0;
+    uint64 mant = 0;            // value of the first 19 digits
+    char digits[MaxDigits];
+};
+
+//------------------------------------------------------------------------------
+static bool
+matchNoCase(const char* str, int32 len, const char* lowerStr) {
+    const int32 matchLen = int32(std::strlen(lowerStr));
+    if (len < matchLen) {
+        return false;
+    }
+    for (int32 i = 0; i < matchLen; i++) {
+        if ((str[i] | 0x20) != lowerStr[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Scan a float string into its decimal digits and exponent, return
+ number of consumed chars, or 0 if the string doesn't start with a number.
+*/
+static int32
+scanFloat(const char* str, int32 len, floatScan& scan) {
+    int32 i = 0;
+    if ((i < len) && (('+' == str[i]) || ('-' == str[i]))) {
+        scan.neg = '-' == str[i];
+        i++;
+    }
+    const char c = (i < len) ? (str[i] | 0x20) : 0;
+    if (('i' == c) && matchNoCase(str + i, len - i, "inf")) {
+        scan.isInf = true;
+        i += 3;
+        if (matchNoCase(str + i, len - i, "inity")) {
+            i += 5;
+        }
+        return i;
+    }
+    if (('n' == c) && matchNoCase(str + i, len - i, "nan")) {
+        scan.isNaN = true;
+        return i + 3;
+    }
+
+    // integer and fraction digits, leading zeros are skipped
+    bool anyDigits = false;
+    for (; (i < len) && isDigit(str[i]); i++) {
+        anyDigits = true;
+        if ((0 == scan.numDigits) && ('0' == str[i])) {
+            continue;
+        }
+        if (scan.numDigits < floatScan::MaxDigits) {
+            if (scan.numDigits < 19) {
+                scan.mant = scan.mant * 10 + uint64(str[i] - '0');
+            }
+            scan.digits[scan.numDigits++] = str[i];
+        }
+        else {
+            scan.truncated |= '0' != str[i];
+            scan.exp10++;
+        }
+    }
+    if ((i < len) && ('.' == str[i])) {
+        i++;
+        for (; (i < len) && isDigit(str[i]); i++) {
+            anyDigits = true;
+            if ((0 == scan.numDigits) && ('0' == str[i])) {
+                scan.exp10--;
+            }
+            else if (scan.numDigits < floatScan::MaxDigits) {
+                if (scan.numDigits < 19) {
+                    scan.mant = scan.mant * 10 + uint64(str[i] - '0');
+                }
+                scan.digits[scan.numDigits++] = str[i];
+                scan.exp10--;
+            }
+            else {
+                scan.truncated |= '0' != str[i];
+            }
+        }
+    }
+    if (!anyDigits) {
+        return 0;
+    }
+
+    // optional exponent, only consumed if followed by digits
+    if ((i < len) && ('e' == (str[i] | 0x20))) {
+        int32 j = i + 1;
+        bool expNeg = false;
+        if ((j < len) && (('+' == str[j]) || ('-' == str[j]))) {
+            expNeg = '-' == str[j];
+            j++;
+        }
+        if ((j < len) && isDigit(str[j])) {
+            int32 exp = 0;
+            for (; (j < len) && isDigit(str[j]); j++) {
+                if (exp < 100000) {
+                    exp = exp * 10 + (str[j] - '0');
+                }
+            }
+            scan.exp10 += expNeg ? -exp : exp;
+            i = j;
+        }
+    }
+
+    // strip trailing zeros
+    while ((scan.numDigits > 0) && ('0' == scan.digits[scan.numDigits - 1])) {
+        if (scan.numDigits <= 19) {
+            scan.mant /= 10;
+        }
+        scan.numDigits--;
+        scan.exp10++;
+    }
+    return i;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Compare digits * 10^exp10 against h * 2^g.
+*/
+static int32
+compareExact(const bigNum& digits, int32 exp10, uint64 h, int32 g) {
+    bigNum x, y;
+    x.assign(digits);
+    y.set(h);
+    if (exp10 >= 0) {
+        x.mulPow10(exp10);
+    }
+    else {
+        y.mulPow10(-exp10);
+    }
+    if (g >= 0) {
+        y.shiftLeft(g);
+    }
+    else {
+        x.shiftLeft(-g);
+    }
+    return bigNum::compare(x, y);
+}
+
+//------------------------------------------------------------------------------
+/**
+ Compute the correctly rounded m * 2^e for a scanned decimal number,
+ starting at an approximation, return false on overflow.
+*/
+static bool
+roundExact(const floatScan& scan, float64 approx, const floatDesc& desc, uint64& outM, int32& outE) {
+    const uint64 hidden = uint64(1) << desc.mantBits;
+
+    // the exact decimal value, dropped digits are represented by
+    // an extra non-zero digit, which can't move the value across
+    // a halfway point (those have less than MaxDigits digits)
+    bigNum digits;
+    digits.set(0);
+    int32 exp10 = scan.exp10;
+    for (int32 i = 0; i < scan.numDigits; i += 9) {
+        const int32 chunkLen = ((scan.numDigits - i) < 9) ? (scan.numDigits - i) : 9;
+        uint32 chunk = 0;
+        for (int32 j = 0; j < chunkLen; j++) {
+            chunk = chunk * 10 + uint32(scan.digits[i + j] - '0');
+        }
+        if (digits.num > 0) {
+            digits.mulSmall(pow10u32[chunkLen]);
+        }
+        digits.addSmall(chunk);
+    }
+    if (scan.truncated) {
+        digits.mulSmall(10);
+        digits.addSmall(1);
+        exp10--;
+    }
+
+    // decompose the approximation
+    uint64 m = 0;
+    int32 e = desc.minExp;
+    if (std::isinf(approx)) {
+        m = (hidden << 1) - 1;
+        e = desc.maxExp;
+    }
+    else if (approx > 0.0) {
+        int32 binExp = 0;
+        const float64 frac = std::frexp(approx, &binExp);
+        m = uint64(std::ldexp(frac, desc.mantBits + 1));
+        e = binExp - (desc.mantBits + 1);
+        if (e < desc.minExp) {
+            const int32 shift = desc.minExp - e;
+            m = (shift < 64) ? (m >> shift) : 0;
+            e = desc.minExp;
+        }
+        else if (e > desc.maxExp) {
+            m = (hidden << 1) - 1;
+            e = desc.maxExp;
+        }
+    }
+
+    // walk to the correctly rounded neighbour
+    for (;;) {
+        // compare with the halfway point to the next value
+        int32 c = compareExact(digits, exp10, 2 * m + 1, e - 1);
+        if ((c > 0) || ((0 == c) && (m & 1))) {
+            m++;
+            if (m == (hidden << 1)) {
+                m = hidden;
+                e++;
+                if (e > desc.maxExp) {
+                    return false;
+                }
+            }
+            if (c == 0) {
+                break;
+            }
+            continue;
+        }
+        if (0 == m) {
+            break;
+        }
+        // compare with the halfway point to the previous value, which is
+        // closer if m is a power of 2
+        const bool lowerCloser = (m == hidden) && (e > desc.minExp);
+        if (lowerCloser) {
+            c = compareExact(digits, exp10, 4 * m - 1, e - 2);
+        }
+        else {
+            c = compareExact(digits, exp10, 2 * m - 1, e - 1);
+        }
+        if ((c < 0) || ((0 == c) && (m & 1))) {
+            if (lowerCloser) {
+                m = (hidden << 1) - 1;
+                e--;
+            }
+            else {
+                m--;
+            }
+            if (c == 0) {
+                break;
+            }
+            continue;
+        }
+        break;
+    }
+    outM = m;
+    outE = e;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Approximate digits * 10^exp10 with 64-bit floats (used as starting
+ point for the exact rounding).
+*/
+static float64
+approxFloat(const floatScan& scan) {
+    const int32 num = (scan.numDigits < 19) ? scan.numDigits : 19;
+    float64 val = float64(scan.mant);
+    int32 exp = scan.exp10 + (scan.numDigits - num);
+    while (exp > 22) {
+        val *= pow10f64[22];
+        exp -= 22;
+    }
+    while (exp < -22) {
+        val /= pow10f64[22];
+        exp += 22;
+    }
+    return (exp >= 0) ? (val * pow10f64[exp]) : (val / pow10f64[-exp]);
+}
+
+//------------------------------------------------------------------------------
+int32
+numberConverter::ParseFloat64(const char* str, int32 len, float64& outVal) {
+    o_assert_dbg(str && (len >= 0));
+    floatScan scan;
+    const int32 numChars = scanFloat(str, len, scan);
+    if (0 == numChars) {
+        return 0;
+    }
+    float64 val;
+    const int32 decExp = scan.numDigits + scan.exp10;
+    if (scan.isNaN) {
+        val = NAN;
+    }
+    else if (scan.isInf) {
+        val = INFINITY;
+    }
+    else if ((scan.numDigits > 0) && (decExp > float64Desc.maxDecExp)) {
+        // too big for the result type
+        return 0;
+    }
+    else if ((0 == scan.numDigits) || (decExp < float64Desc.minDecExp)) {
+        val = 0.0;
+    }
+    else if (!scan.truncated && (scan.numDigits <= 19) && (scan.exp10 >= -22) && (scan.exp10 <= 22) &&
+             (scan.mant <= (uint64(1) << 53))) {
+        // Clinger's fast path: both operands are exact, so the result
+        // is correctly rounded
+        const float64 mant = float64(scan.mant);
+        val = (scan.exp10 >= 0) ? (mant * pow10f64[scan.exp10]) : (mant / pow10f64[-scan.exp10]);
+    }
+    else {
+        uint64 m;
+        int32 e;
+        if (roundExact(scan, approxFloat(scan), float64Desc, m, e)) {
+            const uint64 hidden = uint64(1) << 52;
+            uint64 bits = m;
+            if (m >= hidden) {
+                bits = (uint64(e - float64Desc.minExp + 1) << 52) | (m - hidden);
+            }
+            std::memcpy(&val, &bits, sizeof(val));
+        }
+        else {
+            // rounds up to infinity
+            return 0;
+        }
+    }
+    outVal = scan.neg ? -val : val;
+    return numChars;
+}
+
+//------------------------------------------------------------------------------
+int32
+numberConverter::ParseFloat32(const char* str, int32 len, float32& outVal) {
+    o_assert_dbg(str && (len >= 0));
+    floatScan scan;
+    const int32 numChars = scanFloat(str, len, scan);
+    if (0 == numChars) {
+        return 0;
+    }
+    float32 val;
+    const int32 decExp = scan.numDigits + scan.exp10;
+    if (scan.isNaN) {
+        val = NAN;
+    }
+    else if (scan.isInf) {
+        val = INFINITY;
+    }
+    else if ((scan.numDigits > 0) && (decExp > float32Desc.maxDecExp)) {
+        // too big for the result type
+        return 0;
+    }
+    else if ((0 == scan.numDigits) || (decExp < float32Desc.minDecExp)) {
+        val = 0.0f;
+    }
+    else if (!scan.truncated && (scan.numDigits <= 19) && (scan.exp10 >= -10) && (scan.exp10 <= 10) &&
+             (scan.mant <= (uint64(1) << 24))) {
+        // Clinger's fast path with 32-bit floats
+        const float32 mant = float32(scan.mant);
+        val = (scan.exp10 >= 0) ? (mant * pow10f32[scan.exp10]) : (mant / pow10f32[-scan.exp10]);
+    }
+    else {
+        uint64 m;
+        int32 e;
+        if (roundExact(scan, approxFloat(scan), float32Desc, m, e)) {
+            const uint32 hidden = uint32(1) << 23;
+            uint32 bits = uint32(m);
+            if (m >= hidden) {
+                bits = (uint32(e - float32Desc.minExp + 1) << 23) | (uint32(m) - hidden);
+            }
+            std::memcpy(&val, &bits, sizeof(val));
+        }
+        else {
+            // rounds up to infinity
+            return 0;
+        }
+    }
+    outVal = scan.neg ? -val : val;
+    return numChars;
+}
+
+} // namespace Oryol
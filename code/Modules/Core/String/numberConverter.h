@@ -0,0 +1,57 @@
+#pragma once
+//------------------------------------------------------------------------------
+/*
+    private class, do not use
+
+    Allocation-free, locale-independent number formatting and parsing
+    used by StringConverter and StringBuilder.
+
+    Integers are formatted two digits at a time. Floating point numbers
+    are formatted with the shortest digit sequence which parses back to
+    the same value (free-format digit generation after Steele/White and
+    Burger/Dybvig on a fixed-size big integer, so there are no
+    precomputed power tables). The output follows the ECMAScript
+    Number-to-String rules: fixed notation for decimal exponents between
+    -7 and 20, otherwise scientific notation ("1e+21", "1.5e-7").
+
+    Parsing accepts an optional sign, decimal digits with an optional
+    fraction and exponent, and "inf", "infinity" and "nan". Float parsing
+    is correctly rounded: short inputs take the exact Clinger fast path,
+    everything else is corrected against the exact decimal value.
+
+    All parse functions return the number of consumed characters, or 0
+    if the input doesn't start with a number or the number doesn't fit
+    into the result type. For floats this means that a finite number
+    which would round to infinity is rejected (only the literals "inf"
+    and "infinity" produce an infinite result), while a number which is
+    too small rounds to zero.
+*/
+#include "Core/Types.h"
+
+namespace Oryol {
+
+class numberConverter {
+public:
+    /// max number of chars written by the format functions (including 0-terminator)
+    static const int32 MaxChars = 32;
+
+    /// format a signed integer, return number of chars (excluding 0-terminator)
+    static int32 FormatInt(int64 val, char* buf);
+    /// format an unsigned integer, return number of chars (excluding 0-terminator)
+    static int32 FormatUInt(uint64 val, char* buf);
+    /// format a 32-bit float, return number of chars (excluding 0-terminator)
+    static int32 FormatFloat32(float32 val, char* buf);
+    /// format a 64-bit float, return number of chars (excluding 0-terminator)
+    static int32 FormatFloat64(float64 val, char* buf);
+
+    /// parse a signed integer, return number of consumed chars
+    static int32 ParseInt(const char* str, int32 len, int64& outVal);
+    /// parse an unsigned integer, return number of consumed chars
+    static int32 ParseUInt(const char* str, int32 len, uint64& outVal);
+    /// parse a 32-bit float, return number of consumed chars
+    static int32 ParseFloat32(const char* str, int32 len, float32& outVal);
+    /// parse a 64-bit float, return number of consumed chars
+    static int32 ParseFloat64(const char* str, int32 len, float64& outVal);
+};
+
+} // namespace Oryol
@@ -22,15 +22,14 @@ stringAtomBuffer::~stringAtomBuffer() {
 //------------------------------------------------------------------------------
 void
 stringAtomBuffer::allocChunk() {
-    int8* newChunk = (int8*) Memory::Alloc(this->chunkSize);
+    int8* newChunk = (int8*) Memory::Alloc(this->chunkSize, MemoryTag::String);
     this->chunks.Add(newChunk);
     this->curPointer = newChunk;
 }
 
 //------------------------------------------------------------------------------
 const stringAtomBuffer::Header*
-stringAtomBuffer::AddString(stringAtomTable* table, int32 hash, const char* str) {
-    o_assert(nullptr != table);
+stringAtomBuffer::AddString(int32 hash, const char* str) {
     o_assert(nullptr != str);
     
     // no chunks allocated yet?
@@ -50,7 +49,6 @@ stringAtomBuffer::AddString(stringAtomTable* table, int32 hash, const char* str)
     
     // copy over data
     Header* head = (Header*) this->curPointer;
-    head->table = table;
     head->hash = hash;
     head->length  = strLen;
     head->str  = (char*) this->curPointer + sizeof(Header);
@@ -3,53 +3,152 @@
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include <cstring>
+#include <new>
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
 #include "stringAtomTable.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Assert.h"
 
 namespace Oryol {
 
-ORYOL_THREADLOCAL_PTR(stringAtomTable) stringAtomTable::ptr = nullptr;
-
 //------------------------------------------------------------------------------
 stringAtomTable*
-stringAtomTable::threadLocalPtr() {
-    if (!ptr) {
-        ptr = new stringAtomTable();
+stringAtomTable::Instance() {
+    // NOTE: the table is never destroyed, string atom data pointers
+    // must remain valid until the very end
+    static stringAtomTable* instance = new stringAtomTable();
+    return instance;
+}
+
+//------------------------------------------------------------------------------
+stringAtomTable::stringAtomTable() {
+    for (shard& s : this->shards) {
+        s.slots.store(nullptr, std::memory_order_relaxed);
+        s.lock.clear();
+        s.num = 0;
     }
-    return ptr;
+}
+
+//------------------------------------------------------------------------------
+stringAtomTable::shard&
+stringAtomTable::shardForHash(int32 hash) {
+    // the low hash bits are used for the slot index, use the high bits here
+    return this->shards[(uint32(hash) >> 24) % NumShards];
+}
+
+//------------------------------------------------------------------------------
+const stringAtomTable::shard&
+stringAtomTable::shardForHash(int32 hash) const {
+    return this->shards[(uint32(hash) >> 24) % NumShards];
+}
+
+//------------------------------------------------------------------------------
+stringAtomTable::slotArray*
+stringAtomTable::allocSlots(int32 capacity) {
+    o_assert_dbg(0 == (capacity & (capacity - 1)));
+    const int32 size = sizeof(slotArray) + capacity * sizeof(std::atomic<const stringAtomBuffer::Header*>);
+    slotArray* arr = (slotArray*) Memory::Alloc(size, MemoryTag::String);
+    arr->capacity = capacity;
+    std::atomic<const stringAtomBuffer::Header*>* slots = arr->slots();
+    for (int32 i = 0; i < capacity; i++) {
+        new(&slots[i]) std::atomic<const stringAtomBuffer::Header*>(nullptr);
+    }
+    return arr;
 }
 
 //------------------------------------------------------------------------------
 const stringAtomBuffer::Header*
-stringAtomTable::Find(int32 hash, const char* str) const {
-    
-    // need to create a temp object for searching in the set
-    stringAtomBuffer::Header dummyHead(this, hash, 0, str);
-    Entry dummyEntry(&dummyHead);
-    auto ptr = this->table.Find(dummyEntry);
-    if (nullptr == ptr) {
+stringAtomTable::findInSlots(const slotArray* arr, int32 hash, const char* str) {
+    if (nullptr == arr) {
         return nullptr;
     }
-    else {
-        o_assert(nullptr != ptr->header);
-        return ptr->header;
+    // the table is never more than half full, so there's always a free slot
+    const uint32 mask = uint32(arr->capacity - 1);
+    const std::atomic<const stringAtomBuffer::Header*>* slots = arr->slots();
+    for (uint32 i = uint32(hash) & mask;; i = (i + 1) & mask) {
+        const stringAtomBuffer::Header* head = slots[i].load(std::memory_order_acquire);
+        if (nullptr == head) {
+            return nullptr;
+        }
+        if ((head->hash == hash) && (0 == std::strcmp(head->str, str))) {
+            return head;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+stringAtomTable::insertIntoSlots(slotArray* arr, const stringAtomBuffer::Header* header) {
+    const uint32 mask = uint32(arr->capacity - 1);
+    std::atomic<const stringAtomBuffer::Header*>* slots = arr->slots();
+    uint32 i = uint32(header->hash) & mask;
+    while (nullptr != slots[i].load(std::memory_order_relaxed)) {
+        i = (i + 1) & mask;
     }
+    slots[i].store(header, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+void
+stringAtomTable::grow(shard& s) {
+    slotArray* oldSlots = s.slots.load(std::memory_order_relaxed);
+    const int32 newCapacity = oldSlots ? oldSlots->capacity * 2 : MinSlots;
+    slotArray* newSlots = allocSlots(newCapacity);
+    if (oldSlots) {
+        const std::atomic<const stringAtomBuffer::Header*>* slots = oldSlots->slots();
+        for (int32 i = 0; i < oldSlots->capacity; i++) {
+            const stringAtomBuffer::Header* head = slots[i].load(std::memory_order_relaxed);
+            if (head) {
+                insertIntoSlots(newSlots, head);
+            }
+        }
+        // readers may still be probing the old slot array
+        s.retired.Add(oldSlots);
+    }
+    s.slots.store(newSlots, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+const stringAtomBuffer::Header*
+stringAtomTable::Find(int32 hash, const char* str) const {
+    const shard& s = this->shardForHash(hash);
+    return findInSlots(s.slots.load(std::memory_order_acquire), hash, str);
 }
 
 //------------------------------------------------------------------------------
 const stringAtomBuffer::Header*
-stringAtomTable::Add(int32 hash, const char* str) {
-    
-    #if ORYOL_DEBUG
-    o_assert(nullptr == this->Find(hash, str));
-    #endif
-    
-    // add new string to the string buffer
-    const stringAtomBuffer::Header* newHeader = this->buffer.AddString(this, hash, str);
-    o_assert(nullptr != newHeader);
-    
-    // add new entry to our lookup table
-    this->table.Add(Entry(newHeader));
-    return newHeader;
+stringAtomTable::FindOrAdd(int32 hash, const char* str) {
+    o_assert_dbg(nullptr != str);
+
+    // fast path: lock-free lookup
+    const stringAtomBuffer::Header* head = this->Find(hash, str);
+    if (head) {
+        return head;
+    }
+
+    // slow path: lock the shard, and check again, since another
+    // thread might have added the same string in the meantime
+    shard& s = this->shardForHash(hash);
+    while (s.lock.test_and_set(std::memory_order_acquire)) {
+        #if ORYOL_HAS_THREADS
+        std::this_thread::yield();
+        #endif
+    }
+    head = findInSlots(s.slots.load(std::memory_order_relaxed), hash, str);
+    if (nullptr == head) {
+        const slotArray* slots = s.slots.load(std::memory_order_relaxed);
+        if ((nullptr == slots) || (((s.num + 1) * 2) > slots->capacity)) {
+            grow(s);
+        }
+        head = s.buffer.AddString(hash, str);
+        o_assert(nullptr != head);
+        insertIntoSlots(s.slots.load(std::memory_order_relaxed), head);
+        s.num++;
+    }
+    s.lock.clear(std::memory_order_release);
+    return head;
 }
 
 //------------------------------------------------------------------------------
@@ -57,51 +156,15 @@ int32
 stringAtomTable::HashForString(const char* str) {
 
     // see here: http://eternallyconfuzzled.com/tuts/algorithms/jsw_tut_hashing.aspx
+    // NOTE: must return the same value as HashForLiteral()
     const char* p = str;
-    int32 h = 0;
+    uint32 h = 0;
     char c;
     while (0 != (c = *p++))
     {
-        h += c;
-        h += (h << 10);
-        h ^= (h >> 6);
-    }
-    h += (h << 3);
-    h ^= (h >> 11);
-    h += (h << 15);
-    return h;
-}
-
-//------------------------------------------------------------------------------
-bool
-stringAtomTable::Entry::operator==(const Entry& rhs) const {
-
-    #if ORYOL_DEBUG
-    o_assert(this->header != 0 && rhs.header != 0);
-    o_assert(this->header->hash != 0 && rhs.header->hash != 0);
-    o_assert(this->header->str != 0 && rhs.header->str != 0);
-    #endif
-    
-    if (this->header->hash != rhs.header->hash) {
-        // if hashes differ, the entries are definitely not equal
-        return false;
-    }
-    else {
-        // if hashes are identical, need to do a strcmp
-        return (0 == std::strcmp(this->header->str, rhs.header->str));
+        h = hashStep(h, c);
     }
-}
-
-//------------------------------------------------------------------------------
-bool
-stringAtomTable::Entry::operator<(const Entry& rhs) const {
-        
-    #if ORYOL_DEBUG
-    o_assert(this->header != 0 && rhs.header != 0);
-    o_assert(this->header->hash != 0 && rhs.header->hash != 0);
-    o_assert(this->header->str != 0 && rhs.header->str != 0);
-    #endif
-    return std::strcmp(this->header->str, rhs.header->str) < 0;
+    return int32(hashFinish(h));
 }
 
 } // namespace Oryol
@@ -2,52 +2,114 @@
 //------------------------------------------------------------------------------
 /*
     private class, do not use
-    
-    A thread-local StringAtom table.
+
+    The process-wide StringAtom table.
+
+    The table is split into shards (selected by the string hash), each
+    shard is an open-addressing hash table of pointers into the shard's
+    stringAtomBuffer. Lookups are lock-free: they load the current slot
+    array of the shard and probe it with acquire-loads. Adding a new
+    string locks only its shard, re-checks under the lock, and publishes
+    the new entry with a release-store. When a shard grows, a new slot
+    array is published, and the old slot array is retired but not freed,
+    since lock-free readers may still be probing it (a reader which
+    misses an entry in a retired array falls through to the locked path).
+
+    The table and its string data are never destroyed, so that string
+    atoms in static objects and on exited threads stay valid.
 */
+#include <atomic>
+#include "Core/Config.h"
 #include "Core/Types.h"
 #include "Core/String/stringAtomBuffer.h"
-#include "Core/Containers/HashSet.h"
-#include "Core/Threading/ThreadLocalPtr.h"
+#include "Core/Containers/Array.h"
 
 namespace Oryol {
 
 class stringAtomTable {
 public:
-    /// access to thread-local stringAtomTable (created on demand)
-    static stringAtomTable* threadLocalPtr();
+    /// access to the process-wide stringAtomTable (created on demand)
+    static stringAtomTable* Instance();
     /// compute hash value for string
     static int32 HashForString(const char* str);
-    /// find a matching buffer header in the table
+    /// compute hash value for a string literal at compile time (same result as HashForString)
+    static constexpr int32 HashForLiteral(const char* str) {
+        return int32(hashFinish(hashChars(str, 0)));
+    };
+    /// find a matching buffer header in the table (lock-free)
     const stringAtomBuffer::Header* Find(int32 hash, const char* str) const;
-    /// add a string to the atom table
-    const stringAtomBuffer::Header* Add(int32 hash, const char* str);
-    
+    /// find a matching buffer header, or add the string to the table
+    const stringAtomBuffer::Header* FindOrAdd(int32 hash, const char* str);
+
 private:
-    static ORYOL_THREADLOCAL_PTR(stringAtomTable) ptr;
-
-    /// a bucket entry
-    struct Entry {
-        /// default constructor
-        Entry() : header(0) { };
-        /// constructor with header ptr
-        Entry(const stringAtomBuffer::Header* h) : header(h) { };
-        /// equality operator
-        bool operator==(const Entry& rhs) const;
-        /// less-then operator
-        bool operator<(const Entry& rhs) const;
-        
-        const stringAtomBuffer::Header* header;
-    };
-    
-    /// hash function for bucket entry
-    struct Hasher {
-        int32 operator()(const Entry& e) const {
-            return e.header->hash;
+    /// constructor
+    stringAtomTable();
+
+    // the hash function works on unsigned values to avoid signed overflow,
+    // but keeps the arithmetic right shifts of the original signed version
+
+    /// arithmetic right shift
+    static constexpr uint32 hashAsr(uint32 h, int n) {
+        return (h >> n) | ((h & 0x80000000) ? ~(0xFFFFFFFF >> n) : 0);
+    };
+    /// mix step after adding a character
+    static constexpr uint32 hashMix(uint32 h) {
+        return h ^ hashAsr(h, 6);
+    };
+    /// one hash step per character
+    static constexpr uint32 hashStep(uint32 h, char c) {
+        return hashMix((h + uint32(int32(c))) + ((h + uint32(int32(c))) << 10));
+    };
+    /// hash the characters of a string (recursive, for compile-time evaluation)
+    static constexpr uint32 hashChars(const char* str, uint32 h) {
+        return (0 != *str) ? hashChars(str + 1, hashStep(h, *str)) : h;
+    };
+    /// final avalanche step
+    static constexpr uint32 hashFinal(uint32 h) {
+        return h ^ hashAsr(h, 11);
+    };
+    /// finish the hash value
+    static constexpr uint32 hashFinish(uint32 h) {
+        return (hashFinal(h + (h << 3))) + (hashFinal(h + (h << 3)) << 15);
+    };
+
+    static const int32 NumShards = 8;
+    static const int32 MinSlots = 64;
+
+    /// a slot array, the slot entries follow the struct in memory
+    struct slotArray {
+        int32 capacity;
+        int32 padding;      // keep the following slots pointer-aligned
+        std::atomic<const stringAtomBuffer::Header*>* slots() {
+            return (std::atomic<const stringAtomBuffer::Header*>*) (this + 1);
+        };
+        const std::atomic<const stringAtomBuffer::Header*>* slots() const {
+            return (const std::atomic<const stringAtomBuffer::Header*>*) (this + 1);
         };
     };
-    stringAtomBuffer buffer;
-    HashSet<Entry, Hasher, 1024> table;
+    /// a table shard, padded so that shards don't share cache lines
+    struct shard {
+        std::atomic<slotArray*> slots;
+        std::atomic_flag lock;
+        int32 num;
+        stringAtomBuffer buffer;
+        Array<slotArray*> retired;
+        uint8 pad[ORYOL_CACHELINE_SIZE];
+    };
+    /// get the shard for a hash value
+    shard& shardForHash(int32 hash);
+    /// get the shard for a hash value
+    const shard& shardForHash(int32 hash) const;
+    /// probe a slot array for a string
+    static const stringAtomBuffer::Header* findInSlots(const slotArray* arr, int32 hash, const char* str);
+    /// allocate a new, empty slot array
+    static slotArray* allocSlots(int32 capacity);
+    /// insert a header into a slot array (must have a free slot)
+    static void insertIntoSlots(slotArray* arr, const stringAtomBuffer::Header* header);
+    /// grow the slot array of a shard (shard must be locked)
+    static void grow(shard& s);
+
+    shard shards[NumShards];
 };
 
 } // namespace Oryol
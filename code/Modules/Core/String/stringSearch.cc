@@ -0,0 +1,504 @@
+//------------------------------------------------------------------------------
+//  stringSearch.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include <cstring>
+#include "stringSearch.h"
+#include "Core/Assert.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define ORYOL_STRINGSEARCH_SSE2 (1)
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define ORYOL_STRINGSEARCH_AVX2 (1)
+#define ORYOL_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER)
+#define ORYOL_STRINGSEARCH_AVX2 (1)
+#define ORYOL_TARGET_AVX2
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define ORYOL_STRINGSEARCH_NEON (1)
+#include <arm_neon.h>
+#endif
+
+namespace Oryol {
+
+//------------------------------------------------------------------------------
+static inline int32
+ctz32(uint32 mask) {
+    o_assert_dbg(0 != mask);
+    #if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return int32(index);
+    #else
+    return __builtin_ctz(mask);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+static inline int32
+ctz64(uint64 mask) {
+    o_assert_dbg(0 != mask);
+    #if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return int32(index);
+    #elif defined(_MSC_VER)
+    const uint32 lo = uint32(mask);
+    return lo ? ctz32(lo) : 32 + ctz32(uint32(mask >> 32));
+    #else
+    return __builtin_ctzll(mask);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+//  scalar kernels, also used for the tails of the SIMD kernels
+//
+static int32
+scalarFindSet(const char* str, int32 len, const char* delims, int32 numDelims, bool inSet) {
+    bool table[256] = { };
+    for (int32 i = 0; i < numDelims; i++) {
+        table[uint8(delims[i])] = true;
+    }
+    for (int32 i = 0; i < len; i++) {
+        if (table[uint8(str[i])] == inSet) {
+            return i;
+        }
+    }
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+static int32
+scalarFindFirstOf(const char* str, int32 len, const char* delims, int32 numDelims) {
+    return scalarFindSet(str, len, delims, numDelims, true);
+}
+
+//------------------------------------------------------------------------------
+static int32
+scalarFindFirstNotOf(const char* str, int32 len, const char* delims, int32 numDelims) {
+    return scalarFindSet(str, len, delims, numDelims, false);
+}
+
+//------------------------------------------------------------------------------
+static int32
+scalarFindSubString(const char* str, int32 len, const char* subStr, int32 subStrLen) {
+    const char first = subStr[0];
+    const int32 lastStart = len - subStrLen;
+    for (int32 i = 0; i <= lastStart; i++) {
+        if ((str[i] == first) && (0 == std::memcmp(str + i + 1, subStr + 1, subStrLen - 1))) {
+            return i;
+        }
+    }
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Scan the tail of a range which is too short for a full SIMD block.
+*/
+static inline int32
+tailFindSet(const char* str, int32 i, int32 len, const char* delims, int32 numDelims, bool inSet) {
+    for (; i < len; i++) {
+        const bool found = nullptr != std::memchr(delims, str[i], numDelims);
+        if (found == inSet) {
+            return i;
+        }
+    }
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+static inline int32
+tailFindSubString(const char* str, int32 i, int32 len, const char* subStr, int32 subStrLen) {
+    const int32 res = scalarFindSubString(str + i, len - i, subStr, subStrLen);
+    return (InvalidIndex != res) ? (i + res) : InvalidIndex;
+}
+
+#if ORYOL_STRINGSEARCH_SSE2
+//------------------------------------------------------------------------------
+//  SSE2 kernels (16 bytes per step)
+//
+static inline uint32
+sse2SetMask(__m128i v, const __m128i* d, int32 numDelims) {
+    __m128i m = _mm_cmpeq_epi8(v, d[0]);
+    for (int32 k = 1; k < numDelims; k++) {
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, d[k]));
+    }
+    return uint32(_mm_movemask_epi8(m));
+}
+
+//------------------------------------------------------------------------------
+static int32
+sse2FindSet(const char* str, int32 len, const char* delims, int32 numDelims, bool inSet) {
+    if ((0 == numDelims) || (numDelims > stringSearch::MaxSIMDDelims)) {
+        return scalarFindSet(str, len, delims, numDelims, inSet);
+    }
+    __m128i d[stringSearch::MaxSIMDDelims];
+    for (int32 k = 0; k < numDelims; k++) {
+        d[k] = _mm_set1_epi8(delims[k]);
+    }
+    const uint32 flip = inSet ? 0 : 0xFFFF;
+    int32 i = 0;
+    for (; (i + 16) <= len; i += 16) {
+        const __m128i v = _mm_loadu_si128((const __m128i*)(str + i));
+        const uint32 mask = sse2SetMask(v, d, numDelims) ^ flip;
+        if (mask) {
+            return i + ctz32(mask);
+        }
+    }
+    return tailFindSet(str, i, len, delims, numDelims, inSet);
+}
+
+//------------------------------------------------------------------------------
+static int32
+sse2FindFirstOf(const char* str, int32 len, const char* delims, int32 numDelims) {
+    return sse2FindSet(str, len, delims, numDelims, true);
+}
+
+//------------------------------------------------------------------------------
+static int32
+sse2FindFirstNotOf(const char* str, int32 len, const char* delims, int32 numDelims) {
+    return sse2FindSet(str, len, delims, numDelims, false);
+}
+
+//------------------------------------------------------------------------------
+static int32
+sse2FindSubString(const char* str, int32 len, const char* subStr, int32 subStrLen) {
+    if (1 == subStrLen) {
+        const void* ptr = std::memchr(str, subStr[0], len);
+        return ptr ? int32((const char*)ptr - str) : InvalidIndex;
+    }
+    const __m128i first = _mm_set1_epi8(subStr[0]);
+    const __m128i last = _mm_set1_epi8(subStr[subStrLen - 1]);
+    int32 i = 0;
+    for (; (i + subStrLen - 1 + 16) <= len; i += 16) {
+        const __m128i blockFirst = _mm_loadu_si128((const __m128i*)(str + i));
+        const __m128i blockLast = _mm_loadu_si128((const __m128i*)(str + i + subStrLen - 1));
+        uint32 mask = uint32(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, blockFirst), _mm_cmpeq_epi8(last, blockLast))));
+        while (mask) {
+            const int32 pos = i + ctz32(mask);
+            if (0 == std::memcmp(str + pos + 1, subStr + 1, subStrLen - 2)) {
+                return pos;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return tailFindSubString(str, i, len, subStr, subStrLen);
+}
+#endif
+
+#if ORYOL_STRINGSEARCH_AVX2
+//------------------------------------------------------------------------------
+//  AVX2 kernels (32 bytes per step)
+//
+ORYOL_TARGET_AVX2 static int32
+avx2FindSet(const char* str, int32 len, const char* delims, int32 numDelims, bool inSet) {
+    if ((0 == numDelims) || (numDelims > stringSearch::MaxSIMDDelims)) {
+        return scalarFindSet(str, len, delims, numDelims, inSet);
+    }
+    __m256i d[stringSearch::MaxSIMDDelims];
+    for (int32 k = 0; k < numDelims; k++) {
+        d[k] = _mm256_set1_epi8(delims[k]);
+    }
+    const uint32 flip = inSet ? 0 : 0xFFFFFFFF;
+    int32 i = 0;
+    for (; (i + 32) <= len; i += 32) {
+        const __m256i v = _mm256_loadu_si256((const __m256i*)(str + i));
+        __m256i m = _mm256_cmpeq_epi8(v, d[0]);
+        for (int32 k = 1; k < numDelims; k++) {
+            m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, d[k]));
+        }
+        const uint32 mask = uint32(_mm256_movemask_epi8(m)) ^ flip;
+        if (mask) {
+            return i + ctz32(mask);
+        }
+    }
+    return tailFindSet(str, i, len, delims, numDelims, inSet);
+}
+
+//------------------------------------------------------------------------------
+static int32
+avx2FindFirstOf(const char* str, int32 len, const char* delims, int32 numDelims) {
+    return avx2FindSet(str, len, delims, numDelims, true);
+}
+
+//------------------------------------------------------------------------------
+static int32
+avx2FindFirstNotOf(const char* str, int32 len, const char* delims, int32 numDelims) {
+    return avx2FindSet(str, len, delims, numDelims, false);
+}
+
+//------------------------------------------------------------------------------
+ORYOL_TARGET_AVX2 static int32
+avx2FindSubString(const char* str, int32 len, const char* subStr, int32 subStrLen) {
+    if (1 == subStrLen) {
+        const void* ptr = std::memchr(str, subStr[0], len);
+        return ptr ? int32((const char*)ptr - str) : InvalidIndex;
+    }
+    const __m256i first = _mm256_set1_epi8(subStr[0]);
+    const __m256i last = _mm256_set1_epi8(subStr[subStrLen - 1]);
+    int32 i = 0;
+    for (; (i + subStrLen - 1 + 32) <= len; i += 32) {
+        const __m256i blockFirst = _mm256_loadu_si256((const __m256i*)(str + i));
+        const __m256i blockLast = _mm256_loadu_si256((const __m256i*)(str + i + subStrLen - 1));
+        uint32 mask = uint32(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, blockFirst), _mm256_cmpeq_epi8(last, blockLast))));
+        while (mask) {
+            const int32 pos = i + ctz32(mask);
+            if (0 == std::memcmp(str + pos + 1, subStr + 1, subStrLen - 2)) {
+                return pos;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return tailFindSubString(str, i, len, subStr, subStrLen);
+}
+
+//------------------------------------------------------------------------------
+static bool
+cpuHasAVX2() {
+    #if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 0);
+    if (regs[0] < 7) {
+        return false;
+    }
+    // check that the OS saves the AVX registers
+    __cpuid(regs, 1);
+    const bool osxsave = 0 != (regs[2] & (1<<27));
+    if (!osxsave || (6 != (_xgetbv(0) & 6))) {
+        return false;
+    }
+    __cpuidex(regs, 7, 0);
+    return 0 != (regs[1] & (1<<5));
+    #else
+    __builtin_cpu_init();
+    return 0 != __builtin_cpu_supports("avx2");
+    #endif
+}
+#endif
+
+#if ORYOL_STRINGSEARCH_NEON
+//------------------------------------------------------------------------------
+//  NEON kernels (16 bytes per step), there's no movemask on NEON, instead
+//  narrow the 0x00/0xFF compare result to a 64-bit mask with 4 bits per byte
+//
+static inline uint64
+neonMask(uint8x16_t cmp) {
+    return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4)), 0);
+}
+
+//------------------------------------------------------------------------------
+static int32
+neonFindSet(const char* str, int32 len, const char* delims, int32 numDelims, bool inSet) {
+    if ((0 == numDelims) || (numDelims > stringSearch::MaxSIMDDelims)) {
+        return scalarFindSet(str, len, delims, numDelims, inSet);
+    }
+    uint8x16_t d[stringSearch::MaxSIMDDelims];
+    for (int32 k = 0; k < numDelims; k++) {
+        d[k] = vdupq_n_u8(uint8(delims[k]));
+    }
+    int32 i = 0;
+    for (; (i + 16) <= len; i += 16) {
+        const uint8x16_t v = vld1q_u8((const uint8*)(str + i));
+        uint8x16_t m = vceqq_u8(v, d[0]);
+        for (int32 k = 1; k < numDelims; k++) {
+            m = vorrq_u8(m, vceqq_u8(v, d[k]));
+        }
+        if (!inSet) {
+            m = vmvnq_u8(m);
+        }
+        const uint64 mask = neonMask(m);
+        if (mask) {
+            return i + (ctz64(mask) >> 2);
+        }
+    }
+    return tailFindSet(str, i, len, delims, numDelims, inSet);
+}
+
+//------------------------------------------------------------------------------
+static int32
+neonFindFirstOf(const char* str, int32 len, const char* delims, int32 numDelims) {
+    return neonFindSet(str, len, delims, numDelims, true);
+}
+
+//------------------------------------------------------------------------------
+static int32
+neonFindFirstNotOf(const char* str, int32 len, const char* delims, int32 numDelims) {
+    return neonFindSet(str, len, delims, numDelims, false);
+}
+
+//------------------------------------------------------------------------------
+static int32
+neonFindSubString(const char* str, int32 len, const char* subStr, int32 subStrLen) {
+    if (1 == subStrLen) {
+        const void* ptr = std::memchr(str, subStr[0], len);
+        return ptr ? int32((const char*)ptr - str) : InvalidIndex;
+    }
+    const uint8x16_t first = vdupq_n_u8(uint8(subStr[0]));
+    const uint8x16_t last = vdupq_n_u8(uint8(subStr[subStrLen - 1]));
+    int32 i = 0;
+    for (; (i + subStrLen - 1 + 16) <= len; i += 16) {
+        const uint8x16_t blockFirst = vld1q_u8((const uint8*)(str + i));
+        const uint8x16_t blockLast = vld1q_u8((const uint8*)(str + i + subStrLen - 1));
+        uint64 mask = neonMask(vandq_u8(vceqq_u8(first, blockFirst), vceqq_u8(last, blockLast)));
+        while (mask) {
+            const int32 bit = ctz64(mask);
+            const int32 pos = i + (bit >> 2);
+            if (0 == std::memcmp(str + pos + 1, subStr + 1, subStrLen - 2)) {
+                return pos;
+            }
+            // clear the 4 bits of this byte
+            mask &= ~(uint64(0xF) << bit);
+        }
+    }
+    return tailFindSubString(str, i, len, subStr, subStrLen);
+}
+#endif
+
+//------------------------------------------------------------------------------
+bool
+stringSearch::IsSupported(Level level) {
+    switch (level) {
+        case Scalar:
+            return true;
+        #if ORYOL_STRINGSEARCH_SSE2
+        case SSE2:
+            return true;
+        #endif
+        #if ORYOL_STRINGSEARCH_AVX2
+        case AVX2: {
+            static const bool hasAVX2 = cpuHasAVX2();
+            return hasAVX2;
+        }
+        #endif
+        #if ORYOL_STRINGSEARCH_NEON
+        case NEON:
+            return true;
+        #endif
+        default:
+            return false;
+    }
+}
+
+//------------------------------------------------------------------------------
+stringSearch::Level
+stringSearch::BestLevel() {
+    if (IsSupported(AVX2)) {
+        return AVX2;
+    }
+    else if (IsSupported(SSE2)) {
+        return SSE2;
+    }
+    else if (IsSupported(NEON)) {
+        return NEON;
+    }
+    else {
+        return Scalar;
+    }
+}
+
+//------------------------------------------------------------------------------
+const char*
+stringSearch::LevelName(Level level) {
+    switch (level) {
+        case Scalar:    return "Scalar";
+        case SSE2:      return "SSE2";
+        case AVX2:      return "AVX2";
+        case NEON:      return "NEON";
+        default:        return "Invalid";
+    }
+}
+
+//------------------------------------------------------------------------------
+stringSearch::kernels
+stringSearch::kernelsForLevel(Level level) {
+    o_assert(IsSupported(level));
+    kernels k;
+    k.level = Scalar;
+    k.findFirstOf = scalarFindFirstOf;
+    k.findFirstNotOf = scalarFindFirstNotOf;
+    k.findSubString = scalarFindSubString;
+    switch (level) {
+        #if ORYOL_STRINGSEARCH_SSE2
+        case SSE2:
+            k.level = SSE2;
+            k.findFirstOf = sse2FindFirstOf;
+            k.findFirstNotOf = sse2FindFirstNotOf;
+            k.findSubString = sse2FindSubString;
+            break;
+        #endif
+        #if ORYOL_STRINGSEARCH_AVX2
+        case AVX2:
+            k.level = AVX2;
+            k.findFirstOf = avx2FindFirstOf;
+            k.findFirstNotOf = avx2FindFirstNotOf;
+            k.findSubString = avx2FindSubString;
+            break;
+        #endif
+        #if ORYOL_STRINGSEARCH_NEON
+        case NEON:
+            k.level = NEON;
+            k.findFirstOf = neonFindFirstOf;
+            k.findFirstNotOf = neonFindFirstNotOf;
+            k.findSubString = neonFindSubString;
+            break;
+        #endif
+        default:
+            break;
+    }
+    return k;
+}
+
+//------------------------------------------------------------------------------
+stringSearch::kernels&
+stringSearch::current() {
+    static kernels k = kernelsForLevel(BestLevel());
+    return k;
+}
+
+//------------------------------------------------------------------------------
+stringSearch::Level
+stringSearch::CurrentLevel() {
+    return current().level;
+}
+
+//------------------------------------------------------------------------------
+void
+stringSearch::SetLevel(Level level) {
+    current() = kernelsForLevel(level);
+}
+
+//------------------------------------------------------------------------------
+int32
+stringSearch::FindFirstOf(const char* str, int32 len, const char* delims) {
+    o_assert_dbg(str && delims && (len >= 0));
+    return current().findFirstOf(str, len, delims, int32(std::strlen(delims)));
+}
+
+//------------------------------------------------------------------------------
+int32
+stringSearch::FindFirstNotOf(const char* str, int32 len, const char* delims) {
+    o_assert_dbg(str && delims && (len >= 0));
+    return current().findFirstNotOf(str, len, delims, int32(std::strlen(delims)));
+}
+
+//------------------------------------------------------------------------------
+int32
+stringSearch::FindSubString(const char* str, int32 len, const char* subStr, int32 subStrLen) {
+    o_assert_dbg(str && subStr && (len >= 0) && (subStrLen >= 0));
+    if (0 == subStrLen) {
+        return 0;
+    }
+    if (subStrLen > len) {
+        return InvalidIndex;
+    }
+    return current().findSubString(str, len, subStr, subStrLen);
+}
+
+} // namespace Oryol
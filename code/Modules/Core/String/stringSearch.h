@@ -0,0 +1,72 @@
+#pragma once
+//------------------------------------------------------------------------------
+/*
+    private class, do not use
+
+    SIMD byte-search kernels used by StringBuilder: length-bounded
+    search functions for delimiter sets and substrings. There are
+    scalar, SSE2, AVX2 and NEON implementations, the best implementation
+    supported by the CPU is selected at runtime on first use. SetLevel()
+    can be used to override the selection (for testing and benchmarking).
+
+    The SIMD delimiter-set kernels compare against each delimiter
+    character, delimiter sets with more than MaxSIMDDelims characters
+    always use the scalar lookup-table version. The substring kernels
+    first look for positions where the first and last character of the
+    substring match, and only compare the complete substring there.
+
+    All functions work on the byte range [str, str+len), 0-bytes are
+    treated like any other character.
+*/
+#include "Core/Types.h"
+
+namespace Oryol {
+
+class stringSearch {
+public:
+    /// kernel implementation levels
+    enum Level {
+        Scalar = 0,
+        SSE2,
+        AVX2,
+        NEON,
+
+        NumLevels,
+    };
+    /// max number of delimiters handled by the SIMD kernels
+    static const int32 MaxSIMDDelims = 16;
+
+    /// find first byte which is in delims, return InvalidIndex if not found
+    static int32 FindFirstOf(const char* str, int32 len, const char* delims);
+    /// find first byte which is not in delims, return InvalidIndex if not found
+    static int32 FindFirstNotOf(const char* str, int32 len, const char* delims);
+    /// find first occurrence of subStr, return InvalidIndex if not found
+    static int32 FindSubString(const char* str, int32 len, const char* subStr, int32 subStrLen);
+
+    /// return true if a kernel level is supported on this CPU
+    static bool IsSupported(Level level);
+    /// get the best supported level
+    static Level BestLevel();
+    /// get the currently used level
+    static Level CurrentLevel();
+    /// override the used level, level must be supported
+    static void SetLevel(Level level);
+    /// get human-readable name of a level
+    static const char* LevelName(Level level);
+
+private:
+    typedef int32 (*findSetFunc)(const char* str, int32 len, const char* delims, int32 numDelims);
+    typedef int32 (*findSubStringFunc)(const char* str, int32 len, const char* subStr, int32 subStrLen);
+    struct kernels {
+        Level level;
+        findSetFunc findFirstOf;
+        findSetFunc findFirstNotOf;
+        findSubStringFunc findSubString;
+    };
+    /// get the kernels for a level
+    static kernels kernelsForLevel(Level level);
+    /// get the currently selected kernels (selects best level on first call)
+    static kernels& current();
+};
+
+} // namespace Oryol
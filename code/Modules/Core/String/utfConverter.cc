@@ -0,0 +1,472 @@
+//------------------------------------------------------------------------------
+//  utfConverter.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include <cstring>
+#include "utfConverter.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define ORYOL_UTFCONVERTER_SSE2 (1)
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define ORYOL_UTFCONVERTER_NEON (1)
+#include <arm_neon.h>
+#endif
+
+namespace Oryol {
+
+//------------------------------------------------------------------------------
+/**
+ Widen a run of ASCII chars, return number of converted chars (a multiple
+ of the block size, stops at the first block with a non-ASCII char).
+*/
+static int32
+asciiToUTF32(const UTF8* src, int32 num, UTF32* dst) {
+    int32 i = 0;
+    #if ORYOL_UTFCONVERTER_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for (; (i + 16) <= num; i += 16) {
+        const __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        if (_mm_movemask_epi8(v)) {
+            break;
+        }
+        const __m128i lo = _mm_unpacklo_epi8(v, zero);
+        const __m128i hi = _mm_unpackhi_epi8(v, zero);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_unpacklo_epi16(lo, zero));
+        _mm_storeu_si128((__m128i*)(dst + i + 4), _mm_unpackhi_epi16(lo, zero));
+        _mm_storeu_si128((__m128i*)(dst + i + 8), _mm_unpacklo_epi16(hi, zero));
+        _mm_storeu_si128((__m128i*)(dst + i + 12), _mm_unpackhi_epi16(hi, zero));
+    }
+    #elif ORYOL_UTFCONVERTER_NEON
+    for (; (i + 16) <= num; i += 16) {
+        const uint8x16_t v = vld1q_u8(src + i);
+        if (vmaxvq_u8(v) >= 0x80) {
+            break;
+        }
+        const uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+        const uint16x8_t hi = vmovl_u8(vget_high_u8(v));
+        vst1q_u32((uint32_t*)(dst + i), vmovl_u16(vget_low_u16(lo)));
+        vst1q_u32((uint32_t*)(dst + i + 4), vmovl_u16(vget_high_u16(lo)));
+        vst1q_u32((uint32_t*)(dst + i + 8), vmovl_u16(vget_low_u16(hi)));
+        vst1q_u32((uint32_t*)(dst + i + 12), vmovl_u16(vget_high_u16(hi)));
+    }
+    #else
+    for (; (i + 8) <= num; i += 8) {
+        uint64 word;
+        std::memcpy(&word, src + i, sizeof(word));
+        if (word & 0x8080808080808080ULL) {
+            break;
+        }
+        for (int32 j = 0; j < 8; j++) {
+            dst[i + j] = src[i + j];
+        }
+    }
+    #endif
+    return i;
+}
+
+//------------------------------------------------------------------------------
+static int32
+asciiToUTF16(const UTF8* src, int32 num, UTF16* dst) {
+    int32 i = 0;
+    #if ORYOL_UTFCONVERTER_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for (; (i + 16) <= num; i += 16) {
+        const __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        if (_mm_movemask_epi8(v)) {
+            break;
+        }
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_unpacklo_epi8(v, zero));
+        _mm_storeu_si128((__m128i*)(dst + i + 8), _mm_unpackhi_epi8(v, zero));
+    }
+    #elif ORYOL_UTFCONVERTER_NEON
+    for (; (i + 16) <= num; i += 16) {
+        const uint8x16_t v = vld1q_u8(src + i);
+        if (vmaxvq_u8(v) >= 0x80) {
+            break;
+        }
+        vst1q_u16((uint16_t*)(dst + i), vmovl_u8(vget_low_u8(v)));
+        vst1q_u16((uint16_t*)(dst + i + 8), vmovl_u8(vget_high_u8(v)));
+    }
+    #else
+    for (; (i + 8) <= num; i += 8) {
+        uint64 word;
+        std::memcpy(&word, src + i, sizeof(word));
+        if (word & 0x8080808080808080ULL) {
+            break;
+        }
+        for (int32 j = 0; j < 8; j++) {
+            dst[i + j] = src[i + j];
+        }
+    }
+    #endif
+    return i;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Narrow a run of ASCII code points, return number of converted chars.
+*/
+static int32
+asciiFromUTF32(const UTF32* src, int32 num, UTF8* dst) {
+    int32 i = 0;
+    #if ORYOL_UTFCONVERTER_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i nonAscii = _mm_set1_epi32(int(0xFFFFFF80));
+    for (; (i + 16) <= num; i += 16) {
+        const __m128i a = _mm_loadu_si128((const __m128i*)(src + i));
+        const __m128i b = _mm_loadu_si128((const __m128i*)(src + i + 4));
+        const __m128i c = _mm_loadu_si128((const __m128i*)(src + i + 8));
+        const __m128i d = _mm_loadu_si128((const __m128i*)(src + i + 12));
+        const __m128i all = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+        if (0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(all, nonAscii), zero))) {
+            break;
+        }
+        const __m128i ab = _mm_packs_epi32(a, b);
+        const __m128i cd = _mm_packs_epi32(c, d);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(ab, cd));
+    }
+    #elif ORYOL_UTFCONVERTER_NEON
+    for (; (i + 16) <= num; i += 16) {
+        const uint32x4_t a = vld1q_u32((const uint32_t*)(src + i));
+        const uint32x4_t b = vld1q_u32((const uint32_t*)(src + i + 4));
+        const uint32x4_t c = vld1q_u32((const uint32_t*)(src + i + 8));
+        const uint32x4_t d = vld1q_u32((const uint32_t*)(src + i + 12));
+        if (vmaxvq_u32(vorrq_u32(vorrq_u32(a, b), vorrq_u32(c, d))) >= 0x80) {
+            break;
+        }
+        const uint16x8_t ab = vcombine_u16(vmovn_u32(a), vmovn_u32(b));
+        const uint16x8_t cd = vcombine_u16(vmovn_u32(c), vmovn_u32(d));
+        vst1q_u8(dst + i, vcombine_u8(vmovn_u16(ab), vmovn_u16(cd)));
+    }
+    #else
+    for (; i < num; i++) {
+        if (src[i] >= 0x80) {
+            break;
+        }
+        dst[i] = UTF8(src[i]);
+    }
+    #endif
+    return i;
+}
+
+//------------------------------------------------------------------------------
+static int32
+asciiFromUTF16(const UTF16* src, int32 num, UTF8* dst) {
+    int32 i = 0;
+    #if ORYOL_UTFCONVERTER_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i nonAscii = _mm_set1_epi16(short(0xFF80));
+    for (; (i + 16) <= num; i += 16) {
+        const __m128i a = _mm_loadu_si128((const __m128i*)(src + i));
+        const __m128i b = _mm_loadu_si128((const __m128i*)(src + i + 8));
+        if (0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(_mm_or_si128(a, b), nonAscii), zero))) {
+            break;
+        }
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(a, b));
+    }
+    #elif ORYOL_UTFCONVERTER_NEON
+    for (; (i + 16) <= num; i += 16) {
+        const uint16x8_t a = vld1q_u16((const uint16_t*)(src + i));
+        const uint16x8_t b = vld1q_u16((const uint16_t*)(src + i + 8));
+        if (vmaxvq_u16(vorrq_u16(a, b)) >= 0x80) {
+            break;
+        }
+        vst1q_u8(dst + i, vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+    }
+    #else
+    for (; i < num; i++) {
+        if (src[i] >= 0x80) {
+            break;
+        }
+        dst[i] = UTF8(src[i]);
+    }
+    #endif
+    return i;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Decode a single legal multi-byte UTF-8 sequence, return number of
+ consumed bytes, or 0 if the sequence is illegal or truncated.
+*/
+static inline int32
+decodeUTF8(const UTF8* src, const UTF8* srcEnd, UTF32& outChar) {
+    const UTF32 c0 = src[0];
+    const intptr_t avail = srcEnd - src;
+    if (c0 < 0xC2) {
+        // continuation byte or overlong 2-byte sequence
+        return 0;
+    }
+    else if (c0 < 0xE0) {
+        if ((avail < 2) || (0x80 != (src[1] & 0xC0))) {
+            return 0;
+        }
+        outChar = ((c0 & 0x1F) << 6) | (src[1] & 0x3F);
+        return 2;
+    }
+    else if (c0 < 0xF0) {
+        if ((avail < 3) || (0x80 != (src[1] & 0xC0)) || (0x80 != (src[2] & 0xC0))) {
+            return 0;
+        }
+        // reject overlong sequences and surrogates
+        if (((0xE0 == c0) && (src[1] < 0xA0)) || ((0xED == c0) && (src[1] > 0x9F))) {
+            return 0;
+        }
+        outChar = ((c0 & 0x0F) << 12) | ((src[1] & 0x3F) << 6) | (src[2] & 0x3F);
+        return 3;
+    }
+    else if (c0 < 0xF5) {
+        if ((avail < 4) || (0x80 != (src[1] & 0xC0)) || (0x80 != (src[2] & 0xC0)) || (0x80 != (src[3] & 0xC0))) {
+            return 0;
+        }
+        // reject overlong sequences and code points above 0x10FFFF
+        if (((0xF0 == c0) && (src[1] < 0x90)) || ((0xF4 == c0) && (src[1] > 0x8F))) {
+            return 0;
+        }
+        outChar = ((c0 & 0x07) << 18) | ((src[1] & 0x3F) << 12) | ((src[2] & 0x3F) << 6) | (src[3] & 0x3F);
+        return 4;
+    }
+    else {
+        return 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+ Encode a legal code point as UTF-8, return number of bytes, or 0 if
+ there's not enough room.
+*/
+static inline int32
+encodeUTF8(UTF32 ch, UTF8* dst, const UTF8* dstEnd) {
+    const intptr_t avail = dstEnd - dst;
+    if (ch < 0x80) {
+        if (avail < 1) {
+            return 0;
+        }
+        dst[0] = UTF8(ch);
+        return 1;
+    }
+    else if (ch < 0x800) {
+        if (avail < 2) {
+            return 0;
+        }
+        dst[0] = UTF8(0xC0 | (ch >> 6));
+        dst[1] = UTF8(0x80 | (ch & 0x3F));
+        return 2;
+    }
+    else if (ch < 0x10000) {
+        if (avail < 3) {
+            return 0;
+        }
+        dst[0] = UTF8(0xE0 | (ch >> 12));
+        dst[1] = UTF8(0x80 | ((ch >> 6) & 0x3F));
+        dst[2] = UTF8(0x80 | (ch & 0x3F));
+        return 3;
+    }
+    else {
+        if (avail < 4) {
+            return 0;
+        }
+        dst[0] = UTF8(0xF0 | (ch >> 18));
+        dst[1] = UTF8(0x80 | ((ch >> 12) & 0x3F));
+        dst[2] = UTF8(0x80 | ((ch >> 6) & 0x3F));
+        dst[3] = UTF8(0x80 | (ch & 0x3F));
+        return 4;
+    }
+}
+
+//------------------------------------------------------------------------------
+static inline int32
+minRemaining(intptr_t a, intptr_t b) {
+    return int32((a < b) ? a : b);
+}
+
+//------------------------------------------------------------------------------
+ConversionResult
+utfConverter::UTF8ToUTF32(const UTF8** srcStart, const UTF8* srcEnd, UTF32** dstStart, UTF32* dstEnd) {
+    const UTF8* src = *srcStart;
+    UTF32* dst = *dstStart;
+    while (src < srcEnd) {
+        if (*src < 0x80) {
+            if (dst >= dstEnd) {
+                break;
+            }
+            // only try the block path if this doesn't look like a short run
+            const int32 avail = minRemaining(srcEnd - src, dstEnd - dst);
+            if ((avail >= 16) && (src[15] < 0x80)) {
+                const int32 num = asciiToUTF32(src, avail, dst);
+                src += num;
+                dst += num;
+            }
+            // finish the ASCII run one char at a time
+            while ((src < srcEnd) && (dst < dstEnd) && (*src < 0x80)) {
+                *dst++ = *src++;
+            }
+            continue;
+        }
+        UTF32 ch;
+        const int32 len = decodeUTF8(src, srcEnd, ch);
+        if ((0 == len) || (dst >= dstEnd)) {
+            break;
+        }
+        *dst++ = ch;
+        src += len;
+    }
+    *srcStart = src;
+    *dstStart = dst;
+    if (src < srcEnd) {
+        // illegal input or target exhausted, let the reference implementation decide
+        return ConvertUTF8toUTF32(srcStart, srcEnd, dstStart, dstEnd, strictConversion);
+    }
+    return conversionOK;
+}
+
+//------------------------------------------------------------------------------
+ConversionResult
+utfConverter::UTF8ToUTF16(const UTF8** srcStart, const UTF8* srcEnd, UTF16** dstStart, UTF16* dstEnd) {
+    const UTF8* src = *srcStart;
+    UTF16* dst = *dstStart;
+    while (src < srcEnd) {
+        if (*src < 0x80) {
+            if (dst >= dstEnd) {
+                break;
+            }
+            // only try the block path if this doesn't look like a short run
+            const int32 avail = minRemaining(srcEnd - src, dstEnd - dst);
+            if ((avail >= 16) && (src[15] < 0x80)) {
+                const int32 num = asciiToUTF16(src, avail, dst);
+                src += num;
+                dst += num;
+            }
+            // finish the ASCII run one char at a time
+            while ((src < srcEnd) && (dst < dstEnd) && (*src < 0x80)) {
+                *dst++ = *src++;
+            }
+            continue;
+        }
+        UTF32 ch;
+        const int32 len = decodeUTF8(src, srcEnd, ch);
+        if (0 == len) {
+            break;
+        }
+        if (ch < 0x10000) {
+            if (dst >= dstEnd) {
+                break;
+            }
+            *dst++ = UTF16(ch);
+        }
+        else {
+            // surrogate pair (the reference implementation always keeps
+            // one extra target element free here)
+            if ((dst + 1) >= dstEnd) {
+                break;
+            }
+            ch -= 0x10000;
+            *dst++ = UTF16((ch >> 10) + 0xD800);
+            *dst++ = UTF16((ch & 0x3FF) + 0xDC00);
+        }
+        src += len;
+    }
+    *srcStart = src;
+    *dstStart = dst;
+    if (src < srcEnd) {
+        // illegal input or target exhausted, let the reference implementation decide
+        return ConvertUTF8toUTF16(srcStart, srcEnd, dstStart, dstEnd, strictConversion);
+    }
+    return conversionOK;
+}
+
+//------------------------------------------------------------------------------
+ConversionResult
+utfConverter::UTF32ToUTF8(const UTF32** srcStart, const UTF32* srcEnd, UTF8** dstStart, UTF8* dstEnd) {
+    const UTF32* src = *srcStart;
+    UTF8* dst = *dstStart;
+    while (src < srcEnd) {
+        if (*src < 0x80) {
+            if (dst >= dstEnd) {
+                break;
+            }
+            // only try the block path if this doesn't look like a short run
+            const int32 avail = minRemaining(srcEnd - src, dstEnd - dst);
+            if ((avail >= 16) && (src[15] < 0x80)) {
+                const int32 num = asciiFromUTF32(src, avail, dst);
+                src += num;
+                dst += num;
+            }
+            // finish the ASCII run one char at a time
+            while ((src < srcEnd) && (dst < dstEnd) && (*src < 0x80)) {
+                *dst++ = UTF8(*src++);
+            }
+            continue;
+        }
+        const UTF32 ch = *src;
+        if (((ch >= 0xD800) && (ch <= 0xDFFF)) || (ch > 0x10FFFF)) {
+            break;
+        }
+        const int32 len = encodeUTF8(ch, dst, dstEnd);
+        if (0 == len) {
+            break;
+        }
+        dst += len;
+        src++;
+    }
+    *srcStart = src;
+    *dstStart = dst;
+    if (src < srcEnd) {
+        // illegal input or target exhausted, let the reference implementation decide
+        return ConvertUTF32toUTF8(srcStart, srcEnd, dstStart, dstEnd, strictConversion);
+    }
+    return conversionOK;
+}
+
+//------------------------------------------------------------------------------
+ConversionResult
+utfConverter::UTF16ToUTF8(const UTF16** srcStart, const UTF16* srcEnd, UTF8** dstStart, UTF8* dstEnd) {
+    const UTF16* src = *srcStart;
+    UTF8* dst = *dstStart;
+    while (src < srcEnd) {
+        if (*src < 0x80) {
+            if (dst >= dstEnd) {
+                break;
+            }
+            // only try the block path if this doesn't look like a short run
+            const int32 avail = minRemaining(srcEnd - src, dstEnd - dst);
+            if ((avail >= 16) && (src[15] < 0x80)) {
+                const int32 num = asciiFromUTF16(src, avail, dst);
+                src += num;
+                dst += num;
+            }
+            // finish the ASCII run one char at a time
+            while ((src < srcEnd) && (dst < dstEnd) && (*src < 0x80)) {
+                *dst++ = UTF8(*src++);
+            }
+            continue;
+        }
+        UTF32 ch = *src;
+        int32 srcLen = 1;
+        if ((ch >= 0xD800) && (ch <= 0xDFFF)) {
+            // must be a complete surrogate pair
+            if ((ch > 0xDBFF) || ((src + 1) >= srcEnd) || (src[1] < 0xDC00) || (src[1] > 0xDFFF)) {
+                break;
+            }
+            ch = ((ch - 0xD800) << 10) + (src[1] - 0xDC00) + 0x10000;
+            srcLen = 2;
+        }
+        const int32 len = encodeUTF8(ch, dst, dstEnd);
+        if (0 == len) {
+            break;
+        }
+        dst += len;
+        src += srcLen;
+    }
+    *srcStart = src;
+    *dstStart = dst;
+    if (src < srcEnd) {
+        // illegal input or target exhausted, let the reference implementation decide
+        return ConvertUTF16toUTF8(srcStart, srcEnd, dstStart, dstEnd, strictConversion);
+    }
+    return conversionOK;
+}
+
+} // namespace Oryol
@@ -0,0 +1,35 @@
+#pragma once
+//------------------------------------------------------------------------------
+/*
+    private class, do not use
+
+    Fast UTF-8 <=> UTF-16/UTF-32 transcoders used by StringConverter.
+
+    The functions have the same interface and results as the ConvertUTF
+    reference functions (with strictConversion). Runs of ASCII characters
+    are validated and widened/narrowed 16 characters at a time with
+    SSE2 or NEON (or 8 at a time with 64-bit integer ops on other
+    platforms), legal multi-byte sequences are decoded with a short
+    scalar path. On anything else (illegal or truncated sequences,
+    unpaired surrogates, or a full target buffer) the remaining range
+    is handed to the reference implementation, which produces the
+    exact same error codes, and source and target positions.
+*/
+#include "Core/Types.h"
+#include "Ext/ConvertUTF/ConvertUTF.h"
+
+namespace Oryol {
+
+class utfConverter {
+public:
+    /// convert UTF-8 to UTF-32
+    static ConversionResult UTF8ToUTF32(const UTF8** srcStart, const UTF8* srcEnd, UTF32** dstStart, UTF32* dstEnd);
+    /// convert UTF-8 to UTF-16
+    static ConversionResult UTF8ToUTF16(const UTF8** srcStart, const UTF8* srcEnd, UTF16** dstStart, UTF16* dstEnd);
+    /// convert UTF-32 to UTF-8
+    static ConversionResult UTF32ToUTF8(const UTF32** srcStart, const UTF32* srcEnd, UTF8** dstStart, UTF8* dstEnd);
+    /// convert UTF-16 to UTF-8
+    static ConversionResult UTF16ToUTF8(const UTF16** srcStart, const UTF16* srcEnd, UTF8** dstStart, UTF8* dstEnd);
+};
+
+} // namespace Oryol
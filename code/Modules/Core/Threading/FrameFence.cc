@@ -0,0 +1,76 @@
+//------------------------------------------------------------------------------
+//  FrameFence.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "FrameFence.h"
+#include "Core/Assert.h"
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
+
+namespace Oryol {
+
+//------------------------------------------------------------------------------
+FrameFence::FrameFence() :
+#if ORYOL_HAS_THREADS
+value(-1),
+numWaiting(0) {
+#else
+value(-1) {
+#endif
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+ The value store and the numWaiting load are both seq_cst, and Wait()
+ increments numWaiting before it checks the value, so either the
+ waiter sees the new value, or Signal() sees the waiter and wakes it up.
+*/
+void
+FrameFence::Signal(int64 frameIndex) {
+    o_assert_dbg(frameIndex >= this->value.load(std::memory_order_relaxed));
+    this->value.store(frameIndex, std::memory_order_seq_cst);
+    #if ORYOL_HAS_THREADS
+    if (this->numWaiting.load(std::memory_order_seq_cst) > 0) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->cond.notify_all();
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+FrameFence::Wait(int64 frameIndex) {
+    if (this->IsSignaled(frameIndex)) {
+        return;
+    }
+    #if ORYOL_HAS_THREADS
+    // the other side is usually almost done, so try yielding first
+    for (int32 i = 0; i < 16; i++) {
+        std::this_thread::yield();
+        if (this->IsSignaled(frameIndex)) {
+            return;
+        }
+    }
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->numWaiting.fetch_add(1, std::memory_order_seq_cst);
+    this->cond.wait(lock, [this, frameIndex] {
+        return this->value.load(std::memory_order_seq_cst) >= frameIndex;
+    });
+    this->numWaiting.fetch_sub(1, std::memory_order_relaxed);
+    #else
+    o_error("FrameFence::Wait(): would block forever on platform without threads!\n");
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+FrameFence::Reset(int64 frameIndex) {
+    #if ORYOL_HAS_THREADS
+    o_assert_dbg(0 == this->numWaiting.load(std::memory_order_relaxed));
+    #endif
+    this->value.store(frameIndex, std::memory_order_seq_cst);
+}
+
+} // namespace Oryol
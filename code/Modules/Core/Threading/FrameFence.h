@@ -0,0 +1,71 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::FrameFence
+    @ingroup Core
+    @brief a monotonic frame counter which threads can wait on
+
+    A FrameFence holds the index of the last frame which has passed
+    a certain point (for instance "update of frame N is finished").
+    One thread calls Signal(N) when it's done with frame N, other
+    threads call Wait(N) to block until frame N (or a later frame)
+    has been signalled. The fence value never goes backwards, and
+    starts at -1 (no frame signalled yet).
+
+    Signal() only needs to lock a mutex if a thread is actually
+    blocked in Wait(), Wait() first yields a few times before it
+    goes to sleep.
+*/
+#include "Core/Config.h"
+#include "Core/Types.h"
+#include <atomic>
+#if ORYOL_HAS_THREADS
+#include <mutex>
+#include <condition_variable>
+#endif
+
+namespace Oryol {
+
+class FrameFence {
+public:
+    /// constructor
+    FrameFence();
+
+    /// signal that frameIndex has passed the fence (any thread)
+    void Signal(int64 frameIndex);
+    /// test if frameIndex has passed the fence (any thread)
+    bool IsSignaled(int64 frameIndex) const;
+    /// block until frameIndex has passed the fence (any thread)
+    void Wait(int64 frameIndex);
+    /// get the last signalled frame index (-1 if nothing signalled yet)
+    int64 Value() const;
+    /// reset the fence value, no thread may wait on the fence
+    void Reset(int64 frameIndex=-1);
+
+private:
+    /// not copyable
+    FrameFence(const FrameFence& rhs) = delete;
+    /// not copyable
+    void operator=(const FrameFence& rhs) = delete;
+
+    std::atomic<int64> value;
+    #if ORYOL_HAS_THREADS
+    std::atomic<int32> numWaiting;
+    std::mutex mutex;
+    std::condition_variable cond;
+    #endif
+};
+
+//------------------------------------------------------------------------------
+inline bool
+FrameFence::IsSignaled(int64 frameIndex) const {
+    return this->value.load(std::memory_order_acquire) >= frameIndex;
+}
+
+//------------------------------------------------------------------------------
+inline int64
+FrameFence::Value() const {
+    return this->value.load(std::memory_order_acquire);
+}
+
+} // namespace Oryol
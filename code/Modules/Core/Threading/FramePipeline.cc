@@ -0,0 +1,120 @@
+//------------------------------------------------------------------------------
+//  FramePipeline.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "FramePipeline.h"
+#include "Core/Core.h"
+#include "Core/RunLoop.h"
+#include "Core/Assert.h"
+
+namespace Oryol {
+
+//------------------------------------------------------------------------------
+FramePipeline::FramePipeline() :
+isValid(false),
+#if ORYOL_HAS_THREADS
+curFrame(-1),
+stopRequested(false) {
+#else
+curFrame(-1) {
+#endif
+    // empty
+}
+
+//------------------------------------------------------------------------------
+FramePipeline::~FramePipeline() {
+    o_assert_dbg(!this->isValid);
+}
+
+//------------------------------------------------------------------------------
+void
+FramePipeline::Setup(UpdateFunc func) {
+    o_assert_dbg(!this->isValid);
+    o_assert_dbg(func);
+    this->isValid = true;
+    this->curFrame = -1;
+    this->updateFunc = func;
+    this->startFence.Reset();
+    this->updateFence.Reset();
+    #if ORYOL_HAS_THREADS
+    this->stopRequested = false;
+    this->thread = std::thread(&FramePipeline::threadFunc, this);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+FramePipeline::Discard() {
+    o_assert_dbg(this->isValid);
+    this->Sync();
+    #if ORYOL_HAS_THREADS
+    // wake up the update thread without starting another update
+    this->stopRequested = true;
+    this->startFence.Signal(this->startFence.Value() + 1);
+    this->thread.join();
+    #endif
+    this->updateFunc = nullptr;
+    this->isValid = false;
+}
+
+//------------------------------------------------------------------------------
+void
+FramePipeline::update(int64 frameIndex) {
+    Core::PreRunLoop()->Run();
+    this->updateFunc(frameIndex, int32(frameIndex & (NumBuffers - 1)));
+    Core::PostRunLoop()->Run();
+    this->updateFence.Signal(frameIndex);
+}
+
+//------------------------------------------------------------------------------
+void
+FramePipeline::threadFunc() {
+    #if ORYOL_HAS_THREADS
+    Core::EnterThread();
+    for (int64 frameIndex = 0; ; frameIndex++) {
+        this->startFence.Wait(frameIndex);
+        if (this->stopRequested) {
+            break;
+        }
+        this->update(frameIndex);
+    }
+    Core::LeaveThread();
+    #endif
+}
+
+//------------------------------------------------------------------------------
+/**
+ If the update of the new frame hasn't been started yet (only on the
+ first frame, or if StartUpdate() wasn't called in the previous frame),
+ it is started here, so that the waiting below doesn't block forever.
+*/
+void
+FramePipeline::BeginFrame() {
+    o_assert_dbg(this->isValid);
+    if (this->startFence.Value() <= this->curFrame) {
+        this->StartUpdate();
+    }
+    this->curFrame++;
+    this->updateFence.Wait(this->curFrame);
+}
+
+//------------------------------------------------------------------------------
+void
+FramePipeline::StartUpdate() {
+    o_assert_dbg(this->isValid);
+    const int64 nextFrame = this->curFrame + 1;
+    o_assert_dbg(this->startFence.Value() < nextFrame);
+    this->startFence.Signal(nextFrame);
+    #if !ORYOL_HAS_THREADS
+    this->update(nextFrame);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+FramePipeline::Sync() {
+    o_assert_dbg(this->isValid);
+    this->updateFence.Wait(this->startFence.Value());
+}
+
+} // namespace Oryol
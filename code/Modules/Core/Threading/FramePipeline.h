@@ -0,0 +1,146 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::FramePipeline
+    @ingroup Core
+    @brief overlap the update of the next frame with rendering the current frame
+
+    A FramePipeline owns an update thread which runs an update function
+    one frame ahead of the thread which owns the pipeline (usually the
+    main thread, which renders). Per-frame data which is written by the
+    update and read by the renderer must be double-buffered, the update
+    function gets the buffer index it must write to, and the renderer
+    reads from RenderBufferIndex():
+
+        pipeline.Setup([](int64 frameIndex, int32 bufferIndex) {
+            // runs on the update thread
+            updateParticles(particles[bufferIndex ^ 1], particles[bufferIndex]);
+        });
+        ...
+        // each frame, on the main thread:
+        pipeline.BeginFrame();
+        // sync point: no update is running here, exchange data with the update side
+        pipeline.StartUpdate();
+        // runs in parallel with the update of the next frame
+        drawParticles(particles[pipeline.RenderBufferIndex()]);
+
+    BeginFrame() waits until the update of the current frame has finished
+    (this is the only place where the main thread waits in a frame,
+    on the first frame it runs the update of frame 0 first).
+    StartUpdate() kicks the update of the next frame, which writes to the
+    other buffer. Between BeginFrame() and StartUpdate() neither side is
+    running, this is where input and other main-thread state should be
+    handed to the update side. Sync() is an explicit sync point which
+    waits for a running update to finish.
+
+    The update thread calls Core::EnterThread() and runs its own
+    before- and after-frame RunLoops around each update, so the update
+    function can use the thread-local Core objects (like the FrameArena).
+    It must not call rendering functions.
+
+    UpdateFence() is signalled with the frame index after each update,
+    other threads can use it to wait for a specific update.
+
+    On platforms without threads, StartUpdate() calls the update function
+    directly, so that the frame data flow is the same, just without
+    the overlap.
+*/
+#include "Core/Config.h"
+#include "Core/Types.h"
+#include "Core/Threading/FrameFence.h"
+#include <functional>
+#include <atomic>
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
+
+namespace Oryol {
+
+class FramePipeline {
+public:
+    /// number of per-frame data buffers
+    static const int32 NumBuffers = 2;
+    /// the update function, called with the frame index and the buffer index to write
+    typedef std::function<void(int64 frameIndex, int32 bufferIndex)> UpdateFunc;
+
+    /// constructor
+    FramePipeline();
+    /// destructor
+    ~FramePipeline();
+
+    /// setup the pipeline and start the update thread
+    void Setup(UpdateFunc updateFunc);
+    /// wait for the running update and stop the update thread
+    void Discard();
+    /// return true if the pipeline has been setup
+    bool IsValid() const;
+
+    /// begin a new frame, waits until the update of the frame has finished
+    void BeginFrame();
+    /// start the update of the next frame
+    void StartUpdate();
+    /// wait until a running update has finished (explicit sync point)
+    void Sync();
+
+    /// get the index of the current frame (-1 before the first BeginFrame())
+    int64 FrameIndex() const;
+    /// get the buffer index the current frame reads from
+    int32 RenderBufferIndex() const;
+    /// get the buffer index the next frame's update writes to
+    int32 UpdateBufferIndex() const;
+    /// get the fence which is signalled after each update
+    const FrameFence& UpdateFence() const;
+
+private:
+    /// not copyable
+    FramePipeline(const FramePipeline& rhs) = delete;
+    /// not copyable
+    void operator=(const FramePipeline& rhs) = delete;
+
+    /// run the update of a frame on the calling thread
+    void update(int64 frameIndex);
+    /// the update thread function
+    void threadFunc();
+
+    bool isValid;
+    int64 curFrame;
+    UpdateFunc updateFunc;
+    FrameFence startFence;          // signalled by main thread when an update may start
+    FrameFence updateFence;         // signalled by update thread when an update is done
+    #if ORYOL_HAS_THREADS
+    std::atomic<bool> stopRequested;
+    std::thread thread;
+    #endif
+};
+
+//------------------------------------------------------------------------------
+inline bool
+FramePipeline::IsValid() const {
+    return this->isValid;
+}
+
+//------------------------------------------------------------------------------
+inline int64
+FramePipeline::FrameIndex() const {
+    return this->curFrame;
+}
+
+//------------------------------------------------------------------------------
+inline int32
+FramePipeline::RenderBufferIndex() const {
+    return int32(this->curFrame & (NumBuffers - 1));
+}
+
+//------------------------------------------------------------------------------
+inline int32
+FramePipeline::UpdateBufferIndex() const {
+    return int32((this->curFrame + 1) & (NumBuffers - 1));
+}
+
+//------------------------------------------------------------------------------
+inline const FrameFence&
+FramePipeline::UpdateFence() const {
+    return this->updateFence;
+}
+
+} // namespace Oryol
@@ -0,0 +1,481 @@
+//------------------------------------------------------------------------------
+//  JobSystem.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "JobSystem.h"
+#include "Core/Core.h"
+#include "Core/Threading/jobDeque.h"
+#include "Core/Threading/ThreadLocalPtr.h"
+#include "Core/Containers/MPMCQueue.h"
+#include "Core/Containers/Array.h"
+#include "Core/Memory/Memory.h"
+#include <atomic>
+#if ORYOL_HAS_THREADS
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
+
+namespace Oryol {
+
+// per-thread job queue, one for each worker and one for the setup thread
+struct jobWorker {
+    jobWorker(int32 index_, int32 dequeCapacity) :
+        index(index_),
+        rand(0x9E3779B9 * uint32(index_ + 1)),
+        deque(dequeCapacity) { };
+    int32 index;
+    uint32 rand;
+    jobDeque deque;
+    #if ORYOL_HAS_THREADS
+    std::thread thread;
+    #endif
+};
+
+// a job slot
+struct alignas(ORYOL_CACHELINE_SIZE) jobSlot {
+    void (*func)(void* data);
+    uint32 parent;
+    std::atomic<int32> unfinished;      // 1 for the job itself + number of unfinished children
+    std::atomic<int32> pendingDeps;     // 1 while starting + number of unfinished dependencies
+    std::atomic<uint32> generation;     // incremented when job is finished
+    std::atomic<bool> lock;             // protects continuations and the generation bump
+    int32 numContinuations;
+    uint32 continuations[JobSystem::MaxContinuations];
+    alignas(16) uint8 data[JobSystem::MaxJobDataSize];
+};
+
+struct JobSystem::_state {
+    _state(int32 maxJobs_) :
+        jobs(nullptr),
+        maxJobs(maxJobs_),
+        freeJobs(maxJobs_),
+        injectQueue(maxJobs_),
+        numQueued(0),
+        numSleeping(0),
+        stopRequested(false) { };
+    jobSlot* jobs;
+    int32 maxJobs;
+    MPMCQueue<uint32> freeJobs;
+    MPMCQueue<uint32> injectQueue;      // jobs pushed from non-worker threads
+    Array<jobWorker*> workers;
+    std::atomic<int32> numQueued;
+    std::atomic<int32> numSleeping;
+    std::atomic<bool> stopRequested;
+    #if ORYOL_HAS_THREADS
+    std::mutex wakeupMutex;
+    std::condition_variable wakeup;
+    #endif
+};
+
+JobSystem::_state* JobSystem::state = nullptr;
+static ORYOL_THREADLOCAL_PTR(jobWorker) threadWorker = nullptr;
+static ORYOL_THREADLOCAL_PTR(jobSlot) threadCurJob = nullptr;
+
+// number of unsuccessful job searches before a worker goes to sleep
+static const int32 MaxIdleSpins = 64;
+
+//------------------------------------------------------------------------------
+static void
+lockJob(jobSlot& job) {
+    while (job.lock.exchange(true, std::memory_order_acquire)) {
+        // spinning...
+    }
+}
+
+//------------------------------------------------------------------------------
+static void
+unlockJob(jobSlot& job) {
+    job.lock.store(false, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::Setup(int32 numWorkers, int32 maxJobs) {
+    o_assert(!IsValid());
+    o_assert((maxJobs > 0) && (maxJobs <= (1<<24)));
+    #if ORYOL_HAS_THREADS
+    if (numWorkers < 0) {
+        numWorkers = int32(std::thread::hardware_concurrency()) - 1;
+        if (numWorkers < 0) {
+            numWorkers = 0;
+        }
+    }
+    #else
+    numWorkers = 0;
+    #endif
+
+    state = new _state(maxJobs);
+    state->jobs = (jobSlot*) Memory::AllocAligned(maxJobs * sizeof(jobSlot), ORYOL_CACHELINE_SIZE, MemoryTag::Core);
+    for (int32 i = 0; i < maxJobs; i++) {
+        jobSlot* job = new(&state->jobs[i]) jobSlot();
+        job->func = nullptr;
+        job->parent = JobHandle::InvalidJobIndex;
+        job->unfinished.store(0, std::memory_order_relaxed);
+        job->pendingDeps.store(0, std::memory_order_relaxed);
+        job->generation.store(0, std::memory_order_relaxed);
+        job->lock.store(false, std::memory_order_relaxed);
+        job->numContinuations = 0;
+        state->freeJobs.TryEnqueue(uint32(i));
+    }
+
+    // every deque must be able to hold all jobs
+    int32 dequeCapacity = 2;
+    while (dequeCapacity < maxJobs) {
+        dequeCapacity <<= 1;
+    }
+    for (int32 i = 0; i <= numWorkers; i++) {
+        state->workers.Add(new jobWorker(i, dequeCapacity));
+    }
+    threadWorker = state->workers[0];
+    #if ORYOL_HAS_THREADS
+    for (int32 i = 1; i <= numWorkers; i++) {
+        state->workers[i]->thread = std::thread(workerFunc, i);
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::Discard() {
+    o_assert(IsValid());
+    o_assert(0 == ThreadIndex());
+
+    // run remaining jobs, then stop the workers (they also run
+    // all remaining jobs before they exit)
+    while (runOneJob()) {
+        // empty
+    }
+    #if ORYOL_HAS_THREADS
+    {
+        std::lock_guard<std::mutex> lock(state->wakeupMutex);
+        state->stopRequested.store(true);
+        state->wakeup.notify_all();
+    }
+    for (int32 i = 1; i < state->workers.Size(); i++) {
+        state->workers[i]->thread.join();
+    }
+    #endif
+    while (runOneJob()) {
+        // empty
+    }
+    o_assert2(state->freeJobs.Size() == state->maxJobs, "JobSystem::Discard(): unfinished jobs (unclosed group?)\n");
+
+    for (jobWorker* worker : state->workers) {
+        delete worker;
+    }
+    state->workers.Clear();
+    for (int32 i = 0; i < state->maxJobs; i++) {
+        state->jobs[i].~jobSlot();
+    }
+    Memory::FreeAligned(state->jobs);
+    threadWorker = nullptr;
+    delete state;
+    state = nullptr;
+}
+
+//------------------------------------------------------------------------------
+bool
+JobSystem::IsValid() {
+    return nullptr != state;
+}
+
+//------------------------------------------------------------------------------
+int32
+JobSystem::NumThreads() {
+    o_assert_dbg(IsValid());
+    return state->workers.Size();
+}
+
+//------------------------------------------------------------------------------
+int32
+JobSystem::ThreadIndex() {
+    jobWorker* worker = threadWorker;
+    return worker ? worker->index : InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+/**
+ NOTE: this must not wait for a free slot, since the slots may all be
+ owned by jobs which are themselves waiting for a free slot.
+*/
+JobHandle
+JobSystem::allocJob(void (*func)(void*), const JobHandle& parent) {
+    o_assert_dbg(IsValid());
+    uint32 index = 0;
+    if (!state->freeJobs.TryDequeue(index)) {
+        return JobHandle();
+    }
+    jobSlot& job = state->jobs[index];
+    job.func = func;
+    job.parent = parent.index;
+    job.unfinished.store(1, std::memory_order_relaxed);
+    job.pendingDeps.store(1, std::memory_order_relaxed);
+    job.numContinuations = 0;
+    if (parent.IsValid()) {
+        // the caller must guarantee that the parent can't finish while
+        // children are added (e.g. by adding children from within the
+        // parent job, or before a group is closed)
+        o_assert_dbg(!IsFinished(parent));
+        state->jobs[parent.index].unfinished.fetch_add(1, std::memory_order_relaxed);
+    }
+    JobHandle handle;
+    handle.index = index;
+    handle.generation = job.generation.load(std::memory_order_relaxed);
+    return handle;
+}
+
+//------------------------------------------------------------------------------
+void*
+JobSystem::jobData(const JobHandle& job) {
+    o_assert_dbg(job.IsValid());
+    return state->jobs[job.index].data;
+}
+
+//------------------------------------------------------------------------------
+/**
+ The job registers itself as continuation of each unfinished dependency,
+ the last finishing dependency pushes the job. If a dependency already
+ has MaxContinuations waiting jobs, this will wait for the dependency
+ right here instead.
+*/
+void
+JobSystem::startJob(const JobHandle& handle, const JobHandle* deps, int32 numDeps) {
+    jobSlot& job = state->jobs[handle.index];
+    for (int32 i = 0; i < numDeps; i++) {
+        const JobHandle& dep = deps[i];
+        if (!dep.IsValid()) {
+            continue;
+        }
+        jobSlot& depJob = state->jobs[dep.index];
+        bool added = false;
+        bool finished = false;
+        lockJob(depJob);
+        if (depJob.generation.load(std::memory_order_relaxed) != dep.generation) {
+            finished = true;
+        }
+        else if (depJob.numContinuations < MaxContinuations) {
+            job.pendingDeps.fetch_add(1, std::memory_order_relaxed);
+            depJob.continuations[depJob.numContinuations++] = handle.index;
+            added = true;
+        }
+        unlockJob(depJob);
+        if (!(added || finished)) {
+            Wait(dep);
+        }
+    }
+    if (1 == job.pendingDeps.fetch_sub(1, std::memory_order_acq_rel)) {
+        pushJob(handle.index);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::CloseGroup(const JobHandle& group) {
+    o_assert_dbg(group.IsValid() && !IsFinished(group));
+    finishJob(group.index);
+}
+
+//------------------------------------------------------------------------------
+JobHandle
+JobSystem::CurrentJob() {
+    JobHandle handle;
+    jobSlot* job = threadCurJob;
+    if (job) {
+        handle.index = uint32(job - state->jobs);
+        handle.generation = job->generation.load(std::memory_order_relaxed);
+    }
+    return handle;
+}
+
+//------------------------------------------------------------------------------
+/**
+ If all job slots are in use, this will run other jobs until a
+ slot has been freed.
+*/
+JobHandle
+JobSystem::CreateGroup() {
+    JobHandle group = allocJob(nullptr, JobHandle());
+    while (!group.IsValid()) {
+        if (!runOneJob()) {
+            #if ORYOL_HAS_THREADS
+            std::this_thread::yield();
+            #else
+            o_assert2(false, "JobSystem::CreateGroup(): out of job slots!\n");
+            #endif
+        }
+        group = allocJob(nullptr, JobHandle());
+    }
+    return group;
+}
+
+//------------------------------------------------------------------------------
+bool
+JobSystem::IsFinished(const JobHandle& job) {
+    if (!job.IsValid()) {
+        return true;
+    }
+    o_assert_dbg(IsValid());
+    return state->jobs[job.index].generation.load(std::memory_order_acquire) != job.generation;
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::Wait(const JobHandle& job) {
+    while (!IsFinished(job)) {
+        if (!runOneJob()) {
+            #if ORYOL_HAS_THREADS
+            std::this_thread::yield();
+            #else
+            o_assert2(false, "JobSystem::Wait(): job can never finish (unclosed group?)\n");
+            #endif
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::pushJob(uint32 index) {
+    state->numQueued.fetch_add(1);
+    jobWorker* worker = threadWorker;
+    bool pushed = false;
+    if (worker) {
+        pushed = worker->deque.Push(index);
+    }
+    if (!pushed) {
+        pushed = state->injectQueue.TryEnqueue(index);
+    }
+    if (!pushed) {
+        // queues are full, run the job right here
+        state->numQueued.fetch_sub(1);
+        execJob(index);
+        return;
+    }
+    #if ORYOL_HAS_THREADS
+    // the mutex makes sure that a worker which is about to sleep
+    // either sees the new job, or gets the notification
+    if (state->numSleeping.load() > 0) {
+        std::lock_guard<std::mutex> lock(state->wakeupMutex);
+        state->wakeup.notify_one();
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+bool
+JobSystem::runOneJob() {
+    jobWorker* worker = threadWorker;
+    uint32 index = 0;
+    bool found = worker && worker->deque.Pop(index);
+    if (!found) {
+        found = state->injectQueue.TryDequeue(index);
+    }
+    if (!found) {
+        // try to steal from other threads, starting at a random victim
+        const int32 numWorkers = state->workers.Size();
+        uint32 start = 0;
+        if (worker) {
+            worker->rand ^= worker->rand << 13;
+            worker->rand ^= worker->rand >> 17;
+            worker->rand ^= worker->rand << 5;
+            start = worker->rand;
+        }
+        for (int32 i = 0; (i < numWorkers) && !found; i++) {
+            jobWorker* victim = state->workers[(start + i) % numWorkers];
+            if (victim != worker) {
+                found = victim->deque.Steal(index);
+            }
+        }
+    }
+    if (found) {
+        state->numQueued.fetch_sub(1, std::memory_order_relaxed);
+        execJob(index);
+    }
+    return found;
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::execJob(uint32 index) {
+    jobSlot& job = state->jobs[index];
+    o_assert_dbg(job.func);
+    // jobs can be nested if a job waits for other jobs
+    jobSlot* prevJob = threadCurJob;
+    threadCurJob = &job;
+    job.func(job.data);
+    threadCurJob = prevJob;
+    finishJob(index);
+}
+
+//------------------------------------------------------------------------------
+/**
+ When the last reference is gone (the job itself and all children),
+ the generation is bumped which marks the job as finished, the slot
+ is freed, the continuations are released and the parent is notified.
+*/
+void
+JobSystem::finishJob(uint32 index) {
+    jobSlot& job = state->jobs[index];
+    if (1 != job.unfinished.fetch_sub(1, std::memory_order_acq_rel)) {
+        return;
+    }
+    uint32 continuations[MaxContinuations];
+    lockJob(job);
+    const int32 numContinuations = job.numContinuations;
+    for (int32 i = 0; i < numContinuations; i++) {
+        continuations[i] = job.continuations[i];
+    }
+    job.numContinuations = 0;
+    const uint32 parent = job.parent;
+    job.generation.fetch_add(1, std::memory_order_release);
+    unlockJob(job);
+    const bool freed = state->freeJobs.TryEnqueue(index);
+    o_assert_dbg(freed);
+    (void)freed;
+
+    for (int32 i = 0; i < numContinuations; i++) {
+        if (1 == state->jobs[continuations[i]].pendingDeps.fetch_sub(1, std::memory_order_acq_rel)) {
+            pushJob(continuations[i]);
+        }
+    }
+    if (JobHandle::InvalidJobIndex != parent) {
+        finishJob(parent);
+    }
+}
+
+//------------------------------------------------------------------------------
+#if ORYOL_HAS_THREADS
+void
+JobSystem::workerFunc(int32 threadIndex) {
+    Core::EnterThread();
+    threadWorker = state->workers[threadIndex];
+
+    int32 numIdleSpins = 0;
+    for (;;) {
+        if (runOneJob()) {
+            numIdleSpins = 0;
+            continue;
+        }
+        if (state->stopRequested.load(std::memory_order_relaxed)) {
+            break;
+        }
+        if (++numIdleSpins < MaxIdleSpins) {
+            std::this_thread::yield();
+            continue;
+        }
+        // no work found for a while, go to sleep until jobs are pushed
+        numIdleSpins = 0;
+        std::unique_lock<std::mutex> lock(state->wakeupMutex);
+        state->numSleeping++;
+        state->wakeup.wait(lock, [] {
+            return (state->numQueued.load() > 0) || state->stopRequested.load();
+        });
+        state->numSleeping--;
+    }
+
+    threadWorker = nullptr;
+    Core::LeaveThread();
+}
+#endif
+
+} // namespace Oryol
@@ -0,0 +1,231 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::JobSystem
+    @ingroup Core
+    @brief work-stealing job system for spreading CPU work over all cores
+
+    The JobSystem owns a fixed pool of worker threads, each with its own
+    Chase-Lev deque. A job pushed from a worker goes to the bottom of
+    that worker's deque and is popped from there again (LIFO, cache-hot),
+    idle workers steal from the top of other deques (FIFO). The thread
+    which called Setup() (usually the main thread) has a deque too and
+    runs jobs while it waits, jobs pushed from any other thread go into
+    a shared injection queue. Workers which don't find any work spin
+    shortly and then go to sleep until new jobs are pushed.
+
+    A job is a small function object (at most MaxJobDataSize bytes, so
+    capture big things by reference or pointer) which is copied into
+    a preallocated job slot, creating a job doesn't allocate memory.
+    If all job slots are in use, Run() calls the job function directly
+    and returns an invalid handle (which counts as finished).
+    Run() returns a JobHandle which can be waited on, a job is finished
+    when its function has returned AND all of its child jobs have
+    finished (to spawn children from inside a job, use CurrentJob() as
+    parent), so a job handle doubles as a counter for fork/join:
+
+        JobHandle group = JobSystem::CreateGroup();
+        for (...) {
+            JobSystem::Run([...]() { ... }, group);
+        }
+        JobSystem::CloseGroup(group);
+        JobSystem::Wait(group);
+
+    RunAfter() starts a job only after a set of other jobs has finished.
+    Wait() doesn't block the calling thread but runs other jobs until
+    the waited-on job is finished.
+
+    ParallelFor(begin, end, grain, func) calls func(first, last) on
+    sub-ranges [first, last) of [begin, end) in parallel, the range is
+    split recursively into halves until they are not bigger than grain,
+    and returns when all sub-ranges have been processed.
+
+    Worker threads call Core::EnterThread() and Core::LeaveThread(),
+    so thread-local Core objects (like the thread's FrameArena) are
+    available in jobs. Job functions must not block waiting for other
+    threads (except through Wait()), and must not throw.
+
+    On platforms without threads, no workers are created and jobs are
+    run by the thread which waits on them.
+*/
+#include "Core/Config.h"
+#include "Core/Types.h"
+#include "Core/Assert.h"
+#include <initializer_list>
+#include <new>
+
+namespace Oryol {
+
+class JobHandle {
+public:
+    /// default constructor, invalid handle
+    JobHandle() : index(InvalidJobIndex), generation(0) { };
+    /// return true if the handle is valid
+    bool IsValid() const {
+        return InvalidJobIndex != this->index;
+    };
+    /// invalidate the handle
+    void Invalidate() {
+        this->index = InvalidJobIndex;
+        this->generation = 0;
+    };
+    /// equality
+    bool operator==(const JobHandle& rhs) const {
+        return (this->index == rhs.index) && (this->generation == rhs.generation);
+    };
+    /// inequality
+    bool operator!=(const JobHandle& rhs) const {
+        return !operator==(rhs);
+    };
+
+private:
+    friend class JobSystem;
+    static const uint32 InvalidJobIndex = 0xFFFFFFFF;
+    uint32 index;
+    uint32 generation;
+};
+
+class JobSystem {
+public:
+    /// max size of a job function object in bytes
+    static const int32 MaxJobDataSize = 64;
+    /// max number of jobs which can directly wait on one job through RunAfter()
+    static const int32 MaxContinuations = 6;
+    /// default max number of jobs in flight
+    static const int32 DefaultMaxJobs = 4096;
+
+    /// setup the job system, numWorkers < 0 means 'number of cores - 1'
+    static void Setup(int32 numWorkers=-1, int32 maxJobs=DefaultMaxJobs);
+    /// discard the job system (runs remaining jobs and stops the workers)
+    static void Discard();
+    /// return true if the job system has been setup
+    static bool IsValid();
+    /// get number of threads running jobs (worker threads + setup thread)
+    static int32 NumThreads();
+    /// get index of the calling thread (0: setup thread, 1..N: workers, InvalidIndex: other threads)
+    static int32 ThreadIndex();
+
+    /// run a job, optionally as child of a parent job (or group)
+    template<class FUNC> static JobHandle Run(const FUNC& func, const JobHandle& parent=JobHandle());
+    /// run a job after other jobs have finished
+    template<class FUNC> static JobHandle RunAfter(std::initializer_list<JobHandle> deps, const FUNC& func);
+    /// get handle of the job running on this thread (invalid if not called from a job)
+    static JobHandle CurrentJob();
+    /// create an empty job which finishes when all of its children are finished
+    static JobHandle CreateGroup();
+    /// close a group after all children have been added
+    static void CloseGroup(const JobHandle& group);
+    /// test if a job (or group) has finished
+    static bool IsFinished(const JobHandle& job);
+    /// wait for a job (or group) to finish, runs other jobs while waiting
+    static void Wait(const JobHandle& job);
+    /// call func(first, last) on sub-ranges of [begin, end) in parallel
+    template<class FUNC> static void ParallelFor(int32 begin, int32 end, int32 grain, const FUNC& func);
+
+private:
+    /// call and destroy a job function object
+    template<class FUNC> static void callJobFunc(void* data);
+    /// recursively split a ParallelFor range into child jobs of root
+    template<class FUNC> static void parallelForRange(const JobHandle& root, int32 begin, int32 end, int32 grain, const FUNC* func);
+    /// allocate a job slot, returns invalid handle if all slots are in use
+    static JobHandle allocJob(void (*func)(void*), const JobHandle& parent);
+    /// get pointer to job function object storage
+    static void* jobData(const JobHandle& job);
+    /// start a job after its dependencies are finished
+    static void startJob(const JobHandle& job, const JobHandle* deps, int32 numDeps);
+    /// push a ready job to a queue
+    static void pushJob(uint32 jobIndex);
+    /// try to find and run one job, return false if no job was found
+    static bool runOneJob();
+    /// run a job and finish it
+    static void execJob(uint32 jobIndex);
+    /// decrement the unfinished-counter of a job, and complete the job if 0
+    static void finishJob(uint32 jobIndex);
+    /// the worker thread function
+    static void workerFunc(int32 threadIndex);
+
+    struct _state;
+    static _state* state;
+};
+
+//------------------------------------------------------------------------------
+template<class FUNC> void
+JobSystem::callJobFunc(void* data) {
+    FUNC* func = (FUNC*) data;
+    (*func)();
+    func->~FUNC();
+}
+
+//------------------------------------------------------------------------------
+template<class FUNC> JobHandle
+JobSystem::Run(const FUNC& func, const JobHandle& parent) {
+    static_assert(sizeof(FUNC) <= MaxJobDataSize, "JobSystem: job function too big, capture by reference or pointer!");
+    static_assert(alignof(FUNC) <= 16, "JobSystem: job function alignment too big!");
+    JobHandle job = allocJob(&callJobFunc<FUNC>, parent);
+    if (!job.IsValid()) {
+        // out of job slots, run the job right here
+        func();
+        return job;
+    }
+    new(jobData(job)) FUNC(func);
+    startJob(job, nullptr, 0);
+    return job;
+}
+
+//------------------------------------------------------------------------------
+template<class FUNC> JobHandle
+JobSystem::RunAfter(std::initializer_list<JobHandle> deps, const FUNC& func) {
+    static_assert(sizeof(FUNC) <= MaxJobDataSize, "JobSystem: job function too big, capture by reference or pointer!");
+    static_assert(alignof(FUNC) <= 16, "JobSystem: job function alignment too big!");
+    JobHandle job = allocJob(&callJobFunc<FUNC>, JobHandle());
+    if (!job.IsValid()) {
+        // out of job slots, wait for the dependencies and run the job right here
+        for (const JobHandle& dep : deps) {
+            Wait(dep);
+        }
+        func();
+        return job;
+    }
+    new(jobData(job)) FUNC(func);
+    startJob(job, deps.begin(), int32(deps.size()));
+    return job;
+}
+
+//------------------------------------------------------------------------------
+template<class FUNC> void
+JobSystem::parallelForRange(const JobHandle& root, int32 begin, int32 end, int32 grain, const FUNC* func) {
+    // push the upper halves as jobs, and process the lowest part directly
+    while ((end - begin) > grain) {
+        const int32 mid = begin + (end - begin) / 2;
+        JobHandle r = root;
+        Run([r, mid, end, grain, func]() {
+            parallelForRange(r, mid, end, grain, func);
+        }, root);
+        end = mid;
+    }
+    (*func)(begin, end);
+}
+
+//------------------------------------------------------------------------------
+template<class FUNC> void
+JobSystem::ParallelFor(int32 begin, int32 end, int32 grain, const FUNC& func) {
+    o_assert_dbg(IsValid());
+    o_assert_dbg(grain > 0);
+    if (begin >= end) {
+        return;
+    }
+    if (((end - begin) <= grain) || (1 == NumThreads())) {
+        func(begin, end);
+        return;
+    }
+    JobHandle root = allocJob(nullptr, JobHandle());
+    if (!root.IsValid()) {
+        func(begin, end);
+        return;
+    }
+    parallelForRange(root, begin, end, grain, &func);
+    CloseGroup(root);
+    Wait(root);
+}
+
+} // namespace Oryol
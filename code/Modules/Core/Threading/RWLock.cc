@@ -0,0 +1,127 @@
+//------------------------------------------------------------------------------
+//  RWLock.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "RWLock.h"
+#if ORYOL_HAS_THREADS
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define ORYOL_RWLOCK_PAUSE() _mm_pause()
+#elif (defined(__arm__) || defined(__aarch64__)) && (defined(__GNUC__) || defined(__clang__))
+#define ORYOL_RWLOCK_PAUSE() __asm__ __volatile__("yield")
+#else
+#define ORYOL_RWLOCK_PAUSE()
+#endif
+
+namespace Oryol {
+
+// number of exponential backoff rounds (1, 2, 4, ... pause instructions)
+static const int32 MaxSpinRounds = 10;
+// number of yields after spinning before a thread is parked
+static const int32 MaxYieldRounds = 4;
+
+#if ORYOL_HAS_THREADS
+namespace {
+// the parking lot, threads wait on the condition variable of the
+// bucket their lock hashes to (different locks can share a bucket)
+struct parkingBucket {
+    std::mutex mutex;
+    std::condition_variable cond;
+    uint8 pad[ORYOL_CACHELINE_SIZE];
+};
+const int32 NumParkingBuckets = 64;
+
+parkingBucket&
+parkingBucketFor(const void* lock) {
+    static parkingBucket buckets[NumParkingBuckets];
+    const uintptr addr = (uintptr) lock;
+    return buckets[((addr >> 4) ^ (addr >> 10)) & (NumParkingBuckets - 1)];
+}
+} // anonymous namespace
+#endif
+
+//------------------------------------------------------------------------------
+/**
+ Wait a bit before the next attempt to take the lock: spin with
+ exponential backoff first, then yield, and finally park the thread
+ until the lock is released (canLock() is checked while parking).
+*/
+template<class CANLOCK> static void
+backoff(int32& round, std::atomic<int32>& numParked, const void* lock, CANLOCK canLock) {
+    if (round < MaxSpinRounds) {
+        const int32 numPauses = 1 << round;
+        for (int32 i = 0; i < numPauses; i++) {
+            ORYOL_RWLOCK_PAUSE();
+        }
+        round++;
+        return;
+    }
+    #if ORYOL_HAS_THREADS
+    if (round < (MaxSpinRounds + MaxYieldRounds)) {
+        std::this_thread::yield();
+        round++;
+        return;
+    }
+    // park the thread, the lock state is checked again after numParked
+    // has been incremented, so that an unlocking thread either sees
+    // the parked thread, or this thread sees the unlocked state
+    parkingBucket& bucket = parkingBucketFor(lock);
+    std::unique_lock<std::mutex> guard(bucket.mutex);
+    numParked.fetch_add(1, std::memory_order_seq_cst);
+    if (!canLock()) {
+        bucket.cond.wait(guard);
+    }
+    numParked.fetch_sub(1, std::memory_order_relaxed);
+    round = 0;
+    #else
+    o_assert2(false, "RWLock: lock can never be acquired without threads!\n");
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+RWLock::lockWriteSlow() {
+    // with PreferWriter, waiting writers block new readers
+    this->numWaitingWriters.fetch_add(1, std::memory_order_seq_cst);
+    int32 round = 0;
+    bool locked = false;
+    while (!locked) {
+        if (0 == this->state.load(std::memory_order_relaxed)) {
+            locked = this->TryLockWrite();
+        }
+        if (!locked) {
+            backoff(round, this->numParked, this, [this]() -> bool {
+                return 0 == this->state.load(std::memory_order_seq_cst);
+            });
+        }
+    }
+    this->numWaitingWriters.fetch_sub(1, std::memory_order_seq_cst);
+}
+
+//------------------------------------------------------------------------------
+void
+RWLock::lockReadSlow() {
+    int32 round = 0;
+    while (!this->TryLockRead()) {
+        backoff(round, this->numParked, this, [this]() -> bool {
+            const bool writerWaits = (PreferWriter == this->policy) && (this->numWaitingWriters.load(std::memory_order_seq_cst) > 0);
+            return !writerWaits && (0 == (this->state.load(std::memory_order_seq_cst) & WriterBit));
+        });
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+RWLock::wakeParked() {
+    #if ORYOL_HAS_THREADS
+    parkingBucket& bucket = parkingBucketFor(this);
+    std::lock_guard<std::mutex> guard(bucket.mutex);
+    bucket.cond.notify_all();
+    #endif
+}
+
+} // namespace Oryol
@@ -4,17 +4,48 @@
     @class Oryol::RWLock
     @ingroup Core
     @brief single-write / multiple-reader lock
+
+    The lock state is a single atomic word (a writer bit and the number
+    of readers), so taking an uncontended lock is one compare-and-swap,
+    and releasing it is one atomic subtraction.
+
+    If the lock is taken, a thread first spins with exponential backoff
+    (using the CPU's pause instruction), then yields a few times, and
+    finally parks on a condition variable. The condition variables live
+    in a small global 'parking lot' hashed by the lock's address, so an
+    RWLock object itself is only a few words and can be a global object.
+    Unlocking only touches the parking lot if threads are parked.
+
+    The policy decides what happens if readers and writers compete:
+
+    - PreferWriter (default): new readers wait while a writer is waiting,
+      so writers can't be starved by a steady stream of readers
+    - PreferReader: readers only wait while a writer holds the lock,
+      writers wait until there are no readers at all
+
+    Read locks are not recursive under PreferWriter: if a thread which
+    holds a read lock locks for reading again while another thread
+    waits for the write lock, both threads deadlock. Use PreferReader
+    if read locks can be re-entered (e.g. the global lock in Log).
 */
 #include "Core/Config.h"
 #include "Core/Types.h"
-#if ORYOL_HAS_ATOMIC
+#include "Core/Assert.h"
 #include <atomic>
-#endif
 
 namespace Oryol {
 
 class RWLock {
 public:
+    /// lock policies
+    enum Policy {
+        PreferWriter,
+        PreferReader,
+    };
+
+    /// constructor (constexpr, so global RWLocks are constant-initialized)
+    constexpr RWLock(Policy policy=PreferWriter);
+
     /// lock for writing
     void LockWrite();
     /// unlock from writing
@@ -23,57 +54,107 @@ public:
     void LockRead();
     /// unlock from reading
     void UnlockRead();
-    
+    /// try to lock for writing, return false if the lock is taken
+    bool TryLockWrite();
+    /// try to lock for reading, return false if the lock is taken (or a writer waits)
+    bool TryLockRead();
+    /// get the lock policy
+    Policy GetPolicy() const;
+
 private:
-#if ORYOL_HAS_ATOMIC
-    std::atomic<bool> writeLock{false};
-    std::atomic<int32> readCount{0};
-#endif
+    /// not copyable
+    RWLock(const RWLock& rhs) = delete;
+    /// not copyable
+    void operator=(const RWLock& rhs) = delete;
+
+    /// spin, yield and park until locked for writing
+    void lockWriteSlow();
+    /// spin, yield and park until locked for reading
+    void lockReadSlow();
+    /// wake up parked threads
+    void wakeParked();
+
+    static const uint32 WriterBit = 0x80000000;
+    Policy policy;
+    std::atomic<uint32> state;              // WriterBit | number of readers
+    std::atomic<int32> numWaitingWriters;   // writers in the slow path
+    std::atomic<int32> numParked;           // threads parked in the parking lot
 };
 
+//------------------------------------------------------------------------------
+constexpr
+RWLock::RWLock(Policy policy_) :
+policy(policy_),
+state(0),
+numWaitingWriters(0),
+numParked(0) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+inline RWLock::Policy
+RWLock::GetPolicy() const {
+    return this->policy;
+}
+
+//------------------------------------------------------------------------------
+inline bool
+RWLock::TryLockWrite() {
+    uint32 expected = 0;
+    return this->state.compare_exchange_strong(expected, WriterBit, std::memory_order_acquire, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+inline bool
+RWLock::TryLockRead() {
+    uint32 s = this->state.load(std::memory_order_relaxed);
+    if ((PreferWriter == this->policy) && (this->numWaitingWriters.load(std::memory_order_relaxed) > 0)) {
+        return false;
+    }
+    while (0 == (s & WriterBit)) {
+        if (this->state.compare_exchange_weak(s, s + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 //------------------------------------------------------------------------------
 inline void
 RWLock::LockWrite() {
-#if ORYOL_HAS_ATOMIC
-    /// acquire the write-lock
-    while (std::atomic_exchange_explicit(&this->writeLock, true, std::memory_order_acquire)) {
-        // spinning...
-    }
-    /// spin until no-one's reading anymore
-    while (this->readCount > 0) {
-        // spinning...
+    if (!this->TryLockWrite()) {
+        this->lockWriteSlow();
     }
-#endif
 }
 
 //------------------------------------------------------------------------------
 inline void
 RWLock::UnlockWrite() {
-#if ORYOL_HAS_ATOMIC
-    std::atomic_store_explicit(&this->writeLock, false, std::memory_order_release);
-#endif
+    o_assert_dbg(WriterBit == this->state.load(std::memory_order_relaxed));
+    // NOTE: the seq_cst RMW and load pair up with the parking threads
+    this->state.fetch_and(~WriterBit, std::memory_order_seq_cst);
+    if (this->numParked.load(std::memory_order_seq_cst) > 0) {
+        this->wakeParked();
+    }
 }
 
 //------------------------------------------------------------------------------
 inline void
 RWLock::LockRead() {
-#if ORYOL_HAS_ATOMIC
-    /// spin until no one is writing anymore
-    while (this->writeLock) {
-        // spinning...
+    if (!this->TryLockRead()) {
+        this->lockReadSlow();
     }
-    /// increment the read-count
-    ++this->readCount;
-#endif
 }
 
 //------------------------------------------------------------------------------
 inline void
 RWLock::UnlockRead() {
-#if ORYOL_HAS_ATOMIC
-    --this->readCount;
-#endif
+    const uint32 prev = this->state.fetch_sub(1, std::memory_order_seq_cst);
+    o_assert_dbg((prev & ~WriterBit) > 0);
+    // only the last reader can make room for a writer
+    if ((1 == prev) && (this->numParked.load(std::memory_order_seq_cst) > 0)) {
+        this->wakeParked();
+    }
 }
 
 } // namespace Oryol
-
@@ -32,7 +32,7 @@ ThreadLocalData::PointerTable() {
         // not assigned yet, allocate thread-specific table and
         // associate with key
         int tableSize = MaxNumSlots * sizeof(void*);
-        table = (void**) Memory::Alloc(tableSize);
+        table = (void**) Memory::Alloc(tableSize, MemoryTag::Core);
         Memory::Clear(table, tableSize);
         pthread_setspecific(key, table);
     }
@@ -0,0 +1,141 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::jobDeque
+    @ingroup Core
+    @brief private class, do not use
+
+    Fixed-capacity Chase-Lev work-stealing deque of job indices (the C11
+    version from Le et al., "Correct and Efficient Work-Stealing for Weak
+    Memory Models"). Only the owning thread may call Push() and Pop(),
+    which work on the bottom end (LIFO), any thread may call Steal()
+    which takes jobs from the top end (FIFO). Push() returns false if
+    the deque is full, the deque doesn't grow.
+*/
+#include "Core/Config.h"
+#include "Core/Types.h"
+#include "Core/Assert.h"
+#include "Core/Memory/Memory.h"
+#include <atomic>
+#include <new>
+
+namespace Oryol {
+
+class jobDeque {
+public:
+    /// constructor, capacity must be a power of 2
+    jobDeque(int32 capacity);
+    /// destructor
+    ~jobDeque();
+
+    /// push a job index to the bottom (owner thread only), return false if full
+    bool Push(uint32 jobIndex);
+    /// pop a job index from the bottom (owner thread only), return false if empty
+    bool Pop(uint32& outJobIndex);
+    /// steal a job index from the top (any thread), return false if empty or lost a race
+    bool Steal(uint32& outJobIndex);
+    /// return true if the deque looks empty (approximation)
+    bool Empty() const;
+
+private:
+    /// not copyable
+    jobDeque(const jobDeque& rhs) = delete;
+    /// not copyable
+    void operator=(const jobDeque& rhs) = delete;
+
+    std::atomic<uint32>* buffer;
+    int64 mask;
+    uint8 pad0[ORYOL_CACHELINE_SIZE];
+    std::atomic<int64> top;
+    uint8 pad1[ORYOL_CACHELINE_SIZE];
+    std::atomic<int64> bottom;
+    uint8 pad2[ORYOL_CACHELINE_SIZE];
+};
+
+//------------------------------------------------------------------------------
+inline
+jobDeque::jobDeque(int32 capacity) :
+buffer(nullptr),
+mask(capacity - 1),
+top(0),
+bottom(0) {
+    o_assert((capacity > 0) && (0 == (capacity & (capacity - 1))));
+    this->buffer = (std::atomic<uint32>*) Memory::AllocAligned(capacity * sizeof(std::atomic<uint32>), ORYOL_CACHELINE_SIZE, MemoryTag::Core);
+    for (int32 i = 0; i < capacity; i++) {
+        new(&this->buffer[i]) std::atomic<uint32>(0);
+    }
+}
+
+//------------------------------------------------------------------------------
+inline
+jobDeque::~jobDeque() {
+    Memory::FreeAligned(this->buffer);
+    this->buffer = nullptr;
+}
+
+//------------------------------------------------------------------------------
+inline bool
+jobDeque::Push(uint32 jobIndex) {
+    const int64 b = this->bottom.load(std::memory_order_relaxed);
+    const int64 t = this->top.load(std::memory_order_acquire);
+    if ((b - t) > this->mask) {
+        return false;
+    }
+    this->buffer[b & this->mask].store(jobIndex, std::memory_order_relaxed);
+    // publishes the job index (and the job data written before Push) to thieves
+    this->bottom.store(b + 1, std::memory_order_release);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+ The owner reserves the bottom slot first, and only needs to race
+ with thieves (through a CAS on top) when the last job is taken.
+*/
+inline bool
+jobDeque::Pop(uint32& outJobIndex) {
+    const int64 b = this->bottom.load(std::memory_order_relaxed) - 1;
+    this->bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64 t = this->top.load(std::memory_order_relaxed);
+    if (t > b) {
+        // was empty
+        this->bottom.store(b + 1, std::memory_order_relaxed);
+        return false;
+    }
+    outJobIndex = this->buffer[b & this->mask].load(std::memory_order_relaxed);
+    if (t == b) {
+        // last job, race against thieves
+        const bool won = this->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        this->bottom.store(b + 1, std::memory_order_relaxed);
+        return won;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+inline bool
+jobDeque::Steal(uint32& outJobIndex) {
+    int64 t = this->top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64 b = this->bottom.load(std::memory_order_acquire);
+    if (t >= b) {
+        return false;
+    }
+    const uint32 jobIndex = this->buffer[t & this->mask].load(std::memory_order_relaxed);
+    if (!this->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return false;
+    }
+    outJobIndex = jobIndex;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+inline bool
+jobDeque::Empty() const {
+    const int64 t = this->top.load(std::memory_order_relaxed);
+    const int64 b = this->bottom.load(std::memory_order_relaxed);
+    return b <= t;
+}
+
+} // namespace Oryol
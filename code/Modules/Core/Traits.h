@@ -0,0 +1,61 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @file Core/Traits.h
+    @brief type traits used by Oryol containers
+
+    IsTriviallyRelocatable<TYPE> is true if an object can be moved to
+    a new memory location with a plain memcpy() (without calling the
+    move constructor and the destructor of the moved-from object). This 
+    is true for all trivially copyable types, and can be specialized
+    for types which only own heap data through pointers (e.g. Ptr<> 
+    and String):
+
+    namespace Oryol {
+    template<> struct IsTriviallyRelocatable<MyType> : std::true_type { };
+    }
+
+    Containers will then grow, insert and erase elements with
+    Memory::Move() instead of moving elements one by one.
+
+    RadixSortKey<TYPE> describes how to map a value to an unsigned
+    integer sort key, so that the ordering of the keys matches the
+    ordering of operator<. If it is available (IsValid is true), the
+    sorting functions in Core/Containers/Sort.h use a radix sort
+    instead of a comparison sort. It is defined for integer types, and
+    can be specialized for integer-like types (e.g. handles or ids):
+
+    namespace Oryol {
+    template<> struct RadixSortKey<MyId> {
+        static const bool IsValid = true;
+        typedef uint64 Type;
+        static Type Get(const MyId& id) { return id.Value(); };
+    };
+    }
+*/
+#include <type_traits>
+#include "Core/Types.h"
+
+namespace Oryol {
+
+template<class TYPE> struct IsTriviallyRelocatable : std::is_trivially_copyable<TYPE> { };
+
+template<class TYPE, class ENABLE=void> struct RadixSortKey {
+    static const bool IsValid = false;
+    typedef uint32 Type;
+    static Type Get(const TYPE&) { return 0; };
+};
+
+/// integer types: signed values get their sign bit flipped to keep the ordering
+template<class TYPE> struct RadixSortKey<TYPE, typename std::enable_if<std::is_integral<TYPE>::value>::type> {
+    static const bool IsValid = true;
+    typedef typename std::conditional<(sizeof(TYPE) > 4), uint64, uint32>::type Type;
+    static Type Get(const TYPE& val) {
+        if (std::is_signed<TYPE>::value) {
+            return Type(val) ^ (Type(1) << (sizeof(Type) * 8 - 1));
+        }
+        return Type(val);
+    };
+};
+
+} // namespace Oryol
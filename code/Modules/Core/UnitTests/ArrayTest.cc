@@ -10,6 +10,24 @@
 
 using namespace Oryol;
 
+TEST(ArrayAlignmentTest) {
+    Array<float> array;
+    array.SetAlignment(64);
+    for (int32 i = 0; i < 1000; i++) {
+        array.Add(float(i));
+        CHECK(Memory::IsAligned(array.begin(), 64));
+    }
+    // copies keep the alignment
+    Array<float> copy(array);
+    CHECK(Memory::IsAligned(copy.begin(), 64));
+    copy.Add(1000.0f);
+    CHECK(copy.Size() == 1001);
+    CHECK(copy[999] == 999.0f);
+    Array<float> moved(std::move(copy));
+    CHECK(Memory::IsAligned(moved.begin(), 64));
+    CHECK(moved.Back() == 1000.0f);
+}
+
 TEST(ArrayTest) {
     
     // create empty array
@@ -0,0 +1,146 @@
+//------------------------------------------------------------------------------
+//  FrameArenaTest.cc
+//  Test FrameArena allocator.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Core.h"
+#include "Core/RunLoop.h"
+#include "Core/Memory/FrameArena.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/Queue.h"
+
+using namespace Oryol;
+
+TEST(FrameArenaTest) {
+
+    FrameArena arena(1024);
+    CHECK(arena.Capacity() == 0);
+    CHECK(arena.NumChunks() == 0);
+    CHECK(arena.AllocatedBytes() == 0);
+    CHECK(arena.NumAllocs() == 0);
+
+    // allocations are aligned and linear
+    uint8* p0 = (uint8*) arena.Alloc(10);
+    uint8* p1 = (uint8*) arena.Alloc(20);
+    CHECK((intptr(p0) & (ORYOL_MAX_PLATFORM_ALIGN - 1)) == 0);
+    CHECK((intptr(p1) & (ORYOL_MAX_PLATFORM_ALIGN - 1)) == 0);
+    CHECK(p1 == p0 + Memory::RoundUp(10, ORYOL_MAX_PLATFORM_ALIGN));
+    CHECK(arena.Owns(p0));
+    CHECK(arena.Owns(p1));
+    CHECK(arena.NumChunks() == 1);
+    CHECK(arena.Capacity() == 1024);
+    CHECK(arena.NumAllocs() == 2);
+    CHECK(arena.AllocatedBytes() == Memory::RoundUp(10, ORYOL_MAX_PLATFORM_ALIGN) + Memory::RoundUp(20, ORYOL_MAX_PLATFORM_ALIGN));
+
+    // freeing the last allocation rewinds the arena
+    arena.Free(p1);
+    uint8* p2 = (uint8*) arena.Alloc(20);
+    CHECK(p2 == p1);
+
+    // realloc of last allocation grows in place
+    Memory::Fill(p2, 20, 0x12);
+    uint8* p3 = (uint8*) arena.ReAlloc(p2, 20, 100);
+    CHECK(p3 == p2);
+    CHECK(p3[19] == 0x12);
+    // realloc of a previous allocation copies
+    Memory::Fill(p0, 10, 0x34);
+    uint8* p4 = (uint8*) arena.ReAlloc(p0, 10, 40);
+    CHECK(p4 != p0);
+    CHECK(p4[0] == 0x34);
+    CHECK(p4[9] == 0x34);
+
+    // spill into new chunks, oversized allocations get their own chunk
+    arena.Alloc(900);
+    CHECK(arena.NumChunks() == 2);
+    uint8* big = (uint8*) arena.Alloc(4096);
+    CHECK(arena.NumChunks() == 3);
+    CHECK(arena.Owns(big));
+    CHECK(arena.Capacity() == 1024 + 1024 + 4096);
+
+    // reset coalesces into a single chunk
+    arena.Reset();
+    CHECK(arena.NumChunks() == 1);
+    CHECK(arena.Capacity() == 1024 + 1024 + 4096);
+    CHECK(arena.AllocatedBytes() == 0);
+    CHECK(arena.NumAllocs() == 0);
+    uint8* p5 = (uint8*) arena.Alloc(5000);
+    CHECK(arena.NumChunks() == 1);
+    CHECK(arena.Owns(p5));
+    arena.Reset();
+    uint8* p6 = (uint8*) arena.Alloc(16);
+    CHECK(p6 == p5);
+}
+
+TEST(FrameArenaContainerTest) {
+
+    FrameArena arena(1<<16);
+    
+    Array<int32> array;
+    array.SetArena(&arena);
+    for (int32 i = 0; i < 1000; i++) {
+        array.Add(i);
+    }
+    CHECK(array.Size() == 1000);
+    CHECK(arena.Owns(array.begin()));
+    for (int32 i = 0; i < 1000; i++) {
+        CHECK(array[i] == i);
+    }
+    
+    // a copy allocates from the heap, a move takes the arena along
+    Array<int32> copy(array);
+    CHECK(!arena.Owns(copy.begin()));
+    CHECK(copy.Size() == 1000);
+    CHECK(copy[999] == 999);
+    Array<int32> moved(std::move(array));
+    CHECK(arena.Owns(moved.begin()));
+    CHECK(moved[999] == 999);
+    moved.Add(1000);
+    CHECK(arena.Owns(moved.begin()));
+    CHECK(moved.Size() == 1001);
+    
+    Queue<int32> queue;
+    queue.SetArena(&arena);
+    for (int32 i = 0; i < 100; i++) {
+        queue.Enqueue(i);
+    }
+    for (int32 i = 0; i < 100; i++) {
+        CHECK(queue.Dequeue() == i);
+    }
+    CHECK(queue.Empty());
+}
+
+TEST(FrameArenaThreadTest) {
+
+    // the thread frame arena is reset by the PreRunLoop
+    FrameArena* arena = Core::ThreadFrameArena();
+    CHECK(nullptr != arena);
+    Core::PreRunLoop()->Run();
+    arena->Alloc(128);
+    CHECK(arena->NumAllocs() == 1);
+    Core::PreRunLoop()->Run();
+    CHECK(arena->NumAllocs() == 0);
+    CHECK(arena->AllocatedBytes() == 0);
+}
+
+TEST(FrameArenaAlignedTest) {
+
+    FrameArena arena(1024);
+    arena.Alloc(4);
+    uint8* p0 = (uint8*) arena.AllocAligned(100, 64);
+    CHECK(Memory::IsAligned(p0, 64));
+    CHECK(arena.Owns(p0));
+    uint8* p1 = (uint8*) arena.AllocAligned(2000, 256);
+    CHECK(Memory::IsAligned(p1, 256));
+    CHECK(arena.NumChunks() == 2);
+
+    Array<float> array;
+    array.SetArena(&arena);
+    array.SetAlignment(32);
+    for (int32 i = 0; i < 100; i++) {
+        array.Add(float(i));
+        CHECK(Memory::IsAligned(array.begin(), 32));
+    }
+    CHECK(arena.Owns(array.begin()));
+    CHECK(array[99] == 99.0f);
+}
@@ -0,0 +1,151 @@
+//------------------------------------------------------------------------------
+//  FramePipelineTest.cc
+//  Test FrameFence and FramePipeline classes.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Threading/FramePipeline.h"
+#include "Core/Log.h"
+#include <chrono>
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
+
+using namespace Oryol;
+
+#if ORYOL_HAS_THREADS
+//------------------------------------------------------------------------------
+TEST(FrameFenceTest) {
+    FrameFence fence;
+    CHECK(fence.Value() == -1);
+    CHECK(fence.IsSignaled(-1));
+    CHECK(!fence.IsSignaled(0));
+    fence.Signal(0);
+    CHECK(fence.IsSignaled(0));
+    CHECK(!fence.IsSignaled(1));
+    fence.Wait(0);
+    fence.Signal(2);
+    CHECK(fence.Value() == 2);
+    CHECK(fence.IsSignaled(1));
+    fence.Reset();
+    CHECK(fence.Value() == -1);
+
+    // ping-pong between 2 threads
+    FrameFence ping, pong;
+    const int64 numFrames = 1000;
+    std::thread thread([&ping, &pong, numFrames]() {
+        for (int64 i = 0; i < numFrames; i++) {
+            ping.Wait(i);
+            pong.Signal(i);
+        }
+    });
+    for (int64 i = 0; i < numFrames; i++) {
+        ping.Signal(i);
+        pong.Wait(i);
+    }
+    thread.join();
+    CHECK(pong.Value() == numFrames - 1);
+}
+#endif
+
+//------------------------------------------------------------------------------
+TEST(FramePipelineTest) {
+    // the update writes frameIndex + 1 into its buffer, based on the
+    // value in the other buffer (which is read in parallel by the 'renderer')
+    int64 frameData[FramePipeline::NumBuffers] = { -1, -1 };
+    int32 numUpdates = 0;
+    #if ORYOL_HAS_THREADS
+    std::thread::id updateThreadId;
+    #endif
+    FramePipeline pipeline;
+    CHECK(!pipeline.IsValid());
+    pipeline.Setup([&](int64 frameIndex, int32 bufferIndex) {
+        #if ORYOL_HAS_THREADS
+        updateThreadId = std::this_thread::get_id();
+        #endif
+        frameData[bufferIndex] = frameData[bufferIndex ^ 1] + 1;
+        CHECK(frameData[bufferIndex] == frameIndex);
+        numUpdates++;
+    });
+    CHECK(pipeline.IsValid());
+    CHECK(pipeline.FrameIndex() == -1);
+
+    const int64 numFrames = 100;
+    for (int64 frameIndex = 0; frameIndex < numFrames; frameIndex++) {
+        pipeline.BeginFrame();
+        CHECK(pipeline.FrameIndex() == frameIndex);
+        CHECK(pipeline.UpdateFence().IsSignaled(frameIndex));
+        CHECK(pipeline.RenderBufferIndex() == int32(frameIndex & 1));
+        CHECK(pipeline.UpdateBufferIndex() == int32((frameIndex + 1) & 1));
+        // all updates up to the current frame have happened
+        CHECK(numUpdates == frameIndex + 1);
+        pipeline.StartUpdate();
+        CHECK(frameData[pipeline.RenderBufferIndex()] == frameIndex);
+    }
+    pipeline.Sync();
+    CHECK(pipeline.UpdateFence().Value() == numFrames);
+    CHECK(numUpdates == numFrames + 1);
+    pipeline.Discard();
+    CHECK(!pipeline.IsValid());
+    #if ORYOL_HAS_THREADS
+    CHECK(updateThreadId != std::this_thread::get_id());
+    #endif
+
+    // BeginFrame() without StartUpdate() in the previous frame,
+    // and a restarted pipeline starts again at frame 0
+    frameData[0] = frameData[1] = -1;
+    numUpdates = 0;
+    pipeline.Setup([&](int64 frameIndex, int32 bufferIndex) {
+        frameData[bufferIndex] = frameData[bufferIndex ^ 1] + 1;
+        numUpdates++;
+    });
+    pipeline.BeginFrame();
+    CHECK(frameData[pipeline.RenderBufferIndex()] == 0);
+    pipeline.BeginFrame();
+    CHECK(pipeline.FrameIndex() == 1);
+    CHECK(frameData[pipeline.RenderBufferIndex()] == 1);
+    CHECK(numUpdates == 2);
+    pipeline.Discard();
+}
+
+//------------------------------------------------------------------------------
+static float32
+busyWork(int32 numIters) {
+    volatile float32 val = 1.0f;
+    for (int32 i = 0; i < numIters; i++) {
+        val = val * 0.999f + 0.001f;
+    }
+    return val;
+}
+
+//------------------------------------------------------------------------------
+TEST(FramePipelineBenchmark) {
+    // a CPU-bound frame with equally expensive update and render parts
+    const int32 updateIters = 500000;
+    const int32 renderIters = 500000;
+    const int32 numFrames = 50;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int32 i = 0; i < numFrames; i++) {
+        busyWork(updateIters);
+        busyWork(renderIters);
+    }
+    std::chrono::duration<double, std::milli> serialTime = std::chrono::high_resolution_clock::now() - start;
+
+    FramePipeline pipeline;
+    pipeline.Setup([updateIters](int64 frameIndex, int32 bufferIndex) {
+        busyWork(updateIters);
+    });
+    start = std::chrono::high_resolution_clock::now();
+    for (int32 i = 0; i < numFrames; i++) {
+        pipeline.BeginFrame();
+        pipeline.StartUpdate();
+        busyWork(renderIters);
+    }
+    pipeline.Sync();
+    std::chrono::duration<double, std::milli> pipelinedTime = std::chrono::high_resolution_clock::now() - start;
+    pipeline.Discard();
+
+    Log::Info("FramePipeline: serial frame time %.3f ms, pipelined frame time %.3f ms (%.2fx)\n",
+        serialTime.count() / numFrames, pipelinedTime.count() / numFrames, serialTime.count() / pipelinedTime.count());
+}
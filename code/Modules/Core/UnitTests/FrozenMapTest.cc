@@ -0,0 +1,153 @@
+//------------------------------------------------------------------------------
+//  FrozenMapTest.cc
+//  Test FrozenMap class.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Containers/FrozenMap.h"
+#include "Core/Containers/Map.h"
+#include "Core/String/String.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Log.h"
+#include <chrono>
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+TEST(FrozenMapTest) {
+    FrozenMap<int32, int32> empty;
+    CHECK(empty.Empty());
+    CHECK(!empty.Contains(0));
+    CHECK(nullptr == empty.Find(0));
+
+    // all sizes up to a few complete and incomplete tree levels
+    for (int32 num = 1; num < 70; num++) {
+        Map<int32, int32> map;
+        for (int32 i = 0; i < num; i++) {
+            map.Add(i * 2, i * 10);
+        }
+        FrozenMap<int32, int32> frozen(map);
+        CHECK(frozen.Size() == num);
+        CHECK(!frozen.IsView());
+        for (int32 i = 0; i < num; i++) {
+            CHECK(frozen.Contains(i * 2));
+            CHECK(!frozen.Contains(i * 2 + 1));
+            CHECK(frozen[i * 2] == i * 10);
+            const int32 index = frozen.FindIndex(i * 2);
+            CHECK(frozen.KeyAtIndex(index) == i * 2);
+            CHECK(frozen.ValueAtIndex(index) == i * 10);
+        }
+        CHECK(!frozen.Contains(-1));
+        CHECK(nullptr == frozen.Find(num * 2));
+    }
+
+    // non-trivial key and value types, build from unsorted pairs
+    KeyValuePair<String, String> kvps[] = {
+        KeyValuePair<String, String>("text/html", "html"),
+        KeyValuePair<String, String>("image/png", "png"),
+        KeyValuePair<String, String>("application/json", "json"),
+        KeyValuePair<String, String>("audio/ogg", "ogg"),
+    };
+    FrozenMap<String, String> strMap;
+    strMap.Build(kvps, 4);
+    CHECK(strMap.Size() == 4);
+    CHECK(strMap["text/html"] == "html");
+    CHECK(strMap["application/json"] == "json");
+    CHECK(nullptr == strMap.Find("video/mp4"));
+
+    // copy and move
+    FrozenMap<String, String> copy(strMap);
+    CHECK(copy.Size() == 4);
+    CHECK(copy["image/png"] == "png");
+    FrozenMap<String, String> moved(std::move(copy));
+    CHECK(copy.Empty());
+    CHECK(moved["audio/ogg"] == "ogg");
+    moved.Clear();
+    CHECK(moved.Empty());
+}
+
+//------------------------------------------------------------------------------
+TEST(FrozenMapBlobTest) {
+    Map<uint32, int64> map;
+    for (uint32 i = 0; i < 1000; i++) {
+        map.Add(i * 7919, int64(i) * 3);
+    }
+    FrozenMap<uint32, int64> frozen(map);
+    const int32 size = frozen.BlobSize();
+    void* blob = Memory::Alloc(size);
+    CHECK(frozen.WriteBlob(blob, size) == size);
+
+    FrozenMap<uint32, int64> view;
+    CHECK(view.SetupFromBlob(blob, size));
+    CHECK(view.IsView());
+    CHECK(view.Size() == 1000);
+    for (uint32 i = 0; i < 1000; i++) {
+        CHECK(view[i * 7919] == int64(i) * 3);
+        CHECK(!view.Contains(i * 7919 + 1));
+    }
+    // a copy of a view owns its memory
+    FrozenMap<uint32, int64> copy(view);
+    CHECK(!copy.IsView());
+    CHECK(copy[7919] == 3);
+
+    // invalid blobs are rejected
+    FrozenMap<uint32, int64> invalid;
+    CHECK(!invalid.SetupFromBlob(blob, size - 1));
+    FrozenMap<uint32, int32> wrongType;
+    CHECK(!wrongType.SetupFromBlob(blob, size));
+    view.Clear();
+    Memory::Free(blob);
+}
+
+//------------------------------------------------------------------------------
+TEST(FrozenMapBlobFloat64Test) {
+    // blob layout doesn't depend on the platform alignment
+    Map<int32, float64> map;
+    for (int32 i = 0; i < 3; i++) {
+        map.Add(i, float64(i) + 0.5);
+    }
+    FrozenMap<int32, float64> frozen(map);
+    const int32 size = frozen.BlobSize();
+    CHECK(size == 16 + 16 + 3 * 8);
+    void* blob = Memory::AllocAligned(size, FrozenMap<int32, float64>::BlobAlign);
+    CHECK(frozen.WriteBlob(blob, size) == size);
+
+    FrozenMap<int32, float64> view;
+    CHECK(view.SetupFromBlob(blob, size));
+    CHECK(view.Size() == 3);
+    for (int32 i = 0; i < 3; i++) {
+        CHECK(view[i] == float64(i) + 0.5);
+    }
+    CHECK(!view.Contains(3));
+    view.Clear();
+    Memory::FreeAligned(blob);
+}
+
+//------------------------------------------------------------------------------
+TEST(FrozenMapBenchmark) {
+    const int32 num = 100000;
+    const int32 numLookups = 1000000;
+    Map<uint32, int32> map;
+    map.Reserve(num);
+    for (int32 i = 0; i < num; i++) {
+        map.Add(uint32(i) * 2654435761u, i);
+    }
+    FrozenMap<uint32, int32> frozen(map);
+
+    int64 sum = 0;
+    uint32 key = 0;
+    std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+    for (int32 i = 0; i < numLookups; i++) {
+        key = uint32(i % num) * 2654435761u;
+        sum += map[key];
+    }
+    std::chrono::duration<double> mapDur = std::chrono::system_clock::now() - start;
+    start = std::chrono::system_clock::now();
+    for (int32 i = 0; i < numLookups; i++) {
+        key = uint32(i % num) * 2654435761u;
+        sum -= frozen[key];
+    }
+    std::chrono::duration<double> frozenDur = std::chrono::system_clock::now() - start;
+    CHECK(0 == sum);
+    Log::Info("%d lookups in %d elements: Map: %f sec, FrozenMap: %f sec\n", numLookups, num, mapDur.count(), frozenDur.count());
+}
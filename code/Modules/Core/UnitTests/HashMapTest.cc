@@ -0,0 +1,237 @@
+//------------------------------------------------------------------------------
+//  HashMapTest.cc
+//  Test HashMap functionality and performance.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Containers/HashMap.h"
+#include "Core/Containers/Map.h"
+#include "Core/String/String.h"
+#include "Core/Log.h"
+#include <chrono>
+
+using namespace Oryol;
+
+struct HashMapIntHasher {
+    uint32 operator()(int32 val) {
+        return val;
+    };
+};
+
+struct HashMapStringHasher {
+    uint32 operator()(const String& str) {
+        // FNV-1a
+        uint32 hash = 2166136261U;
+        for (const char* c = str.AsCStr(); *c; c++) {
+            hash = (hash ^ uint8(*c)) * 16777619U;
+        }
+        return hash;
+    };
+};
+
+// a bad hasher, which puts all keys into the same probe sequence
+struct HashMapBadHasher {
+    uint32 operator()(int32 val) {
+        return val & 3;
+    };
+};
+
+//------------------------------------------------------------------------------
+TEST(HashMapTest) {
+
+    HashMap<int32, int32, HashMapIntHasher> map;
+    CHECK(map.Size() == 0);
+    CHECK(map.Empty());
+    CHECK(map.Capacity() == 0);
+    CHECK(!map.Contains(1));
+    CHECK(nullptr == map.Find(1));
+    CHECK(InvalidIndex == map.FindIndex(1));
+    map.Erase(1);
+
+    // add elements, this will grow the index table
+    for (int32 i = 0; i < 100; i++) {
+        map.Add(i * 1024, i);
+    }
+    CHECK(map.Size() == 100);
+    CHECK(!map.Empty());
+    CHECK(map.Capacity() >= 100);
+    for (int32 i = 0; i < 100; i++) {
+        CHECK(map.Contains(i * 1024));
+        CHECK(map[i * 1024] == i);
+        CHECK(*map.Find(i * 1024) == i);
+        CHECK(map.KeyAtIndex(map.FindIndex(i * 1024)) == i * 1024);
+    }
+    CHECK(!map.Contains(1));
+    CHECK(!map.AddUnique(5 * 1024, 123));
+    CHECK(map.AddUnique(5 * 1024 + 1, 123));
+    CHECK(map[5 * 1024 + 1] == 123);
+    map[5 * 1024 + 1] = 321;
+    CHECK(map.ValueAtIndex(map.FindIndex(5 * 1024 + 1)) == 321);
+
+    // iterate
+    int32 sum = 0;
+    for (const auto& kvp : map) {
+        sum += kvp.Value();
+    }
+    CHECK(sum == (99 * 100) / 2 + 321);
+
+    // erase every other element
+    for (int32 i = 0; i < 100; i += 2) {
+        map.Erase(i * 1024);
+    }
+    map.Erase(5 * 1024 + 1);
+    CHECK(map.Size() == 50);
+    for (int32 i = 0; i < 100; i++) {
+        CHECK(map.Contains(i * 1024) == ((i & 1) != 0));
+    }
+    for (int32 i = 1; i < 100; i += 2) {
+        CHECK(map[i * 1024] == i);
+    }
+
+    // copy and move
+    HashMap<int32, int32, HashMapIntHasher> map1(map);
+    CHECK(map1.Size() == 50);
+    CHECK(map1[99 * 1024] == 99);
+    HashMap<int32, int32, HashMapIntHasher> map2(std::move(map1));
+    CHECK(map1.Size() == 0);
+    CHECK(map1.Capacity() == 0);
+    CHECK(map2.Size() == 50);
+    CHECK(map2[97 * 1024] == 97);
+    map1 = map2;
+    CHECK(map1.Size() == 50);
+    CHECK(map1[1024] == 1);
+    map1 = std::move(map2);
+    CHECK(map2.Empty());
+    CHECK(map1[3 * 1024] == 3);
+    map1.Add(0, 0);
+    CHECK(map1.Contains(0));
+
+    // rehash and reserve
+    const int32 capacity = map.Capacity();
+    map.Rehash();
+    CHECK(map.Capacity() < capacity);
+    CHECK(map.Capacity() >= map.Size());
+    for (int32 i = 1; i < 100; i += 2) {
+        CHECK(map[i * 1024] == i);
+    }
+    map.Reserve(1000);
+    CHECK(map.Capacity() >= 1050);
+    const int32 reserved = map.Capacity();
+    for (int32 i = 0; i < 1000; i++) {
+        map.Add(-i - 1, i);
+    }
+    CHECK(map.Capacity() == reserved);
+    CHECK(map.Size() == 1050);
+
+    // clear
+    map.Clear();
+    CHECK(map.Empty());
+    CHECK(map.Capacity() == reserved);
+    CHECK(!map.Contains(1024));
+    map.Add(1, 2);
+    CHECK(map[1] == 2);
+}
+
+//------------------------------------------------------------------------------
+TEST(HashMapCollisionTest) {
+
+    // many collisions, test backward-shift deletion
+    HashMap<int32, int32, HashMapBadHasher> map;
+    for (int32 i = 0; i < 200; i++) {
+        map.Add(i, i);
+    }
+    for (int32 i = 0; i < 200; i += 3) {
+        map.Erase(i);
+    }
+    bool valid = true;
+    for (int32 i = 0; i < 200; i++) {
+        const bool contained = (i % 3) != 0;
+        if (map.Contains(i) != contained) {
+            valid = false;
+        }
+        if (contained && (map[i] != i)) {
+            valid = false;
+        }
+    }
+    CHECK(valid);
+    for (int32 i = 0; i < 200; i += 3) {
+        map.Add(i, i * 2);
+    }
+    CHECK(map.Size() == 200);
+    CHECK(map[99] == 198);
+}
+
+//------------------------------------------------------------------------------
+TEST(HashMapStringTest) {
+
+    HashMap<String, int32, HashMapStringHasher> map;
+    map.Add("One", 1);
+    map.Add("Two", 2);
+    map.Add("Three", 3);
+    CHECK(map.Size() == 3);
+    CHECK(map["One"] == 1);
+    CHECK(map["Two"] == 2);
+    CHECK(map["Three"] == 3);
+    CHECK(!map.Contains("Four"));
+    map.Erase("One");
+    CHECK(!map.Contains("One"));
+    CHECK(map["Three"] == 3);
+}
+
+//------------------------------------------------------------------------------
+TEST(HashMapBenchmark) {
+
+    // random keys (LCG)
+    uint32 seed = 12345;
+    const int32 maxNum = 1000000;
+    Array<int32> keys;
+    keys.Reserve(maxNum);
+    for (int32 i = 0; i < maxNum; i++) {
+        seed = seed * 1103515245 + 12345;
+        keys.Add(int32(seed >> 1));
+    }
+
+    for (int32 num = 1000; num <= maxNum; num *= 10) {
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        HashMap<int32, int32, HashMapIntHasher> hashMap;
+        for (int32 i = 0; i < num; i++) {
+            hashMap.AddUnique(keys[i], i);
+        }
+        std::chrono::duration<double> addDur = std::chrono::system_clock::now() - start;
+        start = std::chrono::system_clock::now();
+        int32 found = 0;
+        for (int32 i = 0; i < num; i++) {
+            found += hashMap.Contains(keys[i]) ? 1 : 0;
+        }
+        std::chrono::duration<double> findDur = std::chrono::system_clock::now() - start;
+        CHECK(found == num);
+        Log::Info("HashMap %d elements: add %f sec, find %f sec\n", num, addDur.count(), findDur.count());
+
+        // Map::Add is O(N), only measure up to 100k elements
+        if (num <= 100000) {
+            start = std::chrono::system_clock::now();
+            Map<int32, int32> map;
+            for (int32 i = 0; i < num; i++) {
+                map.Add(keys[i], i);
+            }
+            addDur = std::chrono::system_clock::now() - start;
+            Log::Info("Map %d elements: add %f sec\n", num, addDur.count());
+        }
+        start = std::chrono::system_clock::now();
+        Map<int32, int32> map;
+        map.BeginBulk();
+        for (int32 i = 0; i < num; i++) {
+            map.AddBulk(keys[i], i);
+        }
+        map.EndBulk();
+        addDur = std::chrono::system_clock::now() - start;
+        start = std::chrono::system_clock::now();
+        found = 0;
+        for (int32 i = 0; i < num; i++) {
+            found += map.Contains(keys[i]) ? 1 : 0;
+        }
+        findDur = std::chrono::system_clock::now() - start;
+        CHECK(found == num);
+        Log::Info("Map %d elements: bulk add %f sec, find %f sec\n", num, addDur.count(), findDur.count());
+    }
+}
@@ -137,3 +137,98 @@ TEST(HashSetTest) {
     CHECK(hashSet4.Size() == 0);
     CHECK(!hashSet4.Contains(10));
 }
+
+//------------------------------------------------------------------------------
+TEST(HashSetDynamicTest) {
+
+    HashSet<int, IntHasher> hashSet;
+    CHECK(hashSet.Empty());
+    CHECK(hashSet.Capacity() == 0);
+    CHECK(!hashSet.Contains(1));
+    CHECK(nullptr == hashSet.Find(1));
+
+    // add enough values to force the index table to grow several times
+    const int num = 10000;
+    for (int i = 0; i < num; i++) {
+        hashSet.Add(i * 7);
+    }
+    CHECK(hashSet.Size() == num);
+    CHECK((hashSet.Size() * 8) <= (hashSet.Capacity() * 7));
+    CHECK((hashSet.Capacity() & (hashSet.Capacity() - 1)) == 0);
+    for (int i = 0; i < num; i++) {
+        CHECK(hashSet.Contains(i * 7));
+        CHECK(!hashSet.Contains(i * 7 + 1));
+    }
+    CHECK(*hashSet.Find(70) == 70);
+    CHECK(!hashSet.AddUnique(70));
+    CHECK(hashSet.AddUnique(71));
+    CHECK(hashSet.Size() == num + 1);
+    hashSet.Erase(71);
+    hashSet.Erase(71);
+    CHECK(hashSet.Size() == num);
+
+    // erase every other value
+    for (int i = 0; i < num; i += 2) {
+        hashSet.Erase(i * 7);
+    }
+    CHECK(hashSet.Size() == num / 2);
+    for (int i = 0; i < num; i++) {
+        CHECK(hashSet.Contains(i * 7) == ((i & 1) != 0));
+    }
+    int sum = 0;
+    for (int val : hashSet) {
+        sum += val;
+    }
+    int expected = 0;
+    for (int i = 1; i < num; i += 2) {
+        expected += i * 7;
+    }
+    CHECK(sum == expected);
+
+    // shrink the index table
+    const int32 oldCapacity = hashSet.Capacity();
+    hashSet.Rehash();
+    CHECK(hashSet.Capacity() < oldCapacity);
+    CHECK(hashSet.Size() == num / 2);
+    for (int i = 1; i < num; i += 2) {
+        CHECK(hashSet.Contains(i * 7));
+    }
+
+    // copy and move
+    HashSet<int, IntHasher> hashSet1(hashSet);
+    CHECK(hashSet1.Size() == num / 2);
+    CHECK(hashSet1.Contains(7));
+    hashSet1.Erase(7);
+    CHECK(!hashSet1.Contains(7));
+    CHECK(hashSet.Contains(7));
+    HashSet<int, IntHasher> hashSet2(std::move(hashSet1));
+    CHECK(hashSet1.Empty());
+    CHECK(hashSet1.Capacity() == 0);
+    CHECK(hashSet2.Size() == (num / 2) - 1);
+    CHECK(hashSet2.Contains(21));
+    hashSet1 = hashSet2;
+    CHECK(hashSet1.Size() == hashSet2.Size());
+    hashSet1.Clear();
+    CHECK(hashSet1.Empty());
+    CHECK(hashSet1.Capacity() > 0);
+    CHECK(!hashSet1.Contains(21));
+    hashSet1.Add(21);
+    CHECK(hashSet1.Contains(21));
+}
+
+//------------------------------------------------------------------------------
+TEST(HashSetReserveTest) {
+    HashSet<int, IntHasher> hashSet;
+    hashSet.Reserve(1000);
+    const int32 capacity = hashSet.Capacity();
+    CHECK((1000 * 8) <= (capacity * 7));
+    for (int i = 0; i < 1000; i++) {
+        hashSet.Add(i);
+    }
+    // no rehash must have happened
+    CHECK(hashSet.Capacity() == capacity);
+    CHECK(hashSet.Size() == 1000);
+    for (int i = 0; i < 1000; i++) {
+        CHECK(hashSet.Contains(i));
+    }
+}
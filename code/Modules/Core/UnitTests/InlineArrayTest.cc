@@ -0,0 +1,208 @@
+//------------------------------------------------------------------------------
+//  InlineArrayTest.cc
+//  Test InlineArray class.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Containers/InlineArray.h"
+#include "Core/Containers/Array.h"
+#include "Core/String/String.h"
+#include "Core/Log.h"
+#include <chrono>
+
+using namespace Oryol;
+
+// a non-relocatable type which counts live objects
+struct _tracked {
+    static int32 numLive;
+    _tracked() : value(0), self(this) { numLive++; };
+    _tracked(int32 val) : value(val), self(this) { numLive++; };
+    _tracked(const _tracked& rhs) : value(rhs.value), self(this) { numLive++; };
+    _tracked(_tracked&& rhs) : value(rhs.value), self(this) { rhs.value = -1; numLive++; };
+    ~_tracked() { o_assert(this == this->self); numLive--; };
+    void operator=(const _tracked& rhs) { this->value = rhs.value; };
+    void operator=(_tracked&& rhs) { this->value = rhs.value; rhs.value = -1; };
+    bool operator==(const _tracked& rhs) const { return this->value == rhs.value; };
+    int32 value;
+    _tracked* self;
+};
+int32 _tracked::numLive = 0;
+
+//------------------------------------------------------------------------------
+TEST(InlineArrayTest) {
+    InlineArray<int32, 4> array0;
+    CHECK(array0.Empty());
+    CHECK(array0.Size() == 0);
+    CHECK(array0.Capacity() == 4);
+    CHECK(array0.IsInline());
+    CHECK(array0.GetMinGrow() == ORYOL_CONTAINER_DEFAULT_MIN_GROW);
+    CHECK(array0.GetMaxGrow() == ORYOL_CONTAINER_DEFAULT_MAX_GROW);
+
+    // stays inline up to NUMINLINE elements
+    for (int32 i = 0; i < 4; i++) {
+        array0.Add(i);
+    }
+    CHECK(array0.IsInline());
+    CHECK(array0.Size() == 4);
+    CHECK(array0.Spare() == 0);
+    CHECK(array0.Front() == 0);
+    CHECK(array0.Back() == 3);
+
+    // ...and spills to the heap beyond that
+    array0.Add(4);
+    CHECK(!array0.IsInline());
+    CHECK(array0.Size() == 5);
+    CHECK(array0.Capacity() == 4 + ORYOL_CONTAINER_DEFAULT_MIN_GROW);
+    for (int32 i = 0; i < 5; i++) {
+        CHECK(array0[i] == i);
+    }
+
+    // insert and erase
+    array0.Insert(0, 10);
+    array0.Insert(3, 11);
+    CHECK(array0.Size() == 7);
+    CHECK(array0[0] == 10);
+    CHECK(array0[3] == 11);
+    CHECK(array0.FindIndexLinear(11) == 3);
+    array0.Erase(3);
+    array0.EraseSwapBack(0);
+    CHECK(array0.Size() == 5);
+    CHECK(array0[0] == 4);
+    CHECK(array0.FindIndexLinear(10) == InvalidIndex);
+
+    // trim moves back into inline storage when possible
+    array0.Erase(0);
+    array0.Trim();
+    CHECK(array0.IsInline());
+    CHECK(array0.Capacity() == 4);
+    CHECK(array0.Size() == 4);
+    for (int32 i = 0; i < 4; i++) {
+        CHECK(array0[i] == i);
+    }
+
+    // initializer list
+    InlineArray<int32, 2> array1({ 1, 2, 3 });
+    CHECK(!array1.IsInline());
+    CHECK(array1.Size() == 3);
+    CHECK(array1[2] == 3);
+    int32 sum = 0;
+    for (int32 i : array1) {
+        sum += i;
+    }
+    CHECK(sum == 6);
+    array1.Clear();
+    CHECK(array1.Empty());
+    array1.Emplace(5);
+    CHECK(array1[0] == 5);
+}
+
+//------------------------------------------------------------------------------
+TEST(InlineArrayCopyMoveTest) {
+    CHECK(_tracked::numLive == 0);
+    {
+        // inline copy and move
+        InlineArray<_tracked, 4> array0;
+        array0.Add(_tracked(1));
+        array0.Add(_tracked(2));
+        CHECK(_tracked::numLive == 2);
+        InlineArray<_tracked, 4> array1(array0);
+        CHECK(array1.IsInline());
+        CHECK(array1.Size() == 2);
+        CHECK(array1[1].value == 2);
+        CHECK(_tracked::numLive == 4);
+        InlineArray<_tracked, 4> array2(std::move(array1));
+        CHECK(array2.IsInline());
+        CHECK(array2.Size() == 2);
+        CHECK(array2[0].value == 1);
+        CHECK(array1.Empty());
+        CHECK(array1.IsInline());
+        CHECK(_tracked::numLive == 4);
+
+        // heap copy and move
+        for (int32 i = 3; i <= 10; i++) {
+            array0.Add(_tracked(i));
+        }
+        CHECK(!array0.IsInline());
+        CHECK(_tracked::numLive == 12);
+        InlineArray<_tracked, 4> array3(array0);
+        CHECK(!array3.IsInline());
+        CHECK(array3.Capacity() == 10);
+        CHECK(_tracked::numLive == 22);
+        const _tracked* heapPtr = array3.begin();
+        InlineArray<_tracked, 4> array4(std::move(array3));
+        CHECK(array4.begin() == heapPtr);
+        CHECK(array3.Empty());
+        CHECK(array3.IsInline());
+        CHECK(_tracked::numLive == 22);
+
+        // assignment in all directions
+        array3 = array4;
+        CHECK(array3.Size() == 10);
+        CHECK(_tracked::numLive == 32);
+        array3 = array2;
+        CHECK(array3.IsInline());
+        CHECK(array3.Size() == 2);
+        CHECK(_tracked::numLive == 24);
+        array4 = std::move(array2);
+        CHECK(array4.IsInline());
+        CHECK(array4.Size() == 2);
+        CHECK(array4[1].value == 2);
+        CHECK(_tracked::numLive == 14);
+
+        // spill and trim with non-relocatable elements
+        array4.Insert(1, _tracked(7));
+        array4.Insert(1, _tracked(8));
+        array4.Insert(1, _tracked(9));
+        CHECK(!array4.IsInline());
+        CHECK(array4.Size() == 5);
+        CHECK(array4[0].value == 1);
+        CHECK(array4[1].value == 9);
+        CHECK(array4[4].value == 2);
+        array4.EraseSwap(2);
+        array4.Trim();
+        CHECK(array4.IsInline());
+        CHECK(array4.Size() == 4);
+        CHECK(_tracked::numLive == 16);
+    }
+    CHECK(_tracked::numLive == 0);
+
+    // relocatable elements
+    InlineArray<String, 2> strings;
+    strings.Add("one");
+    strings.Add("two");
+    InlineArray<String, 2> strings1(std::move(strings));
+    CHECK(strings1[0] == "one");
+    CHECK(strings1[1] == "two");
+    strings1.Add("three");
+    CHECK(!strings1.IsInline());
+    CHECK(strings1[2] == "three");
+}
+
+//------------------------------------------------------------------------------
+TEST(InlineArrayBenchmark) {
+    // many short-lived tiny arrays, e.g. tokenizer results
+    const int32 numIters = 1000000;
+    for (int32 run = 0; run < 2; run++) {
+        int32 sum = 0;
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        for (int32 i = 0; i < numIters; i++) {
+            Array<int32> array;
+            array.Add(i);
+            array.Add(i + 1);
+            array.Add(i + 2);
+            sum += array[1];
+        }
+        std::chrono::duration<double> arrayDur = std::chrono::system_clock::now() - start;
+        start = std::chrono::system_clock::now();
+        for (int32 i = 0; i < numIters; i++) {
+            InlineArray<int32, 4> array;
+            array.Add(i);
+            array.Add(i + 1);
+            array.Add(i + 2);
+            sum -= array[1];
+        }
+        std::chrono::duration<double> inlineDur = std::chrono::system_clock::now() - start;
+        CHECK(0 == sum);
+        Log::Info("run %d: %dx 3-element Array: %f sec, InlineArray: %f sec\n", run, numIters, arrayDur.count(), inlineDur.count());
+    }
+}
@@ -0,0 +1,343 @@
+//------------------------------------------------------------------------------
+//  JobSystemTest.cc
+//  Test JobSystem functionality.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Threading/JobSystem.h"
+#include "Core/Core.h"
+#include "Core/Memory/FrameArena.h"
+#include "Core/String/StringAtom.h"
+#include "Core/Containers/Array.h"
+#include "Core/Log.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+TEST(JobSystemTest) {
+    CHECK(!JobSystem::IsValid());
+    JobSystem::Setup(3);
+    CHECK(JobSystem::IsValid());
+    #if ORYOL_HAS_THREADS
+    CHECK(JobSystem::NumThreads() == 4);
+    #endif
+    CHECK(JobSystem::ThreadIndex() == 0);
+
+    // a single job
+    std::atomic<int32> counter(0);
+    JobHandle job = JobSystem::Run([&counter]() {
+        counter++;
+    });
+    CHECK(job.IsValid());
+    JobSystem::Wait(job);
+    CHECK(JobSystem::IsFinished(job));
+    CHECK(counter == 1);
+    CHECK(JobSystem::IsFinished(JobHandle()));
+
+    // a parent job is only finished when all its children are finished
+    counter = 0;
+    JobHandle parent = JobSystem::Run([&counter]() {
+        // children are added from inside the parent job
+        for (int32 i = 0; i < 100; i++) {
+            JobSystem::Run([&counter]() {
+                #if ORYOL_HAS_THREADS
+                std::this_thread::sleep_for(std::chrono::microseconds(10));
+                #endif
+                counter++;
+            }, JobSystem::CurrentJob());
+        }
+    });
+    JobSystem::Wait(parent);
+    CHECK(JobSystem::IsFinished(parent));
+    CHECK(counter == 100);
+    CHECK(!JobSystem::CurrentJob().IsValid());
+
+    // groups
+    counter = 0;
+    JobHandle group = JobSystem::CreateGroup();
+    for (int32 i = 0; i < 1000; i++) {
+        JobSystem::Run([&counter]() {
+            counter++;
+        }, group);
+    }
+    CHECK(!JobSystem::IsFinished(group));
+    JobSystem::CloseGroup(group);
+    JobSystem::Wait(group);
+    CHECK(counter == 1000);
+
+    // nested groups
+    counter = 0;
+    group = JobSystem::CreateGroup();
+    for (int32 i = 0; i < 10; i++) {
+        JobSystem::Run([&counter, group]() {
+            for (int32 j = 0; j < 10; j++) {
+                JobSystem::Run([&counter]() {
+                    counter++;
+                }, group);
+            }
+        }, group);
+    }
+    JobSystem::CloseGroup(group);
+    JobSystem::Wait(group);
+    CHECK(counter == 100);
+
+    // dependencies: c runs after a and b, d after c
+    std::atomic<int32> order(0);
+    int32 orderA = -1, orderB = -1, orderC = -1, orderD = -1;
+    JobHandle a = JobSystem::Run([&order, &orderA]() {
+        #if ORYOL_HAS_THREADS
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        #endif
+        orderA = order++;
+    });
+    JobHandle b = JobSystem::Run([&order, &orderB]() {
+        orderB = order++;
+    });
+    JobHandle c = JobSystem::RunAfter({ a, b }, [&order, &orderC]() {
+        orderC = order++;
+    });
+    JobHandle d = JobSystem::RunAfter({ c }, [&order, &orderD]() {
+        orderD = order++;
+    });
+    JobSystem::Wait(d);
+    CHECK(JobSystem::IsFinished(a) && JobSystem::IsFinished(b) && JobSystem::IsFinished(c));
+    CHECK((orderA >= 0) && (orderB >= 0));
+    CHECK((orderC > orderA) && (orderC > orderB));
+    CHECK(orderD > orderC);
+
+    // a dependency which has already finished, and more waiting
+    // jobs than continuation slots
+    JobHandle e = JobSystem::RunAfter({ a, JobHandle() }, []() { });
+    JobSystem::Wait(e);
+    counter = 0;
+    group = JobSystem::CreateGroup();
+    JobHandle gate = JobSystem::Run([]() {
+        #if ORYOL_HAS_THREADS
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        #endif
+    });
+    Array<JobHandle> waiting;
+    for (int32 i = 0; i < 2 * JobSystem::MaxContinuations; i++) {
+        waiting.Add(JobSystem::RunAfter({ gate }, [&counter]() {
+            counter++;
+        }));
+    }
+    for (const JobHandle& w : waiting) {
+        JobSystem::Wait(w);
+    }
+    CHECK(counter == 2 * JobSystem::MaxContinuations);
+    JobSystem::CloseGroup(group);
+    JobSystem::Wait(group);
+
+    JobSystem::Discard();
+    CHECK(!JobSystem::IsValid());
+}
+
+//------------------------------------------------------------------------------
+TEST(JobSystemParallelFor) {
+    JobSystem::Setup(3);
+
+    // each index is visited exactly once
+    const int32 num = 100000;
+    Array<int32> visits;
+    visits.Reserve(num);
+    for (int32 i = 0; i < num; i++) {
+        visits.Add(0);
+    }
+    std::atomic<int32> numRanges(0);
+    JobSystem::ParallelFor(0, num, 1000, [&visits, &numRanges](int32 first, int32 last) {
+        CHECK(first < last);
+        CHECK((last - first) <= 1000);
+        for (int32 i = first; i < last; i++) {
+            visits[i]++;
+        }
+        numRanges++;
+    });
+    int32 numBadVisits = 0;
+    for (int32 i = 0; i < num; i++) {
+        if (visits[i] != 1) {
+            numBadVisits++;
+        }
+    }
+    CHECK(numBadVisits == 0);
+    CHECK(numRanges >= 100);
+
+    // empty and small ranges are handled on the calling thread
+    numRanges = 0;
+    JobSystem::ParallelFor(10, 10, 16, [&numRanges](int32 first, int32 last) {
+        numRanges++;
+    });
+    CHECK(numRanges == 0);
+    JobSystem::ParallelFor(0, 10, 16, [&numRanges](int32 first, int32 last) {
+        CHECK((0 == first) && (10 == last));
+        numRanges++;
+    });
+    CHECK(numRanges == 1);
+
+    // nested ParallelFor calls inside jobs
+    std::atomic<int64> sum(0);
+    JobSystem::ParallelFor(0, 64, 1, [&sum](int32 first, int32 last) {
+        for (int32 i = first; i < last; i++) {
+            JobSystem::ParallelFor(0, 1000, 100, [&sum](int32 first, int32 last) {
+                int64 s = 0;
+                for (int32 j = first; j < last; j++) {
+                    s += j;
+                }
+                sum += s;
+            });
+        }
+    });
+    CHECK(sum == 64 * ((999 * 1000) / 2));
+
+    // thread-local Core objects are available inside jobs on worker threads
+    #if ORYOL_HAS_THREADS
+    std::atomic<int32> numWorkerRanges(0);
+    std::atomic<int32> numBadRanges(0);
+    JobSystem::ParallelFor(0, 256, 1, [&numWorkerRanges, &numBadRanges](int32 first, int32 last) {
+        if (JobSystem::ThreadIndex() > 0) {
+            if (!Core::PreRunLoop() || !Core::ThreadFrameArena()->Alloc(16)) {
+                numBadRanges++;
+            }
+            StringAtom atom("JobSystemTest");
+            if (atom != "JobSystemTest") {
+                numBadRanges++;
+            }
+            numWorkerRanges++;
+        }
+        // give other threads a chance to steal
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    });
+    CHECK(numBadRanges == 0);
+    if (JobSystem::NumThreads() > 1) {
+        CHECK(numWorkerRanges > 0);
+    }
+    #endif
+
+    JobSystem::Discard();
+}
+
+//------------------------------------------------------------------------------
+TEST(JobSystemOutOfSlots) {
+    // more jobs than slots, Run() must help out until a slot is free
+    JobSystem::Setup(2, 8);
+    std::atomic<int32> counter(0);
+    JobHandle group = JobSystem::CreateGroup();
+    for (int32 i = 0; i < 1000; i++) {
+        JobSystem::Run([&counter]() {
+            counter++;
+        }, group);
+    }
+    JobSystem::CloseGroup(group);
+    JobSystem::Wait(group);
+    CHECK(counter == 1000);
+    JobSystem::ParallelFor(0, 10000, 10, [&counter](int32 first, int32 last) {
+        counter += last - first;
+    });
+    CHECK(counter == 11000);
+    JobSystem::Discard();
+}
+
+#if ORYOL_HAS_THREADS
+//------------------------------------------------------------------------------
+TEST(JobSystemMultiThreadedPush) {
+    // jobs pushed from threads which are not part of the job system
+    JobSystem::Setup(2);
+    std::atomic<int32> counter(0);
+    Array<std::thread> threads;
+    for (int32 t = 0; t < 4; t++) {
+        threads.Add(std::thread([&counter]() {
+            CHECK(JobSystem::ThreadIndex() == InvalidIndex);
+            for (int32 i = 0; i < 100; i++) {
+                JobHandle job = JobSystem::Run([&counter]() {
+                    counter++;
+                });
+                JobSystem::Wait(job);
+            }
+        }));
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    CHECK(counter == 400);
+    JobSystem::Discard();
+}
+
+//------------------------------------------------------------------------------
+TEST(JobSystemBenchmark) {
+    // a particle update like in the DrawCallPerf sample, with 1..N threads
+    struct particle {
+        float pos[4];
+        float vec[4];
+    };
+    const int32 numParticles = 1<<20;
+    const int32 numFrames = 20;
+    Array<particle> particles;
+    particles.Reserve(numParticles);
+    for (int32 i = 0; i < numParticles; i++) {
+        particle p;
+        for (int32 j = 0; j < 4; j++) {
+            p.pos[j] = 0.0f;
+            p.vec[j] = float((i * 7 + j * 13) % 100) * 0.01f - 0.5f;
+        }
+        particles.Add(p);
+    }
+    particle* ptr = &particles[0];
+    auto update = [ptr](int32 first, int32 last) {
+        const float frameTime = 1.0f / 60.0f;
+        for (int32 i = first; i < last; i++) {
+            particle& p = ptr[i];
+            p.vec[1] -= 1.0f * frameTime;
+            for (int32 j = 0; j < 3; j++) {
+                p.pos[j] += p.vec[j] * frameTime;
+            }
+            if (p.pos[1] < -2.0f) {
+                p.pos[1] = -1.8f;
+                p.vec[1] = -p.vec[1];
+                p.vec[0] *= 0.8f; p.vec[1] *= 0.8f; p.vec[2] *= 0.8f;
+            }
+            p.pos[3] = std::sqrt(p.pos[0] * p.pos[0] + p.pos[1] * p.pos[1] + p.pos[2] * p.pos[2]);
+        }
+    };
+
+    const int32 maxThreads = int32(std::thread::hardware_concurrency());
+    double oneThreadDur = 0.0;
+    for (int32 numThreads = 1; numThreads <= (maxThreads > 0 ? maxThreads : 1); numThreads++) {
+        JobSystem::Setup(numThreads - 1);
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        for (int32 frame = 0; frame < numFrames; frame++) {
+            JobSystem::ParallelFor(0, numParticles, 4096, update);
+        }
+        std::chrono::duration<double> dur = std::chrono::system_clock::now() - start;
+        JobSystem::Discard();
+        if (1 == numThreads) {
+            oneThreadDur = dur.count();
+        }
+        Log::Info("JobSystem::ParallelFor %d threads, %d frames * %d particles: %f sec (%.2fx)\n",
+            numThreads, numFrames, numParticles, dur.count(), oneThreadDur / dur.count());
+    }
+
+    // cost of running small jobs
+    JobSystem::Setup();
+    const int32 numJobs = 100000;
+    std::atomic<int32> counter(0);
+    std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+    JobHandle group = JobSystem::CreateGroup();
+    for (int32 i = 0; i < numJobs; i++) {
+        JobSystem::Run([&counter]() {
+            counter.fetch_add(1, std::memory_order_relaxed);
+        }, group);
+    }
+    JobSystem::CloseGroup(group);
+    JobSystem::Wait(group);
+    std::chrono::duration<double> dur = std::chrono::system_clock::now() - start;
+    CHECK(counter == numJobs);
+    Log::Info("JobSystem: %d empty jobs on %d threads: %f sec\n", numJobs, JobSystem::NumThreads(), dur.count());
+    JobSystem::Discard();
+}
+#endif
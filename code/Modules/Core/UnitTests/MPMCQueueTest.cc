@@ -0,0 +1,207 @@
+//------------------------------------------------------------------------------
+//  MPMCQueueTest.cc
+//  Test MPMCQueue class.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Containers/MPMCQueue.h"
+#include "Core/Containers/Queue.h"
+#include "Core/Containers/Array.h"
+#include "Core/String/String.h"
+#include "Core/Log.h"
+#include <chrono>
+#if ORYOL_HAS_THREADS
+#include <thread>
+#include <mutex>
+#include <atomic>
+#endif
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+TEST(MPMCQueueTest) {
+    MPMCQueue<String> queue(4);
+    CHECK(queue.Capacity() == 4);
+    CHECK(queue.Empty());
+
+    String str;
+    CHECK(!queue.TryDequeue(str));
+    CHECK(queue.TryEnqueue("one"));
+    CHECK(queue.TryEnqueue("two"));
+    CHECK(queue.TryEnqueue("three"));
+    CHECK(queue.TryEnqueue("four"));
+    CHECK(!queue.TryEnqueue("five"));
+    CHECK(queue.Size() == 4);
+    CHECK(queue.TryDequeue(str));
+    CHECK(str == "one");
+    CHECK(queue.TryEnqueue("five"));
+    String out[8];
+    CHECK(queue.TryDequeueBatch(out, 8) == 4);
+    CHECK((out[0] == "two") && (out[1] == "three") && (out[2] == "four") && (out[3] == "five"));
+    CHECK(queue.Empty());
+
+    // batch enqueue stops at the first full cell
+    String in[6] = { "a", "b", "c", "d", "e", "f" };
+    CHECK(queue.TryEnqueueBatch(in, 3) == 3);
+    CHECK(queue.TryEnqueueBatch(in + 3, 3) == 1);
+    CHECK(queue.TryDequeueBatch(out, 2) == 2);
+    CHECK((out[0] == "a") && (out[1] == "b"));
+    CHECK(queue.TryEnqueueBatch(in + 4, 2) == 2);
+    CHECK(queue.TryDequeueBatch(out, 8) == 4);
+    CHECK((out[0] == "c") && (out[1] == "d") && (out[2] == "e") && (out[3] == "f"));
+
+    // remaining elements are destroyed with the queue
+    CHECK(queue.TryEnqueue("leftover"));
+}
+
+#if ORYOL_HAS_THREADS
+//------------------------------------------------------------------------------
+TEST(MPMCQueueMultiThreaded) {
+    const int32 numProducers = 4;
+    const int32 numConsumers = 4;
+    const int32 numPerProducer = 250000;
+    MPMCQueue<int32> queue(1024);
+    std::atomic<int32> numConsumed(0);
+    std::atomic<int64> sum(0);
+    // each consumer checks that the items of each producer arrive in order
+    std::atomic<int32> numOutOfOrder(0);
+
+    Array<std::thread> threads;
+    for (int32 p = 0; p < numProducers; p++) {
+        threads.Add(std::thread([&queue, p, numPerProducer]() {
+            int32 batch[8];
+            int32 i = 0;
+            while (i < numPerProducer) {
+                int32 n = 0;
+                if (p & 1) {
+                    while ((n < 8) && ((i + n) < numPerProducer)) {
+                        batch[n] = (p << 24) | (i + n);
+                        n++;
+                    }
+                    n = queue.TryEnqueueBatch(batch, n);
+                }
+                else if (queue.TryEnqueue((p << 24) | i)) {
+                    n = 1;
+                }
+                if (0 == n) {
+                    std::this_thread::yield();
+                }
+                i += n;
+            }
+        }));
+    }
+    const int32 total = numProducers * numPerProducer;
+    for (int32 c = 0; c < numConsumers; c++) {
+        threads.Add(std::thread([&queue, &numConsumed, &sum, &numOutOfOrder, c, total]() {
+            int32 last[numProducers] = { -1, -1, -1, -1 };
+            int32 batch[8];
+            while (numConsumed.load() < total) {
+                int32 n = 0;
+                if (c & 1) {
+                    n = queue.TryDequeueBatch(batch, 8);
+                }
+                else if (queue.TryDequeue(batch[0])) {
+                    n = 1;
+                }
+                if (0 == n) {
+                    std::this_thread::yield();
+                }
+                for (int32 i = 0; i < n; i++) {
+                    const int32 p = batch[i] >> 24;
+                    const int32 val = batch[i] & 0xFFFFFF;
+                    if (val <= last[p]) {
+                        numOutOfOrder++;
+                    }
+                    last[p] = val;
+                    sum += val;
+                }
+                numConsumed += n;
+            }
+        }));
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    int64 expected = 0;
+    for (int32 i = 0; i < numPerProducer; i++) {
+        expected += i;
+    }
+    CHECK(numConsumed.load() == total);
+    CHECK(sum.load() == expected * numProducers);
+    CHECK(numOutOfOrder.load() == 0);
+    CHECK(queue.Empty());
+}
+
+//------------------------------------------------------------------------------
+TEST(MPMCQueueBenchmark) {
+    const int32 numThreads = 4;
+    const int32 numPerProducer = 500000;
+    const int32 total = numThreads * numPerProducer;
+
+    // Queue + std::mutex
+    std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+    {
+        Queue<int32> queue;
+        std::mutex mutex;
+        std::atomic<int32> numConsumed(0);
+        Array<std::thread> threads;
+        for (int32 i = 0; i < numThreads; i++) {
+            threads.Add(std::thread([&queue, &mutex, numPerProducer]() {
+                for (int32 i = 0; i < numPerProducer; i++) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    queue.Enqueue(i);
+                }
+            }));
+            threads.Add(std::thread([&queue, &mutex, &numConsumed, total]() {
+                while (numConsumed.load(std::memory_order_relaxed) < total) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!queue.Empty()) {
+                        queue.Dequeue();
+                        numConsumed++;
+                    }
+                }
+            }));
+        }
+        for (std::thread& t : threads) {
+            t.join();
+        }
+    }
+    std::chrono::duration<double> mutexDur = std::chrono::system_clock::now() - start;
+
+    // MPMCQueue
+    start = std::chrono::system_clock::now();
+    {
+        MPMCQueue<int32> queue(4096);
+        std::atomic<int32> numConsumed(0);
+        Array<std::thread> threads;
+        for (int32 i = 0; i < numThreads; i++) {
+            threads.Add(std::thread([&queue, numPerProducer]() {
+                for (int32 i = 0; i < numPerProducer; ) {
+                    if (queue.TryEnqueue(i)) {
+                        i++;
+                    }
+                    else {
+                        std::this_thread::yield();
+                    }
+                }
+            }));
+            threads.Add(std::thread([&queue, &numConsumed, total]() {
+                int32 val = 0;
+                while (numConsumed.load(std::memory_order_relaxed) < total) {
+                    if (queue.TryDequeue(val)) {
+                        numConsumed++;
+                    }
+                    else {
+                        std::this_thread::yield();
+                    }
+                }
+            }));
+        }
+        for (std::thread& t : threads) {
+            t.join();
+        }
+    }
+    std::chrono::duration<double> mpmcDur = std::chrono::system_clock::now() - start;
+    Log::Info("%d producers, %d consumers, %d items: Queue+mutex %f sec, MPMCQueue %f sec\n", numThreads, numThreads, total, mutexDur.count(), mpmcDur.count());
+}
+#endif
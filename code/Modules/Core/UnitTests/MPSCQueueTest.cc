@@ -0,0 +1,167 @@
+//------------------------------------------------------------------------------
+//  MPSCQueueTest.cc
+//  Test MPSCQueue class.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Containers/MPSCQueue.h"
+#include "Core/Containers/Array.h"
+#include "Core/String/String.h"
+#if ORYOL_HAS_THREADS
+#include <thread>
+#include <atomic>
+#endif
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+TEST(MPSCQueueTest) {
+    MPSCQueue<String> queue;
+    CHECK(queue.Empty());
+
+    String str;
+    CHECK(!queue.TryDequeue(str));
+    queue.Enqueue("one");
+    CHECK(!queue.Empty());
+    String two("two");
+    queue.Enqueue(two);
+    queue.Enqueue(String("three"));
+    CHECK(queue.TryDequeue(str));
+    CHECK(str == "one");
+    CHECK(queue.TryDequeue(str));
+    CHECK(str == "two");
+    CHECK(queue.TryDequeue(str));
+    CHECK(str == "three");
+    CHECK(queue.Empty());
+    CHECK(!queue.TryDequeue(str));
+
+    // the queue grows as needed
+    for (int32 i = 0; i < 10000; i++) {
+        queue.Enqueue(String("bla"));
+    }
+    int32 num = 0;
+    while (queue.TryDequeue(str)) {
+        num++;
+    }
+    CHECK(num == 10000);
+    CHECK(queue.Empty());
+
+    // remaining elements are destroyed with the queue
+    queue.Enqueue("leftover");
+}
+
+//------------------------------------------------------------------------------
+TEST(MPSCQueueBatchTest) {
+    MPSCQueue<String> queue;
+    const String strs[] = { "one", "two", "three" };
+    queue.EnqueueBatch(strs, 0);
+    CHECK(queue.Empty());
+    queue.Enqueue("zero");
+    queue.EnqueueBatch(strs, 3);
+    queue.EnqueueBatch(strs, 1);
+    CHECK(!queue.Empty());
+    String str;
+    CHECK(queue.TryDequeue(str) && (str == "zero"));
+    CHECK(queue.TryDequeue(str) && (str == "one"));
+    CHECK(queue.TryDequeue(str) && (str == "two"));
+    CHECK(queue.TryDequeue(str) && (str == "three"));
+    CHECK(queue.TryDequeue(str) && (str == "one"));
+    CHECK(!queue.TryDequeue(str));
+    CHECK(queue.Empty());
+    queue.EnqueueBatch(strs, 2);
+}
+
+#if ORYOL_HAS_THREADS
+//------------------------------------------------------------------------------
+TEST(MPSCQueueMultiThreadedBatch) {
+    // the elements of a batch must arrive without elements
+    // of other producers in between
+    const int32 numProducers = 4;
+    const int32 numBatches = 10000;
+    const int32 batchSize = 8;
+    MPSCQueue<int32> queue;
+
+    Array<std::thread> threads;
+    for (int32 p = 0; p < numProducers; p++) {
+        threads.Add(std::thread([&queue, p, numBatches, batchSize]() {
+            int32 batch[batchSize];
+            for (int32 b = 0; b < numBatches; b++) {
+                for (int32 i = 0; i < batchSize; i++) {
+                    batch[i] = (p << 24) | (b * batchSize + i);
+                }
+                queue.EnqueueBatch(batch, batchSize);
+            }
+        }));
+    }
+    int32 numInterleaved = 0;
+    int32 numConsumed = 0;
+    int32 prev = 0;
+    const int32 total = numProducers * numBatches * batchSize;
+    while (numConsumed < total) {
+        int32 val = 0;
+        if (queue.TryDequeue(val)) {
+            if ((0 != ((val & 0xFFFFFF) % batchSize)) && (val != prev + 1)) {
+                numInterleaved++;
+            }
+            prev = val;
+            numConsumed++;
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    CHECK(numInterleaved == 0);
+    CHECK(queue.Empty());
+}
+
+//------------------------------------------------------------------------------
+TEST(MPSCQueueMultiThreaded) {
+    const int32 numProducers = 4;
+    const int32 numPerProducer = 250000;
+    MPSCQueue<int32> queue;
+
+    Array<std::thread> threads;
+    for (int32 p = 0; p < numProducers; p++) {
+        threads.Add(std::thread([&queue, p, numPerProducer]() {
+            for (int32 i = 0; i < numPerProducer; i++) {
+                queue.Enqueue((p << 24) | i);
+            }
+        }));
+    }
+    // the items of each producer must arrive in order
+    int32 last[numProducers] = { -1, -1, -1, -1 };
+    int32 numOutOfOrder = 0;
+    int32 numConsumed = 0;
+    int64 sum = 0;
+    const int32 total = numProducers * numPerProducer;
+    while (numConsumed < total) {
+        int32 val = 0;
+        if (queue.TryDequeue(val)) {
+            const int32 p = val >> 24;
+            val &= 0xFFFFFF;
+            if (val <= last[p]) {
+                numOutOfOrder++;
+            }
+            last[p] = val;
+            sum += val;
+            numConsumed++;
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    int64 expected = 0;
+    for (int32 i = 0; i < numPerProducer; i++) {
+        expected += i;
+    }
+    CHECK(sum == expected * numProducers);
+    CHECK(numOutOfOrder == 0);
+    CHECK(queue.Empty());
+}
+#endif
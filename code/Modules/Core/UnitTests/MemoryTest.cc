@@ -6,6 +6,7 @@
 #include "UnitTest++/src/UnitTest++.h"
 #include "Core/Memory/Memory.h"
 #include "Core/Assert.h"
+#include <cstring>
 
 using namespace Oryol;
 
@@ -76,3 +77,86 @@ TEST(Memory) {
 }
 
 
+
+//------------------------------------------------------------------------------
+TEST(MemoryTagTest) {
+    CHECK(MemoryTag::FromString("Containers") == MemoryTag::Containers);
+    CHECK(0 == std::strcmp(MemoryTag::ToString(MemoryTag::IO), "IO"));
+
+    // default backend must be installed
+    const Memory::Allocator& alloc = Memory::GetAllocator();
+    CHECK(nullptr != alloc.Alloc);
+    CHECK(nullptr != alloc.ReAlloc);
+    CHECK(nullptr != alloc.Free);
+
+    // tagged allocations work with and without statistics
+    uint8* p = (uint8*) Memory::Alloc(100, MemoryTag::Synth);
+    CHECK(Memory::IsAligned(p, ORYOL_MAX_PLATFORM_ALIGN));
+    Memory::Fill(p, 100, 0x12);
+    p = (uint8*) Memory::ReAlloc(p, 200);
+    CHECK(p[99] == 0x12);
+    Memory::Free(p);
+#if !ORYOL_ALLOCATOR_STATS
+    const Memory::Stats stats = Memory::GetStats(MemoryTag::Synth);
+    CHECK(0 == stats.LiveBytes);
+    CHECK(0 == stats.TotalAllocs);
+#endif
+}
+
+#if ORYOL_ALLOCATOR_STATS
+//------------------------------------------------------------------------------
+TEST(MemoryStatsTest) {
+    const Memory::Stats before = Memory::GetStats(MemoryTag::Synth);
+    const Memory::Stats totalBefore = Memory::GetTotalStats();
+
+    // tagged allocations are accounted to their tag and the totals
+    void* p0 = Memory::Alloc(100, MemoryTag::Synth);
+    void* p1 = Memory::Alloc(28, MemoryTag::Synth);
+    Memory::Stats stats = Memory::GetStats(MemoryTag::Synth);
+    CHECK(stats.LiveBytes == before.LiveBytes + 128);
+    CHECK(stats.LiveAllocs == before.LiveAllocs + 2);
+    CHECK(stats.TotalAllocs == before.TotalAllocs + 2);
+    CHECK(stats.PeakBytes >= stats.LiveBytes);
+    Memory::Stats total = Memory::GetTotalStats();
+    CHECK(total.TotalAllocs >= totalBefore.TotalAllocs + 2);
+
+    // ReAlloc keeps the original tag
+    p0 = Memory::ReAlloc(p0, 200);
+    stats = Memory::GetStats(MemoryTag::Synth);
+    CHECK(stats.LiveBytes == before.LiveBytes + 228);
+    CHECK(stats.LiveAllocs == before.LiveAllocs + 2);
+
+    Memory::Free(p0);
+    Memory::Free(p1);
+    stats = Memory::GetStats(MemoryTag::Synth);
+    CHECK(stats.LiveBytes == before.LiveBytes);
+    CHECK(stats.LiveAllocs == before.LiveAllocs);
+    CHECK(stats.PeakBytes >= before.LiveBytes + 228);
+
+    // frame statistics
+    Memory::NewFrameStats();
+    p0 = Memory::Alloc(16, MemoryTag::Synth);
+    Memory::Free(p0);
+    Memory::NewFrameStats();
+    stats = Memory::GetStats(MemoryTag::Synth);
+    CHECK(stats.FrameAllocs == 1);
+}
+#endif
+
+//------------------------------------------------------------------------------
+TEST(MemoryAlignedTest) {
+    for (int32 align = 1; align <= 4096; align <<= 1) {
+        uint8* p = (uint8*) Memory::AllocAligned(100, align);
+        CHECK(nullptr != p);
+        CHECK(Memory::IsAligned(p, align));
+        Memory::Fill(p, 100, 0x33);
+        Memory::FreeAligned(p);
+    }
+    Memory::FreeAligned(nullptr);
+
+    void* ptr = (void*) 0x1234567;
+    ptr = Memory::AlignUp(ptr, 64);
+    CHECK(intptr(ptr) == 0x1234580);
+    CHECK(Memory::IsAligned(ptr, 64));
+    CHECK(!Memory::IsAligned(ptr, 256));
+}
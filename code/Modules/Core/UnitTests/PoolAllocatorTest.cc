@@ -9,6 +9,10 @@
 #include "Core/RefCounted.h"
 #include "Core/Ptr.h"
 #include "Core/Memory/poolAllocator.h"
+#include "Core/Containers/Array.h"
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
 
 using namespace Oryol;
 using namespace Oryol::_priv;
@@ -28,3 +32,94 @@ TEST(PoolAllocator) {
     CHECK(obj == obj1);
     allocatorOne.Destroy(obj1);
 }
+
+struct PoolTestObj {
+    PoolTestObj(int32 v) : val(v) { };
+    int32 val;
+};
+
+TEST(PoolAllocatorGrow) {
+
+    // more then 256x256 objects must be possible
+    poolAllocator<PoolTestObj> pool;
+    const int32 num = 200000;
+    Array<PoolTestObj*> objs;
+    objs.Reserve(num);
+    for (int32 i = 0; i < num; i++) {
+        objs.Add(pool.Create(i));
+    }
+    CHECK(pool.Capacity() >= num);
+    bool valid = true;
+    for (int32 i = 0; i < num; i++) {
+        if (objs[i]->val != i) {
+            valid = false;
+        }
+    }
+    CHECK(valid);
+    const int32 capacity = pool.Capacity();
+    for (PoolTestObj* obj : objs) {
+        pool.Destroy(obj);
+    }
+    objs.Clear();
+
+    // re-creating the same number of objects must not grow the pool
+    for (int32 i = 0; i < num; i++) {
+        objs.Add(pool.Create(i));
+    }
+    CHECK(pool.Capacity() == capacity);
+    for (PoolTestObj* obj : objs) {
+        pool.Destroy(obj);
+    }
+}
+
+#if ORYOL_HAS_THREADS
+TEST(PoolAllocatorMultiThreaded) {
+
+    // objects are created and destroyed on different threads, and
+    // must never be handed out twice
+    poolAllocator<PoolTestObj> pool;
+    const int32 numThreads = 8;
+    const int32 numObjects = 20000;
+    const int32 numLoops = 10;
+    Array<PoolTestObj*> objs[numThreads];
+    bool valid[numThreads] = { };
+    std::thread threads[numThreads];
+    for (int32 loop = 0; loop < numLoops; loop++) {
+        for (int32 t = 0; t < numThreads; t++) {
+            threads[t] = std::thread([&pool, &objs, &valid, t, numThreads, numObjects] {
+                // destroy the objects created by a neighbour thread in the previous loop
+                Array<PoolTestObj*>& prev = objs[(t + 1) % numThreads];
+                valid[t] = true;
+                for (PoolTestObj* obj : prev) {
+                    if (obj->val != ((t + 1) % numThreads)) {
+                        valid[t] = false;
+                    }
+                    pool.Destroy(obj);
+                }
+                prev.Clear();
+            });
+        }
+        for (int32 t = 0; t < numThreads; t++) {
+            threads[t].join();
+            CHECK(valid[t]);
+        }
+        for (int32 t = 0; t < numThreads; t++) {
+            threads[t] = std::thread([&pool, &objs, t, numObjects] {
+                for (int32 i = 0; i < numObjects; i++) {
+                    objs[t].Add(pool.Create(t));
+                }
+            });
+        }
+        for (int32 t = 0; t < numThreads; t++) {
+            threads[t].join();
+        }
+    }
+    for (int32 t = 0; t < numThreads; t++) {
+        for (PoolTestObj* obj : objs[t]) {
+            CHECK(obj->val == t);
+            pool.Destroy(obj);
+        }
+    }
+    CHECK(pool.Capacity() <= 2 * numThreads * numObjects);
+}
+#endif
@@ -0,0 +1,218 @@
+//------------------------------------------------------------------------------
+//  RWLockTest.cc
+//  Test RWLock class.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Threading/RWLock.h"
+#include "Core/Containers/Array.h"
+#include "Core/Log.h"
+#if ORYOL_HAS_THREADS
+#include <thread>
+#include <atomic>
+#include <chrono>
+#endif
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+TEST(RWLockTest) {
+    RWLock lock;
+    CHECK(lock.GetPolicy() == RWLock::PreferWriter);
+
+    // multiple readers, no writers
+    lock.LockRead();
+    CHECK(lock.TryLockRead());
+    CHECK(!lock.TryLockWrite());
+    lock.UnlockRead();
+    lock.UnlockRead();
+
+    // one writer, no readers
+    CHECK(lock.TryLockWrite());
+    CHECK(!lock.TryLockWrite());
+    CHECK(!lock.TryLockRead());
+    lock.UnlockWrite();
+    lock.LockWrite();
+    lock.UnlockWrite();
+    lock.LockRead();
+    lock.UnlockRead();
+    CHECK(lock.TryLockWrite());
+    lock.UnlockWrite();
+
+    RWLock readerLock(RWLock::PreferReader);
+    CHECK(readerLock.GetPolicy() == RWLock::PreferReader);
+    readerLock.LockRead();
+    CHECK(!readerLock.TryLockWrite());
+    readerLock.UnlockRead();
+    CHECK(readerLock.TryLockWrite());
+    readerLock.UnlockWrite();
+}
+
+#if ORYOL_HAS_THREADS
+//------------------------------------------------------------------------------
+TEST(RWLockPolicy) {
+    for (int32 p = 0; p < 2; p++) {
+        const RWLock::Policy policy = (0 == p) ? RWLock::PreferWriter : RWLock::PreferReader;
+        RWLock lock(policy);
+
+        // a writer waits for a reader to leave
+        lock.LockRead();
+        std::atomic<bool> writerDone(false);
+        std::thread writer([&lock, &writerDone]() {
+            lock.LockWrite();
+            writerDone = true;
+            lock.UnlockWrite();
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        CHECK(!writerDone.load());
+
+        // with PreferWriter, new readers must wait for the waiting writer
+        if (RWLock::PreferWriter == policy) {
+            CHECK(!lock.TryLockRead());
+        }
+        else {
+            CHECK(lock.TryLockRead());
+            lock.UnlockRead();
+        }
+        lock.UnlockRead();
+        writer.join();
+        CHECK(writerDone.load());
+        CHECK(lock.TryLockRead());
+        lock.UnlockRead();
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST(RWLockMultiThreaded) {
+    for (int32 p = 0; p < 2; p++) {
+        RWLock lock((0 == p) ? RWLock::PreferWriter : RWLock::PreferReader);
+        // writers keep both values identical, readers check this
+        int32 value0 = 0;
+        int32 value1 = 0;
+        std::atomic<int32> numErrors(0);
+        const int32 numThreads = 8;
+        const int32 numIters = 20000;
+        Array<std::thread> threads;
+        for (int32 t = 0; t < numThreads; t++) {
+            threads.Add(std::thread([&lock, &value0, &value1, &numErrors, t, numIters]() {
+                for (int32 i = 0; i < numIters; i++) {
+                    if (0 == ((i + t) % 8)) {
+                        lock.LockWrite();
+                        value0++;
+                        value1++;
+                        lock.UnlockWrite();
+                    }
+                    else {
+                        lock.LockRead();
+                        if (value0 != value1) {
+                            numErrors++;
+                        }
+                        lock.UnlockRead();
+                    }
+                }
+            }));
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        CHECK(numErrors.load() == 0);
+        CHECK(value0 == (numThreads * numIters) / 8);
+        CHECK(value1 == value0);
+    }
+}
+
+//------------------------------------------------------------------------------
+// the previous pure-spinning RWLock, for comparison
+class spinRWLock {
+public:
+    void LockWrite() {
+        while (std::atomic_exchange_explicit(&this->writeLock, true, std::memory_order_acquire)) { }
+        while (this->readCount > 0) { }
+    };
+    void UnlockWrite() {
+        std::atomic_store_explicit(&this->writeLock, false, std::memory_order_release);
+    };
+    void LockRead() {
+        while (this->writeLock) { }
+        ++this->readCount;
+    };
+    void UnlockRead() {
+        --this->readCount;
+    };
+private:
+    std::atomic<bool> writeLock{false};
+    std::atomic<int32> readCount{0};
+};
+
+//------------------------------------------------------------------------------
+template<class LOCK> static void
+contentionBenchmark(const char* name, LOCK& lock, int32 numThreads, int32 writePercent) {
+    // each thread locks as often as possible for a fixed amount of time,
+    // with a little bit of work inside the lock
+    std::atomic<bool> stop(false);
+    std::atomic<int64> numReads(0);
+    std::atomic<int64> numWrites(0);
+    std::atomic<int64> maxWriteWait(0);
+    volatile int32 shared = 0;
+    Array<std::thread> threads;
+    for (int32 t = 0; t < numThreads; t++) {
+        threads.Add(std::thread([&, t]() {
+            int64 reads = 0, writes = 0, maxWait = 0;
+            uint32 rnd = 0x12345 * (t + 1);
+            while (!stop.load(std::memory_order_relaxed)) {
+                rnd = rnd * 1103515245 + 12345;
+                if (int32((rnd >> 16) % 100) < writePercent) {
+                    auto start = std::chrono::high_resolution_clock::now();
+                    lock.LockWrite();
+                    std::chrono::duration<double, std::micro> wait = std::chrono::high_resolution_clock::now() - start;
+                    maxWait = int64(wait.count()) > maxWait ? int64(wait.count()) : maxWait;
+                    for (int32 i = 0; i < 16; i++) {
+                        shared = shared + 1;
+                    }
+                    lock.UnlockWrite();
+                    writes++;
+                }
+                else {
+                    lock.LockRead();
+                    int32 sum = 0;
+                    for (int32 i = 0; i < 16; i++) {
+                        sum += shared;
+                    }
+                    (void)sum;
+                    lock.UnlockRead();
+                    reads++;
+                }
+            }
+            numReads += reads;
+            numWrites += writes;
+            int64 prevMax = maxWriteWait.load();
+            while ((maxWait > prevMax) && !maxWriteWait.compare_exchange_weak(prevMax, maxWait)) { }
+        }));
+    }
+    const double duration = 0.2;
+    std::this_thread::sleep_for(std::chrono::milliseconds(int(duration * 1000)));
+    stop = true;
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    Log::Info("%s, %d threads, %d%% writes: %.0f reads/sec, %.0f writes/sec, max write wait %d usec\n",
+        name, numThreads, writePercent, numReads.load() / duration, numWrites.load() / duration, int32(maxWriteWait.load()));
+}
+
+//------------------------------------------------------------------------------
+TEST(RWLockBenchmark) {
+    const int32 numCores = int32(std::thread::hardware_concurrency());
+    const int32 numThreadCounts = 2;
+    const int32 threadCounts[numThreadCounts] = { numCores > 1 ? numCores : 2, (numCores > 1 ? numCores : 2) * 4 };
+    for (int32 i = 0; i < numThreadCounts; i++) {
+        for (int32 writePercent : { 1, 10 }) {
+            spinRWLock spinLock;
+            contentionBenchmark("spinning RWLock", spinLock, threadCounts[i], writePercent);
+            RWLock writerLock(RWLock::PreferWriter);
+            contentionBenchmark("RWLock(PreferWriter)", writerLock, threadCounts[i], writePercent);
+            RWLock readerLock(RWLock::PreferReader);
+            contentionBenchmark("RWLock(PreferReader)", readerLock, threadCounts[i], writePercent);
+        }
+    }
+}
+#endif
@@ -5,6 +5,13 @@
 #include "Pre.h"
 #include "UnitTest++/src/UnitTest++.h"
 #include "Core/RunLoop.h"
+#include "Core/Threading/JobSystem.h"
+#include "Core/Log.h"
+#include <atomic>
+#include <chrono>
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
 
 using namespace Oryol;
 
@@ -30,3 +37,123 @@ TEST(RunLoopTest) {
     CHECK(y == 4);
     runLoop = 0;
 }
+
+//------------------------------------------------------------------------------
+TEST(RunLoopPhaseTest) {
+    Ptr<RunLoop> runLoop = RunLoop::Create();
+    Array<int32> order;
+    runLoop->Add("late", 10, RunLoop::Serial, [&order]() { order.Add(3); });
+    runLoop->Add("early", -10, RunLoop::Serial, [&order]() { order.Add(0); });
+    runLoop->Add([&order]() { order.Add(1); });
+    runLoop->Add("default", [&order]() { order.Add(2); });
+    runLoop->Run();
+    CHECK(order.Size() == 4);
+    for (int32 i = 0; i < order.Size(); i++) {
+        CHECK(order[i] == i);
+    }
+
+    const Array<RunLoop::Timing>& timings = runLoop->Timings();
+    CHECK(timings.Size() == 4);
+    CHECK(timings[0].Name == "early");
+    CHECK(timings[0].Phase == -10);
+    CHECK(timings[1].Name.Empty());
+    CHECK(timings[1].Phase == RunLoop::DefaultPhase);
+    CHECK(timings[2].Name == "default");
+    CHECK(timings[3].Name == "late");
+    CHECK(timings[3].Mode == RunLoop::Serial);
+    for (const auto& timing : timings) {
+        CHECK(timing.MilliSecs >= 0.0);
+    }
+    runLoop = 0;
+}
+
+#if ORYOL_HAS_THREADS
+//------------------------------------------------------------------------------
+TEST(RunLoopParallelTest) {
+    JobSystem::Setup(3);
+    Ptr<RunLoop> runLoop = RunLoop::Create();
+
+    // phase 0: parallel callbacks, phase 1 checks that all of them
+    // have finished (barrier between phases)
+    const int32 numParallel = 8;
+    std::atomic<int32> counter(0);
+    std::atomic<int32> numOtherThreads(0);
+    const std::thread::id mainThreadId = std::this_thread::get_id();
+    for (int32 i = 0; i < numParallel; i++) {
+        runLoop->Add("parallel", 0, RunLoop::Parallel, [&counter, &numOtherThreads, mainThreadId]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            if (std::this_thread::get_id() != mainThreadId) {
+                numOtherThreads++;
+            }
+            counter++;
+        });
+    }
+    bool serialOnMainThread = false;
+    runLoop->Add("serial", 0, RunLoop::Serial, [&serialOnMainThread, mainThreadId]() {
+        serialOnMainThread = std::this_thread::get_id() == mainThreadId;
+    });
+    int32 counterInPhase1 = 0;
+    runLoop->Add("check", 1, RunLoop::Serial, [&counter, &counterInPhase1]() {
+        counterInPhase1 = counter;
+    });
+    for (int32 frame = 0; frame < 3; frame++) {
+        runLoop->Run();
+        CHECK(counterInPhase1 == (frame + 1) * numParallel);
+    }
+    CHECK(serialOnMainThread);
+    CHECK(numOtherThreads > 0);
+
+    const Array<RunLoop::Timing>& timings = runLoop->Timings();
+    CHECK(timings.Size() == numParallel + 2);
+    for (int32 i = 0; i < numParallel; i++) {
+        CHECK(timings[i].Mode == RunLoop::Parallel);
+        CHECK(timings[i].MilliSecs >= 4.0);
+    }
+    CHECK(timings[numParallel + 1].Name == "check");
+    runLoop = 0;
+    JobSystem::Discard();
+
+    // without a JobSystem, Parallel callbacks run on the calling thread
+    runLoop = RunLoop::Create();
+    numOtherThreads = 0;
+    runLoop->Add("parallel", 0, RunLoop::Parallel, [&numOtherThreads, mainThreadId]() {
+        if (std::this_thread::get_id() != mainThreadId) {
+            numOtherThreads++;
+        }
+    });
+    runLoop->Run();
+    CHECK(numOtherThreads == 0);
+    runLoop = 0;
+}
+
+//------------------------------------------------------------------------------
+TEST(RunLoopParallelBenchmark) {
+    // 4 independent callbacks with 2ms of CPU work each
+    const int32 numCallbacks = 4;
+    const int32 numFrames = 20;
+    auto work = []() {
+        volatile float32 val = 1.0f;
+        for (int32 i = 0; i < 250000; i++) {
+            val = val * 0.999f + 0.001f;
+        }
+    };
+    for (int32 pass = 0; pass < 2; pass++) {
+        const RunLoop::Mode mode = (0 == pass) ? RunLoop::Serial : RunLoop::Parallel;
+        JobSystem::Setup();
+        Ptr<RunLoop> runLoop = RunLoop::Create();
+        for (int32 i = 0; i < numCallbacks; i++) {
+            runLoop->Add("work", RunLoop::DefaultPhase, mode, work);
+        }
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int32 frame = 0; frame < numFrames; frame++) {
+            runLoop->Run();
+        }
+        std::chrono::duration<double, std::milli> dur = std::chrono::high_resolution_clock::now() - start;
+        Log::Info("RunLoop: %d %s callbacks on %d threads: %.3f ms per frame (last frame: %.3f ms per callback)\n",
+            numCallbacks, (0 == pass) ? "Serial" : "Parallel", JobSystem::NumThreads(),
+            dur.count() / numFrames, runLoop->Timings()[0].MilliSecs);
+        runLoop = 0;
+        JobSystem::Discard();
+    }
+}
+#endif
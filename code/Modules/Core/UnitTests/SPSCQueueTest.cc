@@ -0,0 +1,164 @@
+//------------------------------------------------------------------------------
+//  SPSCQueueTest.cc
+//  Test SPSCQueue class.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Containers/SPSCQueue.h"
+#include "Core/Containers/Queue.h"
+#include "Core/String/String.h"
+#include "Core/Log.h"
+#include <chrono>
+#if ORYOL_HAS_THREADS
+#include <thread>
+#include <mutex>
+#endif
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+TEST(SPSCQueueTest) {
+    SPSCQueue<String> queue(5);
+    CHECK(queue.Capacity() == 8);
+    CHECK(queue.Empty());
+    CHECK(queue.Size() == 0);
+
+    const char* names[8] = { "0", "1", "2", "3", "4", "5", "6", "7" };
+    String str;
+    CHECK(!queue.TryDequeue(str));
+    for (int32 i = 0; i < 8; i++) {
+        CHECK(queue.TryEnqueue(String(names[i])));
+    }
+    CHECK(queue.Size() == 8);
+    CHECK(!queue.TryEnqueue("full"));
+    for (int32 i = 0; i < 8; i++) {
+        CHECK(queue.TryDequeue(str));
+        CHECK(str == names[i]);
+    }
+    CHECK(queue.Empty());
+
+    // batches which wrap around the end of the ring buffer
+    String in[6] = { "a", "b", "c", "d", "e", "f" };
+    String out[8];
+    CHECK(queue.TryEnqueueBatch(in, 6) == 6);
+    CHECK(queue.TryEnqueueBatch(in, 6) == 2);
+    CHECK(queue.TryDequeueBatch(out, 3) == 3);
+    CHECK((out[0] == "a") && (out[1] == "b") && (out[2] == "c"));
+    CHECK(queue.TryEnqueueBatch(in, 6) == 3);
+    CHECK(queue.Size() == 8);
+    CHECK(queue.TryDequeueBatch(out, 8) == 8);
+    CHECK((out[0] == "d") && (out[2] == "f") && (out[3] == "a") && (out[4] == "b"));
+    CHECK((out[5] == "a") && (out[7] == "c"));
+    CHECK(queue.TryDequeueBatch(out, 8) == 0);
+
+    // remaining elements are destroyed with the queue
+    CHECK(queue.TryEnqueue("leftover"));
+}
+
+#if ORYOL_HAS_THREADS
+//------------------------------------------------------------------------------
+TEST(SPSCQueueMultiThreaded) {
+    const int32 num = 1000000;
+    SPSCQueue<int32> queue(256);
+    std::thread producer([&queue, num]() {
+        int32 batch[16];
+        int32 i = 0;
+        while (i < num) {
+            if (i & 1) {
+                if (queue.TryEnqueue(i)) {
+                    i++;
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+            else {
+                int32 n = 0;
+                while ((n < 16) && ((i + n) < num)) {
+                    batch[n] = i + n;
+                    n++;
+                }
+                n = queue.TryEnqueueBatch(batch, n);
+                if (0 == n) {
+                    std::this_thread::yield();
+                }
+                i += n;
+            }
+        }
+    });
+    int32 next = 0;
+    bool ordered = true;
+    int32 batch[32];
+    while (next < num) {
+        const int32 n = queue.TryDequeueBatch(batch, 32);
+        if (0 == n) {
+            std::this_thread::yield();
+        }
+        for (int32 i = 0; i < n; i++) {
+            if (batch[i] != next++) {
+                ordered = false;
+            }
+        }
+    }
+    producer.join();
+    CHECK(ordered);
+    CHECK(queue.Empty());
+}
+
+//------------------------------------------------------------------------------
+TEST(SPSCQueueBenchmark) {
+    const int32 num = 4000000;
+
+    // Queue + std::mutex
+    std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+    {
+        Queue<int32> queue;
+        std::mutex mutex;
+        std::thread producer([&queue, &mutex, num]() {
+            for (int32 i = 0; i < num; i++) {
+                std::lock_guard<std::mutex> lock(mutex);
+                queue.Enqueue(i);
+            }
+        });
+        int32 received = 0;
+        while (received < num) {
+            std::lock_guard<std::mutex> lock(mutex);
+            while (!queue.Empty()) {
+                queue.Dequeue();
+                received++;
+            }
+        }
+        producer.join();
+    }
+    std::chrono::duration<double> mutexDur = std::chrono::system_clock::now() - start;
+
+    // SPSCQueue
+    start = std::chrono::system_clock::now();
+    {
+        SPSCQueue<int32> queue(4096);
+        std::thread producer([&queue, num]() {
+            for (int32 i = 0; i < num; ) {
+                if (queue.TryEnqueue(i)) {
+                    i++;
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        int32 received = 0;
+        int32 val = 0;
+        while (received < num) {
+            if (queue.TryDequeue(val)) {
+                received++;
+            }
+            else {
+                std::this_thread::yield();
+            }
+        }
+        producer.join();
+    }
+    std::chrono::duration<double> spscDur = std::chrono::system_clock::now() - start;
+    Log::Info("1 producer, 1 consumer, %d items: Queue+mutex %f sec, SPSCQueue %f sec\n", num, mutexDur.count(), spscDur.count());
+}
+#endif
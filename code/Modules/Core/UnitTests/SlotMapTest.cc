@@ -0,0 +1,128 @@
+//------------------------------------------------------------------------------
+//  SlotMapTest.cc
+//  Test SlotMap class.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Containers/SlotMap.h"
+#include "Core/String/String.h"
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+TEST(SlotMapTest) {
+    SlotMap<String> map;
+    CHECK(map.Empty());
+    CHECK(map.Size() == 0);
+    CHECK(map.NumSlots() == 0);
+    CHECK(!SlotHandle().IsValid());
+    CHECK(!map.Contains(SlotHandle()));
+    CHECK(nullptr == map.Find(SlotHandle()));
+
+    SlotHandle h0 = map.Add("zero");
+    SlotHandle h1 = map.Add(String("one"));
+    SlotHandle h2 = map.Emplace("two");
+    CHECK(h0.IsValid() && h1.IsValid() && h2.IsValid());
+    CHECK(h0 != h1);
+    CHECK(map.Size() == 3);
+    CHECK(map.NumSlots() == 3);
+    CHECK(map[h0] == "zero");
+    CHECK(map[h1] == "one");
+    CHECK(*map.Find(h2) == "two");
+    CHECK(map.HandleAtIndex(map.FindIndex(h1)) == h1);
+
+    // erase swaps in the last value, handles stay valid
+    map.Erase(h0);
+    CHECK(!map.Contains(h0));
+    CHECK(nullptr == map.Find(h0));
+    CHECK(map.Size() == 2);
+    CHECK(map[h1] == "one");
+    CHECK(map[h2] == "two");
+    CHECK(map.ValueAtIndex(0) == "two");
+    map.Erase(h0);
+    CHECK(map.Size() == 2);
+
+    // slot reuse bumps the generation, old handles are stale
+    SlotHandle h3 = map.Add("three");
+    CHECK(h3.SlotIndex() == h0.SlotIndex());
+    CHECK(h3.Generation() != h0.Generation());
+    CHECK(map.NumSlots() == 3);
+    CHECK(!map.Contains(h0));
+    CHECK(map[h3] == "three");
+
+    // iteration over live values
+    int32 num = 0;
+    for (const String& str : map) {
+        CHECK((str == "one") || (str == "two") || (str == "three"));
+        num++;
+    }
+    CHECK(num == 3);
+    for (int32 i = 0; i < map.Size(); i++) {
+        CHECK(map[map.HandleAtIndex(i)] == map.ValueAtIndex(i));
+    }
+
+    // copy and move
+    SlotMap<String> map1(map);
+    CHECK(map1.Size() == 3);
+    CHECK(map1[h3] == "three");
+    map1.Erase(h3);
+    CHECK(!map1.Contains(h3));
+    CHECK(map.Contains(h3));
+    SlotMap<String> map2(std::move(map1));
+    CHECK(map1.Empty());
+    CHECK(map2.Size() == 2);
+    SlotHandle h4 = map2.Add("four");
+    CHECK(h4.SlotIndex() == h3.SlotIndex());
+    map1 = map2;
+    CHECK(map1[h4] == "four");
+
+    // clear makes all handles stale
+    map.Clear();
+    CHECK(map.Empty());
+    CHECK(!map.Contains(h1));
+    CHECK(!map.Contains(h2));
+    CHECK(!map.Contains(h3));
+    SlotHandle h5 = map.Add("five");
+    CHECK(map.Size() == 1);
+    CHECK(map.NumSlots() == 3);
+    CHECK(map[h5] == "five");
+}
+
+//------------------------------------------------------------------------------
+TEST(SlotMapStressTest) {
+    SlotMap<int32> map;
+    map.Reserve(100000);
+    Array<SlotHandle> handles;
+    // more than 16-bit slot indices
+    for (int32 i = 0; i < 100000; i++) {
+        handles.Add(map.Add(i));
+    }
+    CHECK(map.Size() == 100000);
+    CHECK(handles.Back().SlotIndex() == 99999);
+    for (int32 i = 0; i < 100000; i += 3) {
+        map.Erase(handles[i]);
+    }
+    for (int32 i = 0; i < 100000; i++) {
+        if ((i % 3) == 0) {
+            CHECK(!map.Contains(handles[i]));
+        }
+        else {
+            CHECK(map[handles[i]] == i);
+        }
+    }
+    // refill the free slots, no new slots must be created
+    const int32 numSlots = map.NumSlots();
+    for (int32 i = 0; i < 100000; i += 3) {
+        handles[i] = map.Add(-i);
+    }
+    CHECK(map.NumSlots() == numSlots);
+    CHECK(map.Size() == 100000);
+    int64 sum = 0;
+    for (int32 val : map) {
+        sum += val < 0 ? -val : val;
+    }
+    CHECK(sum == (int64(99999) * 100000) / 2);
+    for (int32 i = 0; i < 100000; i++) {
+        CHECK(map[handles[i]] == (((i % 3) == 0) ? -i : i));
+    }
+}
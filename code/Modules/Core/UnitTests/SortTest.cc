@@ -0,0 +1,263 @@
+//------------------------------------------------------------------------------
+//  SortTest.cc
+//  Test radix and parallel merge sort, and container bulk modes.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Containers/Sort.h"
+#include "Core/Threading/JobSystem.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/Map.h"
+#include "Core/Containers/Set.h"
+#include "Core/Containers/ArrayMap.h"
+#include "Core/Containers/KeyValuePair.h"
+#include "Core/String/String.h"
+#include "Core/Log.h"
+#include <algorithm>
+#include <chrono>
+
+using namespace Oryol;
+
+// simple deterministic pseudo-random numbers
+static uint32 _rand(uint32& seed) {
+    seed = seed * 1664525 + 1013904223;
+    return seed ^ (seed >> 16);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> static bool
+_isSorted(const Array<TYPE>& array) {
+    for (int32 i = 1; i < array.Size(); i++) {
+        if (array[i] < array[i-1]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+TEST(SortRadixTest) {
+    uint32 seed = 1;
+    const int32 num = 10000;
+
+    // unsigned 32-bit
+    Array<uint32> u32;
+    for (int32 i = 0; i < num; i++) {
+        u32.Add(_rand(seed));
+    }
+    Array<uint32> u32Ref = u32;
+    std::sort(u32Ref.begin(), u32Ref.end());
+    Sort::Radix(u32.begin(), u32.end());
+    CHECK(_isSorted(u32));
+    CHECK(std::equal(u32.begin(), u32.end(), u32Ref.begin()));
+
+    // signed 32-bit, positive and negative values
+    Array<int32> i32;
+    for (int32 i = 0; i < num; i++) {
+        i32.Add(int32(_rand(seed)));
+    }
+    i32.Add(0); i32.Add(-1); i32.Add(0x7FFFFFFF); i32.Add(int32(0x80000000));
+    Array<int32> i32Ref = i32;
+    std::sort(i32Ref.begin(), i32Ref.end());
+    Sort::Radix(i32.begin(), i32.end());
+    CHECK(std::equal(i32.begin(), i32.end(), i32Ref.begin()));
+    CHECK(i32[0] == int32(0x80000000));
+    CHECK(i32[i32.Size()-1] == 0x7FFFFFFF);
+
+    // signed 64-bit
+    Array<int64> i64;
+    for (int32 i = 0; i < num; i++) {
+        i64.Add((int64(_rand(seed)) << 32) | _rand(seed));
+    }
+    Array<int64> i64Ref = i64;
+    std::sort(i64Ref.begin(), i64Ref.end());
+    Sort::Radix(i64.begin(), i64.end());
+    CHECK(std::equal(i64.begin(), i64.end(), i64Ref.begin()));
+
+    // signed 8-bit
+    Array<int8> i8;
+    for (int32 i = 0; i < num; i++) {
+        i8.Add(int8(_rand(seed)));
+    }
+    Array<int8> i8Ref = i8;
+    std::sort(i8Ref.begin(), i8Ref.end());
+    Sort::Radix(i8.begin(), i8.end());
+    CHECK(std::equal(i8.begin(), i8.end(), i8Ref.begin()));
+
+    // small keys (only the lowest pass is needed), and degenerate ranges
+    Array<int32> small;
+    for (int32 i = 0; i < num; i++) {
+        small.Add(_rand(seed) & 0x7F);
+    }
+    Sort::Radix(small.begin(), small.end());
+    CHECK(_isSorted(small));
+    Sort::Radix(small.begin(), small.begin());
+    Sort::Radix(small.begin(), small.begin() + 1);
+}
+
+//------------------------------------------------------------------------------
+TEST(SortKeyValuePairTest) {
+    // trivially copyable key/value pairs
+    uint32 seed = 2;
+    Array<KeyValuePair<int32, int32>> kvps;
+    for (int32 i = 0; i < 5000; i++) {
+        kvps.Add(KeyValuePair<int32, int32>(int32(_rand(seed) % 1000) - 500, i));
+    }
+    Sort::Radix(kvps.begin(), kvps.end());
+    CHECK(_isSorted(kvps));
+    // radix sort is stable
+    for (int32 i = 1; i < kvps.Size(); i++) {
+        if (kvps[i-1].key == kvps[i].key) {
+            CHECK(kvps[i-1].value < kvps[i].value);
+        }
+    }
+
+    // non-trivial value type (takes the key/index path)
+    Array<KeyValuePair<uint16, String>> strs;
+    strs.Add(KeyValuePair<uint16, String>(3, "three"));
+    strs.Add(KeyValuePair<uint16, String>(1, "one"));
+    strs.Add(KeyValuePair<uint16, String>(300, "threehundred"));
+    strs.Add(KeyValuePair<uint16, String>(2, "two"));
+    strs.Add(KeyValuePair<uint16, String>(1, "uno"));
+    Sort::Radix(strs.begin(), strs.end());
+    CHECK(strs[0].value == "one");
+    CHECK(strs[1].value == "uno");
+    CHECK(strs[2].value == "two");
+    CHECK(strs[3].value == "three");
+    CHECK(strs[4].value == "threehundred");
+}
+
+//------------------------------------------------------------------------------
+TEST(SortParallelMergeTest) {
+    uint32 seed = 3;
+    const int32 num = 100000;
+    Array<int32> values;
+    for (int32 i = 0; i < num; i++) {
+        values.Add(int32(_rand(seed)));
+    }
+    Array<int32> ref = values;
+    std::sort(ref.begin(), ref.end());
+    // use an explicit chunk count, so the merge steps are also tested
+    // without a JobSystem (chunks are then processed on this thread)
+    for (int32 numChunks = 1; numChunks <= 5; numChunks++) {
+        Array<int32> copy = values;
+        Sort::ParallelMerge(copy.begin(), copy.end(), numChunks);
+        CHECK(std::equal(copy.begin(), copy.end(), ref.begin()));
+    }
+
+    // same with the chunks running as JobSystem jobs
+    JobSystem::Setup(3);
+    for (int32 numChunks = 0; numChunks <= 5; numChunks++) {
+        Array<int32> copy = values;
+        Sort::ParallelMerge(copy.begin(), copy.end(), numChunks);
+        CHECK(std::equal(copy.begin(), copy.end(), ref.begin()));
+    }
+    JobSystem::Discard();
+
+    // non-radix type
+    Array<String> strs;
+    for (int32 i = 0; i < 1000; i++) {
+        char buf[16];
+        int32 len = 1 + (_rand(seed) % 8);
+        for (int32 j = 0; j < len; j++) {
+            buf[j] = 'a' + (_rand(seed) % 26);
+        }
+        buf[len] = 0;
+        strs.Add(String(buf));
+    }
+    Sort::Auto(strs.begin(), strs.end());
+    CHECK(_isSorted(strs));
+}
+
+//------------------------------------------------------------------------------
+TEST(SortBulkTest) {
+    uint32 seed = 4;
+
+    Map<int32, int32> map;
+    map.BeginBulk();
+    for (int32 i = 0; i < 1000; i++) {
+        map.AddBulk(int32(_rand(seed) % 500), i);
+    }
+    map.EndBulk();
+    CHECK(map.Size() == 1000);
+    for (int32 i = 1; i < map.Size(); i++) {
+        CHECK(map.KeyAtIndex(i-1) <= map.KeyAtIndex(i));
+    }
+
+    Set<int32> set;
+    set.BeginBulk();
+    for (int32 i = 999; i >= 0; i--) {
+        set.AddBulk(i * 3);
+    }
+    set.EndBulk();
+    CHECK(set.Size() == 1000);
+    CHECK(set.ValueAtIndex(0) == 0);
+    CHECK(set.ValueAtIndex(999) == 2997);
+    CHECK(set.Contains(300));
+    CHECK(!set.Contains(301));
+    set.Add(301);
+    CHECK(set.Contains(301));
+    Set<int32> setCopy(set);
+    CHECK(setCopy.Size() == 1001);
+
+    ArrayMap<int32, String> arrayMap;
+    arrayMap.BeginBulk();
+    arrayMap.AddBulk(3, "three");
+    arrayMap.AddBulk(1, "one");
+    arrayMap.AddBulk(2, "two");
+    arrayMap.EndBulk();
+    CHECK(arrayMap.Size() == 3);
+    CHECK(arrayMap[1] == "one");
+    CHECK(arrayMap[2] == "two");
+    CHECK(arrayMap[3] == "three");
+    // values keep their insertion order
+    CHECK(arrayMap.ValueAtIndex(0) == "three");
+    CHECK(arrayMap.ValueAtIndex(2) == "two");
+}
+
+//------------------------------------------------------------------------------
+TEST(SortBenchmark) {
+    const int32 sizes[] = { 100000, 1000000 };
+    for (int32 num : sizes) {
+        uint32 seed = 5;
+        Array<KeyValuePair<uint32, int32>> values;
+        values.Reserve(num);
+        for (int32 i = 0; i < num; i++) {
+            values.Add(KeyValuePair<uint32, int32>(_rand(seed), i));
+        }
+
+        Array<KeyValuePair<uint32, int32>> copy = values;
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        std::sort(copy.begin(), copy.end());
+        std::chrono::duration<double> stdDur = std::chrono::system_clock::now() - start;
+        CHECK(_isSorted(copy));
+
+        copy = values;
+        start = std::chrono::system_clock::now();
+        Sort::Radix(copy.begin(), copy.end());
+        std::chrono::duration<double> radixDur = std::chrono::system_clock::now() - start;
+        CHECK(_isSorted(copy));
+
+        copy = values;
+        start = std::chrono::system_clock::now();
+        Sort::ParallelMerge(copy.begin(), copy.end());
+        std::chrono::duration<double> mergeDur = std::chrono::system_clock::now() - start;
+        CHECK(_isSorted(copy));
+
+        Log::Info("sort %d key/value pairs: std::sort: %f sec, Sort::Radix: %f sec, Sort::ParallelMerge: %f sec\n",
+            num, stdDur.count(), radixDur.count(), mergeDur.count());
+
+        // Map bulk-mode (uses Sort::Auto)
+        Map<uint32, int32> map;
+        map.Reserve(num);
+        start = std::chrono::system_clock::now();
+        map.BeginBulk();
+        for (const auto& kvp : values) {
+            map.AddBulk(kvp);
+        }
+        map.EndBulk();
+        std::chrono::duration<double> mapDur = std::chrono::system_clock::now() - start;
+        CHECK(map.Size() == num);
+        Log::Info("Map bulk-add %d elements: %f sec\n", num, mapDur.count());
+    }
+}
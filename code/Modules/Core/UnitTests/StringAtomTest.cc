@@ -7,10 +7,13 @@
 #include "Core/String/StringAtom.h"
 #include "Core/String/String.h"
 #include "Core/Core.h"
+#include "Core/Containers/Array.h"
+#include "Core/Log.h"
 
 #include <cstring>
 #include <thread>
 #include <array>
+#include <cstdio>
 
 using namespace std;
 using namespace Oryol;
@@ -56,17 +59,16 @@ TEST(StringAtomSingleThreaded) {
 }
 
 #if ORYOL_HAS_THREADS
-// must use reference, the copy would fail since there is no thread-local
-// string-atom table yet
 static void threadFunc(const StringAtom& a0) {
     
     Oryol::Core::EnterThread();
     
-    // transfer into a thread-local string atom
+    // string atoms are unique across threads
     StringAtom a1(a0);
-    StringAtom a2(a0);
+    StringAtom a2("BLOB");
     CHECK(a0 == a1);
     CHECK(a1 == a2);
+    CHECK(a0.AsCStr() == a2.AsCStr());
     CHECK(a1.AsString() == "BLOB");
     CHECK(a0.AsString() == "BLOB");
     CHECK(a2.AsString() == "BLOB");
@@ -81,6 +83,87 @@ TEST(StringAtomMultiThreaded) {
     std::thread t1(threadFunc, std::ref(atom0));
     t1.join();
 }
+
+// create the same string atoms concurrently from several threads
+TEST(StringAtomConcurrentCreation) {
+    const int32 numThreads = 4;
+    const int32 numStrings = 2000;
+    Array<StringAtom> atoms[numThreads];
+    std::thread threads[numThreads];
+    for (int32 t = 0; t < numThreads; t++) {
+        threads[t] = std::thread([&atoms, t]() {
+            char buf[32];
+            for (int32 i = 0; i < numStrings; i++) {
+                // each thread walks the strings in a different order
+                const int32 n = (t & 1) ? (numStrings - 1 - i) : i;
+                std::snprintf(buf, sizeof(buf), "atom_%d", n);
+                atoms[t].Add(StringAtom(buf));
+            }
+        });
+    }
+    for (int32 t = 0; t < numThreads; t++) {
+        threads[t].join();
+    }
+    for (int32 i = 0; i < numStrings; i++) {
+        const StringAtom& a0 = atoms[0][i];
+        const StringAtom& a1 = atoms[1][numStrings - 1 - i];
+        const StringAtom& a2 = atoms[2][i];
+        const StringAtom& a3 = atoms[3][numStrings - 1 - i];
+        CHECK(a0 == a1);
+        CHECK(a0 == a2);
+        CHECK(a0 == a3);
+        CHECK(a0.AsCStr() == a3.AsCStr());
+        if (i > 0) {
+            CHECK(a0 != atoms[0][i - 1]);
+        }
+    }
+}
+
+// compare cross-thread copies with re-creating the atom in the
+// receiving thread (which is what the previous per-thread tables did)
+TEST(StringAtomCrossThreadBenchmark) {
+    const int32 numUniqueStrings = 16;
+    const int32 numCopies = 1000000;
+    Array<StringAtom> remote;
+    std::thread t([&remote]() {
+        const char* strs[numUniqueStrings] = {
+            "root:", "http://floooh.github.io/", "res:", "shd:", "tex:", "msh:", "snd:", "fnt:",
+            "res:textures/a.dds", "res:textures/b.dds", "res:meshes/c.omsh", "res:meshes/d.omsh",
+            "res:sounds/e.ogg", "res:sounds/f.ogg", "res:fonts/g.ttf", "res:fonts/h.ttf"
+        };
+        for (int32 i = 0; i < numUniqueStrings; i++) {
+            remote.Add(StringAtom(strs[i]));
+        }
+    });
+    t.join();
+
+    Array<StringAtom> local;
+    local.Reserve(numCopies);
+    chrono::time_point<chrono::system_clock> start = chrono::system_clock::now();
+    for (int32 i = 0; i < numCopies; i++) {
+        local.Add(remote[i & (numUniqueStrings - 1)]);
+    }
+    chrono::duration<double> copyDur = chrono::system_clock::now() - start;
+    int32 numEqual = 0;
+    start = chrono::system_clock::now();
+    for (int32 i = 0; i < numCopies; i++) {
+        if (local[i] == remote[(i + 1) & (numUniqueStrings - 1)]) {
+            numEqual++;
+        }
+    }
+    chrono::duration<double> cmpDur = chrono::system_clock::now() - start;
+    CHECK(0 == numEqual);
+
+    local.Clear();
+    start = chrono::system_clock::now();
+    for (int32 i = 0; i < numCopies; i++) {
+        local.Add(StringAtom(remote[i & (numUniqueStrings - 1)].AsCStr()));
+    }
+    chrono::duration<double> reinternDur = chrono::system_clock::now() - start;
+    CHECK(local[0] == remote[0]);
+    Log::Info("%dx cross-thread StringAtom copy: %f sec, compare: %f sec, re-intern: %f sec\n",
+        numCopies, copyDur.count(), cmpDur.count(), reinternDur.count());
+}
 #endif
 
 // test string atom creation performance
@@ -109,4 +192,88 @@ TEST(StringAtomPerformance) {
         chrono::duration<double> dur = end - start;
         Log::Info("run %d: %dx StringAtoms created: %f sec\n", i, numStringAtoms, dur.count());
     }
-}
\ No newline at end of file
+}
+
+// StringAtoms from literals with compile-time hashes
+static_assert(stringAtomTable::HashForLiteral("Content-Type") != stringAtomTable::HashForLiteral("Content-type"), "compile-time hash");
+
+static StringAtom contentTypeAtom() {
+    return ORYOL_ATOM("Content-Type");
+}
+
+TEST(StringAtomLiteral) {
+    // compile-time hashes must match the runtime hashes
+    const char* strs[] = { "a", "http", "Content-Type", "res:textures/a.dds", "\xC3\xBC\xC3\xA4\xC3\xB6", "\x7F\x80\xFF" };
+    constexpr int32 hashes[] = {
+        stringAtomTable::HashForLiteral("a"),
+        stringAtomTable::HashForLiteral("http"),
+        stringAtomTable::HashForLiteral("Content-Type"),
+        stringAtomTable::HashForLiteral("res:textures/a.dds"),
+        stringAtomTable::HashForLiteral("\xC3\xBC\xC3\xA4\xC3\xB6"),
+        stringAtomTable::HashForLiteral("\x7F\x80\xFF")
+    };
+    for (int32 i = 0; i < 6; i++) {
+        CHECK(hashes[i] == stringAtomTable::HashForString(strs[i]));
+    }
+
+    // literal atoms are the same as atoms created at runtime
+    StringAtom atom0 = ORYOL_ATOM("http");
+    StringAtom atom1("http");
+    CHECK(atom0 == atom1);
+    CHECK(atom0.AsCStr() == atom1.AsCStr());
+    CHECK(atom0 == "http");
+    CHECK(atom0.Length() == 4);
+    CHECK(ORYOL_ATOM("http") != ORYOL_ATOM("https"));
+    CHECK(ORYOL_ATOM("") == StringAtom());
+    CHECK(!ORYOL_ATOM("").IsValid());
+
+    // repeated use returns the same atom
+    for (int32 i = 0; i < 4; i++) {
+        CHECK(contentTypeAtom() == StringAtom("Content-Type"));
+    }
+}
+
+#if ORYOL_HAS_THREADS
+TEST(StringAtomLiteralMultiThreaded) {
+    const int32 numThreads = 4;
+    StringAtom atoms[numThreads];
+    std::thread threads[numThreads];
+    for (int32 t = 0; t < numThreads; t++) {
+        threads[t] = std::thread([&atoms, t]() {
+            for (int32 i = 0; i < 1000; i++) {
+                atoms[t] = ORYOL_ATOM("literal_atom_mt");
+            }
+        });
+    }
+    for (int32 t = 0; t < numThreads; t++) {
+        threads[t].join();
+    }
+    for (int32 t = 0; t < numThreads; t++) {
+        CHECK(atoms[t] == StringAtom("literal_atom_mt"));
+    }
+}
+#endif
+
+// compare creating atoms from a literal with ORYOL_ATOM
+TEST(StringAtomLiteralBenchmark) {
+    const int32 num = 1000000;
+    int32 numEqual = 0;
+    StringAtom key("Content-Type");
+    chrono::time_point<chrono::system_clock> start = chrono::system_clock::now();
+    for (int32 i = 0; i < num; i++) {
+        if (StringAtom("Content-Type") == key) {
+            numEqual++;
+        }
+    }
+    chrono::duration<double> runtimeDur = chrono::system_clock::now() - start;
+    start = chrono::system_clock::now();
+    for (int32 i = 0; i < num; i++) {
+        if (ORYOL_ATOM("Content-Type") == key) {
+            numEqual++;
+        }
+    }
+    chrono::duration<double> literalDur = chrono::system_clock::now() - start;
+    CHECK(numEqual == 2 * num);
+    Log::Info("%dx StringAtom from literal: StringAtom(): %f sec, ORYOL_ATOM(): %f sec\n",
+        num, runtimeDur.count(), literalDur.count());
+}
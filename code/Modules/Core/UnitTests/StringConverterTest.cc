@@ -4,9 +4,317 @@
 #include "Pre.h"
 #include "UnitTest++/src/UnitTest++.h"
 #include "Core/String/StringConverter.h"
+#include "Core/String/StringBuilder.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Log.h"
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
 
 using namespace Oryol;
 
-TEST(StringUtilTest) {
-    /// @todo IMPLEMENT STRING CONVERTER TEST!!!
-}
\ No newline at end of file
+// simple deterministic pseudo-random numbers
+static uint64 _rand(uint64& seed) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return seed ^ (seed >> 29);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> static bool
+_checkToChars(TYPE val, const char* expected) {
+    char buf[StringConverter::MaxNumberChars];
+    const int32 len = StringConverter::ToChars(val, buf, sizeof(buf));
+    return (0 == std::strcmp(buf, expected)) && (len == int32(std::strlen(expected)));
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> static bool
+_checkFromChars(const char* str, TYPE expected, int32 expectedNumChars) {
+    TYPE val = 0;
+    const int32 numChars = StringConverter::FromChars(str, int32(std::strlen(str)), val);
+    return (numChars == expectedNumChars) && ((0 == numChars) || (val == expected));
+}
+
+//------------------------------------------------------------------------------
+TEST(StringConverterIntTest) {
+    CHECK(_checkToChars<int32>(0, "0"));
+    CHECK(_checkToChars<int32>(7, "7"));
+    CHECK(_checkToChars<int32>(-42, "-42"));
+    CHECK(_checkToChars<int32>(1234567890, "1234567890"));
+    CHECK(_checkToChars<int32>(-2147483647 - 1, "-2147483648"));
+    CHECK(_checkToChars<uint32>(4294967295u, "4294967295"));
+    CHECK(_checkToChars<int8>(-128, "-128"));
+    CHECK(_checkToChars<uint8>(255, "255"));
+    CHECK(_checkToChars<int16>(-32768, "-32768"));
+    CHECK(_checkToChars<uint16>(65535, "65535"));
+    CHECK(_checkToChars<int64>(-9223372036854775807LL - 1, "-9223372036854775808"));
+    CHECK(_checkToChars<uint64>(18446744073709551615ULL, "18446744073709551615"));
+
+    // buffer too small
+    char buf[4];
+    CHECK(StringConverter::ToChars<int32>(123, buf, sizeof(buf)) == 3);
+    CHECK(0 == std::strcmp(buf, "123"));
+    CHECK(StringConverter::ToChars<int32>(1234, buf, sizeof(buf)) == 0);
+    CHECK(buf[0] == 0);
+
+    CHECK(_checkFromChars<int32>("123", 123, 3));
+    CHECK(_checkFromChars<int32>("-123abc", -123, 4));
+    CHECK(_checkFromChars<int32>("+5", 5, 2));
+    CHECK(_checkFromChars<int32>("abc", 0, 0));
+    CHECK(_checkFromChars<int32>("-", 0, 0));
+    CHECK(_checkFromChars<int32>("2147483647", 2147483647, 10));
+    CHECK(_checkFromChars<int32>("-2147483648", -2147483647 - 1, 11));
+    CHECK(_checkFromChars<int32>("2147483648", 0, 0));
+    CHECK(_checkFromChars<uint32>("4294967295", 4294967295u, 10));
+    CHECK(_checkFromChars<uint32>("-1", 0, 0));
+    CHECK(_checkFromChars<int8>("127", 127, 3));
+    CHECK(_checkFromChars<int8>("128", 0, 0));
+    CHECK(_checkFromChars<uint8>("256", 0, 0));
+    CHECK(_checkFromChars<uint64>("18446744073709551615", 18446744073709551615ULL, 20));
+    CHECK(_checkFromChars<uint64>("18446744073709551616", 0, 0));
+    CHECK(_checkFromChars<int64>("-9223372036854775808", -9223372036854775807LL - 1, 20));
+
+    // length-bounded parsing
+    int32 val = 0;
+    CHECK(StringConverter::FromChars("12345", 2, val) == 2);
+    CHECK(val == 12);
+
+    CHECK(StringConverter::ToString<int32>(-17) == "-17");
+    CHECK(StringConverter::ToString<uint64>(10000000000ULL) == "10000000000");
+    CHECK(StringConverter::FromString<int32>(" 42") == 42);
+    CHECK(StringConverter::FromString<int32>("bla") == 0);
+    CHECK(StringConverter::FromString<uint32>("3000000000") == 3000000000u);
+}
+
+//------------------------------------------------------------------------------
+TEST(StringConverterFloatTest) {
+    CHECK(_checkToChars<float64>(0.0, "0"));
+    CHECK(_checkToChars<float64>(-0.0, "-0"));
+    CHECK(_checkToChars<float64>(1.0, "1"));
+    CHECK(_checkToChars<float64>(-2.5, "-2.5"));
+    CHECK(_checkToChars<float64>(0.1, "0.1"));
+    CHECK(_checkToChars<float64>(0.1 + 0.2, "0.30000000000000004"));
+    CHECK(_checkToChars<float64>(100.0, "100"));
+    CHECK(_checkToChars<float64>(123.456, "123.456"));
+    CHECK(_checkToChars<float64>(1e21, "1e+21"));
+    CHECK(_checkToChars<float64>(1e20, "100000000000000000000"));
+    CHECK(_checkToChars<float64>(1.5e-7, "1.5e-7"));
+    CHECK(_checkToChars<float64>(0.000001, "0.000001"));
+    CHECK(_checkToChars<float64>(5e-324, "5e-324"));
+    CHECK(_checkToChars<float64>(1.7976931348623157e308, "1.7976931348623157e+308"));
+    CHECK(_checkToChars<float64>(2.2250738585072014e-308, "2.2250738585072014e-308"));
+    CHECK(_checkToChars<float64>(9007199254740993.0, "9007199254740992"));
+    CHECK(_checkToChars<float64>(INFINITY, "inf"));
+    CHECK(_checkToChars<float64>(-INFINITY, "-inf"));
+    CHECK(_checkToChars<float64>(NAN, "nan"));
+    CHECK(_checkToChars<float32>(0.1f, "0.1"));
+    CHECK(_checkToChars<float32>(1.0f / 3.0f, "0.33333334"));
+    CHECK(_checkToChars<float32>(16777216.0f, "16777216"));
+    CHECK(_checkToChars<float32>(3.4028235e38f, "3.4028235e+38"));
+    CHECK(_checkToChars<float32>(1e-45f, "1e-45"));
+    CHECK(_checkToChars<float32>(60.0f, "60"));
+    CHECK(_checkToChars<float32>(0.016666668f, "0.016666668"));
+
+    CHECK(_checkFromChars<float64>("0.1", 0.1, 3));
+    CHECK(_checkFromChars<float64>("-1.5e3", -1500.0, 6));
+    CHECK(_checkFromChars<float64>("1e", 1.0, 1));
+    CHECK(_checkFromChars<float64>("1.", 1.0, 2));
+    CHECK(_checkFromChars<float64>(".5", 0.5, 2));
+    CHECK(_checkFromChars<float64>(".", 0.0, 0));
+    CHECK(_checkFromChars<float64>("x", 0.0, 0));
+    CHECK(_checkFromChars<float64>("1e400", 0.0, 0));
+    CHECK(_checkFromChars<float64>("-1e400", 0.0, 0));
+    CHECK(_checkFromChars<float64>("1e-400", 0.0, 6));
+    CHECK(_checkFromChars<float64>("-inf", -INFINITY, 4));
+    CHECK(_checkFromChars<float64>("Infinity", INFINITY, 8));
+    CHECK(_checkFromChars<float64>("4.9406564584124654e-324", 5e-324, 23));
+    CHECK(_checkFromChars<float64>("2.4703282292062328e-324", 5e-324, 23));
+    CHECK(_checkFromChars<float64>("2.4703282292062327e-324", 0.0, 23));
+    CHECK(_checkFromChars<float64>("1.7976931348623157e308", 1.7976931348623157e308, 22));
+    CHECK(_checkFromChars<float64>("1.7976931348623158e308", 1.7976931348623157e308, 22));
+    CHECK(_checkFromChars<float64>("1.7976931348623159e308", 0.0, 0));
+    // exactly halfway between 2^53 and 2^53+2, rounds to even
+    CHECK(_checkFromChars<float64>("9007199254740993", 9007199254740992.0, 16));
+    CHECK(_checkFromChars<float64>("9007199254740993.0000000000000000000001", 9007199254740994.0, 39));
+    CHECK(_checkFromChars<float32>("0.1", 0.1f, 3));
+    CHECK(_checkFromChars<float32>("3.4028235e38", 3.4028235e38f, 12));
+    CHECK(_checkFromChars<float32>("3.5e38", 0.0f, 0));
+    CHECK(_checkFromChars<float32>("3.4028236e38", 0.0f, 0));
+    CHECK(_checkFromChars<float32>("1e39", 0.0f, 0));
+    CHECK(_checkFromChars<float32>("1e-46", 0.0f, 5));
+    CHECK(_checkFromChars<float32>("1.00000005960464477539062500001", 1.0000001f, 31));
+    CHECK(_checkFromChars<float32>("1.000000059604644775390625", 1.0f, 26));
+
+    // overflow leaves the result untouched
+    float64 overflow = 1.0;
+    CHECK(StringConverter::FromChars("1e400", 5, overflow) == 0);
+    CHECK(overflow == 1.0);
+
+    float64 nan = 0.0;
+    CHECK(StringConverter::FromChars("nan", 3, nan) == 3);
+    CHECK(std::isnan(nan));
+
+    CHECK(StringConverter::ToString<float32>(0.5f) == "0.5");
+    CHECK(StringConverter::FromString<float32>("0.25") == 0.25f);
+    CHECK(StringConverter::FromString<float64>("  1e10") == 1e10);
+}
+
+//------------------------------------------------------------------------------
+TEST(StringConverterRoundtripTest) {
+    // random bit patterns must roundtrip, and parse like the C runtime
+    uint64 seed = 1;
+    char buf[StringConverter::MaxNumberChars];
+    for (int32 i = 0; i < 20000; i++) {
+        const uint64 bits = _rand(seed);
+        float64 val;
+        std::memcpy(&val, &bits, sizeof(val));
+        if (std::isnan(val)) {
+            continue;
+        }
+        const int32 len = StringConverter::ToChars(val, buf, sizeof(buf));
+        float64 parsed = 0.0;
+        CHECK(StringConverter::FromChars(buf, len, parsed) == len);
+        CHECK(parsed == val);
+        CHECK(std::strtod(buf, nullptr) == val);
+
+        // no shorter representation roundtrips, compare digit count against %.17g
+        char ref[64];
+        for (int32 prec = 1; prec <= 17; prec++) {
+            std::snprintf(ref, sizeof(ref), "%.*g", prec, val);
+            if (std::strtod(ref, nullptr) == val) {
+                // count significant digits, without leading and trailing zeros
+                const char* first = buf;
+                while (('-' == *first) || ('0' == *first) || ('.' == *first)) {
+                    first++;
+                }
+                const char* last = std::strchr(first, 'e');
+                last = last ? last : buf + len;
+                while ((last > first) && (('0' == last[-1]) || ('.' == last[-1]))) {
+                    last--;
+                }
+                int32 numDigits = 0;
+                for (const char* p = first; p < last; p++) {
+                    numDigits += ('.' != *p) ? 1 : 0;
+                }
+                CHECK(numDigits <= prec);
+                break;
+            }
+        }
+
+        // float32 roundtrip
+        const uint32 bits32 = uint32(bits);
+        float32 val32;
+        std::memcpy(&val32, &bits32, sizeof(val32));
+        if (!std::isnan(val32)) {
+            const int32 len32 = StringConverter::ToChars(val32, buf, sizeof(buf));
+            float32 parsed32 = 0.0f;
+            CHECK(StringConverter::FromChars(buf, len32, parsed32) == len32);
+            CHECK(parsed32 == val32);
+            CHECK(std::strtof(buf, nullptr) == val32);
+        }
+
+        // random decimal strings must parse like the C runtime, except
+        // that overflow is rejected instead of returning infinity
+        std::snprintf(ref, sizeof(ref), "%llue%d", (unsigned long long)(_rand(seed) >> (_rand(seed) % 64)), int32(_rand(seed) % 700) - 350);
+        float64 parsedRef = INFINITY;
+        StringConverter::FromChars(ref, int32(std::strlen(ref)), parsedRef);
+        CHECK(parsedRef == std::strtod(ref, nullptr));
+        float32 parsedRef32 = INFINITY;
+        StringConverter::FromChars(ref, int32(std::strlen(ref)), parsedRef32);
+        CHECK(parsedRef32 == std::strtof(ref, nullptr));
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST(StringBuilderAppendNumberTest) {
+    StringBuilder builder;
+    builder.Append("fps: ");
+    builder.AppendNumber(60);
+    builder.Append(", dt: ");
+    builder.AppendNumber(0.016f);
+    builder.Append(", mem: ");
+    builder.AppendNumber(uint64(4294967296ULL));
+    CHECK(builder.GetString() == "fps: 60, dt: 0.016, mem: 4294967296");
+    for (int32 i = 0; i < 100; i++) {
+        builder.AppendNumber(-1.5e-300);
+    }
+    CHECK(builder.Length() == 35 + 100 * 9);
+}
+
+//------------------------------------------------------------------------------
+TEST(StringConverterBenchmark) {
+    const int32 num = 100000;
+    uint64 seed = 5;
+    float32* values = (float32*) Memory::Alloc(num * sizeof(float32), MemoryTag::Default);
+    for (int32 i = 0; i < num; i++) {
+        values[i] = float32(_rand(seed) % 100000) / 97.0f;
+    }
+    char buf[64];
+
+    // format floats
+    int32 sum = 0;
+    std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+    for (int32 i = 0; i < num; i++) {
+        sum += StringConverter::ToChars(values[i], buf, sizeof(buf));
+    }
+    std::chrono::duration<double> toCharsDur = std::chrono::system_clock::now() - start;
+    start = std::chrono::system_clock::now();
+    for (int32 i = 0; i < num; i++) {
+        sum += std::snprintf(buf, sizeof(buf), "%.9g", values[i]);
+    }
+    std::chrono::duration<double> snprintfDur = std::chrono::system_clock::now() - start;
+    CHECK(sum > 0);
+    Log::Info("format %d floats: ToChars: %f sec, snprintf: %f sec\n", num, toCharsDur.count(), snprintfDur.count());
+
+    // format integers
+    start = std::chrono::system_clock::now();
+    for (int32 i = 0; i < num; i++) {
+        sum += StringConverter::ToChars(int32(i * 7919), buf, sizeof(buf));
+    }
+    toCharsDur = std::chrono::system_clock::now() - start;
+    start = std::chrono::system_clock::now();
+    for (int32 i = 0; i < num; i++) {
+        sum += std::snprintf(buf, sizeof(buf), "%d", int32(i * 7919));
+    }
+    snprintfDur = std::chrono::system_clock::now() - start;
+    Log::Info("format %d ints: ToChars: %f sec, snprintf: %f sec\n", num, toCharsDur.count(), snprintfDur.count());
+
+    // parse floats
+    const char* str = "123.4567";
+    float32 fsum = 0.0f;
+    start = std::chrono::system_clock::now();
+    for (int32 i = 0; i < num; i++) {
+        float32 val = 0.0f;
+        StringConverter::FromChars(str, 8, val);
+        fsum += val;
+    }
+    std::chrono::duration<double> fromCharsDur = std::chrono::system_clock::now() - start;
+    start = std::chrono::system_clock::now();
+    for (int32 i = 0; i < num; i++) {
+        fsum += std::strtof(str, nullptr);
+    }
+    std::chrono::duration<double> strtofDur = std::chrono::system_clock::now() - start;
+    CHECK(fsum > 0.0f);
+    Log::Info("parse %d floats: FromChars: %f sec, strtof: %f sec\n", num, fromCharsDur.count(), strtofDur.count());
+
+    // build a stats line
+    StringBuilder builder;
+    start = std::chrono::system_clock::now();
+    for (int32 i = 0; i < num; i++) {
+        builder.Clear();
+        builder.Append("frame: ");
+        builder.AppendNumber(i);
+        builder.Append(" time: ");
+        builder.AppendNumber(values[i]);
+    }
+    std::chrono::duration<double> appendDur = std::chrono::system_clock::now() - start;
+    start = std::chrono::system_clock::now();
+    for (int32 i = 0; i < num; i++) {
+        builder.Format(64, "frame: %d time: %.9g", i, values[i]);
+    }
+    std::chrono::duration<double> formatDur = std::chrono::system_clock::now() - start;
+    Log::Info("build %d stats lines: AppendNumber: %f sec, Format: %f sec\n", num, appendDur.count(), formatDur.count());
+    Memory::Free(values);
+}
@@ -0,0 +1,233 @@
+//------------------------------------------------------------------------------
+//  StringSearchTest.cc
+//  Test the SIMD string search kernels against the scalar kernels.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/String/stringSearch.h"
+#include "Core/String/StringBuilder.h"
+#include "Core/Containers/Array.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Log.h"
+#include <cstring>
+#include <chrono>
+
+using namespace Oryol;
+
+// simple deterministic pseudo-random numbers
+static uint32 _rand(uint32& seed) {
+    seed = seed * 1664525 + 1013904223;
+    return seed ^ (seed >> 16);
+}
+
+//------------------------------------------------------------------------------
+/**
+ Fill a buffer with characters from a small alphabet, so that delimiters
+ and substrings are actually found.
+*/
+static void
+_fill(char* buf, int32 len, uint32& seed) {
+    static const char* alphabet = "abcdefgh/:?&= \t";
+    const int32 alphabetLen = int32(std::strlen(alphabet));
+    for (int32 i = 0; i < len; i++) {
+        buf[i] = alphabet[_rand(seed) % alphabetLen];
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST(StringSearchBasicTest) {
+    for (int32 level = 0; level < stringSearch::NumLevels; level++) {
+        if (!stringSearch::IsSupported((stringSearch::Level)level)) {
+            continue;
+        }
+        stringSearch::SetLevel((stringSearch::Level)level);
+        CHECK(stringSearch::CurrentLevel() == level);
+        const char* str = "http://www.flohofwoe.net:8080/bla/blub?query=abc#frag";
+        const int32 len = int32(std::strlen(str));
+        CHECK(stringSearch::FindFirstOf(str, len, ":") == 4);
+        CHECK(stringSearch::FindFirstOf(str, len, "?#") == 38);
+        CHECK(stringSearch::FindFirstOf(str, len, "!") == InvalidIndex);
+        CHECK(stringSearch::FindFirstOf(str, 4, ":") == InvalidIndex);
+        CHECK(stringSearch::FindFirstOf(str, 0, ":") == InvalidIndex);
+        CHECK(stringSearch::FindFirstNotOf(str, len, "ptth") == 4);
+        CHECK(stringSearch::FindFirstNotOf(str, 4, "ptth") == InvalidIndex);
+        CHECK(stringSearch::FindSubString(str, len, "://", 3) == 4);
+        CHECK(stringSearch::FindSubString(str, len, "#frag", 5) == 48);
+        CHECK(stringSearch::FindSubString(str, len - 1, "#frag", 5) == InvalidIndex);
+        CHECK(stringSearch::FindSubString(str, len, "8", 1) == 25);
+        CHECK(stringSearch::FindSubString(str, len, "", 0) == 0);
+        CHECK(stringSearch::FindSubString(str, 3, "http", 4) == InvalidIndex);
+        CHECK(stringSearch::FindSubString(str, len, "bla/blubx", 9) == InvalidIndex);
+
+        // more delimiters than the SIMD kernels can handle
+        CHECK(stringSearch::FindFirstOf(str, len, "ABCDEFGHIJKLMNOPQRSTUVWXYZ#") == 48);
+        CHECK(stringSearch::FindFirstNotOf(str, len, "abcdefghijklmnopqrstuvwxyz:/.") == 25);
+    }
+    stringSearch::SetLevel(stringSearch::BestLevel());
+}
+
+//------------------------------------------------------------------------------
+TEST(StringSearchCompareTest) {
+    const int32 maxLen = 300;
+    char buf[maxLen];
+    uint32 seed = 7;
+    static const char* delimSets[] = { "/", ":?", "=&#", " \t", "xyz", "abcdefgh/:?&= \t", "ABCDEFGHIJKLMNOPQRSTa" };
+    const int32 numDelimSets = sizeof(delimSets) / sizeof(delimSets[0]);
+    for (int32 level = 1; level < stringSearch::NumLevels; level++) {
+        if (!stringSearch::IsSupported((stringSearch::Level)level)) {
+            continue;
+        }
+        Log::Info("StringSearchCompareTest: testing level %s\n", stringSearch::LevelName((stringSearch::Level)level));
+        for (int32 iter = 0; iter < 2000; iter++) {
+            // cover all short lengths, and the SIMD block boundaries
+            const int32 len = (iter < maxLen) ? iter : int32(_rand(seed) % maxLen);
+            _fill(buf, len, seed);
+            // sprinkle in some rare characters
+            if (len > 0) {
+                buf[_rand(seed) % len] = 'x';
+                buf[_rand(seed) % len] = 'A';
+            }
+            // start at unaligned offsets
+            const int32 offset = (len > 0) ? int32(_rand(seed) % 17) % (len + 1) : 0;
+            const char* str = buf + offset;
+            const int32 strLen = len - offset;
+
+            for (int32 d = 0; d < numDelimSets; d++) {
+                stringSearch::SetLevel(stringSearch::Scalar);
+                const int32 refOf = stringSearch::FindFirstOf(str, strLen, delimSets[d]);
+                const int32 refNotOf = stringSearch::FindFirstNotOf(str, strLen, delimSets[d]);
+                stringSearch::SetLevel((stringSearch::Level)level);
+                CHECK(stringSearch::FindFirstOf(str, strLen, delimSets[d]) == refOf);
+                CHECK(stringSearch::FindFirstNotOf(str, strLen, delimSets[d]) == refNotOf);
+            }
+
+            // substrings taken from the text itself, and random ones
+            for (int32 s = 0; s < 4; s++) {
+                char subStr[32];
+                int32 subStrLen = 1 + int32(_rand(seed) % 20);
+                if ((s & 1) && (strLen > 0)) {
+                    const int32 pos = int32(_rand(seed) % strLen);
+                    if (subStrLen > (strLen - pos)) {
+                        subStrLen = strLen - pos;
+                    }
+                    std::memcpy(subStr, str + pos, subStrLen);
+                }
+                else {
+                    _fill(subStr, subStrLen, seed);
+                }
+                stringSearch::SetLevel(stringSearch::Scalar);
+                const int32 ref = stringSearch::FindSubString(str, strLen, subStr, subStrLen);
+                stringSearch::SetLevel((stringSearch::Level)level);
+                CHECK(stringSearch::FindSubString(str, strLen, subStr, subStrLen) == ref);
+            }
+        }
+    }
+    stringSearch::SetLevel(stringSearch::BestLevel());
+}
+
+//------------------------------------------------------------------------------
+TEST(StringBuilderSearchTest) {
+    // bounded searches through StringBuilder
+    StringBuilder builder("one two three four");
+    CHECK(builder.FindFirstOf(0, EndOfString, " ") == 3);
+    CHECK(builder.FindFirstOf(4, EndOfString, " ") == 7);
+    CHECK(builder.FindFirstOf(4, 7, " ") == InvalidIndex);
+    CHECK(builder.FindFirstNotOf(3, EndOfString, " ") == 4);
+    CHECK(builder.FindFirstNotOf(14, EndOfString, "ofur") == InvalidIndex);
+    CHECK(builder.FindSubString(0, EndOfString, "three") == 8);
+    CHECK(builder.FindSubString(0, 9, "three") == 8);
+    CHECK(builder.FindSubString(0, 8, "three") == InvalidIndex);
+    CHECK(builder.FindSubString(9, EndOfString, "three") == InvalidIndex);
+    CHECK(StringBuilder::FindFirstNotOf("  abc", 0, EndOfString, " ") == 2);
+    CHECK(StringBuilder::FindFirstNotOf("     ", 0, EndOfString, " ") == InvalidIndex);
+
+    // substitute where the substitute contains the match
+    builder.Set("a.b.c");
+    CHECK(builder.SubstituteAll(".", "..") == 2);
+    CHECK(builder.GetString() == "a..b..c");
+    // substitute which grows the buffer a lot
+    builder.Set("xxxxxxxxxx");
+    CHECK(builder.SubstituteAll("x", "0123456789012345678901234567890123456789") == 10);
+    CHECK(builder.Length() == 400);
+
+    // fenced tokenize
+    Array<String> tokens;
+    builder.Set("a 'b c' '' d");
+    CHECK(builder.Tokenize(" ", '\'', tokens) == 4);
+    CHECK(tokens[0] == "a");
+    CHECK(tokens[1] == "b c");
+    CHECK(tokens[2].Empty());
+    CHECK(tokens[3] == "d");
+}
+
+//------------------------------------------------------------------------------
+TEST(StringSearchBenchmark) {
+    const int32 len = 1024 * 1024;
+    char* buf = (char*) Memory::Alloc(len + 1, MemoryTag::Default);
+    uint32 seed = 3;
+    // a large buffer with rare delimiters, and a match at the end
+    for (int32 i = 0; i < len; i++) {
+        buf[i] = 'a' + (_rand(seed) % 26);
+    }
+    std::memcpy(buf + len - 8, "#needle?", 8);
+    buf[len] = 0;
+    const int32 numIters = 50;
+
+    for (int32 level = 0; level < stringSearch::NumLevels; level++) {
+        if (!stringSearch::IsSupported((stringSearch::Level)level)) {
+            continue;
+        }
+        stringSearch::SetLevel((stringSearch::Level)level);
+        int32 res = 0;
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        for (int32 i = 0; i < numIters; i++) {
+            res += stringSearch::FindFirstOf(buf, len, "?#");
+        }
+        std::chrono::duration<double> ofDur = std::chrono::system_clock::now() - start;
+        CHECK(res == numIters * (len - 8));
+
+        res = 0;
+        start = std::chrono::system_clock::now();
+        for (int32 i = 0; i < numIters; i++) {
+            res += stringSearch::FindSubString(buf, len, "needle", 6);
+        }
+        std::chrono::duration<double> subDur = std::chrono::system_clock::now() - start;
+        CHECK(res == numIters * (len - 7));
+        Log::Info("search 1MB x %d (%s): FindFirstOf: %f sec, FindSubString: %f sec\n",
+            numIters, stringSearch::LevelName((stringSearch::Level)level), ofDur.count(), subDur.count());
+    }
+    stringSearch::SetLevel(stringSearch::BestLevel());
+
+    // C runtime functions for comparison
+    int32 res = 0;
+    std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+    for (int32 i = 0; i < numIters; i++) {
+        res += int32(std::strcspn(buf, "?#"));
+    }
+    std::chrono::duration<double> ofDur = std::chrono::system_clock::now() - start;
+    CHECK(res == numIters * (len - 8));
+    res = 0;
+    start = std::chrono::system_clock::now();
+    for (int32 i = 0; i < numIters; i++) {
+        res += int32(std::strstr(buf, "needle") - buf);
+    }
+    std::chrono::duration<double> subDur = std::chrono::system_clock::now() - start;
+    CHECK(res == numIters * (len - 7));
+    Log::Info("search 1MB x %d (libc): strcspn: %f sec, strstr: %f sec\n", numIters, ofDur.count(), subDur.count());
+
+    // tokenize a large buffer
+    for (int32 i = 0; i < len; i++) {
+        if (0 == (_rand(seed) % 8)) {
+            buf[i] = ' ';
+        }
+    }
+    StringBuilder builder;
+    Array<String> tokens;
+    start = std::chrono::system_clock::now();
+    builder.Set(buf);
+    const int32 numTokens = builder.Tokenize(" ", tokens);
+    std::chrono::duration<double> tokDur = std::chrono::system_clock::now() - start;
+    CHECK(numTokens > 0);
+    Log::Info("tokenize 1MB into %d tokens: %f sec\n", numTokens, tokDur.count());
+    Memory::Free(buf);
+}
@@ -64,20 +64,35 @@ TEST(StringTest) {
     CHECK(str4 == blob);
     CHECK(str4 == "Blob");
     
-    // copy-assignment
+    // copy-assignment (short strings are copied)
     str0 = str2;
     CHECK(str0 == "Bla");
     CHECK(str0 == str2);
-    CHECK(str0.RefCount() == 2);
-    CHECK(str2.RefCount() == 2);
-    CHECK(str0.AsCStr() == str2.AsCStr());  // tests for identical pointers!
+    CHECK(str0.RefCount() == 1);
+    CHECK(str2.RefCount() == 1);
     str2.Clear();
     CHECK(str0 == "Bla");
     CHECK(str2.Empty());
-    CHECK(str0.RefCount() == 1);
     CHECK(str2.RefCount() == 0);
     str0.Clear();
     CHECK(str0.Empty());
+
+    // copy-assignment (long strings are shared)
+    const char* longStr = "A string which is too long to be stored inline";
+    String str5(longStr);
+    str0 = str5;
+    CHECK(str0 == longStr);
+    CHECK(str0 == str5);
+    CHECK(str0.RefCount() == 2);
+    CHECK(str5.RefCount() == 2);
+    CHECK(str0.AsCStr() == str5.AsCStr());  // tests for identical pointers!
+    str5.Clear();
+    CHECK(str0 == longStr);
+    CHECK(str5.Empty());
+    CHECK(str0.RefCount() == 1);
+    CHECK(str5.RefCount() == 0);
+    str0.Clear();
+    CHECK(str0.Empty());
     
     // move-assignment
     str2 = std::move(str3);
@@ -151,3 +166,63 @@ TEST(StringTest) {
     CHECK(nullString.AsCStr() != nullptr);
     CHECK(nullString.AsCStr()[0] == 0);    
 }
+
+TEST(StringInlineTest) {
+    // longest inline string, and shortest shared string
+    const char* inl = "0123456789012345678901";
+    const char* shr = "01234567890123456789012";
+    CHECK(int32(std::strlen(inl)) == String::MaxInlineLength);
+    String str0(inl);
+    String str1(shr);
+    CHECK(str0.Length() == String::MaxInlineLength);
+    CHECK(str1.Length() == String::MaxInlineLength + 1);
+    CHECK(str0 == inl);
+    CHECK(str1 == shr);
+    CHECK(str0 < str1);
+    CHECK(str1 > str0);
+    CHECK(str0.RefCount() == 1);
+    CHECK(str1.RefCount() == 1);
+    CHECK(str0.Back() == '1');
+    CHECK(str1.Back() == '2');
+
+    // copies of inline strings are independent
+    String str2(str0);
+    CHECK(str2 == str0);
+    CHECK(str2.AsCStr() != str0.AsCStr());
+    str0.Clear();
+    CHECK(str2 == inl);
+    String str3(std::move(str2));
+    CHECK(str3 == inl);
+    CHECK(str2.Empty());
+    CHECK(str2.Length() == 0);
+
+    // switching between inline and shared
+    String str4(shr);
+    CHECK(str4.RefCount() == 1);
+    str3 = str4;
+    CHECK(str3 == shr);
+    CHECK(str4.RefCount() == 2);
+    str3 = "short";
+    CHECK(str3.Length() == 5);
+    CHECK(str3.RefCount() == 1);
+    CHECK(str4.RefCount() == 1);
+    str3 = std::move(str4);
+    CHECK(str3 == shr);
+    CHECK(str3.RefCount() == 1);
+    CHECK(str4.Empty());
+
+    // embedded zeros are kept, inline and shared
+    const char raw[] = "ab\0cd\0efghijklmnopqrstuvwxyz";
+    String str5(raw, 0, 6);
+    CHECK(str5.Length() == 6);
+    CHECK(str5.AsCStr()[3] == 'c');
+    CHECK(str5.AsCStr()[6] == 0);
+    CHECK(str5 == "ab");
+    String str6(raw, 0, 28);
+    CHECK(str6.Length() == 28);
+    CHECK(str6.AsCStr()[6] == 'e');
+    CHECK(str6.Back() == 'z');
+    String str7(str5);
+    CHECK(str7.Length() == 6);
+    CHECK(str7.AsCStr()[4] == 'd');
+}
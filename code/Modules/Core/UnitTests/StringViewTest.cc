@@ -0,0 +1,146 @@
+//------------------------------------------------------------------------------
+//  StringViewTest.cc
+//  Test StringView functionality.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/String/StringView.h"
+#include "Core/String/StringBuilder.h"
+#include "Core/Containers/Map.h"
+#include "Core/Containers/HashMap.h"
+
+using namespace Oryol;
+
+// FNV-1a over a view, so that Strings and StringViews hash the same
+struct StringViewHasher {
+    uint32 operator()(const StringView& str) {
+        uint32 hash = 2166136261U;
+        for (int32 i = 0; i < str.Length(); i++) {
+            hash = (hash ^ uint8(str[i])) * 16777619U;
+        }
+        return hash;
+    };
+    uint32 operator()(const String& str) {
+        return this->operator()(StringView(str));
+    };
+};
+
+//------------------------------------------------------------------------------
+TEST(StringViewTest) {
+    StringView empty;
+    CHECK(empty.Empty());
+    CHECK(!empty.IsValid());
+    CHECK(empty.Length() == 0);
+    CHECK(empty == "");
+    CHECK(empty.AsString().Empty());
+
+    const char* str = "Hello World!";
+    StringView view(str);
+    CHECK(view.IsValid());
+    CHECK(view.Length() == 12);
+    CHECK(view.Ptr() == str);
+    CHECK(view.Front() == 'H');
+    CHECK(view.Back() == '!');
+    CHECK(view[6] == 'W');
+    CHECK(view == "Hello World!");
+    CHECK(view != "Hello World");
+    CHECK(view.AsString() == "Hello World!");
+    CHECK(view.AsStringAtom() == StringAtom("Hello World!"));
+
+    // sub views are not 0-terminated
+    StringView hello = view.SubView(0, 5);
+    CHECK(hello.Length() == 5);
+    CHECK(hello == "Hello");
+    CHECK(hello != "Hello World!");
+    CHECK(hello.Ptr() == str);
+    CHECK(view.SubView(6, EndOfString) == "World!");
+    CHECK(view.SubView(12, EndOfString).Empty());
+    CHECK(view.StartsWith("Hello"));
+    CHECK(!view.StartsWith("World"));
+    CHECK(view.EndsWith("World!"));
+    CHECK(!hello.EndsWith("World!"));
+    CHECK(view.StartsWith(empty));
+
+    // searching
+    CHECK(view.FindFirstOf(0, EndOfString, " ") == 5);
+    CHECK(view.FindFirstOf(0, EndOfString, "!W") == 6);
+    CHECK(view.FindFirstOf(0, 5, " ") == EndOfString);
+    CHECK(hello.FindFirstOf(0, EndOfString, " ") == EndOfString);
+    CHECK(view.FindSubString(0, EndOfString, "World") == 6);
+    CHECK(view.FindSubString(0, 10, "World") == EndOfString);
+    CHECK(view.FindSubString(7, EndOfString, "World") == EndOfString);
+
+    // comparison with Strings and StringAtoms
+    String helloStr("Hello");
+    StringAtom helloAtom("Hello");
+    CHECK(hello == helloStr);
+    CHECK(helloStr == hello);
+    CHECK(hello == helloAtom);
+    CHECK(helloAtom == hello);
+    CHECK(view != helloStr);
+    CHECK(view != helloAtom);
+    CHECK(StringView(helloAtom) == "Hello");
+
+    // ordering is the same as for String
+    CHECK(StringView("abc") < StringView("abd"));
+    CHECK(StringView("ab") < StringView("abc"));
+    CHECK(StringView("abc") > StringView("ab"));
+    CHECK(StringView("abc") <= StringView("abc"));
+    CHECK(StringView("abc") >= StringView("abc"));
+    CHECK(StringView("\xC3\xBC") > StringView("z"));
+    CHECK((StringView("ab") < StringView("abc")) == (String("ab") < String("abc")));
+    CHECK((StringView("\xC3\xBC") < StringView("z")) == (String("\xC3\xBC") < String("z")));
+}
+
+//------------------------------------------------------------------------------
+TEST(StringViewBuilderTest) {
+    const char* str = "Hello World!";
+    StringBuilder builder(StringView(str, 5));
+    CHECK(builder.GetString() == "Hello");
+    builder.Append(StringView(str + 5, 7));
+    CHECK(builder.GetString() == "Hello World!");
+    builder.Set(StringView(str + 6, 5));
+    CHECK(builder.GetString() == "World");
+    CHECK(builder.Length() == 5);
+    builder.Append(StringView());
+    CHECK(builder.GetString() == "World");
+}
+
+//------------------------------------------------------------------------------
+TEST(StringViewLookupTest) {
+    const char* str = "Content-Type: text/html";
+    const StringView key(str, 12);
+
+    // lookup String keys in a Map without creating a String
+    Map<String, int32> map;
+    map.Add("Accept", 1);
+    map.Add("Content-Length", 2);
+    map.Add("Content-Type", 3);
+    map.Add("Host", 4);
+    CHECK(map.Contains(key));
+    CHECK(map.FindIndex(key) == 2);
+    CHECK(map[key] == 3);
+    CHECK(!map.Contains(StringView(str, 7)));
+    CHECK(map.FindIndex(StringView(str, 7)) == InvalidIndex);
+    CHECK(!map.Contains(StringView(str)));
+    CHECK(map.Contains(StringView("Accept")));
+    CHECK(map.Contains(StringView("Host")));
+    CHECK(!map.Contains(StringView("Zzz")));
+    map[key] = 5;
+    CHECK(map["Content-Type"] == 5);
+
+    // same for HashMap
+    HashMap<String, int32, StringViewHasher> hashMap;
+    hashMap.Add("Accept", 1);
+    hashMap.Add("Content-Length", 2);
+    hashMap.Add("Content-Type", 3);
+    CHECK(hashMap.Contains(key));
+    CHECK(hashMap[key] == 3);
+    CHECK(hashMap.Find(key) && (*hashMap.Find(key) == 3));
+    CHECK(hashMap.FindIndex(key) == 2);
+    CHECK(!hashMap.Contains(StringView(str, 7)));
+    CHECK(nullptr == hashMap.Find(StringView(str, 7)));
+    CHECK(hashMap.FindIndex(StringView(str, 7)) == InvalidIndex);
+    hashMap[key] = 5;
+    CHECK(hashMap["Content-Type"] == 5);
+}
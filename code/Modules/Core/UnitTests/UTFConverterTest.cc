@@ -0,0 +1,260 @@
+//------------------------------------------------------------------------------
+//  UTFConverterTest.cc
+//  Test the fast UTF transcoders against the ConvertUTF reference functions.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/String/utfConverter.h"
+#include "Core/String/StringConverter.h"
+#include "Core/String/WideString.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Log.h"
+#include <cstring>
+#include <chrono>
+
+using namespace Oryol;
+
+// simple deterministic pseudo-random numbers
+static uint32 _rand(uint32& seed) {
+    seed = seed * 1664525 + 1013904223;
+    return seed ^ (seed >> 16);
+}
+
+//------------------------------------------------------------------------------
+static int32
+_encode(uint32 ch, UTF8* dst) {
+    if (ch < 0x80) {
+        dst[0] = UTF8(ch);
+        return 1;
+    }
+    else if (ch < 0x800) {
+        dst[0] = UTF8(0xC0 | (ch >> 6));
+        dst[1] = UTF8(0x80 | (ch & 0x3F));
+        return 2;
+    }
+    else if (ch < 0x10000) {
+        dst[0] = UTF8(0xE0 | (ch >> 12));
+        dst[1] = UTF8(0x80 | ((ch >> 6) & 0x3F));
+        dst[2] = UTF8(0x80 | (ch & 0x3F));
+        return 3;
+    }
+    else {
+        dst[0] = UTF8(0xF0 | (ch >> 18));
+        dst[1] = UTF8(0x80 | ((ch >> 12) & 0x3F));
+        dst[2] = UTF8(0x80 | ((ch >> 6) & 0x3F));
+        dst[3] = UTF8(0x80 | (ch & 0x3F));
+        return 4;
+    }
+}
+
+//------------------------------------------------------------------------------
+static uint32
+_randCodePoint(uint32& seed) {
+    switch (_rand(seed) % 3) {
+        case 0:  return 0x80 + _rand(seed) % (0x800 - 0x80);
+        case 1:  return 0x800 + _rand(seed) % (0xD800 - 0x800);
+        default: return 0x10000 + _rand(seed) % (0x110000 - 0x10000);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+ Generate mostly-ASCII UTF-8 text with multi-byte sequences, and if
+ 'broken' is true, illegal bytes, overlong encodings, surrogates and
+ truncated sequences sprinkled in.
+*/
+static int32
+_genUTF8(uint32& seed, UTF8* dst, int32 maxLen, bool broken) {
+    int32 len = 0;
+    while ((len + 40) < maxLen) {
+        const int32 ascii = _rand(seed) % 40;
+        for (int32 i = 0; i < ascii; i++) {
+            dst[len++] = UTF8(0x20 + _rand(seed) % 0x5F);
+        }
+        if (broken && (0 == (_rand(seed) % 8))) {
+            switch (_rand(seed) % 5) {
+                case 0: dst[len++] = UTF8(0x80 + _rand(seed) % 0x80); break;
+                case 1: dst[len++] = 0xC0; dst[len++] = 0xAF; break;
+                case 2: dst[len++] = 0xED; dst[len++] = 0xA0; dst[len++] = 0x80; break;
+                case 3: dst[len++] = 0xF4; dst[len++] = 0x90; dst[len++] = 0x80; dst[len++] = 0x80; break;
+                default: len += _encode(_randCodePoint(seed), dst + len) - 1; break;
+            }
+        }
+        else {
+            len += _encode(_randCodePoint(seed), dst + len);
+        }
+    }
+    return len;
+}
+
+//------------------------------------------------------------------------------
+template<class SRC, class DST, class FUNC, class REFFUNC> static bool
+_compare(const SRC* src, int32 srcLen, int32 dstLen, FUNC func, REFFUNC refFunc) {
+    DST* dst = (DST*) Memory::Alloc((dstLen + 1) * sizeof(DST), MemoryTag::Default);
+    DST* refDst = (DST*) Memory::Alloc((dstLen + 1) * sizeof(DST), MemoryTag::Default);
+    const SRC* srcPtr = src;
+    DST* dstPtr = dst;
+    const ConversionResult res = func(&srcPtr, src + srcLen, &dstPtr, dst + dstLen);
+    const SRC* refSrcPtr = src;
+    DST* refDstPtr = refDst;
+    const ConversionResult refRes = refFunc(&refSrcPtr, src + srcLen, &refDstPtr, refDst + dstLen, strictConversion);
+    bool equal = (res == refRes) && ((srcPtr - src) == (refSrcPtr - src)) && ((dstPtr - dst) == (refDstPtr - refDst));
+    if (equal) {
+        equal = (0 == std::memcmp(dst, refDst, (dstPtr - dst) * sizeof(DST)));
+    }
+    Memory::Free(dst);
+    Memory::Free(refDst);
+    return equal;
+}
+
+//------------------------------------------------------------------------------
+TEST(UTFConverterUTF8Test) {
+    const int32 maxLen = 4096;
+    UTF8* src = (UTF8*) Memory::Alloc(maxLen, MemoryTag::Default);
+    uint32 seed = 1;
+    for (int32 iter = 0; iter < 400; iter++) {
+        const bool broken = 0 != (iter & 1);
+        const int32 len = _genUTF8(seed, src, 64 + _rand(seed) % (maxLen - 64), broken);
+        // large enough target, and a random (possibly too small) target
+        const int32 dstLens[2] = { len + 1, int32(_rand(seed) % (len + 1)) };
+        for (int32 i = 0; i < 2; i++) {
+            CHECK((_compare<UTF8, UTF32>(src, len, dstLens[i], utfConverter::UTF8ToUTF32, ConvertUTF8toUTF32)));
+            CHECK((_compare<UTF8, UTF16>(src, len, dstLens[i], utfConverter::UTF8ToUTF16, ConvertUTF8toUTF16)));
+        }
+        // truncated source
+        const int32 truncLen = _rand(seed) % len;
+        CHECK((_compare<UTF8, UTF32>(src, truncLen, len, utfConverter::UTF8ToUTF32, ConvertUTF8toUTF32)));
+        CHECK((_compare<UTF8, UTF16>(src, truncLen, len, utfConverter::UTF8ToUTF16, ConvertUTF8toUTF16)));
+    }
+
+    // error codes
+    const UTF8 illegal[] = { 'a', 'b', 0xC0, 0x80 };
+    const UTF8 truncated[] = { 'a', 'b', 0xE2, 0x82 };
+    UTF32 dst[8];
+    const UTF8* srcPtr = illegal;
+    UTF32* dstPtr = dst;
+    CHECK(sourceIllegal == utfConverter::UTF8ToUTF32(&srcPtr, illegal + 4, &dstPtr, dst + 8));
+    CHECK((srcPtr - illegal) == 2);
+    CHECK((dstPtr - dst) == 2);
+    srcPtr = truncated;
+    dstPtr = dst;
+    CHECK(sourceExhausted == utfConverter::UTF8ToUTF32(&srcPtr, truncated + 4, &dstPtr, dst + 8));
+    srcPtr = illegal;
+    dstPtr = dst;
+    CHECK(targetExhausted == utfConverter::UTF8ToUTF32(&srcPtr, illegal + 4, &dstPtr, dst + 1));
+    CHECK((srcPtr - illegal) == 1);
+    Memory::Free(src);
+}
+
+//------------------------------------------------------------------------------
+TEST(UTFConverterWideTest) {
+    const int32 maxLen = 2048;
+    UTF32* src32 = (UTF32*) Memory::Alloc(maxLen * sizeof(UTF32), MemoryTag::Default);
+    UTF16* src16 = (UTF16*) Memory::Alloc(2 * maxLen * sizeof(UTF16), MemoryTag::Default);
+    uint32 seed = 2;
+    for (int32 iter = 0; iter < 400; iter++) {
+        const bool broken = 0 != (iter & 1);
+        const int32 len = 64 + _rand(seed) % (maxLen - 64);
+        int32 len16 = 0;
+        for (int32 i = 0; i < len; ) {
+            const int32 ascii = _rand(seed) % 40;
+            for (int32 j = 0; (j < ascii) && (i < len); j++, i++) {
+                src32[i] = 0x20 + _rand(seed) % 0x5F;
+                src16[len16++] = UTF16(src32[i]);
+            }
+            if (i < len) {
+                uint32 ch = _randCodePoint(seed);
+                if (broken && (0 == (_rand(seed) % 8))) {
+                    // lone surrogates, or code points out of range
+                    ch = (_rand(seed) & 1) ? (0xD800 + _rand(seed) % 0x800) : (0x110000 + _rand(seed) % 0x1000);
+                }
+                src32[i++] = ch;
+                if (ch < 0x10000) {
+                    src16[len16++] = UTF16(ch);
+                }
+                else if (ch < 0x110000) {
+                    src16[len16++] = UTF16(((ch - 0x10000) >> 10) + 0xD800);
+                    src16[len16++] = UTF16(((ch - 0x10000) & 0x3FF) + 0xDC00);
+                }
+            }
+        }
+        const int32 dstLens[2] = { len16 * 4 + 1, int32(_rand(seed) % (len * 2)) };
+        for (int32 i = 0; i < 2; i++) {
+            CHECK((_compare<UTF32, UTF8>(src32, len, dstLens[i], utfConverter::UTF32ToUTF8, ConvertUTF32toUTF8)));
+            CHECK((_compare<UTF16, UTF8>(src16, len16, dstLens[i], utfConverter::UTF16ToUTF8, ConvertUTF16toUTF8)));
+        }
+        // truncated source, may split a surrogate pair
+        CHECK((_compare<UTF16, UTF8>(src16, _rand(seed) % len16, len16 * 4, utfConverter::UTF16ToUTF8, ConvertUTF16toUTF8)));
+    }
+    Memory::Free(src32);
+    Memory::Free(src16);
+}
+
+//------------------------------------------------------------------------------
+TEST(UTFConverterStringConverterTest) {
+    const char* str = "Gr\xC3\xBC\xC3\x9F" "e aus K\xC3\xB6ln, \xE2\x82\xAC 5, \xF0\x9F\x98\x80 and a long ASCII tail to hit the fast path";
+    WideString wide = StringConverter::UTF8ToWide((const unsigned char*)str, int32(std::strlen(str)));
+    CHECK(wide.IsValid());
+    String utf8 = StringConverter::WideToUTF8(wide);
+    CHECK(utf8 == str);
+}
+
+//------------------------------------------------------------------------------
+TEST(UTFConverterBenchmark) {
+    const int32 len = 1 << 20;
+    UTF8* ascii = (UTF8*) Memory::Alloc(len, MemoryTag::Default);
+    UTF8* mixed = (UTF8*) Memory::Alloc(len, MemoryTag::Default);
+    UTF8* narrow = (UTF8*) Memory::Alloc(len, MemoryTag::Default);
+    UTF32* wide = (UTF32*) Memory::Alloc((len + 1) * sizeof(UTF32), MemoryTag::Default);
+    uint32 seed = 3;
+    for (int32 i = 0; i < len; i++) {
+        ascii[i] = UTF8(0x20 + _rand(seed) % 0x5F);
+    }
+    const int32 mixedLen = _genUTF8(seed, mixed, len, false);
+    const int32 numIters = 20;
+
+    const UTF8* inputs[2] = { ascii, mixed };
+    const int32 inputLens[2] = { len, mixedLen };
+    const char* names[2] = { "ascii", "mixed" };
+    for (int32 i = 0; i < 2; i++) {
+        int32 numChars = 0;
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        for (int32 iter = 0; iter < numIters; iter++) {
+            const UTF8* srcPtr = inputs[i];
+            UTF32* dstPtr = wide;
+            CHECK(conversionOK == utfConverter::UTF8ToUTF32(&srcPtr, inputs[i] + inputLens[i], &dstPtr, wide + len));
+            numChars = int32(dstPtr - wide);
+        }
+        std::chrono::duration<double> fastDur = std::chrono::system_clock::now() - start;
+        start = std::chrono::system_clock::now();
+        for (int32 iter = 0; iter < numIters; iter++) {
+            const UTF8* srcPtr = inputs[i];
+            UTF32* dstPtr = wide;
+            CHECK(conversionOK == ConvertUTF8toUTF32(&srcPtr, inputs[i] + inputLens[i], &dstPtr, wide + len, strictConversion));
+        }
+        std::chrono::duration<double> refDur = std::chrono::system_clock::now() - start;
+        Log::Info("UTF-8 => UTF-32 (%s, %d bytes): utfConverter: %f sec, ConvertUTF: %f sec\n",
+            names[i], inputLens[i], fastDur.count(), refDur.count());
+
+        start = std::chrono::system_clock::now();
+        for (int32 iter = 0; iter < numIters; iter++) {
+            const UTF32* srcPtr = wide;
+            UTF8* dstPtr = narrow;
+            CHECK(conversionOK == utfConverter::UTF32ToUTF8(&srcPtr, wide + numChars, &dstPtr, narrow + len));
+        }
+        fastDur = std::chrono::system_clock::now() - start;
+        start = std::chrono::system_clock::now();
+        for (int32 iter = 0; iter < numIters; iter++) {
+            const UTF32* srcPtr = wide;
+            UTF8* dstPtr = narrow;
+            CHECK(conversionOK == ConvertUTF32toUTF8(&srcPtr, wide + numChars, &dstPtr, narrow + len, strictConversion));
+        }
+        refDur = std::chrono::system_clock::now() - start;
+        Log::Info("UTF-32 => UTF-8 (%s, %d chars): utfConverter: %f sec, ConvertUTF: %f sec\n",
+            names[i], numChars, fastDur.count(), refDur.count());
+    }
+    Memory::Free(ascii);
+    Memory::Free(mixed);
+    Memory::Free(narrow);
+    Memory::Free(wide);
+}
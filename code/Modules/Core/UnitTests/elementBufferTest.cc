@@ -5,6 +5,9 @@
 #include "Pre.h"
 #include "UnitTest++/src/UnitTest++.h"
 #include "Core/Containers/elementBuffer.h"
+#include "Core/String/String.h"
+#include "Core/Log.h"
+#include <chrono>
 
 using namespace Oryol;
 using namespace Oryol::_priv;
@@ -562,3 +565,111 @@ TEST(elementBufferTest) {
     CHECK(buf5.popBack() == 3);
     CHECK(buf5.size() == 0);
 }
+
+//------------------------------------------------------------------------------
+TEST(elementBufferRelocatableTest) {
+    static_assert(IsTriviallyRelocatable<int32>::value, "int32 must be trivially relocatable");
+    static_assert(IsTriviallyRelocatable<String>::value, "String must be trivially relocatable");
+    static_assert(!IsTriviallyRelocatable<_test>::value, "_test must not be trivially relocatable");
+
+    // grow with realloc (same front spare) and with copy (different front spare)
+    // NOTE: must be a shared (not inline) string to check refcounts
+    String str("Bla Blub Bla Blub Bla Blub Bla Blub");
+    elementBuffer<String> buf;
+    buf.alloc(4, 0);
+    for (int32 i = 0; i < 4; i++) {
+        buf.pushBack(str);
+    }
+    CHECK(str.RefCount() == 5);
+    buf.alloc(8, 0);
+    CHECK(buf.size() == 4);
+    CHECK(str.RefCount() == 5);
+    buf.alloc(16, 4);
+    CHECK(buf.frontSpare() == 4);
+    CHECK(buf.size() == 4);
+    CHECK(str.RefCount() == 5);
+    for (int32 i = 0; i < 4; i++) {
+        CHECK(buf[i] == "Bla Blub Bla Blub Bla Blub Bla Blub");
+    }
+
+    // insert and erase in the middle, moving towards front and back
+    buf.insert(1, String("One"));
+    buf.insert(4, String("Four"));
+    CHECK(buf.size() == 6);
+    CHECK(buf[1] == "One");
+    CHECK(buf[4] == "Four");
+    CHECK(str.RefCount() == 5);
+    buf.erase(1);
+    CHECK(buf.size() == 5);
+    CHECK(buf[3] == "Four");
+    buf.erase(3);
+    CHECK(buf.size() == 4);
+    CHECK(str.RefCount() == 5);
+    for (int32 i = 0; i < 4; i++) {
+        CHECK(buf[i] == "Bla Blub Bla Blub Bla Blub Bla Blub");
+    }
+    buf.destroy();
+    CHECK(str.RefCount() == 1);
+
+    // POD elements
+    elementBuffer<int32> ints;
+    ints.alloc(64, 16);
+    for (int32 i = 0; i < 32; i++) {
+        ints.insert(ints.size(), i);
+    }
+    ints.insert(0, -1);
+    ints.insert(10, 100);
+    ints.insert(30, 200);
+    CHECK(ints.size() == 35);
+    CHECK(ints[0] == -1);
+    CHECK(ints[10] == 100);
+    CHECK(ints[30] == 200);
+    ints.erase(30);
+    ints.erase(10);
+    ints.erase(0);
+    for (int32 i = 0; i < 32; i++) {
+        CHECK(ints[i] == i);
+    }
+    elementBuffer<int32> intsCopy(ints);
+    CHECK(intsCopy.size() == 32);
+    CHECK(intsCopy[31] == 31);
+}
+
+//------------------------------------------------------------------------------
+TEST(elementBufferRelocateBenchmark) {
+    
+    // grow a buffer by big amounts and insert/erase in the middle, 
+    // relocatable (int32) vs element-wise moves (_test)
+    const int32 num = 1<<20;
+    for (int32 run = 0; run < 2; run++) {
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        elementBuffer<int32> ints;
+        for (int32 cap = 1024; cap <= num; cap *= 2) {
+            ints.alloc(cap, 0);
+            while (ints.backSpare() > 0) {
+                ints.pushBack(ints.size());
+            }
+        }
+        for (int32 i = 0; i < 64; i++) {
+            ints.erase(num / 2);
+            ints.insert(num / 3, i);
+        }
+        std::chrono::duration<double> dur = std::chrono::system_clock::now() - start;
+        Log::Info("run %d: elementBuffer<int32> grow+insert/erase: %f sec\n", run, dur.count());
+
+        start = std::chrono::system_clock::now();
+        elementBuffer<_test> tests;
+        for (int32 cap = 1024; cap <= num; cap *= 2) {
+            tests.alloc(cap, 0);
+            while (tests.backSpare() > 0) {
+                tests.pushBack(_test(tests.size()));
+            }
+        }
+        for (int32 i = 0; i < 64; i++) {
+            tests.erase(num / 2);
+            tests.insert(num / 3, _test(i));
+        }
+        dur = std::chrono::system_clock::now() - start;
+        Log::Info("run %d: elementBuffer<_test> grow+insert/erase: %f sec\n", run, dur.count());
+    }
+}
@@ -71,7 +71,7 @@ resourceMgr::Setup(const GfxSetup& setup, class renderer* rendr, class displayMg
     }
     
     // add out update method to the runloop
-    this->runLoopId = Core::PreRunLoop()->Add([this] {
+    this->runLoopId = Core::PreRunLoop()->Add("Gfx::ResourceMgr", [this] {
         this->Update();
     });
 }
@@ -20,7 +20,7 @@ Gfx::Setup(const class GfxSetup& setup) {
     state->displayManager.SetupDisplay(setup);
     state->renderer.setup();
     state->resourceManager.Setup(setup, &state->renderer, &state->displayManager);
-    state->runLoopId = Core::PreRunLoop()->Add([] {
+    state->runLoopId = Core::PreRunLoop()->Add("Gfx::SystemEvents", [] {
         state->displayManager.ProcessSystemEvents();
     });
 }
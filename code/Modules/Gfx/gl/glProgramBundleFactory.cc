@@ -147,7 +147,7 @@ glProgramBundleFactory::SetupResource(programBundle& progBundle) {
         GLint logLength;
         ::glGetProgramiv(glProg, GL_INFO_LOG_LENGTH, &logLength);
         if (logLength > 0) {
-            GLchar* logBuffer = (GLchar*) Memory::Alloc(logLength);
+            GLchar* logBuffer = (GLchar*) Memory::Alloc(logLength, MemoryTag::Gfx);
             ::glGetProgramInfoLog(glProg, logLength, &logLength, logBuffer);
             Log::Info("%s\n", logBuffer);
             Memory::Free(logBuffer);
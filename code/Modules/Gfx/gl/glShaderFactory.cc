@@ -127,7 +127,7 @@ glShaderFactory::compileShader(ShaderType::Code type, const String& src) const {
             Log::Info("SHADER SOURCE:\n%s\n\n", sourceString);
             
             // now print the info log
-            GLchar* shdLogBuf = (GLchar*) Memory::Alloc(logLength);
+            GLchar* shdLogBuf = (GLchar*) Memory::Alloc(logLength, MemoryTag::Gfx);
             ::glGetShaderInfoLog(glShader, logLength, &logLength, shdLogBuf);
             ORYOL_GL_CHECK_ERROR();
             Log::Info("SHADER LOG: %s\n\n", shdLogBuf);
@@ -30,7 +30,10 @@ HTTPFileSystem::onRequest(const Ptr<IOProtocol::Request>& msg) {
     if (msg->GetEndOffset() != 0) {
         Map<String,String> requestHeaders;
         // need to add a Range header
-        this->stringBuilder.Format(64, "bytes=%d-%d", msg->GetStartOffset(), msg->GetEndOffset());
+        this->stringBuilder.Set("bytes=");
+        this->stringBuilder.AppendNumber(msg->GetStartOffset());
+        this->stringBuilder.Append('-');
+        this->stringBuilder.AppendNumber(msg->GetEndOffset());
         requestHeaders.Add("Range", this->stringBuilder.GetString()); 
         httpReq->SetRequestHeaders(requestHeaders);
     }
@@ -50,7 +50,7 @@ curlURLLoader::setupCurlSession() {
 
     // setup the error buffer
     const int32 curlErrorBufferSize = CURL_ERROR_SIZE * 4;
-    this->curlError = (char*) Memory::Alloc(curlErrorBufferSize);
+    this->curlError = (char*) Memory::Alloc(curlErrorBufferSize, MemoryTag::HTTP);
     Memory::Clear(this->curlError, curlErrorBufferSize);
 
     // setup the curl session
@@ -152,10 +152,12 @@ curlURLLoader::doOneRequest(const Ptr<HTTPProtocol::HTTPRequest>& req) {
 
     // set URL in curl
     const URL& url = req->GetURL();
-    o_assert(url.Scheme() == "http");
+    o_assert(url.SchemeView() == "http");
     curl_easy_setopt(this->curlSession, CURLOPT_URL, url.AsCStr());
     if (url.HasPort()) {
-        uint16 port = StringConverter::FromString<uint16>(url.Port());
+        const StringView portView = url.PortView();
+        uint16 port = 0;
+        StringConverter::FromChars(portView.Ptr(), portView.Length(), port);
         curl_easy_setopt(this->curlSession, CURLOPT_PORT, port);
     }
 
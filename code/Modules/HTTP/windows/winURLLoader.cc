@@ -160,7 +160,7 @@ winURLLoader::doOneRequest(const Ptr<HTTPProtocol::HTTPRequest>& req) {
                                         WINHTTP_NO_HEADER_INDEX);
                     if (GetLastError() == ERROR_INSUFFICIENT_BUFFER) {
                         // and get the response headers
-                        LPVOID headerBuffer = Memory::Alloc(dwSize);
+                        LPVOID headerBuffer = Memory::Alloc(dwSize, MemoryTag::HTTP);
                         BOOL headerResult = WinHttpQueryHeaders(
                             hRequest,
                             WINHTTP_QUERY_RAW_HEADERS_CRLF,
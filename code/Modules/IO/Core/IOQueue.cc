@@ -26,7 +26,7 @@ void
 IOQueue::Start() {
     o_assert_dbg(!this->isStarted);
     this->isStarted = true;
-    this->runLoopId = Core::PreRunLoop()->Add([this]() { this->update(); });
+    this->runLoopId = Core::PreRunLoop()->Add("IOQueue", [this]() { this->update(); });
 }
 
 //------------------------------------------------------------------------------
@@ -68,6 +68,12 @@ valid(false) {
     this->crack(rhs);
 }
     
+//------------------------------------------------------------------------------
+URL::URL(const StringView& rhs) :
+valid(false) {
+    this->crack(rhs.AsString());
+}
+
 //------------------------------------------------------------------------------
 void
 URL::operator=(const URL& rhs) {
@@ -112,6 +118,12 @@ URL::operator=(const String& rhs) {
     this->crack(rhs);
 }
     
+//------------------------------------------------------------------------------
+void
+URL::operator=(const StringView& rhs) {
+    this->crack(rhs.AsString());
+}
+
 //------------------------------------------------------------------------------
 bool
 URL::operator==(const URL& rhs) {
@@ -265,6 +277,13 @@ URL::crack(String urlString) {
     // fallthrough if valid or empty URL
 }
 
+//------------------------------------------------------------------------------
+StringView
+URL::view(int32 startIndex, int32 endIndex) const {
+    o_assert_dbg((startIndex >= 0) && (endIndex >= startIndex));
+    return StringView(this->content.AsCStr() + startIndex, endIndex - startIndex);
+}
+
 //------------------------------------------------------------------------------
 bool
 URL::HasScheme() const {
@@ -272,16 +291,22 @@ URL::HasScheme() const {
 }
 
 //------------------------------------------------------------------------------
-String
-URL::Scheme() const {
+StringView
+URL::SchemeView() const {
     if (this->HasScheme()) {
-        return String(this->content.AsCStr(), this->indices[schemeStart], this->indices[schemeEnd]);
+        return this->view(this->indices[schemeStart], this->indices[schemeEnd]);
     }
     else {
-        return String();
+        return StringView();
     }
 }
 
+//------------------------------------------------------------------------------
+String
+URL::Scheme() const {
+    return this->SchemeView().AsString();
+}
+
 //------------------------------------------------------------------------------
 bool
 URL::HasUser() const {
@@ -289,16 +314,22 @@ URL::HasUser() const {
 }
 
 //------------------------------------------------------------------------------
-String
-URL::User() const {
+StringView
+URL::UserView() const {
     if (this->HasUser()) {
-        return String(this->content.AsCStr(), this->indices[userStart], this->indices[userEnd]);
+        return this->view(this->indices[userStart], this->indices[userEnd]);
     }
     else {
-        return String();
+        return StringView();
     }
 }
 
+//------------------------------------------------------------------------------
+String
+URL::User() const {
+    return this->UserView().AsString();
+}
+
 //------------------------------------------------------------------------------
 bool
 URL::HasPassword() const {
@@ -306,16 +337,22 @@ URL::HasPassword() const {
 }
 
 //------------------------------------------------------------------------------
-String
-URL::Password() const {
+StringView
+URL::PasswordView() const {
     if (this->HasPassword()) {
-        return String(this->content.AsCStr(), this->indices[pwdStart], this->indices[pwdEnd]);
+        return this->view(this->indices[pwdStart], this->indices[pwdEnd]);
     }
     else {
-        return String();
+        return StringView();
     }
 }
 
+//------------------------------------------------------------------------------
+String
+URL::Password() const {
+    return this->PasswordView().AsString();
+}
+
 //------------------------------------------------------------------------------
 bool
 URL::HasHost() const {
@@ -323,16 +360,22 @@ URL::HasHost() const {
 }
 
 //------------------------------------------------------------------------------
-String
-URL::Host() const {
+StringView
+URL::HostView() const {
     if (this->HasHost()) {
-        return String(this->content.AsCStr(), this->indices[hostStart], this->indices[hostEnd]);
+        return this->view(this->indices[hostStart], this->indices[hostEnd]);
     }
     else {
-        return String();
+        return StringView();
     }
 }
 
+//------------------------------------------------------------------------------
+String
+URL::Host() const {
+    return this->HostView().AsString();
+}
+
 //------------------------------------------------------------------------------
 bool
 URL::HasPort() const {
@@ -340,35 +383,47 @@ URL::HasPort() const {
 }
 
 //------------------------------------------------------------------------------
-String
-URL::Port() const {
+StringView
+URL::PortView() const {
     if (this->HasPort()) {
-        return String(this->content.AsCStr(), this->indices[portStart], this->indices[portEnd]);
+        return this->view(this->indices[portStart], this->indices[portEnd]);
     }
     else {
-        return String();
+        return StringView();
     }
 }
 
 //------------------------------------------------------------------------------
 String
-URL::HostAndPort() const  {
+URL::Port() const {
+    return this->PortView().AsString();
+}
+
+//------------------------------------------------------------------------------
+StringView
+URL::HostAndPortView() const {
     if (this->HasHost()) {
         if (this->HasPort()) {
             // URL has host and port definition
-            return String(this->content.AsCStr(), this->indices[hostStart], this->indices[portEnd]);
+            return this->view(this->indices[hostStart], this->indices[portEnd]);
         }
         else {
             // URL only has host
-            return String(this->content.AsCStr(), this->indices[hostStart], this->indices[hostEnd]);
+            return this->view(this->indices[hostStart], this->indices[hostEnd]);
         }
     }
     else {
         // no host in URL
-        return String();
+        return StringView();
     }
 }
 
+//------------------------------------------------------------------------------
+String
+URL::HostAndPort() const  {
+    return this->HostAndPortView().AsString();
+}
+
 //------------------------------------------------------------------------------
 bool
 URL::HasPath() const {
@@ -376,16 +431,22 @@ URL::HasPath() const {
 }
 
 //------------------------------------------------------------------------------
-String
-URL::Path() const {
+StringView
+URL::PathView() const {
     if (this->HasPath()) {
-        return String(this->content.AsCStr(), this->indices[pathStart], this->indices[pathEnd]);
+        return this->view(this->indices[pathStart], this->indices[pathEnd]);
     }
     else {
-        return String();
+        return StringView();
     }
 }
 
+//------------------------------------------------------------------------------
+String
+URL::Path() const {
+    return this->PathView().AsString();
+}
+
 //------------------------------------------------------------------------------
 bool
 URL::HasFragment() const {
@@ -393,64 +454,108 @@ URL::HasFragment() const {
 }
 
 //------------------------------------------------------------------------------
-String
-URL::Fragment() const {
+StringView
+URL::FragmentView() const {
     if (this->HasFragment()) {
-        return String(this->content.AsCStr(), this->indices[fragStart], this->indices[fragEnd]);
+        return this->view(this->indices[fragStart], this->indices[fragEnd]);
     }
     else {
-        return String();
+        return StringView();
     }
 }
 
 //------------------------------------------------------------------------------
 String
-URL::PathToEnd() const {
+URL::Fragment() const {
+    return this->FragmentView().AsString();
+}
+
+//------------------------------------------------------------------------------
+StringView
+URL::PathToEndView() const {
     if (this->HasPath()) {
-        return String(this->content.AsCStr(), this->indices[pathStart], EndOfString);
+        return this->view(this->indices[pathStart], this->content.Length());
     }
     else {
-        return String();
+        return StringView();
     }
 }
 
+//------------------------------------------------------------------------------
+String
+URL::PathToEnd() const {
+    return this->PathToEndView().AsString();
+}
+
 //------------------------------------------------------------------------------
 bool
 URL::HasQuery() const {
     return InvalidIndex != this->indices[queryStart];
 }
 
+//------------------------------------------------------------------------------
+StringView
+URL::QueryView() const {
+    if (this->HasQuery()) {
+        return this->view(this->indices[queryStart], this->indices[queryEnd]);
+    }
+    else {
+        return StringView();
+    }
+}
+
 //------------------------------------------------------------------------------
 Map<String, String>
 URL::Query() const {
-    if (this->HasQuery()) {
-        Map<String, String> query;
-        StringBuilder builder;
-        builder.Set(this->content.AsCStr(), this->indices[queryStart], this->indices[queryEnd]);
+    Map<String, String> query;
+    const StringView queryView = this->QueryView();
+    if (queryView.IsValid()) {
         int32 kvpStartIndex = 0;
         int32 kvpEndIndex = 0;
         do {
-            kvpEndIndex = builder.FindFirstOf(kvpStartIndex, EndOfString, "&");
-            int32 keyEndIndex = builder.FindFirstOf(kvpStartIndex, kvpEndIndex, "=");
+            kvpEndIndex = queryView.FindFirstOf(kvpStartIndex, EndOfString, "&");
+            const StringView kvp = queryView.SubView(kvpStartIndex, kvpEndIndex);
+            const int32 keyEndIndex = kvp.FindFirstOf(0, EndOfString, "=");
             if (EndOfString != keyEndIndex) {
                 // key and value
-                String key(builder.GetSubString(kvpStartIndex, keyEndIndex));
-                String value(builder.GetSubString(keyEndIndex + 1, kvpEndIndex));
-                query.Add(key, value);
+                query.Add(kvp.SubView(0, keyEndIndex).AsString(), kvp.SubView(keyEndIndex + 1, EndOfString).AsString());
             }
             else {
                 // only key
-                String key(builder.GetSubString(kvpStartIndex, kvpEndIndex));
-                query.Add(key, String());
+                query.Add(kvp.AsString(), String());
             }
             kvpStartIndex = kvpEndIndex + 1;
         }
         while (EndOfString != kvpEndIndex);
-        return query;
     }
-    else {
-        return Map<String, String>();
+    return query;
+}
+
+//------------------------------------------------------------------------------
+bool
+URL::FindQueryValue(const StringView& key, StringView& outValue) const {
+    const StringView queryView = this->QueryView();
+    int32 kvpStartIndex = 0;
+    while (kvpStartIndex < queryView.Length()) {
+        int32 kvpEndIndex = queryView.FindFirstOf(kvpStartIndex, EndOfString, "&");
+        if (EndOfString == kvpEndIndex) {
+            kvpEndIndex = queryView.Length();
+        }
+        const StringView kvp = queryView.SubView(kvpStartIndex, kvpEndIndex);
+        if (kvp.StartsWith(key)) {
+            if (kvp.Length() == key.Length()) {
+                // only key
+                outValue = StringView();
+                return true;
+            }
+            else if ('=' == kvp[key.Length()]) {
+                outValue = kvp.SubView(key.Length() + 1, EndOfString);
+                return true;
+            }
+        }
+        kvpStartIndex = kvpEndIndex + 1;
     }
+    return false;
 }
 
 } // namespace Oryol
\ No newline at end of file
@@ -10,7 +10,10 @@
     parsed and indices to its parts will be stored internally, this
     is quite fast. The actual URL string will be stored as a StringAtom.
     Expensive String construction only happens when actually getting
-    the URL parts. 
+    the URL parts as String objects. The ...View() methods return
+    the URL parts as StringViews into the StringAtom data instead,
+    which never allocates (and the views stay valid even after the
+    URL object is gone, since StringAtom data is never freed).
     
     @see URLBuilder
 */
@@ -18,6 +21,7 @@
 #include "Core/String/StringAtom.h"
 #include "Core/Containers/Map.h"
 #include "Core/String/String.h"
+#include "Core/String/StringView.h"
 
 namespace Oryol {
 
@@ -36,6 +40,8 @@ public:
     URL(const StringAtom& rhs);
     /// construct from String
     URL(const String& rhs);
+    /// construct from StringView
+    URL(const StringView& rhs);
     
     /// assignment from other URL
     void operator=(const URL& rhs);
@@ -47,6 +53,8 @@ public:
     void operator=(const StringAtom& rhs);
     /// assignment from String
     void operator=(const String& rhs);
+    /// assignment from StringView
+    void operator=(const StringView& rhs);
     
     /// equality
     bool operator==(const URL& rhs);
@@ -66,38 +74,60 @@ public:
     bool HasScheme() const;
     /// get the scheme string
     String Scheme() const;
+    /// get the scheme as string view
+    StringView SchemeView() const;
     /// test if the URL has a user string
     bool HasUser() const;
     /// get the user string
     String User() const;
+    /// get the user as string view
+    StringView UserView() const;
     /// test if the URL has a password
     bool HasPassword() const;
     /// get the password string
     String Password() const;
+    /// get the password as string view
+    StringView PasswordView() const;
     /// test if the URL has a host string
     bool HasHost() const;
     /// get the host string
     String Host() const;
+    /// get the host as string view
+    StringView HostView() const;
     /// test if the URL has a port string
     bool HasPort() const;
     /// get the port string
     String Port() const;
+    /// get the port as string view
+    StringView PortView() const;
     /// get host and port (only host if no port was in URL)
     String HostAndPort() const;
+    /// get host and port as string view
+    StringView HostAndPortView() const;
     /// test if the URL has a path string
     bool HasPath() const;
     /// get the path string
     String Path() const;
+    /// get the path as string view
+    StringView PathView() const;
     /// test if the URL has a fragment
     bool HasFragment() const;
     /// get the fragment string
     String Fragment() const;
+    /// get the fragment as string view
+    StringView FragmentView() const;
     /// test if the URL has a query
     bool HasQuery() const;
     /// get the query component
     Map<String, String> Query() const;
+    /// get the raw query component as string view
+    StringView QueryView() const;
+    /// find a query value by key, return false if the key doesn't exist
+    bool FindQueryValue(const StringView& key, StringView& outValue) const;
     /// get everything right of the server
     String PathToEnd() const;
+    /// get everything right of the server as string view
+    StringView PathToEndView() const;
     
 private:
     /// crack URL, populates string indices
@@ -106,6 +136,8 @@ private:
     void clearIndices();
     /// copy string indices
     void copyIndices(const URL& rhs);
+    /// get a view of the URL string between 2 indices
+    StringView view(int32 startIndex, int32 endIndex) const;
     
     enum {
         schemeStart = 0,
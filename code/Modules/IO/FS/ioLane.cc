@@ -62,14 +62,17 @@ ioLane::onTick() {
 //------------------------------------------------------------------------------
 Ptr<FileSystem>
 ioLane::fileSystemForURL(const URL& url) {
-    StringAtom scheme = url.Scheme();
-    if (this->fileSystems.Contains(scheme)) {
-        return this->fileSystems[scheme];
-    }
-    else {
-        Log::Warn("ioLane::fileSystemForURL: no filesystem registered for URL scheme '%s'!\n", scheme.AsCStr());
-        return Ptr<FileSystem>();
+    // NOTE: this is called for every request, only a handful of schemes
+    // are registered, so a linear search with the scheme view doesn't
+    // need to create a String or StringAtom
+    const StringView scheme = url.SchemeView();
+    for (const auto& kvp : this->fileSystems) {
+        if (kvp.Key() == scheme) {
+            return kvp.Value();
+        }
     }
+    Log::Warn("ioLane::fileSystemForURL: no filesystem registered for URL scheme '%s'!\n", scheme.AsString().AsCStr());
+    return Ptr<FileSystem>();
 }
 
 //------------------------------------------------------------------------------
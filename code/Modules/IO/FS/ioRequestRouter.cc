@@ -29,29 +29,74 @@ ioRequestRouter::~ioRequestRouter() {
 }
 
 //------------------------------------------------------------------------------
-bool
-ioRequestRouter::Put(const Ptr<Message>& msg) {
+int32
+ioRequestRouter::laneIndex(const Ptr<Message>& msg) const {
     // is it a notify message for all lanes?
     Ptr<IOProtocol::notifyLanes> notifyMsg = msg.dynamicCast<IOProtocol::notifyLanes>();
     if (notifyMsg.isValid()) {
-        for (const auto& lane : this->ioLanes) {
-            lane->Put(msg);
-        }
-        return true;
+        return AllLanes;
     }
     else {
         Ptr<IOProtocol::Request> req = msg.dynamicCast<IOProtocol::Request>();
         if (req.isValid()) {
-            const int32 laneIndex = req->GetLane() % this->numLanes;
-            this->ioLanes[laneIndex]->Put(msg);
-            return true;
+            return req->GetLane() % this->numLanes;
         }
     }
     // fallthrough: unrecognized message
-    Log::Warn("ioRequestRouter::Put(): unrecognized message received!\n");
+    Log::Warn("ioRequestRouter: unrecognized message received!\n");
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+bool
+ioRequestRouter::Put(const Ptr<Message>& msg) {
+    const int32 laneIndex = this->laneIndex(msg);
+    if (AllLanes == laneIndex) {
+        for (const auto& lane : this->ioLanes) {
+            lane->Put(msg);
+        }
+        return true;
+    }
+    else if (InvalidIndex != laneIndex) {
+        this->ioLanes[laneIndex]->Put(msg);
+        return true;
+    }
     return false;
 }
 
+//------------------------------------------------------------------------------
+/**
+ The messages are sorted into one batch per lane (notify messages
+ go into all batches), this keeps the message order within each lane,
+ and each lane thread is woken up at most once.
+*/
+bool
+ioRequestRouter::PutBatch(const Ptr<Message>* msgs, int32 num) {
+    o_assert_dbg(msgs || (0 == num));
+    Array<int32> msgLanes;
+    msgLanes.Reserve(num);
+    bool retval = false;
+    for (int32 i = 0; i < num; i++) {
+        const int32 laneIndex = this->laneIndex(msgs[i]);
+        retval |= InvalidIndex != laneIndex;
+        msgLanes.Add(laneIndex);
+    }
+    Array<Ptr<Message>> batch;
+    batch.Reserve(num);
+    for (int32 laneIndex = 0; laneIndex < this->numLanes; laneIndex++) {
+        for (int32 i = 0; i < num; i++) {
+            if ((laneIndex == msgLanes[i]) || (AllLanes == msgLanes[i])) {
+                batch.Add(msgs[i]);
+            }
+        }
+        if (!batch.Empty()) {
+            this->ioLanes[laneIndex]->PutBatch(batch.begin(), batch.Size());
+            batch.Clear();
+        }
+    }
+    return retval;
+}
+
 //------------------------------------------------------------------------------
 void
 ioRequestRouter::DoWork() {
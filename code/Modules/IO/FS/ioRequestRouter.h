@@ -24,10 +24,17 @@ public:
     
     /// put a message into the port
     virtual bool Put(const Ptr<Message>& msg) override;
+    /// put an array of messages into the port, each lane gets its messages as one batch
+    virtual bool PutBatch(const Ptr<Message>* msgs, int32 num) override;
     /// perform work, this will be invoked on downstream ports
     virtual void DoWork() override;
     
 private:
+    /// lane index for messages which go to all lanes
+    static const int32 AllLanes = -2;
+    /// get lane index for a message (AllLanes, or InvalidIndex if not recognized)
+    int32 laneIndex(const Ptr<Message>& msg) const;
+
     int32 numLanes;
     Array<Ptr<ioLane>> ioLanes;
 };
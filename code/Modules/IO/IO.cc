@@ -32,7 +32,7 @@ IO::Setup(const IOSetup& setup) {
         RegisterFileSystem(fs.Key(), fs.Value());
     }
     
-    state->runLoopId = Core::PreRunLoop()->Add([] { doWork(); });
+    state->runLoopId = Core::PreRunLoop()->Add("IO", [] { doWork(); });
 }
 
 //------------------------------------------------------------------------------
@@ -148,6 +148,19 @@ IO::Put(const Ptr<IOProtocol::Request>& ioReq) {
     state->requestRouter->Put(ioReq);
 }
 
+//------------------------------------------------------------------------------
+void
+IO::PutBatch(const Ptr<IOProtocol::Request>* ioReqs, int32 num) {
+    o_assert_dbg(IsValid());
+    o_assert_dbg(ioReqs || (0 == num));
+    Array<Ptr<Message>> msgs;
+    msgs.Reserve(num);
+    for (int32 i = 0; i < num; i++) {
+        msgs.Add(ioReqs[i]);
+    }
+    state->requestRouter->PutBatch(msgs.begin(), msgs.Size());
+}
+
 //------------------------------------------------------------------------------
 schemeRegistry*
 IO::getSchemeRegistry() {
@@ -49,6 +49,8 @@ public:
     static Ptr<IOProtocol::Request> LoadFile(const URL& url, int32 ioLane=0);
     /// push a generic asynchronous IO request
     static void Put(const Ptr<IOProtocol::Request>& ioReq);
+    /// push an array of asynchronous IO requests (much faster than single Put() calls)
+    static void PutBatch(const Ptr<IOProtocol::Request>* ioReqs, int32 num);
     
 private:
     friend class _priv::ioLane;
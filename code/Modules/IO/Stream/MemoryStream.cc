@@ -13,7 +13,9 @@ MemoryStream::MemoryStream() :
 minGrow(ORYOL_STREAM_DEFAULT_MIN_GROW),
 maxGrow(ORYOL_STREAM_DEFAULT_MAX_GROW),
 capacity(0),
-buffer(nullptr) {
+buffer(nullptr),
+arena(nullptr),
+alignment(0) {
     // empty
 }
 
@@ -22,7 +24,9 @@ MemoryStream::MemoryStream(int32 capacity_, int32 minGrow_, int32 maxGrow_) :
 minGrow(minGrow_),
 maxGrow(maxGrow_),
 capacity(0),
-buffer(0) {
+buffer(0),
+arena(nullptr),
+alignment(0) {
     this->alloc(capacity_);
 }
 
@@ -52,9 +56,16 @@ MemoryStream::alloc(int32 newCapacity) {
     }
     o_assert(this->size <= newCapacity);
     
+    // a frame arena can grow the buffer in place
+    if ((nullptr != this->arena) && (0 == this->alignment)) {
+        this->buffer = (uchar*) this->arena->ReAlloc(this->buffer, this->size, newCapacity);
+        this->capacity = newCapacity;
+        return;
+    }
+    
     // allocate new buffer
     const int32 newBufSize = newCapacity;
-    uchar* newBuffer = (uchar*) Memory::Alloc(newBufSize);
+    uchar* newBuffer = this->allocRaw(newBufSize);
     
     // need to move content?
     if (this->size > 0) {
@@ -64,7 +75,7 @@ MemoryStream::alloc(int32 newCapacity) {
     
     // need to free old buffer?
     if (this->buffer) {
-        Memory::Free(this->buffer);
+        this->freeRaw(this->buffer);
         this->buffer = nullptr;
     }
     
@@ -73,6 +84,37 @@ MemoryStream::alloc(int32 newCapacity) {
     this->capacity = newCapacity;
 }
 
+//------------------------------------------------------------------------------
+uchar*
+MemoryStream::allocRaw(int32 numBytes) const {
+    if (nullptr != this->arena) {
+        if (0 != this->alignment) {
+            return (uchar*) this->arena->AllocAligned(numBytes, this->alignment);
+        }
+        return (uchar*) this->arena->Alloc(numBytes);
+    }
+    else if (0 != this->alignment) {
+        return (uchar*) Memory::AllocAligned(numBytes, this->alignment, MemoryTag::IO);
+    }
+    else {
+        return (uchar*) Memory::Alloc(numBytes, MemoryTag::IO);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+MemoryStream::freeRaw(uchar* ptr) const {
+    if (nullptr != this->arena) {
+        this->arena->Free(ptr);
+    }
+    else if (0 != this->alignment) {
+        Memory::FreeAligned(ptr);
+    }
+    else {
+        Memory::Free(ptr);
+    }
+}
+
 //------------------------------------------------------------------------------
 void
 MemoryStream::makeRoom(int32 numBytes) {
@@ -113,6 +155,21 @@ MemoryStream::GetMaxGrow() const {
     return this->maxGrow;
 }
 
+//------------------------------------------------------------------------------
+void
+MemoryStream::SetArena(FrameArena* arena_) {
+    o_assert(nullptr == this->buffer);
+    this->arena = arena_;
+}
+
+//------------------------------------------------------------------------------
+void
+MemoryStream::SetAlignment(int32 alignment_) {
+    o_assert(nullptr == this->buffer);
+    o_assert((alignment_ >= 0) && (0 == (alignment_ & (alignment_ - 1))));
+    this->alignment = alignment_ > ORYOL_MAX_PLATFORM_ALIGN ? alignment_ : 0;
+}
+
 //------------------------------------------------------------------------------
 int32
 MemoryStream::Capacity() const {
@@ -124,7 +181,7 @@ void
 MemoryStream::DiscardContent() {
     o_assert(!this->isOpen);
     if (nullptr != this->buffer) {
-        Memory::Free(this->buffer);
+        this->freeRaw(this->buffer);
         this->buffer = 0;
     }
     this->size = 0;
@@ -8,9 +8,15 @@
     A MemoryStream implements a Stream interface to a dynamic (growable)
     memory buffer. The MemoryStream object will keep its contents until
     destroyed or the DiscardContent method is called. 
+    
+    Optionally a FrameArena can be set as allocation source for transient
+    streams which don't outlive the current frame, and the buffer can
+    be aligned to more then ORYOL_MAX_PLATFORM_ALIGN bytes for aligned
+    vector loads.
 */
 #include "IO/Core/IOConfig.h"
 #include "IO/Stream/Stream.h"
+#include "Core/Memory/FrameArena.h"
 
 namespace Oryol {
 
@@ -30,6 +36,10 @@ public:
     int32 GetMinGrow() const;
     /// get max-grow value
     int32 GetMaxGrow() const;
+    /// allocate from a FrameArena instead of the heap (stream must be empty)
+    void SetArena(FrameArena* arena);
+    /// set buffer alignment, 0 for default (stream must be empty)
+    void SetAlignment(int32 alignment);
     /// get current capacity
     int32 Capacity() const;
     /// increase capacity to hold at least numBytes more (may reallocate)
@@ -57,6 +67,10 @@ private:
     void makeRoom(int32 numBytes);
     /// (re-)allocate to a new capacity
     void alloc(int32 newCapacity);
+    /// allocate raw memory from arena or heap
+    uchar* allocRaw(int32 numBytes) const;
+    /// free raw memory to arena or heap
+    void freeRaw(uchar* ptr) const;
     /// increment writePosition, and probably size
     void incrWritePosition(int32 numBytes);
     /// increment readPosition
@@ -66,6 +80,8 @@ private:
     int32 maxGrow;
     int32 capacity;
     uchar* buffer;
+    FrameArena* arena;
+    int32 alignment;
 };
     
 } // namespace Oryol
\ No newline at end of file
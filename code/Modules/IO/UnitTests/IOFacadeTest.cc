@@ -69,6 +69,29 @@ TEST(IOFacadeTest) {
     CHECK(reader->Read(str));
     stream->Close();
     CHECK(str == msg->GetURL().Get());
+
+    // put a batch of requests, spread over several IO lanes
+    const int32 numReqs = 16;
+    Array<Ptr<IOProtocol::Request>> reqs;
+    for (int32 i = 0; i < numReqs; i++) {
+        Ptr<IOProtocol::Request> req = IOProtocol::Request::Create();
+        req->SetURL(url);
+        req->SetLane(i);
+        reqs.Add(req);
+    }
+    IO::PutBatch(reqs.begin(), reqs.Size());
+    bool allHandled = false;
+    while (!allHandled) {
+        Core::PreRunLoop()->Run();
+        allHandled = true;
+        for (const auto& req : reqs) {
+            allHandled &= req->Handled();
+        }
+    }
+    CHECK(numRequestsHandled == numReqs + 1);
+    for (const auto& req : reqs) {
+        CHECK(req->GetStatus() == IOStatus::OK);
+    }
     
     // FIXME: dynamically add/remove/replace filesystems, ...
     
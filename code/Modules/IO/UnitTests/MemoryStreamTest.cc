@@ -103,3 +103,57 @@ TEST(MemoryStreamTest) {
     /// @todo: test with small initial capacity and small min/max grow
     Ptr<MemoryStream> stream1 = MemoryStream::Create(4, 4, 8);
 }
+
+TEST(MemoryStreamArenaTest) {
+
+    const char* data = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    const int32 dataSize = 26;
+
+    FrameArena arena(1024);
+    Ptr<MemoryStream> stream = MemoryStream::Create();
+    stream->SetArena(&arena);
+    CHECK(stream->Open(OpenMode::WriteOnly));
+    for (int32 i = 0; i < 64; i++) {
+        CHECK(stream->Write(data, dataSize) == dataSize);
+    }
+    stream->Close();
+    CHECK(stream->Size() == 64 * dataSize);
+    CHECK(arena.NumChunks() > 0);
+
+    CHECK(stream->Open(OpenMode::ReadOnly));
+    char buf[dataSize];
+    for (int32 i = 0; i < 64; i++) {
+        CHECK(stream->Read(buf, dataSize) == dataSize);
+        CHECK(0 == std::memcmp(buf, data, dataSize));
+    }
+    stream->Close();
+    stream->DiscardContent();
+    CHECK(stream->Capacity() == 0);
+}
+
+TEST(MemoryStreamAlignedTest) {
+
+    const char* data = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    const int32 dataSize = 26;
+
+    for (int32 pass = 0; pass < 2; pass++) {
+        FrameArena arena(1024);
+        Ptr<MemoryStream> stream = MemoryStream::Create();
+        if (1 == pass) {
+            stream->SetArena(&arena);
+        }
+        stream->SetAlignment(64);
+        CHECK(stream->Open(OpenMode::WriteOnly));
+        for (int32 i = 0; i < 64; i++) {
+            CHECK(stream->Write(data, dataSize) == dataSize);
+        }
+        stream->Close();
+        CHECK(stream->Open(OpenMode::ReadOnly));
+        const uint8* ptr = stream->MapRead(nullptr);
+        CHECK(Memory::IsAligned(ptr, 64));
+        CHECK(0 == std::memcmp(ptr + 63 * dataSize, data, dataSize));
+        stream->UnmapRead();
+        stream->Close();
+        stream->DiscardContent();
+    }
+}
@@ -41,7 +41,7 @@ androidInputMgr::setup(const InputSetup& setup) {
     this->sensors.Attached = true;
     OryolAndroidAppState->onInputEvent = androidInputMgr::onInputEvent;
     androidBridge::ptr()->setSensorEventCallback(this->onSensorEvent);
-    this->runLoopId = Core::PostRunLoop()->Add([this]() { this->reset(); });   
+    this->runLoopId = Core::PostRunLoop()->Add("Input", [this]() { this->reset(); });   
 }
 
 //------------------------------------------------------------------------------
@@ -47,7 +47,7 @@ glfwInputMgr::setup(const InputSetup& setup) {
     this->setCursorMode(CursorMode::Normal);
     
     // attach our reset callback to the global runloop
-    this->runLoopId = Core::PostRunLoop()->Add([this]() { this->reset(); });    
+    this->runLoopId = Core::PostRunLoop()->Add("Input", [this]() { this->reset(); });    
 }
 
 //------------------------------------------------------------------------------
@@ -92,7 +92,7 @@ iosInputMgr::setup(const InputSetup& setup) {
         if ([this->motionManager isDeviceMotionAvailable]) {
             [this->motionManager startDeviceMotionUpdates];
             this->sensors.Attached = true;
-            this->motionRunLoopId = Core::PreRunLoop()->Add([this]() { this->sampleMotionData(); });
+            this->motionRunLoopId = Core::PreRunLoop()->Add("Input::Motion", [this]() { this->sampleMotionData(); });
         }
         else {
             this->motionRunLoopId = RunLoop::InvalidId;
@@ -104,7 +104,7 @@ iosInputMgr::setup(const InputSetup& setup) {
     [glkView setTouchDelegate:this->inputDelegate];
     
     // add reset callback to post-runloop
-    this->resetRunLoopId = Core::PostRunLoop()->Add([this]() { this->reset(); });
+    this->resetRunLoopId = Core::PostRunLoop()->Add("Input", [this]() { this->reset(); });
 }
 
 //------------------------------------------------------------------------------
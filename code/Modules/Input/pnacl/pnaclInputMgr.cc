@@ -31,7 +31,7 @@ pnaclInputMgr::setup(const InputSetup& setup) {
     using namespace std::placeholders;    
     pnaclInstance::Instance()->enableInput(std::function<bool(const pp::InputEvent&)>(std::bind(&pnaclInputMgr::handleEvent, this, _1)));
 
-    this->runLoopId = Core::PostRunLoop()->Add([this]() { this->reset(); });
+    this->runLoopId = Core::PostRunLoop()->Add("Input", [this]() { this->reset(); });
 }
 
 //------------------------------------------------------------------------------
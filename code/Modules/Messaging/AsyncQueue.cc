@@ -36,12 +36,35 @@ AsyncQueue::Put(const Ptr<Message>& msg) {
 }
 
 //------------------------------------------------------------------------------
+bool
+AsyncQueue::PutBatch(const Ptr<Message>* msgs, int32 num) {
+    o_assert_dbg(msgs || (0 == num));
+    this->queue.Reserve(num);
+    for (int32 i = 0; i < num; i++) {
+        this->queue.Enqueue(msgs[i]);
+    }
+    return num > 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+ The queued messages are moved into a batch array (which keeps its
+ capacity between calls), and forwarded with PutBatch(). The batch
+ array is moved out of the object while forwarding, so that the
+ forwarding port can put new messages or call ForwardMessages()
+ again, and this repeats until the queue is empty.
+*/
 void
 AsyncQueue::ForwardMessages() {
-    if (this->forwardingPort) {
+    while (this->forwardingPort && !this->queue.Empty()) {
+        Array<Ptr<Message>> batch(std::move(this->forwardBatch));
+        batch.Reserve(this->queue.Size());
         while (!this->queue.Empty()) {
-            this->forwardingPort->Put(this->queue.Dequeue());
+            batch.Add(this->queue.Dequeue());
         }
+        this->forwardingPort->PutBatch(batch.begin(), batch.Size());
+        batch.Clear();
+        this->forwardBatch = std::move(batch);
     }
 }
 
@@ -7,10 +7,15 @@
     
     A Port which acts as a single-threaded, asynchronous, message queue.
     Incoming messages are put on a Queue, and are forwarded to the
-    attached Port when DoWork() is called.
+    attached Port when ForwardMessages() is called. The queued messages
+    are forwarded in batches with PutBatch() until the queue is empty,
+    so messages which are put while forwarding are forwarded in the
+    same call. ForwardMessages() may be re-entered from the forwarding
+    port.
 */
 #include "Messaging/Port.h"
 #include "Core/Containers/Queue.h"
+#include "Core/Containers/Array.h"
 
 namespace Oryol {
     
@@ -33,11 +38,14 @@ public:
     virtual void DoWork();
     /// put a message into the port
     virtual bool Put(const Ptr<Message>& msg) override;
-    /// explicitly forward queued messages
+    /// put an array of messages into the port
+    virtual bool PutBatch(const Ptr<Message>* msgs, int32 num) override;
+    /// explicitly forward queued messages until the queue is empty
     void ForwardMessages();
 
 protected:
     Queue<Ptr<Message>> queue;
+    Array<Ptr<Message>> forwardBatch;
     Ptr<Port> forwardingPort;
 };
 
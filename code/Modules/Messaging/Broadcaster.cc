@@ -28,6 +28,21 @@ Broadcaster::Put(const Ptr<Message>& msg) {
     return retval;
 }
 
+//------------------------------------------------------------------------------
+/**
+ NOTE: each subscriber gets the messages in the original order, but
+ the first subscriber gets all messages before the second subscriber
+ gets the first message.
+*/
+bool
+Broadcaster::PutBatch(const Ptr<Message>* msgs, int32 num) {
+    bool retval = false;
+    for (const Ptr<Port>& sub : this->subscribers) {
+        retval |= sub->PutBatch(msgs, num);
+    }
+    return retval;
+}
+
 //------------------------------------------------------------------------------
 void
 Broadcaster::DoWork() {
@@ -52,7 +67,7 @@ Broadcaster::Unsubscribe(const Ptr<Port>& port) {
 }
     
 //------------------------------------------------------------------------------
-const Array<Ptr<Port>>&
+const InlineArray<Ptr<Port>, 4>&
 Broadcaster::GetSubscribers() const {
     return this->subscribers;
 }
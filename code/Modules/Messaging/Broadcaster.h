@@ -6,9 +6,12 @@
     @brief broadcast incoming messages to subscriber ports
     
     A Messaging Port which sends an incoming message to any number
-    of subscriber Ports.
+    of subscriber Ports. Most Broadcasters only have a handful of
+    subscribers, so the first few are stored inline without
+    allocating memory.
 */
 #include "Messaging/Port.h"
+#include "Core/Containers/InlineArray.h"
 
 namespace Oryol {
     
@@ -24,16 +27,18 @@ public:
     void Subscribe(const Ptr<Port>& port);
     /// unsubscribe from this port
     void Unsubscribe(const Ptr<Port>& port);
-    /// get subscribers
-    const Array<Ptr<Port>>& GetSubscribers() const;
+    /// get subscribers (NOTE: returned an Array<Ptr<Port>> before subscribers were stored inline)
+    const InlineArray<Ptr<Port>, 4>& GetSubscribers() const;
 
     /// put a message into the port
     virtual bool Put(const Ptr<Message>& msg) override;
+    /// put an array of messages into the port (the whole batch goes to one subscriber after the other)
+    virtual bool PutBatch(const Ptr<Message>* msgs, int32 num) override;
     /// perform work, this will be invoked on downstream ports
     virtual void DoWork();
     
 protected:
-    Array<Ptr<Port>> subscribers;
+    InlineArray<Ptr<Port>, 4> subscribers;
 };
     
 } // namespace Oryol
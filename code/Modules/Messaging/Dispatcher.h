@@ -39,6 +39,8 @@ public:
     
     /// put a message into the port
     virtual bool Put(const Ptr<Message>& msg) override;
+    /// put an array of messages into the port
+    virtual bool PutBatch(const Ptr<Message>* msgs, int32 num) override;
     
     /// bind a function to a message
     template<class MSG> void Subscribe(std::function<void(const Ptr<MSG>&)> func);
@@ -46,6 +48,9 @@ public:
     template<class MSG> void Unsubscribe();
     
 private:
+    /// call the handler function for a message, return false if no handler exists
+    bool dispatch(const Ptr<Message>& msg);
+
     HandlerFunc jumpTable[PROTOCOL::MessageId::NumMessageIds];
 };
 
@@ -63,7 +68,7 @@ Dispatcher<PROTOCOL>::~Dispatcher() {
 
 //------------------------------------------------------------------------------
 template<class PROTOCOL> bool
-Dispatcher<PROTOCOL>::Put(const Ptr<Message>& msg) {
+Dispatcher<PROTOCOL>::dispatch(const Ptr<Message>& msg) {
     // only consider messages of our protocol, ignore others
     if (msg->IsMemberOf(PROTOCOL::GetProtocolId())) {
     
@@ -80,6 +85,23 @@ Dispatcher<PROTOCOL>::Put(const Ptr<Message>& msg) {
     return false;
 }
 
+//------------------------------------------------------------------------------
+template<class PROTOCOL> bool
+Dispatcher<PROTOCOL>::Put(const Ptr<Message>& msg) {
+    return this->dispatch(msg);
+}
+
+//------------------------------------------------------------------------------
+template<class PROTOCOL> bool
+Dispatcher<PROTOCOL>::PutBatch(const Ptr<Message>* msgs, int32 num) {
+    o_assert_dbg(msgs || (0 == num));
+    bool retval = false;
+    for (int32 i = 0; i < num; i++) {
+        retval |= this->dispatch(msgs[i]);
+    }
+    return retval;
+}
+
 //------------------------------------------------------------------------------
 template<class PROTOCOL> template<class MSG> void
 Dispatcher<PROTOCOL>::Subscribe(std::function<void(const Ptr<MSG>&)> func) {
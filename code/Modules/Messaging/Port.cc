@@ -24,6 +24,17 @@ Port::Put(const Ptr<Message>& msg) {
     return false;
 }
 
+//------------------------------------------------------------------------------
+bool
+Port::PutBatch(const Ptr<Message>* msgs, int32 num) {
+    o_assert_dbg(msgs || (0 == num));
+    bool retval = false;
+    for (int32 i = 0; i < num; i++) {
+        retval |= this->Put(msgs[i]);
+    }
+    return retval;
+}
+
 //------------------------------------------------------------------------------
 void
 Port::DoWork() {
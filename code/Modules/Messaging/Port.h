@@ -16,6 +16,13 @@
     
     By default, Messages are forwarded through smart pointers, encoding/decoding
     will only happen when process boundaries are crossed.
+
+    PutBatch() puts an array of messages into the port with one call,
+    the default implementation calls Put() for each message, subclasses
+    override it to handle the whole batch at once (for instance
+    ThreadedQueue hands the batch to its thread with a single
+    queue operation and wakes the thread only once). The order of
+    messages within a batch is always preserved.
 */
 #include "Core/RefCounted.h"
 #include "Core/String/StringAtom.h"
@@ -33,6 +40,8 @@ public:
 
     /// put a message into the port
     virtual bool Put(const Ptr<Message>& msg);
+    /// put an array of messages into the port, returns true if any message was handled
+    virtual bool PutBatch(const Ptr<Message>* msgs, int32 num);
     /// perform work, this will be invoked on downstream ports
     virtual void DoWork();
 };
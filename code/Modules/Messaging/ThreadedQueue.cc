@@ -16,9 +16,11 @@ OryolClassPoolAllocImpl(ThreadedQueue);
  subclasses constructor!
 */
 ThreadedQueue::ThreadedQueue() :
+mode(Immediate),
 tickDuration(0),
-threadStarted(false),
+workerParked(false),
 threadStopRequested(false),
+threadStarted(false),
 threadStopped(false) {
     #if ORYOL_HAS_THREADS
         this->createThreadId = std::this_thread::get_id();
@@ -27,10 +29,12 @@ threadStopped(false) {
 
 //------------------------------------------------------------------------------
 ThreadedQueue::ThreadedQueue(const Ptr<Port>& port_) :
+mode(Immediate),
 tickDuration(0),
 forwardingPort(port_),
-threadStarted(false),
+workerParked(false),
 threadStopRequested(false),
+threadStarted(false),
 threadStopped(false) {
     #if ORYOL_HAS_THREADS
         this->createThreadId = std::this_thread::get_id();
@@ -43,6 +47,19 @@ ThreadedQueue::~ThreadedQueue() {
     o_assert(this->threadStopped);
 }
 
+//------------------------------------------------------------------------------
+void
+ThreadedQueue::SetMode(Mode mode_) {
+    o_assert(!this->threadStarted);
+    this->mode = mode_;
+}
+
+//------------------------------------------------------------------------------
+ThreadedQueue::Mode
+ThreadedQueue::GetMode() const {
+    return this->mode;
+}
+
 //------------------------------------------------------------------------------
 /**
  If a tick-duration is set, the thread will wakeup after this duration
@@ -82,7 +99,10 @@ ThreadedQueue::StopThread() {
     o_assert(this->threadStarted);
     this->threadStopRequested = true;
     #if ORYOL_HAS_THREADS
-        this->wakeup.notify_one();
+        {
+            std::lock_guard<std::mutex> lock(this->wakeupMutex);
+            this->wakeup.notify_one();
+        }
         this->thread.join();
     #else
         this->onThreadLeave();
@@ -91,36 +111,92 @@ ThreadedQueue::StopThread() {
 }
 
 //------------------------------------------------------------------------------
+/**
+ In Immediate mode, this can be called from any thread. The worker thread
+ is only woken up if it is parked (this is a Dekker-style handshake:
+ the worker sets workerParked and then checks the queue, Put() pushes
+ to the queue and then checks workerParked, so at least one of them
+ sees the other's write).
+*/
 bool
 ThreadedQueue::Put(const Ptr<Message>& msg) {
-    o_assert(this->isCreateThread());
     o_assert(this->threadStarted);
     o_assert(!this->threadStopped);
-    this->writeQueue.Enqueue(msg);
+    if (Immediate == this->mode) {
+        this->inQueue.Enqueue(msg);
+        this->wakeupWorker();
+    }
+    else {
+        o_assert(this->isCreateThread());
+        this->writeQueue.Enqueue(msg);
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+ In Immediate mode, the whole batch is published with one atomic
+ operation, and the worker thread is woken up at most once. In Batched
+ mode the messages are appended to the write queue, which is handed
+ to the worker thread in DoWork() anyway.
+*/
+bool
+ThreadedQueue::PutBatch(const Ptr<Message>* msgs, int32 num) {
+    o_assert(this->threadStarted);
+    o_assert(!this->threadStopped);
+    if (num <= 0) {
+        return false;
+    }
+    if (Immediate == this->mode) {
+        this->inQueue.EnqueueBatch(msgs, num);
+        this->wakeupWorker();
+    }
+    else {
+        o_assert(this->isCreateThread());
+        this->writeQueue.Reserve(num);
+        for (int32 i = 0; i < num; i++) {
+            this->writeQueue.Enqueue(msgs[i]);
+        }
+    }
     return true;
 }
 
+//------------------------------------------------------------------------------
+void
+ThreadedQueue::wakeupWorker() {
+    #if ORYOL_HAS_THREADS
+    if (this->workerParked.load() && this->workerParked.exchange(false)) {
+        std::lock_guard<std::mutex> lock(this->wakeupMutex);
+        this->wakeup.notify_one();
+    }
+    #endif
+}
+
 //------------------------------------------------------------------------------
 void
 ThreadedQueue::DoWork() {
-    // move messages to transfer queue and wake up thread
     o_assert(this->isCreateThread());
     o_assert(this->threadStarted);
     o_assert(!this->threadStopped);
-    if (!this->writeQueue.Empty()) {
-        this->moveWriteToTransferQueue();
-    }
-    // signal the worker thread even if no messages have to be processed,
-    // this is to prevent any messages getting stuck on the transfer queue
     #if ORYOL_HAS_THREADS
-        this->wakeup.notify_one();
+        // move messages to transfer queue and wake up thread, but only
+        // if there are messages, the worker thread checks the transfer
+        // queue under the same lock before it goes to sleep
+        if ((Batched == this->mode) && !this->writeQueue.Empty()) {
+            this->moveWriteToTransferQueue();
+        }
     #else
-        // if no threads are available, we pump the message queue right
-        // here
-        // FIXME: we could do without all those queue transfers here!
-        this->moveTransferToReadQueue();
-        while (!this->readQueue.Empty()) {
-            this->onMessage(std::move(this->readQueue.Dequeue()));
+        // if no threads are available, we pump the message queue right here
+        Ptr<Message> msg;
+        if (Immediate == this->mode) {
+            while (this->inQueue.TryDequeue(msg)) {
+                this->onMessage(msg);
+            }
+        }
+        else {
+            while (!this->writeQueue.Empty()) {
+                this->onMessage(this->writeQueue.Dequeue());
+            }
         }
         this->onTick();
     #endif
@@ -150,10 +226,10 @@ ThreadedQueue::isWorkerThread() {
 void
 ThreadedQueue::moveWriteToTransferQueue() {
     o_assert(this->isCreateThread());
-    // if the transfer queue is empty, we can do a very fast complete move
     #if ORYOL_HAS_THREADS
-        this->transferQueueLock.lock();
+        std::lock_guard<std::mutex> lock(this->wakeupMutex);
     #endif
+    // if the transfer queue is empty, we can do a very fast complete move
     if (this->transferQueue.Empty()) {
         this->transferQueue = std::move(this->writeQueue);
     }
@@ -164,7 +240,7 @@ ThreadedQueue::moveWriteToTransferQueue() {
         }
     }
     #if ORYOL_HAS_THREADS
-        this->transferQueueLock.unlock();
+        this->wakeup.notify_one();
     #endif
 }
 
@@ -173,13 +249,7 @@ void
 ThreadedQueue::moveTransferToReadQueue() {
     o_assert(this->isWorkerThread());
     o_assert(this->readQueue.Empty());
-    #if ORYOL_HAS_THREADS
-        this->transferQueueLock.lock();
-    #endif
     this->readQueue = std::move(this->transferQueue);
-    #if ORYOL_HAS_THREADS
-        this->transferQueueLock.unlock();
-    #endif
 }
 
 //------------------------------------------------------------------------------
@@ -194,30 +264,81 @@ ThreadedQueue::threadFunc(ThreadedQueue* self) {
     
     // the message processing loop waits for messages to arrive,
     // and forwards them to the forwardingPort
-    while (!self->threadStopRequested) {
+    if (Immediate == self->mode) {
+        self->immediateLoop();
+    }
+    else {
+        self->batchedLoop();
+    }
+    
+    // notify subclass that we're about to leave the thread
+    self->onThreadLeave();
+}
+
+//------------------------------------------------------------------------------
+void
+ThreadedQueue::immediateLoop() {
+    Ptr<Message> msg;
+    while (!this->threadStopRequested) {
+        
+        // process all pending messages without locking
+        while (this->inQueue.TryDequeue(msg)) {
+            this->onMessage(msg);
+        }
+        msg = nullptr;
+        this->onTick();
+        
+        // only park the thread if the queue is really empty, Empty()
+        // also sees messages which are in the middle of being pushed
+        this->workerParked = true;
+        if (!this->inQueue.Empty()) {
+            this->workerParked = false;
+            std::this_thread::yield();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(this->wakeupMutex);
+        auto wakeupCond = [this] {
+            return !this->workerParked || this->threadStopRequested;
+        };
+        if (0 != this->tickDuration) {
+            // wait with timeout
+            this->wakeup.wait_for(lock, std::chrono::milliseconds(this->tickDuration), wakeupCond);
+        }
+        else {
+            // wait infinitely for messages
+            this->wakeup.wait(lock, wakeupCond);
+        }
+        this->workerParked = false;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ThreadedQueue::batchedLoop() {
+    while (!this->threadStopRequested) {
 
         // wait for messages to arrive, and if so, transfer to read queue
-        std::unique_lock<std::mutex> lock(self->wakeupMutex);
-        if (0 != self->tickDuration) {
+        std::unique_lock<std::mutex> lock(this->wakeupMutex);
+        auto wakeupCond = [this] {
+            return !this->transferQueue.Empty() || this->threadStopRequested;
+        };
+        if (0 != this->tickDuration) {
             // wait with timeout
-            self->wakeup.wait_for(lock, std::chrono::milliseconds(self->tickDuration));
+            this->wakeup.wait_for(lock, std::chrono::milliseconds(this->tickDuration), wakeupCond);
         }
         else {
             // wait infinitely for messages
-            self->wakeup.wait(lock);
+            this->wakeup.wait(lock, wakeupCond);
         }
-        self->moveTransferToReadQueue();
+        this->moveTransferToReadQueue();
         lock.unlock();
         
         // now process the messages, this happens without locking
-        while (!self->readQueue.Empty()) {
-            self->onMessage(std::move(self->readQueue.Dequeue()));
+        while (!this->readQueue.Empty()) {
+            this->onMessage(std::move(this->readQueue.Dequeue()));
         }
-        self->onTick();
+        this->onTick();
     }
-    
-    // notify subclass that we're about to leave the thread
-    self->onThreadLeave();
 }
 #endif
 
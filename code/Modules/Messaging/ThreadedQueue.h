@@ -9,22 +9,35 @@
     a thread and forward messages to it. The forwarding port is running
     on the thread.
     
-    The ThreadedQueue port will try to minimize locking by using 3
-    internal queues: the write queue, the transfer queue and the read queue.
+    The ThreadedQueue has 2 modes of operation:
     
-    Calling Put() will put a message on the write queue without locking.
-    When DoWork() is called (usually once per frame), the sender thread
-    will lock the transfer queue, push all messages from the write queue 
-    on it, and signal the work thread. The work thread will wake up, 
-    lock the transfer queue, move all messages from the transfer queue 
-    to the read queue, and unlock the transfer queue again. It will then
-    process messages from the read queue without locking.  When the read queue
-    is empty it will check the transfer queue for more messages, and if this
-    is empty, go to sleep.
+    In the default Immediate mode, Put() can be called from any thread.
+    Messages are pushed on a lock-free multi-producer/single-consumer
+    queue, and the work thread handles them as soon as they arrive.
+    The work thread only goes to sleep when the queue is empty, and
+    Put() only needs to wake it up (by locking a mutex and signalling
+    a condition variable) if it is sleeping, so the wakeup cost depends
+    on the message traffic, not on the frame rate. DoWork() does
+    nothing in Immediate mode (except on platforms without threads).
+    
+    In Batched mode, Put() can only be called from the thread which
+    created the ThreadedQueue, messages are collected on a write queue
+    without locking, and handed over to the work thread as one batch
+    in DoWork() (usually once per frame): the sender thread locks the
+    transfer queue, moves all messages from the write queue to the
+    transfer queue, and signals the work thread (only if there were
+    any messages). The work thread moves all messages from the transfer
+    queue to its read queue, and processes them without locking.
+    
+    In both modes, onTick() is called on the work thread after each
+    batch of messages, and every TickDuration milliseconds if a tick
+    duration is set.
 */
 #include "Core/Config.h"
 #include "Messaging/Port.h"
 #include "Core/Containers/Queue.h"
+#include "Core/Containers/MPSCQueue.h"
+#include <atomic>
 #if ORYOL_HAS_THREADS
 #include <thread>
 #include <mutex>
@@ -36,6 +49,14 @@ namespace Oryol {
 class ThreadedQueue : public Port {
     OryolClassPoolAllocDecl(ThreadedQueue);
 public:
+    /// message forwarding modes
+    enum Mode {
+        /// Put() from any thread, messages are handled as soon as possible
+        Immediate,
+        /// Put() only from the creation thread, messages are forwarded in DoWork()
+        Batched,
+    };
+
     /// default constructor (must setup forwardingPort in subclass!)
     ThreadedQueue();
     /// constructor with forwarding port
@@ -43,6 +64,10 @@ public:
     /// destructor
     virtual ~ThreadedQueue();
     
+    /// set the forwarding mode (default is Immediate), must be called before StartThread()
+    void SetMode(Mode mode);
+    /// get the forwarding mode
+    Mode GetMode() const;
     /// set optional tick-duration in millsecs, thread will wake up even if no messages pending
     void SetTickDuration(uint32 milliSecs);
     /// get optional tick-rate in millisecs
@@ -53,6 +78,8 @@ public:
     virtual void StopThread();
     /// put a message into the port
     virtual bool Put(const Ptr<Message>& msg) override;
+    /// put an array of messages into the port, wakes the work thread at most once
+    virtual bool PutBatch(const Ptr<Message>* msgs, int32 num) override;
     /// perform work, this will be invoked on downstream ports
     virtual void DoWork();
 
@@ -60,6 +87,10 @@ protected:
     /// the thread entry function
     #if ORYOL_HAS_THREADS
     static void threadFunc(ThreadedQueue* self);
+    /// the work thread loop in Immediate mode
+    void immediateLoop();
+    /// the work thread loop in Batched mode
+    void batchedLoop();
     #endif
     /// test if we are on the creation-thread
     bool isCreateThread();
@@ -73,12 +104,16 @@ protected:
     virtual void onTick();
     /// called in thread before thread is left
     virtual void onThreadLeave();
-    /// move messages from the write queue to the transfer queue
+    /// move messages from the write queue to the transfer queue (Batched mode)
     void moveWriteToTransferQueue();
-    /// move messages from transfer queue to read queue
+    /// move messages from transfer queue to read queue (Batched mode, wakeupMutex must be locked)
     void moveTransferToReadQueue();
+    /// wake up the work thread if it is parked (Immediate mode)
+    void wakeupWorker();
     
+    Mode mode;
     uint32 tickDuration;
+    MPSCQueue<Ptr<Message>> inQueue;    // written by any thread, read by worker thread (Immediate mode)
     Queue<Ptr<Message>> writeQueue;     // written by sender thread
     Queue<Ptr<Message>> transferQueue;  // written by sender, read by worker thread (locked)
     Queue<Ptr<Message>> readQueue;      // read by worker thread
@@ -88,12 +123,12 @@ protected:
     std::thread::id createThreadId;
     std::thread::id workThreadId;
     std::thread thread;
-    std::mutex transferQueueLock;
     std::mutex wakeupMutex;
     std::condition_variable wakeup;
     #endif
+    std::atomic<bool> workerParked;
+    std::atomic<bool> threadStopRequested;
     bool threadStarted;
-    bool threadStopRequested;
     bool threadStopped;
 };
     
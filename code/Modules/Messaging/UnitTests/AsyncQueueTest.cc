@@ -4,6 +4,7 @@
 #include "Pre.h"
 #include "UnitTest++/src/UnitTest++.h"
 #include "Messaging/AsyncQueue.h"
+#include "Messaging/Broadcaster.h"
 #include "Messaging/Dispatcher.h"
 #include "Messaging/UnitTests/TestProtocol.h"
 
@@ -20,6 +21,19 @@ static void MsgHandler2(const Ptr<TestProtocol::TestMsg2>& msg) {
     msg->SetHandled();
 }
 
+static Ptr<AsyncQueue> reentrantQueue;
+static int reentrantCount = 0;
+static void ReentrantHandler(const Ptr<TestProtocol::TestMsg1>& msg) {
+    reentrantCount++;
+    msg->SetHandled();
+    if (reentrantCount < 3) {
+        reentrantQueue->Put(TestProtocol::TestMsg1::Create());
+    }
+    if (1 == reentrantCount) {
+        reentrantQueue->ForwardMessages();
+    }
+}
+
 TEST(AsyncQueueTest) {
     
     // create an uncapped async queue port and set a dispatcher port as
@@ -50,3 +64,59 @@ TEST(AsyncQueueTest) {
     CHECK(val0 == 2);
     CHECK(val1 == 2);
 }
+
+TEST(AsyncQueuePutBatchTest) {
+    val0 = 0;
+    val1 = 0;
+
+    // async queue -> broadcaster -> 2 dispatchers, the batch should
+    // go through the whole chain
+    Ptr<AsyncQueue> asyncQueue = AsyncQueue::Create();
+    Ptr<Broadcaster> broadcaster = Broadcaster::Create();
+    Ptr<Dispatcher<TestProtocol>> dispatcher0 = Dispatcher<TestProtocol>::Create();
+    dispatcher0->Subscribe<TestProtocol::TestMsg1>(&MsgHandler1);
+    Ptr<Dispatcher<TestProtocol>> dispatcher1 = Dispatcher<TestProtocol>::Create();
+    dispatcher1->Subscribe<TestProtocol::TestMsg2>(&MsgHandler2);
+    broadcaster->Subscribe(dispatcher0);
+    broadcaster->Subscribe(dispatcher1);
+    asyncQueue->SetForwardingPort(broadcaster);
+
+    Ptr<Message> msgs[] = {
+        TestProtocol::TestMsg1::Create(),
+        TestProtocol::TestMsg2::Create(),
+        TestProtocol::TestMsg1::Create(),
+    };
+    CHECK(!asyncQueue->PutBatch(msgs, 0));
+    CHECK(asyncQueue->PutBatch(msgs, 3));
+    CHECK(asyncQueue->Put(TestProtocol::TestMsg2::Create()));
+    CHECK(asyncQueue->GetNumQueuedMessages() == 4);
+    CHECK(val0 == 0);
+    CHECK(val1 == 0);
+    asyncQueue->ForwardMessages();
+    CHECK(asyncQueue->GetNumQueuedMessages() == 0);
+    CHECK(val0 == 2);
+    CHECK(val1 == 2);
+    for (const auto& msg : msgs) {
+        CHECK(msg->Handled());
+    }
+
+    // a dispatcher without matching handlers doesn't handle the batch
+    Ptr<Dispatcher<TestProtocol>> emptyDispatcher = Dispatcher<TestProtocol>::Create();
+    CHECK(!emptyDispatcher->PutBatch(msgs, 3));
+    CHECK(dispatcher1->PutBatch(msgs, 3));
+    CHECK(val1 == 3);
+}
+
+TEST(AsyncQueueReentrantTest) {
+    // messages put while forwarding are forwarded in the same call,
+    // and ForwardMessages() may be called from the forwarding port
+    reentrantQueue = AsyncQueue::Create();
+    Ptr<Dispatcher<TestProtocol>> dispatcher = Dispatcher<TestProtocol>::Create();
+    dispatcher->Subscribe<TestProtocol::TestMsg1>(&ReentrantHandler);
+    reentrantQueue->SetForwardingPort(dispatcher);
+    CHECK(reentrantQueue->Put(TestProtocol::TestMsg1::Create()));
+    reentrantQueue->ForwardMessages();
+    CHECK(reentrantCount == 3);
+    CHECK(reentrantQueue->GetNumQueuedMessages() == 0);
+    reentrantQueue = nullptr;
+}
@@ -6,8 +6,10 @@
 #include "Messaging/ThreadedQueue.h"
 #include "Messaging/Dispatcher.h"
 #include "Messaging/UnitTests/TestProtocol.h"
+#include "Core/Containers/Array.h"
 #include <chrono>
 #include <thread>
+#include <atomic>
 
 using namespace Oryol;
 using namespace std::chrono;
@@ -26,7 +28,11 @@ static void HandleTestMsg2(const Ptr<TestProtocol::TestMsg2>& msg) {
     msg->SetHandled();
 }
 
-TEST(ThreadedQueueTest) {
+//------------------------------------------------------------------------------
+static void
+testThreadedQueue(ThreadedQueue::Mode mode) {
+    value0 = 0;
+    value1 = 0;
 
     // create a Dispatcher port, this will run in the worker thread!
     Ptr<Dispatcher<TestProtocol>> disp = Dispatcher<TestProtocol>::Create();
@@ -35,6 +41,8 @@ TEST(ThreadedQueueTest) {
     
     // create a ThreadedQueue port and attach dispatcher to it
     Ptr<ThreadedQueue> threadedQueue = ThreadedQueue::Create(disp);
+    threadedQueue->SetMode(mode);
+    CHECK(threadedQueue->GetMode() == mode);
     threadedQueue->StartThread();
     
     // send messages, these should be queued up
@@ -70,10 +78,168 @@ TEST(ThreadedQueueTest) {
     CHECK(value0 == 1000000);
     end = system_clock::now();
     duration<double> dur = end - start;
-    Log::Info("ThreadedQueue: 1000000 msgs created and handled: %f sec\n", dur.count());
+    Log::Info("ThreadedQueue (%s): 1000000 msgs created and handled: %f sec\n",
+        mode == ThreadedQueue::Immediate ? "Immediate" : "Batched", dur.count());
     
     // shutdown the threaded queue
     threadedQueue->StopThread();
     threadedQueue = 0;
 }
 
+//------------------------------------------------------------------------------
+TEST(ThreadedQueueTest) {
+    testThreadedQueue(ThreadedQueue::Batched);
+    testThreadedQueue(ThreadedQueue::Immediate);
+}
+
+//------------------------------------------------------------------------------
+TEST(ThreadedQueueMultiProducer) {
+    // in Immediate mode, any thread can put messages into the queue
+    value0 = 0;
+    Ptr<Dispatcher<TestProtocol>> disp = Dispatcher<TestProtocol>::Create();
+    disp->Subscribe<TestProtocol::TestMsg1>(&HandleTestMsg1);
+    Ptr<ThreadedQueue> threadedQueue = ThreadedQueue::Create(disp);
+    threadedQueue->StartThread();
+
+    const int32 numThreads = 4;
+    const int32 numMsgs = 10000;
+    Array<std::thread> threads;
+    for (int32 t = 0; t < numThreads; t++) {
+        threads.Add(std::thread([threadedQueue, numMsgs]() {
+            Ptr<TestProtocol::TestMsg1> msg;
+            for (int32 i = 0; i < numMsgs; i++) {
+                msg = TestProtocol::TestMsg1::Create();
+                threadedQueue->Put(msg);
+                // give the worker thread a chance to go to sleep
+                if (0 == (i % 1000)) {
+                    std::this_thread::sleep_for(microseconds(100));
+                }
+            }
+            while (!msg->Handled()) {
+                std::this_thread::yield();
+            }
+        }));
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    // the last message of each thread has been handled, but messages
+    // from other threads may still be pending
+    Ptr<TestProtocol::TestMsg1> last = TestProtocol::TestMsg1::Create();
+    threadedQueue->Put(last);
+    while (!last->Handled()) {
+        std::this_thread::yield();
+    }
+    CHECK(value0 == numThreads * numMsgs + 1);
+    threadedQueue->StopThread();
+}
+
+//------------------------------------------------------------------------------
+TEST(ThreadedQueuePutBatch) {
+    Ptr<Dispatcher<TestProtocol>> disp = Dispatcher<TestProtocol>::Create();
+    disp->Subscribe<TestProtocol::TestMsg1>(&HandleTestMsg1);
+    disp->Subscribe<TestProtocol::TestMsg2>(&HandleTestMsg2);
+    for (int32 m = 0; m < 2; m++) {
+        value0 = 0;
+        value1 = 0;
+        Ptr<ThreadedQueue> threadedQueue = ThreadedQueue::Create(disp);
+        threadedQueue->SetMode((0 == m) ? ThreadedQueue::Batched : ThreadedQueue::Immediate);
+        threadedQueue->StartThread();
+        const int32 numMsgs = 100;
+        Array<Ptr<Message>> msgs;
+        for (int32 i = 0; i < numMsgs; i++) {
+            if (i & 1) {
+                msgs.Add(TestProtocol::TestMsg2::Create());
+            }
+            else {
+                msgs.Add(TestProtocol::TestMsg1::Create());
+            }
+        }
+        CHECK(!threadedQueue->PutBatch(msgs.begin(), 0));
+        CHECK(threadedQueue->PutBatch(msgs.begin(), msgs.Size()));
+        while (!msgs.Back()->Handled()) {
+            threadedQueue->DoWork();
+            std::this_thread::yield();
+        }
+        CHECK(value0 == numMsgs / 2);
+        CHECK(value1 == numMsgs / 2);
+        threadedQueue->StopThread();
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST(ThreadedQueueBenchmark) {
+    Ptr<Dispatcher<TestProtocol>> disp = Dispatcher<TestProtocol>::Create();
+    disp->Subscribe<TestProtocol::TestMsg1>(&HandleTestMsg1);
+    for (int32 m = 0; m < 2; m++) {
+        const ThreadedQueue::Mode mode = (0 == m) ? ThreadedQueue::Batched : ThreadedQueue::Immediate;
+        const char* modeName = (0 == m) ? "Batched" : "Immediate";
+        Ptr<ThreadedQueue> threadedQueue = ThreadedQueue::Create(disp);
+        threadedQueue->SetMode(mode);
+        threadedQueue->StartThread();
+
+        // latency: time from Put() until the message has been handled,
+        // (the worker thread sleeps between messages), in Batched mode
+        // the sender calls DoWork() right after Put()
+        const int32 numLatencyMsgs = 1000;
+        double sumLatency = 0.0;
+        double maxLatency = 0.0;
+        for (int32 i = 0; i < numLatencyMsgs; i++) {
+            Ptr<TestProtocol::TestMsg1> msg = TestProtocol::TestMsg1::Create();
+            time_point<high_resolution_clock> start = high_resolution_clock::now();
+            threadedQueue->Put(msg);
+            threadedQueue->DoWork();
+            while (!msg->Handled()) {
+                // spinning...
+            }
+            duration<double, std::micro> dur = high_resolution_clock::now() - start;
+            sumLatency += dur.count();
+            maxLatency = dur.count() > maxLatency ? dur.count() : maxLatency;
+            std::this_thread::sleep_for(microseconds(50));
+        }
+        Log::Info("ThreadedQueue (%s): latency avg %.2f usec, max %.2f usec\n",
+            modeName, sumLatency / numLatencyMsgs, maxLatency);
+
+        // throughput: messages from one thread, DoWork() once per 100 messages
+        const int32 numMsgs = 200000;
+        time_point<high_resolution_clock> start = high_resolution_clock::now();
+        Ptr<TestProtocol::TestMsg1> msg;
+        for (int32 i = 0; i < numMsgs; i++) {
+            msg = TestProtocol::TestMsg1::Create();
+            threadedQueue->Put(msg);
+            if (0 == (i % 100)) {
+                threadedQueue->DoWork();
+            }
+        }
+        while (!msg->Handled()) {
+            threadedQueue->DoWork();
+            std::this_thread::yield();
+        }
+        duration<double> dur = high_resolution_clock::now() - start;
+        Log::Info("ThreadedQueue (%s): %d msgs: %f sec (%.0f msgs/sec)\n",
+            modeName, numMsgs, dur.count(), numMsgs / dur.count());
+
+        // same with PutBatch(), 100 messages per batch
+        const int32 batchSize = 100;
+        Array<Ptr<Message>> batch;
+        batch.Reserve(batchSize);
+        start = high_resolution_clock::now();
+        for (int32 i = 0; i < numMsgs; i += batchSize) {
+            for (int32 j = 0; j < batchSize; j++) {
+                batch.Add(TestProtocol::TestMsg1::Create());
+            }
+            threadedQueue->PutBatch(batch.begin(), batch.Size());
+            threadedQueue->DoWork();
+            msg = batch.Back();
+            batch.Clear();
+        }
+        while (!msg->Handled()) {
+            threadedQueue->DoWork();
+            std::this_thread::yield();
+        }
+        dur = high_resolution_clock::now() - start;
+        Log::Info("ThreadedQueue (%s): %d msgs with PutBatch(): %f sec (%.0f msgs/sec)\n",
+            modeName, numMsgs, dur.count(), numMsgs / dur.count());
+        threadedQueue->StopThread();
+    }
+}
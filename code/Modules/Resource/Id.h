@@ -8,6 +8,7 @@
     Resource identifiers are abstract handles to a resource object.
 */
 #include "Core/Types.h"
+#include "Core/Traits.h"
 
 namespace Oryol {
     
@@ -151,6 +152,16 @@ Id::Invalidate() {
     this->id = this->makeId(InvalidUniqueStamp, InvalidSlotIndex, InvalidType);
 }
 
+//------------------------------------------------------------------------------
+/// Ids are ordered by their 64-bit value, so they can be radix-sorted
+template<> struct RadixSortKey<Id> {
+    static const bool IsValid = true;
+    typedef uint64 Type;
+    static Type Get(const Id& id) {
+        return (uint64(id.Type()) << 48) | (uint64(id.UniqueStamp()) << 16) | id.SlotIndex();
+    };
+};
+
 } // namespace Oryol
     
  
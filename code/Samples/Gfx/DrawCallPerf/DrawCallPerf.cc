@@ -16,32 +16,45 @@
 
 using namespace Oryol;
 
+// the app runs in pipelined mode: OnUpdate() computes the next frame
+// on the update thread while OnRunning() renders the current frame,
+// all data written by the update is double-buffered, a frame only
+// references one of the two particle buffers so that a paused
+// particle update doesn't need to copy the particles around
 class DrawCallPerfApp : public App {
 public:
     AppState::Code OnRunning();
     AppState::Code OnInit();
     AppState::Code OnCleanup();
+    void OnSync();
+    void OnUpdate(int32 bufferIndex);
     
 private:
-    void updateCamera();
-    void emitParticles();
-    void updateParticles();
+    void updateCamera(int32 bufferIndex);
+    void emitParticles(int32 bufferIndex);
+    void updateParticles(int32 bufferIndex);
 
     GfxId drawState;
     glm::mat4 view;
     glm::mat4 proj;
     glm::mat4 model;
-    glm::mat4 modelViewProj;
     bool updateEnabled = true;    
+    bool toggleUpdate = false;
     int32 frameCount = 0;
-    int32 curNumParticles = 0;
     TimePoint lastFrameTimePoint;
     static const int32 NumParticlesEmittedPerFrame = 100;
     static const int32 MaxNumParticles = 1024 * 1024;
-    struct {
+    struct particle {
         glm::vec4 pos;
         glm::vec4 vec;
-    } particles[MaxNumParticles];
+    };
+    struct frameData {
+        glm::mat4 modelViewProj;
+        int32 numParticles = 0;
+        int32 particleBuffer = 0;
+        Duration updTime;
+    } frames[FramePipeline::NumBuffers];
+    particle particleBuffers[2][MaxNumParticles];
 };
 OryolMain(DrawCallPerfApp);
 
@@ -49,45 +62,36 @@ OryolMain(DrawCallPerfApp);
 AppState::Code
 DrawCallPerfApp::OnRunning() {
     
-    Duration updTime, drawTime;
-    this->frameCount++;
-    
-    // update block
-    this->updateCamera();
-    if (this->updateEnabled) {
-        TimePoint updStart = Clock::Now();
-        this->emitParticles();
-        this->updateParticles();
-        updTime = Clock::Since(updStart);
-    }
-    
-    // render block
+    // render the frame data computed by the previous OnUpdate(), the
+    // update of the next frame runs in parallel
+    const frameData& frame = this->frames[this->RenderBufferIndex()];
+    const particle* particles = this->particleBuffers[frame.particleBuffer];
     TimePoint drawStart = Clock::Now();
     Gfx::ApplyDefaultRenderTarget();
     Gfx::Clear(PixelChannel::All, glm::vec4(0.0f));
     Gfx::ApplyDrawState(this->drawState);
-    Gfx::ApplyVariable(Shaders::Main::ModelViewProjection, this->modelViewProj);
-    for (int32 i = 0; i < this->curNumParticles; i++) {
-        Gfx::ApplyVariable(Shaders::Main::ParticleTranslate, this->particles[i].pos);
+    Gfx::ApplyVariable(Shaders::Main::ModelViewProjection, frame.modelViewProj);
+    for (int32 i = 0; i < frame.numParticles; i++) {
+        Gfx::ApplyVariable(Shaders::Main::ParticleTranslate, particles[i].pos);
         Gfx::Draw(0);
     }
-    drawTime = Clock::Since(drawStart);
+    Duration drawTime = Clock::Since(drawStart);
     
     Dbg::DrawTextBuffer();
     Gfx::CommitFrame();
 
-    // toggle particle update
+    // toggle particle update (handed to the update thread in OnSync())
     const Mouse& mouse = Input::Mouse();
     if (mouse.Attached && mouse.ButtonDown(Mouse::Button::LMB)) {
-        this->updateEnabled = !this->updateEnabled;
+        this->toggleUpdate = true;
     }
     
     Duration frameTime = Clock::LapTime(this->lastFrameTimePoint);
     Dbg::TextColor(glm::vec4(1.0f, 1.0f, 0.0f, 1.0f));
     Dbg::PrintF("\n %d draws\n\r upd=%.3fms\n\r draw=%.3fms\n\r frame=%.3fms\n\r"
                 " LMB/tap: toggle particle update",
-                this->curNumParticles,
-                updTime.AsMilliSeconds(),
+                frame.numParticles,
+                frame.updTime.AsMilliSeconds(),
                 drawTime.AsMilliSeconds(),
                 frameTime.AsMilliSeconds());
     Dbg::TextColor(glm::vec4(1.0f, 0.0f, 0.0f, 1.0f));
@@ -98,33 +102,76 @@ DrawCallPerfApp::OnRunning() {
 
 //------------------------------------------------------------------------------
 void
-DrawCallPerfApp::updateCamera() {
+DrawCallPerfApp::OnSync() {
+    // no update is running here, hand over main-thread state
+    if (this->toggleUpdate) {
+        this->updateEnabled = !this->updateEnabled;
+        this->toggleUpdate = false;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+DrawCallPerfApp::OnUpdate(int32 bufferIndex) {
+    // runs on the update thread, reads the previous frame's data (which
+    // is rendered in parallel), and writes the next frame's data
+    this->frameCount++;
+    this->updateCamera(bufferIndex);
+    const frameData& prevFrame = this->frames[bufferIndex ^ 1];
+    frameData& frame = this->frames[bufferIndex];
+    TimePoint updStart = Clock::Now();
+    frame.numParticles = prevFrame.numParticles;
+    if (this->updateEnabled) {
+        // write the particles into the buffer which isn't rendered
+        frame.particleBuffer = prevFrame.particleBuffer ^ 1;
+        this->emitParticles(bufferIndex);
+        this->updateParticles(bufferIndex);
+    }
+    else {
+        // render the last written particles again, nothing is written
+        frame.particleBuffer = prevFrame.particleBuffer;
+    }
+    frame.updTime = Clock::Since(updStart);
+}
+
+//------------------------------------------------------------------------------
+void
+DrawCallPerfApp::updateCamera(int32 bufferIndex) {
     float32 angle = this->frameCount * 0.01f;
     glm::vec3 pos(glm::sin(angle) * 10.0f, 2.5f, glm::cos(angle) * 10.0f);
     this->view = glm::lookAt(pos, glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-    this->modelViewProj = this->proj * this->view * this->model;
+    this->frames[bufferIndex].modelViewProj = this->proj * this->view * this->model;
 }
 
 //------------------------------------------------------------------------------
 void
-DrawCallPerfApp::emitParticles() {
+DrawCallPerfApp::emitParticles(int32 bufferIndex) {
+    // new particles are appended behind the previous frame's particles
+    // in this frame's particle buffer
+    frameData& frame = this->frames[bufferIndex];
+    particle* particles = this->particleBuffers[frame.particleBuffer];
     for (int32 i = 0; i < NumParticlesEmittedPerFrame; i++) {
-        if (this->curNumParticles < MaxNumParticles) {
-            this->particles[this->curNumParticles].pos = glm::vec4(0.0f, 0.0f, 0.0f, 0.0f);
+        if (frame.numParticles < MaxNumParticles) {
+            particles[frame.numParticles].pos = glm::vec4(0.0f, 0.0f, 0.0f, 0.0f);
             glm::vec3 rnd = glm::ballRand(0.5f);
             rnd.y += 2.0f;
-            this->particles[this->curNumParticles].vec = glm::vec4(rnd, 0.0f);
-            this->curNumParticles++;
+            particles[frame.numParticles].vec = glm::vec4(rnd, 0.0f);
+            frame.numParticles++;
         }
     }
 }
 
 //------------------------------------------------------------------------------
 void
-DrawCallPerfApp::updateParticles() {
+DrawCallPerfApp::updateParticles(int32 bufferIndex) {
     const float32 frameTime = 1.0f / 60.0f;
-    for (int32 i = 0; i < this->curNumParticles; i++) {
-        auto& curParticle = this->particles[i];
+    const frameData& prevFrame = this->frames[bufferIndex ^ 1];
+    const frameData& frame = this->frames[bufferIndex];
+    const particle* src = this->particleBuffers[prevFrame.particleBuffer];
+    particle* dst = this->particleBuffers[frame.particleBuffer];
+    for (int32 i = 0; i < frame.numParticles; i++) {
+        // newly emitted particles are already in this frame's buffer
+        particle curParticle = (i < prevFrame.numParticles) ? src[i] : dst[i];
         curParticle.vec.y -= 1.0f * frameTime;
         curParticle.pos += curParticle.vec * frameTime;
         if (curParticle.pos.y < -2.0f) {
@@ -132,6 +179,7 @@ DrawCallPerfApp::updateParticles() {
             curParticle.vec.y = -curParticle.vec.y;
             curParticle.vec *= 0.8f;
         }
+        dst[i] = curParticle;
     }
 }
 
@@ -167,7 +215,9 @@ DrawCallPerfApp::OnInit() {
     this->proj = glm::perspectiveFov(glm::radians(45.0f), fbWidth, fbHeight, 0.01f, 100.0f);
     this->view = glm::lookAt(glm::vec3(0.0f, 2.5f, 0.0f), glm::vec3(0.0f, 0.0f, -10.0f), glm::vec3(0.0f, 1.0f, 0.0f));
     this->model = glm::mat4();
-    this->modelViewProj = this->proj * this->view * this->model;
+
+    // overlap the particle update with rendering
+    this->SetPipelined(true);
     
     return App::OnInit();
 }